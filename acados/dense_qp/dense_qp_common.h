@@ -66,6 +66,7 @@ typedef struct
     acados_size_t (*memory_calculate_size)(void *config, void *dims, void *args);
     void *(*memory_assign)(void *config, void *dims, void *args, void *raw_memory);
     void (*memory_get)(void *config_, void *mem_, const char *field, void* value);
+    void (*memory_set)(void *config_, void *mem_, const char *field, void* value);  // optional, NULL if not implemented
     acados_size_t (*workspace_calculate_size)(void *config, void *dims, void *args);
     int (*evaluate)(void *config, void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     void (*solver_get)(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2);
@@ -215,6 +215,8 @@ void *dense_qp_hpipm_memory_assign(void *config_, void *dims_, void *opts_, void
     d_dense_qp_ipm_ws_create(dims, opts->hpipm_opts, ipm_workspace, c_ptr);
     c_ptr += ipm_workspace->memsize;
 
+    mem->iter_max_cap = 0;
+
     assert((char *) raw_memory + dense_qp_hpipm_memory_calculate_size(config_, dims, opts) >= c_ptr);
 
     return mem;
@@ -249,6 +251,26 @@ void dense_qp_hpipm_memory_get(void *config_, void *mem_, const char *field, voi
 
 
 
+void dense_qp_hpipm_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    dense_qp_hpipm_memory *mem = mem_;
+
+    if (!strcmp(field, "iter_max_cap"))
+    {
+        int *tmp_ptr = value;
+        mem->iter_max_cap = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: dense_qp_hpipm_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -284,10 +306,18 @@ int dense_qp_hpipm(void *config, void *qp_in_, void *qp_out_, void *opts_, void
     int ns = qp_in->dim->ns;
     blasfeo_dvecse(nv+2*ns, 0.0, qp_out->v, 0);
 
-    // solve ipm
+    // solve ipm, the iteration cap is applied to a copy of the (possibly shared) options
+    struct d_dense_qp_ipm_arg arg_capped;
+    struct d_dense_qp_ipm_arg *arg = opts->hpipm_opts;
+    if (mem->iter_max_cap > 0 && mem->iter_max_cap < arg->iter_max)
+    {
+        arg_capped = *arg;
+        arg_capped.iter_max = mem->iter_max_cap;
+        arg = &arg_capped;
+    }
     acados_tic(&qp_timer);
     int hpipm_status;
-    d_dense_qp_ipm_solve(qp_in, qp_out, opts->hpipm_opts, mem->hpipm_workspace);
+    d_dense_qp_ipm_solve(qp_in, qp_out, arg, mem->hpipm_workspace);
     d_dense_qp_ipm_get_status(mem->hpipm_workspace, &hpipm_status);
 
     info->solve_QP_time = acados_toc(&qp_timer);
@@ -382,6 +412,7 @@ void dense_qp_hpipm_config_initialize_default(void *config_)
     config->memory_calculate_size = &dense_qp_hpipm_memory_calculate_size;
     config->memory_assign = &dense_qp_hpipm_memory_assign;
     config->memory_get = &dense_qp_hpipm_memory_get;
+    config->memory_set = &dense_qp_hpipm_memory_set;
     config->workspace_calculate_size = &dense_qp_hpipm_workspace_calculate_size;
     config->evaluate = &dense_qp_hpipm;
     config->eval_forw_sens = &dense_qp_hpipm_eval_forw_sens;
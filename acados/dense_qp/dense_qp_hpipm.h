@@ -59,6 +59,7 @@ typedef struct dense_qp_hpipm_memory_
     struct d_dense_qp_ipm_ws *hpipm_workspace;
     double time_qp_solver_call;
     int iter;
+    int iter_max_cap;  // upper bound on iter_max for the next solves, 0: no bound
 
 } dense_qp_hpipm_memory;
 
@@ -77,6 +78,8 @@ acados_size_t dense_qp_hpipm_memory_calculate_size(void *config_, void *dims_, v
 //
 void *dense_qp_hpipm_memory_assign(void *config_, void *dims_, void *opts_, void *raw_memory);
 //
+void dense_qp_hpipm_memory_set(void *config_, void *mem_, const char *field, void* value);
+//
 acados_size_t dense_qp_hpipm_calculate_workspace_size(void *dims, void *opts_);
 //
 int dense_qp_hpipm(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
@@ -356,6 +356,7 @@ void *dense_qp_qpoases_memory_assign(void *config_, dense_qp_dims *dims, void *o
 
     // assign default values to fields stored in the memory
     mem->first_it = 1;  // only used if hotstart (only constant data matrices) is enabled
+    mem->iter_max_cap = 0;
 
     return mem;
 }
@@ -389,6 +390,26 @@ void dense_qp_qpoases_memory_get(void *config_, void *mem_, const char *field, v
 
 
 
+void dense_qp_qpoases_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    dense_qp_qpoases_memory *mem = mem_;
+
+    if (!strcmp(field, "iter_max_cap"))
+    {
+        int *tmp_ptr = value;
+        mem->iter_max_cap = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: dense_qp_qpoases_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -512,6 +533,8 @@ int dense_qp_qpoases(void *config_, dense_qp_in *qp_in, dense_qp_out *qp_out, vo
 
     // solve dense qp
     int nwsr = opts->max_nwsr;
+    if (memory->iter_max_cap > 0 && memory->iter_max_cap < nwsr)
+        nwsr = memory->iter_max_cap;
     double cputime = opts->max_cputime;
 
     int qpoases_status = 0;
@@ -817,6 +840,7 @@ void dense_qp_qpoases_config_initialize_default(void *config_)
     config->memory_assign =
         (void *(*) (void *, void *, void *, void *) ) & dense_qp_qpoases_memory_assign;
     config->memory_get = &dense_qp_qpoases_memory_get;
+    config->memory_set = &dense_qp_qpoases_memory_set;
     config->workspace_calculate_size =
         (acados_size_t (*)(void *, void *, void *)) & dense_qp_qpoases_workspace_calculate_size;
     config->eval_forw_sens = &dense_qp_qpoases_eval_forw_sens;
@@ -94,6 +94,7 @@ typedef struct dense_qp_qpoases_memory_
     dense_qp_in *qp_stacked;
     double time_qp_solver_call; // equal to cputime
     int iter;
+    int iter_max_cap;  // upper bound on max_nwsr for the next solves, 0: no bound
 
 } dense_qp_qpoases_memory;
 
@@ -109,6 +110,8 @@ acados_size_t dense_qp_qpoases__memorycalculate_size(void *config, dense_qp_dims
 //
 void *dense_qp_qpoases_memory_assign(void *config, dense_qp_dims *dims, void *opts_, void *raw_memory);
 //
+void dense_qp_qpoases_memory_set(void *config_, void *mem_, const char *field, void* value);
+//
 acados_size_t dense_qp_qpoases_workspace_calculate_size(void *config, dense_qp_dims *dims, void *opts_);
 //
 int dense_qp_qpoases(void *config, dense_qp_in *qp_in, dense_qp_out *qp_out, void *opts_, void *memory_, void *work_);
@@ -105,6 +105,8 @@ ocp_nlp_config *ocp_nlp_config_assign(int N, void *raw_memory)
 
     config->N = N;
     config->with_feasible_qp = false;
+    config->arena = NULL;
+    config->wait_async = NULL;
 
     // qp solver
     config->qp_solver = ocp_qp_xcond_solver_config_assign(c_ptr);
@@ -801,6 +803,8 @@ acados_size_t ocp_nlp_in_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *di
 
     size += (N + 1) * sizeof(double *);
 
+    size += 3 * (N + 1) * sizeof(int);  // num_changes, num_bound_changes, num_cost_vector_changes
+
     size += N * sizeof(void *);  // dynamics
 
     size += (N + 1) * sizeof(void *);  // cost
@@ -920,6 +924,18 @@ ocp_nlp_in *ocp_nlp_in_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void *
     }
     assign_and_advance_double(dims->n_global_data, &in->global_data, &c_ptr);
 
+    // ** ints **
+    assign_and_advance_int(N+1, &in->num_changes, &c_ptr);
+    assign_and_advance_int(N+1, &in->num_bound_changes, &c_ptr);
+    assign_and_advance_int(N+1, &in->num_cost_vector_changes, &c_ptr);
+    for (int i = 0; i <= N; i++)
+    {
+        in->num_changes[i] = 0;
+        in->num_bound_changes[i] = 0;
+        in->num_cost_vector_changes[i] = 0;
+    }
+    in->async_task = NULL;
+
     // blasfeo_mem align
     align_char_to(64, &c_ptr);
 
@@ -944,6 +960,41 @@ ocp_nlp_in *ocp_nlp_in_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void *
 
 
 
+void ocp_nlp_in_stage_changed(ocp_nlp_dims *dims, ocp_nlp_in *in, int stage, bool bounds_only)
+{
+    int i0 = stage < 0 ? 0 : stage;
+    int i1 = stage < 0 ? dims->N : stage;
+
+    for (int i = i0; i <= i1; i++)
+    {
+        if (bounds_only)
+            in->num_bound_changes[i]++;
+        else
+            in->num_changes[i]++;
+    }
+}
+
+
+
+void ocp_nlp_in_cost_vectors_changed(ocp_nlp_dims *dims, ocp_nlp_in *in, int stage)
+{
+    int i0 = stage < 0 ? 0 : stage;
+    int i1 = stage < 0 ? dims->N : stage;
+
+    for (int i = i0; i <= i1; i++)
+        in->num_cost_vector_changes[i]++;
+}
+
+
+
+void ocp_nlp_in_wait_async(ocp_nlp_in *in)
+{
+    if (in->async_task != NULL)
+        acados_async_task_wait(in->async_task);
+}
+
+
+
 /************************************************
  * out
  ************************************************/
@@ -1053,6 +1104,8 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
     blasfeo_dvecse(nz[N], 0.0, out->z+N, 0);
     blasfeo_dvecse(2*ni[N], 0.0, out->lam+N, 0);
 
+    out->async_task = NULL;
+
     assert((char *) raw_memory + ocp_nlp_out_calculate_size(config, dims) >= c_ptr);
 
     return out;
@@ -1060,6 +1113,14 @@ ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void
 
 
 
+void ocp_nlp_out_wait_async(ocp_nlp_out *out)
+{
+    if (out->async_task != NULL)
+        acados_async_task_wait(out->async_task);
+}
+
+
+
 /************************************************
  * options
  ************************************************/
@@ -1203,8 +1264,15 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->num_threads = omp_get_max_threads();
     // printf("\nocp_nlp: omp_get_max_threads %d", omp_get_max_threads());
     #endif
+#elif defined(ACADOS_WITH_THREAD_POOL)
+    #if defined(ACADOS_NUM_THREADS)
+    opts->num_threads = ACADOS_NUM_THREADS;
+    #else
+    opts->num_threads = 1;
+    #endif
 #endif
     // printf("\nocp_nlp: openmp threads = %d\n", opts->num_threads);
+    opts->pin_threads = 0;
 
     opts->print_level = 0;
     opts->levenberg_marquardt = 0.0;
@@ -1253,6 +1321,13 @@ void ocp_nlp_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->ext_qp_res = 0;
     opts->qp_warm_start = 0;
     opts->store_iterates = false;
+    opts->fuse_stage_evaluations = 0;
+    opts->with_memoization = 0;
+    opts->num_changes = 0;
+    opts->autotune_qp = 0;
+
+    opts->deadline = 0.0;
+    opts->deadline_safety_factor = 1.0;
 
     return;
 }
@@ -1302,6 +1377,8 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
     ocp_nlp_opts *opts = (ocp_nlp_opts *) opts_;
     ocp_nlp_config *config = config_;
 
+    opts->num_changes++;
+
     char *ptr_module = NULL;
     int module_length = 0;
     char module[MAX_STR_LEN];
@@ -1340,6 +1417,11 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             int* num_threads = (int *) value;
             opts->num_threads = *num_threads;
         }
+        else if (!strcmp(field, "pin_threads"))
+        {
+            int* pin_threads = (int *) value;
+            opts->pin_threads = *pin_threads;
+        }
         else if (!strcmp(field, "ext_qp_res"))
         {
             int* ext_qp_res = (int *) value;
@@ -1497,6 +1579,36 @@ void ocp_nlp_opts_set(void *config_, void *opts_, const char *field, void* value
             bool* with_anderson_acceleration = (bool *) value;
             opts->with_anderson_acceleration = *with_anderson_acceleration;
         }
+        else if (!strcmp(field, "fuse_stage_evaluations"))
+        {
+            int* fuse_stage_evaluations = (int *) value;
+            opts->fuse_stage_evaluations = *fuse_stage_evaluations;
+        }
+        else if (!strcmp(field, "with_memoization"))
+        {
+            int* with_memoization = (int *) value;
+            opts->with_memoization = *with_memoization;
+        }
+        else if (!strcmp(field, "autotune_qp"))
+        {
+            int* autotune_qp = (int *) value;
+            opts->autotune_qp = *autotune_qp;
+        }
+        else if (!strcmp(field, "deadline"))
+        {
+            double* deadline = (double *) value;
+            opts->deadline = *deadline;
+        }
+        else if (!strcmp(field, "deadline_safety_factor"))
+        {
+            double* deadline_safety_factor = (double *) value;
+            if (*deadline_safety_factor < 1.0)
+            {
+                printf("\nerror: ocp_nlp_opts_set: deadline_safety_factor must be >= 1, got %e\n", *deadline_safety_factor);
+                exit(1);
+            }
+            opts->deadline_safety_factor = *deadline_safety_factor;
+        }
         else
         {
             printf("\nerror: ocp_nlp_opts_set: wrong field: %s\n", field);
@@ -1515,6 +1627,8 @@ void ocp_nlp_opts_set_at_stage(void *config_, void *opts_, int stage, const char
     ocp_nlp_opts *opts = (ocp_nlp_opts *) opts_;
     ocp_nlp_config *config = config_;
 
+    opts->num_changes++;
+
     char *ptr_module = NULL;
     int module_length = 0;
     char module[MAX_STR_LEN];
@@ -1553,6 +1667,16 @@ void ocp_nlp_opts_set_at_stage(void *config_, void *opts_, int stage, const char
  * memory
  ************************************************/
 
+// align_char_to, adding the bytes skipped to padding
+static void ocp_nlp_align_char_to(int num, char **c_ptr, acados_size_t *padding)
+{
+    char *c_ptr_0 = *c_ptr;
+    align_char_to(num, c_ptr);
+    *padding += *c_ptr - c_ptr_0;
+}
+
+
+
 acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *nlp_in)
 {
     ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
@@ -1647,8 +1771,27 @@ acados_size_t ocp_nlp_memory_calculate_size(ocp_nlp_config *config, ocp_nlp_dims
 
     // timings
     size += sizeof(struct ocp_nlp_timings);
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    size += 3*(N+1)*sizeof(double); // time_lin_{dyn,cost,constr}_stage
+#endif
 
     size += (N+1)*sizeof(bool); // set_sim_guess
+    size += (N+1)*sizeof(int); // fill_avoided
+    size += 3*(N+1)*sizeof(int); // memo_in_changes, memo_in_bound_changes, memo_in_cost_vector_changes
+    size += 2*(N+1)*sizeof(bool); // qp_lhs_changed, cost_vectors_changed
+
+    // memoization
+    if (opts->with_memoization)
+    {
+        size += (N+1)*sizeof(ocp_nlp_memo);
+        for (int i = 0; i <= N; i++)
+        {
+            int nx1 = i < N ? nx[i+1] : 0;
+            size += (nu[i]+nx[i]+nx1 + 2*nv[i] + nv[i]+2*nx1+2*ni[i]) * sizeof(double); // key
+            size += (nx1 + 1 + 2*ni[i]) * sizeof(double); // fun
+            size += blasfeo_memsize_dmat(nu[i]+nx[i], nu[i]+nx[i]); // RSQrq
+        }
+    }
     // primal step norm
     if (opts->log_primal_step_norm)
     {
@@ -1713,9 +1856,10 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     int *ni_nl = dims->ni_nl;
 
     char *c_ptr = (char *) raw_memory;
+    acados_size_t alignment_padding = 0;
 
     // initial align
-    align_char_to(8, &c_ptr);
+    ocp_nlp_align_char_to(8, &c_ptr, &alignment_padding);
 
     // struct
     ocp_nlp_memory *mem = (ocp_nlp_memory *) c_ptr;
@@ -1742,7 +1886,7 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     }
 
     // middle align
-    align_char_to(8, &c_ptr);
+    ocp_nlp_align_char_to(8, &c_ptr, &alignment_padding);
 
     /* substructures */
     // qp in
@@ -1816,16 +1960,35 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     // timings
     mem->nlp_timings = (ocp_nlp_timings*) c_ptr;
     c_ptr += sizeof(ocp_nlp_timings);
-
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    mem->nlp_timings->N = N;
+    assign_and_advance_double(N+1, &mem->nlp_timings->time_lin_dyn_stage, &c_ptr);
+    assign_and_advance_double(N+1, &mem->nlp_timings->time_lin_cost_stage, &c_ptr);
+    assign_and_advance_double(N+1, &mem->nlp_timings->time_lin_constr_stage, &c_ptr);
+#endif
 
     // zero timings
     ocp_nlp_timings_reset(mem->nlp_timings);
     mem->nlp_timings->time_feedback = 0;
     mem->nlp_timings->time_preparation = 0;
     mem->nlp_timings->time_solution_sensitivities = 0;
+    mem->nlp_timings->est_time_lin = 0;
+    mem->nlp_timings->est_time_qp_iter = 0;
+    mem->nlp_timings->est_time_glob_trial = 0;
 
     // blasfeo_struct align
-    align_char_to(8, &c_ptr);
+    ocp_nlp_align_char_to(8, &c_ptr, &alignment_padding);
+
+    // memoization
+    if (opts->with_memoization)
+    {
+        mem->memo = (ocp_nlp_memo *) c_ptr;
+        c_ptr += (N+1)*sizeof(ocp_nlp_memo);
+    }
+    else
+    {
+        mem->memo = NULL;
+    }
 
     if (opts->with_solution_sens_wrt_params)
     {
@@ -1866,6 +2029,44 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         c_ptr += opts->max_iter*sizeof(double);
     }
 
+    // memoization keys and function values
+    if (opts->with_memoization)
+    {
+        for (i = 0; i <= N; i++)
+        {
+            int nx1 = i < N ? nx[i+1] : 0;
+            ocp_nlp_memo *memo = mem->memo + i;
+            assign_and_advance_double(nu[i]+nx[i]+nx1, &memo->key[OCP_NLP_MEMO_DYN], &c_ptr);
+            assign_and_advance_double(nv[i], &memo->key[OCP_NLP_MEMO_COST], &c_ptr);
+            assign_and_advance_double(nv[i], &memo->key[OCP_NLP_MEMO_CONSTR], &c_ptr);
+            assign_and_advance_double(nv[i]+2*nx1+2*ni[i], &memo->key[OCP_NLP_MEMO_QP], &c_ptr);
+            assign_and_advance_double(nx1, &memo->fun[OCP_NLP_MEMO_DYN], &c_ptr);
+            assign_and_advance_double(1, &memo->fun[OCP_NLP_MEMO_COST], &c_ptr);
+            assign_and_advance_double(2*ni[i], &memo->fun[OCP_NLP_MEMO_CONSTR], &c_ptr);
+            for (int k = 0; k < OCP_NLP_MEMO_NUM; k++)
+            {
+                memo->valid[k] = 0;
+                memo->num_eval[k] = 0;
+                memo->num_hit[k] = 0;
+            }
+            memo->enabled = false;
+        }
+    }
+
+    // fill_avoided
+    assign_and_advance_int(N+1, &mem->fill_avoided, &c_ptr);
+    for (i = 0; i <= N; ++i)
+    {
+        mem->fill_avoided[i] = 0;
+    }
+
+    // memo_in_changes, memo_in_bound_changes, memo_in_cost_vector_changes
+    assign_and_advance_int(N+1, &mem->memo_in_changes, &c_ptr);
+    assign_and_advance_int(N+1, &mem->memo_in_bound_changes, &c_ptr);
+    assign_and_advance_int(N+1, &mem->memo_in_cost_vector_changes, &c_ptr);
+    mem->memo_in = NULL;
+    mem->memo_opts_changes = -1;
+
     // set_sim_guess
     assign_and_advance_bool(N+1, &mem->set_sim_guess, &c_ptr);
     for (i = 0; i <= N; ++i)
@@ -1873,8 +2074,25 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
         mem->set_sim_guess[i] = false;
     }
 
+    // qp_lhs_changed
+    assign_and_advance_bool(N+1, &mem->qp_lhs_changed, &c_ptr);
+    for (i = 0; i <= N; ++i)
+    {
+        mem->qp_lhs_changed[i] = true;
+    }
+
+    // cost_vectors_changed
+    assign_and_advance_bool(N+1, &mem->cost_vectors_changed, &c_ptr);
+    for (i = 0; i <= N; ++i)
+    {
+        mem->cost_vectors_changed[i] = false;
+    }
+    mem->qp_lhs_valid = false;
+    mem->qp_lhs_levenberg_marquardt = 0.0;
+    mem->num_qp_lhs_reused = 0;
+
     // blasfeo_mem align
-    align_char_to(64, &c_ptr);
+    ocp_nlp_align_char_to(64, &c_ptr, &alignment_padding);
 
     // blasfeo_dmat
     if (opts->with_solution_sens_wrt_params)
@@ -1895,6 +2113,14 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     {
         assign_and_advance_blasfeo_dmat_mem(nu[i]+nx[i], nz[i], mem->dzduxt+i, &c_ptr);
     }
+    // memo RSQrq
+    if (opts->with_memoization)
+    {
+        for (i=0; i<=N; i++)
+        {
+            assign_and_advance_blasfeo_dmat_mem(nu[i]+nx[i], nu[i]+nx[i], &mem->memo[i].RSQrq, &c_ptr);
+        }
+    }
     // z_alg
     for (i=0; i<=N; i++)
     {
@@ -1936,6 +2162,16 @@ ocp_nlp_memory *ocp_nlp_memory_assign(ocp_nlp_config *config, ocp_nlp_dims *dims
     assign_and_advance_blasfeo_dvec_mem(np_global, &mem->out_np_global, &c_ptr);
 
     mem->compute_hess = 1;
+    mem->deadline_qp_iter_max = 0;
+
+    // set in ocp_nlp_solver_create
+    mem->thread_pool = NULL;
+    mem->qp_recorder = NULL;
+    mem->qp_record_failed = 0;
+    mem->autotune_qp_mem = NULL;
+
+    mem->alignment_padding = alignment_padding;
+    mem->workspace_alignment_padding = 0;
 
     return mem;
 }
@@ -2019,11 +2255,12 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
 
     // doubles
     size += nv_max * sizeof(double); // tmp_nv_double
+    size += 4*(N+1) * sizeof(double); // tmp_stage_res
 
     // module workspace
     if (opts->reuse_workspace)
     {
-#if defined(ACADOS_WITH_OPENMP)
+#if defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL)
         // qp solver
         size += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver,
             opts->qp_solver_opts);
@@ -2107,7 +2344,7 @@ acados_size_t ocp_nlp_workspace_calculate_size(ocp_nlp_config *config, ocp_nlp_d
     size_t ext_fun_workspace_size = 0;
     if (opts->reuse_workspace)
     {
-#if defined(ACADOS_WITH_OPENMP)
+#if defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL)
         // constraints
         for (int i = 0; i <= N; i++)
         {
@@ -2205,6 +2442,7 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     }
 
     char *c_ptr = (char *) raw_memory;
+    acados_size_t alignment_padding = 0;
 
     ocp_nlp_workspace *work = (ocp_nlp_workspace *) c_ptr;
     c_ptr += sizeof(ocp_nlp_workspace);
@@ -2220,7 +2458,7 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     work->constraints = (void **) c_ptr;
     c_ptr += (N+1)*sizeof(void *);
 
-    align_char_to(8, &c_ptr);
+    ocp_nlp_align_char_to(8, &c_ptr, &alignment_padding);
 
     /* substructures */
     // tmp_nlp_out
@@ -2250,10 +2488,11 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     }
 
     assign_and_advance_double(nv_max, &work->tmp_nv_double, &c_ptr);
+    assign_and_advance_double(4*(N+1), &work->tmp_stage_res, &c_ptr);
 
     assign_and_advance_int(ni_max+ns_max, &work->tmp_nins, &c_ptr);
     // align for blasfeo mem
-    align_char_to(64, &c_ptr);
+    ocp_nlp_align_char_to(64, &c_ptr, &alignment_padding);
 
     // blasfeo_dvec
     assign_and_advance_blasfeo_dvec_mem(nv_max, &work->tmp_nv, &c_ptr);
@@ -2263,7 +2502,7 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
 
     if (opts->reuse_workspace)
     {
-#if defined(ACADOS_WITH_OPENMP)
+#if defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL)
         // qp solver
         work->qp_work = (void *) c_ptr;
         c_ptr += qp_solver->workspace_calculate_size(qp_solver, dims->qp_solver, opts->qp_solver_opts);
@@ -2352,11 +2591,11 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
     }
 
     // align for external_function workspace
-    align_char_to(64, &c_ptr);
+    ocp_nlp_align_char_to(64, &c_ptr, &alignment_padding);
 
     if (opts->reuse_workspace)
     {
-#if defined(ACADOS_WITH_OPENMP)
+#if defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL)
         /* dont reuse workspace */
         // constraints
         for (int i = 0; i <= N; i++)
@@ -2420,6 +2659,8 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
 
     assert((char *) work + mem->workspace_size >= c_ptr);
 
+    mem->workspace_alignment_padding = alignment_padding;
+
     return work;
 }
 
@@ -2716,194 +2957,640 @@ void ocp_nlp_alias_memory_to_submodules(ocp_nlp_config *config, ocp_nlp_dims *di
 }
 
 
-void ocp_nlp_initialize_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
-         ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+/************************************************
+ * stage loops
+ ************************************************/
+
+// arguments of stage-wise loop bodies
+typedef struct
 {
-    int N = dims->N;
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    ocp_nlp_in *in;
+    ocp_nlp_out *out;
+    ocp_nlp_opts *opts;
+    ocp_nlp_memory *mem;
+    ocp_nlp_workspace *work;
+    // residuals
+    ocp_nlp_res *res;
+    // variable update
+    ocp_nlp_out *out_destination;
+    ocp_qp_out *step;
+    double alpha;
+    bool full_step_dual;
+} ocp_nlp_stage_loop_args;
+
+
+
+static void ocp_nlp_stage_loop_args_init(ocp_nlp_stage_loop_args *args, ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
+    ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    args->config = config;
+    args->dims = dims;
+    args->in = in;
+    args->out = out;
+    args->opts = opts;
+    args->mem = mem;
+    args->work = work;
+    args->res = NULL;
+    args->out_destination = NULL;
+    args->step = NULL;
+    args->alpha = 0.0;
+    args->full_step_dual = false;
+}
 
-    // NOTE: initialize is called at the start of every NLP solver call.
-    // It computes things in submodules based on stuff that can be changed by the user between
-    // subsequent solver calls, e.g. factorization of weight matrix.
-    // IN CONTRAST: precompute is only called once after solver creation
-    //  -> computes things that are not expected to change between subsequent solver calls
+
+
+// call fun(args, i) for i = 0, ..., n-1 on the solver thread pool, with OpenMP or serially
+static void ocp_nlp_parallel_for(ocp_nlp_memory *mem, int n, acados_parallel_fun fun, void *args)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    acados_thread_pool_run(mem->thread_pool, n, fun, args);
+#else
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
 #endif
-    for (int i = 0; i <= N; i++)
+    for (int i = 0; i < n; i++)
     {
-        // cost
-        config->cost[i]->initialize(config->cost[i], dims->cost[i], in->cost[i],
-                opts->cost[i], mem->cost[i], work->cost[i]);
-        // dynamics
-        if (i < N)
-            config->dynamics[i]->initialize(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        // constraints
-        config->constraints[i]->initialize(config->constraints[i], dims->constraints[i],
-                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+        fun(args, i);
     }
-
-    return;
+#endif
 }
 
 
 
-static void adaptive_levenberg_marquardt_update_mu(double iter, double step_size, ocp_nlp_opts *opts, ocp_nlp_memory *mem)
+/************************************************
+ * memoization of stage evaluations
+ ************************************************/
+
+// NOTE: a memo entry of stage i stays valid across solver calls as long as the data of stage i in
+// ocp_nlp_in and the options are unchanged, see ocp_nlp_in_stage_changed. The QP entry relies on the
+// submodule memory still holding the derivatives of the last QP approximation, so it is invalidated
+// whenever a submodule of the stage is evaluated again.
+
+static bool ocp_nlp_memo_key_equal(int n, struct blasfeo_dvec *v, int vi, double *key)
 {
-    if (iter == 0)
+    for (int j = 0; j < n; j++)
     {
-        mem->adaptive_levenberg_marquardt_mu = opts->adaptive_levenberg_marquardt_mu0;
-        mem->adaptive_levenberg_marquardt_mu_bar = opts->adaptive_levenberg_marquardt_mu0;
+        if (BLASFEO_DVECEL(v, vi+j) != key[j])
+            return false;
     }
-    else
+    return true;
+}
+
+
+
+// evaluation point of entry k: ux, for the dynamics followed by x in ux1
+static bool ocp_nlp_memo_fun_hit(ocp_nlp_dims *dims, ocp_nlp_memo *memo, int i, int k,
+    struct blasfeo_dvec *ux, struct blasfeo_dvec *ux1)
+{
+    double *key = memo->key[k];
+
+    if (!memo->valid[k])
+        return false;
+
+    if (k == OCP_NLP_MEMO_DYN)
     {
-        if (step_size == 1.0)
-        {
-            double mu_tmp = mem->adaptive_levenberg_marquardt_mu;
-            mem->adaptive_levenberg_marquardt_mu = fmax(opts->adaptive_levenberg_marquardt_mu_min,
-                            mem->adaptive_levenberg_marquardt_mu_bar/(opts->adaptive_levenberg_marquardt_lam));
-            mem->adaptive_levenberg_marquardt_mu_bar = mu_tmp;
-        }
-        else
-        {
-            mem->adaptive_levenberg_marquardt_mu = fmin(opts->adaptive_levenberg_marquardt_lam * mem->adaptive_levenberg_marquardt_mu, 1.0);
-        }
+        int nux = dims->nu[i] + dims->nx[i];
+        return ocp_nlp_memo_key_equal(nux, ux, 0, key) &&
+               ocp_nlp_memo_key_equal(dims->nx[i+1], ux1, dims->nu[i+1], key+nux);
     }
+    return ocp_nlp_memo_key_equal(dims->nv[i], ux, 0, key);
 }
 
-void ocp_nlp_add_levenberg_marquardt_term(ocp_nlp_config *config, ocp_nlp_dims *dims,
-    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work, double alpha, int iter, ocp_qp_in *qp_in)
+
+
+static void ocp_nlp_memo_fun_store(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem,
+    int i, int k, struct blasfeo_dvec *ux, struct blasfeo_dvec *ux1)
 {
-    if (opts->with_adaptive_levenberg_marquardt)
+    ocp_nlp_memo *memo = mem->memo + i;
+    double *key = memo->key[k];
+    double *fun = memo->fun[k];
+
+    if (k == OCP_NLP_MEMO_DYN)
     {
-        adaptive_levenberg_marquardt_update_mu(iter, alpha, opts, mem);
-        double reg_param = 2*mem->cost_value*mem->adaptive_levenberg_marquardt_mu;
-        opts->levenberg_marquardt = reg_param;
+        int nux = dims->nu[i] + dims->nx[i];
+        blasfeo_unpack_dvec(nux, ux, 0, key, 1);
+        blasfeo_unpack_dvec(dims->nx[i+1], ux1, dims->nu[i+1], key+nux, 1);
+        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_unpack_dvec(dims->nx[i+1], dyn_fun, 0, fun, 1);
     }
-    // Only add the Levenberg-Marquardt term when it is bigger than zero
-    if (mem->compute_hess && opts->levenberg_marquardt > 0.0)
+    else if (k == OCP_NLP_MEMO_COST)
     {
-        int N = dims->N;
-        int *nx = dims->nx;
-        int *nu = dims->nu;
-        for (int i = 0; i <= N; i++)
-        {
-            if (i < N)
-            {
-                // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
-                blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
-                                mem->qp_in->RSQrq+i, 0, 0);
-            }
-            else
-            {
-                // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
-                blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
-                                mem->qp_in->RSQrq+i, 0, 0);
-            }
-        }
-    } // else: do nothing
+        blasfeo_unpack_dvec(dims->nv[i], ux, 0, key, 1);
+        fun[0] = *config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
+    }
+    else
+    {
+        blasfeo_unpack_dvec(dims->nv[i], ux, 0, key, 1);
+        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+        blasfeo_unpack_dvec(2*dims->ni[i], ineq_fun, 0, fun, 1);
+    }
+    memo->valid[k] = 1;
 }
 
 
 
-static void collect_integrator_timings(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem)
+static void ocp_nlp_memo_fun_restore(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem,
+    int i, int k)
 {
-    /* collect stage-wise timings */
-    ocp_nlp_timings *nlp_timings = mem->nlp_timings;
-    for (int ii=0; ii < dims->N; ii++)
+    double *fun = mem->memo[i].fun[k];
+
+    if (k == OCP_NLP_MEMO_DYN)
     {
-        double tmp_time;
-        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim", &tmp_time);
-        nlp_timings->time_sim += tmp_time;
-        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_la", &tmp_time);
-        nlp_timings->time_sim_la += tmp_time;
-        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_ad", &tmp_time);
-        nlp_timings->time_sim_ad += tmp_time;
+        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_pack_dvec(dims->nx[i+1], fun, 1, dyn_fun, 0);
+    }
+    else if (k == OCP_NLP_MEMO_COST)
+    {
+        *config->cost[i]->memory_get_fun_ptr(mem->cost[i]) = fun[0];
+    }
+    else
+    {
+        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+        blasfeo_pack_dvec(2*dims->ni[i], fun, 1, ineq_fun, 0);
     }
 }
 
-void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
-    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
-    ocp_nlp_workspace *work)
+
+
+static void ocp_nlp_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+    ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i, int k,
+    struct blasfeo_dvec *ux, struct blasfeo_dvec *ux1)
 {
-    int N = dims->N;
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    int *nu = dims->nu;
+    ocp_nlp_memo *memo = NULL;
+    if (mem->memo != NULL && mem->memo[i].enabled)
+        memo = mem->memo + i;
 
-    /* stage-wise multiple shooting lagrangian evaluation */
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+    if (memo != NULL && ocp_nlp_memo_fun_hit(dims, memo, i, k, ux, ux1))
     {
-        // init Hessian to 0
-        if (mem->compute_hess)
-        {
-            blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
-        }
-
-        if (i < N)
-        {
-            // dynamics
-            config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
-                    in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        }
+        ocp_nlp_memo_fun_restore(config, dims, mem, i, k);
+        memo->num_hit[k]++;
+        return;
+    }
 
-        // cost
-        config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+    if (k == OCP_NLP_MEMO_DYN)
+        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    else if (k == OCP_NLP_MEMO_COST)
+        config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i],
                 opts->cost[i], mem->cost[i], work->cost[i]);
-
-        // constraints
-        config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+    else
+        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
                 in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+
+    if (memo != NULL)
+    {
+        ocp_nlp_memo_fun_store(config, dims, mem, i, k, ux, ux1);
+        memo->valid[OCP_NLP_MEMO_QP] = 0;
+        memo->num_eval[k]++;
     }
+}
 
-    /* collect stage-wise evaluations */
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i <= N; i++)
-    {
-        // nlp mem: cost_grad
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
 
-        // nlp mem: dyn_fun
+
+void ocp_nlp_dynamics_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux, struct blasfeo_dvec *ux1)
+{
+    ocp_nlp_compute_fun_memo(config, dims, in, opts, mem, work, i, OCP_NLP_MEMO_DYN, ux, ux1);
+}
+
+
+
+void ocp_nlp_cost_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux)
+{
+    ocp_nlp_compute_fun_memo(config, dims, in, opts, mem, work, i, OCP_NLP_MEMO_COST, ux, NULL);
+}
+
+
+
+void ocp_nlp_constraints_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux)
+{
+    ocp_nlp_compute_fun_memo(config, dims, in, opts, mem, work, i, OCP_NLP_MEMO_CONSTR, ux, NULL);
+}
+
+
+
+void ocp_nlp_memo_invalidate_stage(ocp_nlp_memory *mem, int i)
+{
+    // the submodules might have written to the QP matrices of the stage
+    mem->qp_lhs_changed[i] = true;
+    mem->cost_vectors_changed[i] = false;
+    if (mem->memo == NULL)
+        return;
+    for (int k = 0; k < OCP_NLP_MEMO_NUM; k++)
+        mem->memo[i].valid[k] = 0;
+}
+
+
+
+// QP key: ux_i, x_{i+1}, pi_i, lam_i
+static bool ocp_nlp_memo_qp_hit(ocp_nlp_dims *dims, ocp_nlp_out *out, ocp_nlp_memo *memo, int i)
+{
+    int N = dims->N;
+    int nv = dims->nv[i];
+    int nx1 = i < N ? dims->nx[i+1] : 0;
+    int ni = dims->ni[i];
+    double *key = memo->key[OCP_NLP_MEMO_QP];
+
+    if (!memo->valid[OCP_NLP_MEMO_QP])
+        return false;
+    if (!ocp_nlp_memo_key_equal(nv, out->ux+i, 0, key))
+        return false;
+    if (i < N && !(ocp_nlp_memo_key_equal(nx1, out->ux+i+1, dims->nu[i+1], key+nv) &&
+                   ocp_nlp_memo_key_equal(nx1, out->pi+i, 0, key+nv+nx1)))
+        return false;
+    return ocp_nlp_memo_key_equal(2*ni, out->lam+i, 0, key+nv+2*nx1);
+}
+
+
+
+static void ocp_nlp_memo_qp_store(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out,
+    ocp_nlp_memory *mem, int i)
+{
+    int N = dims->N;
+    int nv = dims->nv[i];
+    int nux = dims->nu[i] + dims->nx[i];
+    int nx1 = i < N ? dims->nx[i+1] : 0;
+    ocp_nlp_memo *memo = mem->memo + i;
+    double *key = memo->key[OCP_NLP_MEMO_QP];
+
+    blasfeo_unpack_dvec(nv, out->ux+i, 0, key, 1);
+    if (i < N)
+    {
+        blasfeo_unpack_dvec(nx1, out->ux+i+1, dims->nu[i+1], key+nv, 1);
+        blasfeo_unpack_dvec(nx1, out->pi+i, 0, key+nv+nx1, 1);
+    }
+    blasfeo_unpack_dvec(2*dims->ni[i], out->lam+i, 0, key+nv+2*nx1, 1);
+    blasfeo_dgecp(nux, nux, mem->qp_in->RSQrq+i, 0, 0, &memo->RSQrq, 0, 0);
+    memo->valid[OCP_NLP_MEMO_QP] = 1;
+
+    // the linearization also evaluated dynamics and cost
+    if (i < N)
+        ocp_nlp_memo_fun_store(config, dims, mem, i, OCP_NLP_MEMO_DYN, out->ux+i, out->ux+i+1);
+    ocp_nlp_memo_fun_store(config, dims, mem, i, OCP_NLP_MEMO_COST, out->ux+i, NULL);
+}
+
+
+
+static void ocp_nlp_initialize_submodules_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int N = dims->N;
+
+    // cost
+    config->cost[i]->initialize(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
+    // dynamics
+    if (i < N)
+        config->dynamics[i]->initialize(config->dynamics[i], dims->dynamics[i],
+                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    // constraints
+    config->constraints[i]->initialize(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+
+    // structural sparsity exploited in QP assembly
+    int fill_cost = 0;
+    int fill_dyn = 0;
+    int fill_constr = 0;
+    config->cost[i]->memory_get(config->cost[i], dims->cost[i], mem->cost[i],
+            "fill_avoided", &fill_cost);
+    if (i < N)
+        config->dynamics[i]->memory_get(config->dynamics[i], dims->dynamics[i],
+                mem->dynamics[i], "fill_avoided", &fill_dyn);
+    config->constraints[i]->memory_get(config->constraints[i], dims->constraints[i],
+            mem->constraints[i], "fill_avoided", &fill_constr);
+    mem->fill_avoided[i] = fill_cost + fill_dyn + fill_constr;
+
+    // memoization: keep the entries of stages whose data did not change since the last call
+    bool stage_changed = mem->memo_in != in || mem->memo_opts_changes != opts->num_changes
+                         || mem->memo_in_changes[i] != in->num_changes[i];
+    bool cost_vectors_changed = mem->memo_in_cost_vector_changes[i] != in->num_cost_vector_changes[i];
+    if (cost_vectors_changed && !stage_changed)
+    {
+        // e.g. the reference enters the outer Hessian of the CONL cost and the exact NLS Hessian
+        int ref_enters_hess = 1;
+        config->cost[i]->memory_get(config->cost[i], dims->cost[i], mem->cost[i],
+                "ref_enters_hess", &ref_enters_hess);
+        stage_changed = ref_enters_hess;
+    }
+    if (stage_changed)
+    {
+        mem->qp_lhs_changed[i] = true;
+    }
+    if (mem->memo != NULL)
+    {
+        ocp_nlp_memo *memo = mem->memo + i;
+        int cost_integration = 0;
         if (i < N)
+            config->dynamics[i]->opts_get(config->dynamics[i], opts->dynamics[i],
+                    "cost_computation", &cost_integration);
+        // algebraic states and integrated cost couple the submodule memories
+        memo->enabled = dims->nz[i] == 0 && !cost_integration;
+        if (stage_changed)
+        {
+            ocp_nlp_memo_invalidate_stage(mem, i);
+        }
+        else if (mem->memo_in_bound_changes[i] != in->num_bound_changes[i])
+        {
+            // bounds only enter the constraint values and the QP vectors, which are always updated
+            memo->valid[OCP_NLP_MEMO_CONSTR] = 0;
+        }
+        if (!stage_changed && cost_vectors_changed)
+        {
+            // the cost vectors only enter the cost value and gradient, a hit of the QP entry
+            // keeps the QP matrices and re-evaluates the cost, see ocp_nlp_approximate_qp_matrices_stage
+            memo->valid[OCP_NLP_MEMO_COST] = 0;
+            mem->cost_vectors_changed[i] = true;
+        }
+        for (int k = 0; k < OCP_NLP_MEMO_NUM; k++)
         {
-            struct blasfeo_dvec *dyn_fun
-                = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+            memo->num_eval[k] = 0;
+            memo->num_hit[k] = 0;
         }
+    }
+}
 
-        // nlp mem: dyn_adj
-        if (i < N)
+
+
+void ocp_nlp_initialize_submodules(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+         ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
+{
+    int N = dims->N;
+
+    // NOTE: initialize is called at the start of every NLP solver call.
+    // It computes things in submodules based on stuff that can be changed by the user between
+    // subsequent solver calls, e.g. factorization of weight matrix.
+    // IN CONTRAST: precompute is only called once after solver creation
+    //  -> computes things that are not expected to change between subsequent solver calls
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_initialize_submodules_stage, &args);
+
+    // remember the state of the data, see ocp_nlp_in_stage_changed
+    mem->memo_in = in;
+    mem->num_qp_lhs_reused = 0;
+    mem->memo_opts_changes = opts->num_changes;
+    for (int i = 0; i <= N; i++)
+    {
+        mem->memo_in_changes[i] = in->num_changes[i];
+        mem->memo_in_bound_changes[i] = in->num_bound_changes[i];
+        mem->memo_in_cost_vector_changes[i] = in->num_cost_vector_changes[i];
+    }
+
+    return;
+}
+
+
+
+static void adaptive_levenberg_marquardt_update_mu(double iter, double step_size, ocp_nlp_opts *opts, ocp_nlp_memory *mem)
+{
+    if (iter == 0)
+    {
+        mem->adaptive_levenberg_marquardt_mu = opts->adaptive_levenberg_marquardt_mu0;
+        mem->adaptive_levenberg_marquardt_mu_bar = opts->adaptive_levenberg_marquardt_mu0;
+    }
+    else
+    {
+        if (step_size == 1.0)
         {
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-            blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+            double mu_tmp = mem->adaptive_levenberg_marquardt_mu;
+            mem->adaptive_levenberg_marquardt_mu = fmax(opts->adaptive_levenberg_marquardt_mu_min,
+                            mem->adaptive_levenberg_marquardt_mu_bar/(opts->adaptive_levenberg_marquardt_lam));
+            mem->adaptive_levenberg_marquardt_mu_bar = mu_tmp;
         }
         else
         {
-            blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+            mem->adaptive_levenberg_marquardt_mu = fmin(opts->adaptive_levenberg_marquardt_lam * mem->adaptive_levenberg_marquardt_mu, 1.0);
         }
-        if (i > 0)
+    }
+}
+
+void ocp_nlp_add_levenberg_marquardt_term(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work, double alpha, int iter, ocp_qp_in *qp_in)
+{
+    if (opts->with_adaptive_levenberg_marquardt)
+    {
+        adaptive_levenberg_marquardt_update_mu(iter, alpha, opts, mem);
+        double reg_param = 2*mem->cost_value*mem->adaptive_levenberg_marquardt_mu;
+        opts->levenberg_marquardt = reg_param;
+    }
+    // Only add the Levenberg-Marquardt term when it is bigger than zero
+    if (mem->compute_hess && opts->levenberg_marquardt > 0.0)
+    {
+        int N = dims->N;
+        int *nx = dims->nx;
+        int *nu = dims->nu;
+        for (int i = 0; i <= N; i++)
         {
-            // TODO: this could be simplified by not copying pi in the dynamics module.
-            struct blasfeo_dvec *dyn_adj
-                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
-            blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
-                mem->dyn_adj+i, nu[i]);
+            if (i < N)
+            {
+                // Levenberg Marquardt term: Ts[i] * levenberg_marquardt * eye()
+                blasfeo_ddiare(nu[i] + nx[i], in->Ts[i] * opts->levenberg_marquardt,
+                                mem->qp_in->RSQrq+i, 0, 0);
+            }
+            else
+            {
+                // Levenberg Marquardt term: 1.0 * levenberg_marquardt * eye()
+                blasfeo_ddiare(nu[i] + nx[i], opts->levenberg_marquardt,
+                                mem->qp_in->RSQrq+i, 0, 0);
+            }
         }
+    } // else: do nothing
+}
+
+
+
+// per-stage timers, these expand to nothing unless built with ACADOS_WITH_STAGE_TIMINGS
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+#define STAGE_TIMER_TIC(timer) acados_tic(&(timer))
+#define STAGE_TIMER_TOC(timer, acc) ((acc) += acados_toc(&(timer)))
+#else
+#define STAGE_TIMER_TIC(timer)
+#define STAGE_TIMER_TOC(timer, acc)
+#endif
+
+static void collect_integrator_timings(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_memory *mem)
+{
+    /* collect stage-wise timings */
+    ocp_nlp_timings *nlp_timings = mem->nlp_timings;
+    for (int ii=0; ii < dims->N; ii++)
+    {
+        double tmp_time;
+        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim", &tmp_time);
+        nlp_timings->time_sim += tmp_time;
+        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_la", &tmp_time);
+        nlp_timings->time_sim_la += tmp_time;
+        config->dynamics[ii]->memory_get(config->dynamics[ii], dims->dynamics[ii], mem->dynamics[ii], "time_sim_ad", &tmp_time);
+        nlp_timings->time_sim_ad += tmp_time;
+    }
+}
+
+static void ocp_nlp_approximate_qp_matrices_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    // memoization, only if the Hessian is recomputed
+    ocp_nlp_memo *memo = NULL;
+    if (mem->memo != NULL && mem->memo[i].enabled && mem->compute_hess)
+        memo = mem->memo + i;
+
+    if (memo != NULL && ocp_nlp_memo_qp_hit(dims, out, memo, i))
+    {
+        if (mem->cost_vectors_changed[i])
+        {
+            // new cost gradient and value, the Hessian block added to RSQrq is overwritten below
+            config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+                    opts->cost[i], mem->cost[i], work->cost[i]);
+            ocp_nlp_memo_fun_store(config, dims, mem, i, OCP_NLP_MEMO_COST, out->ux+i, NULL);
+            mem->cost_vectors_changed[i] = false;
+        }
+        // BAbt, DCt and the derivatives in the submodule memory are untouched since,
+        // the Hessian block might have been regularized, the function values overwritten
+        blasfeo_dgecp(nu[i] + nx[i], nu[i] + nx[i], &memo->RSQrq, 0, 0, mem->qp_in->RSQrq+i, 0, 0);
+        if (i < N)
+            ocp_nlp_memo_fun_restore(config, dims, mem, i, OCP_NLP_MEMO_DYN);
+        ocp_nlp_memo_fun_restore(config, dims, mem, i, OCP_NLP_MEMO_COST);
+        memo->num_hit[OCP_NLP_MEMO_QP]++;
+        return;
+    }
+    mem->qp_lhs_changed[i] = true;
+    mem->cost_vectors_changed[i] = false;
+
+    // init Hessian to 0
+    if (mem->compute_hess)
+    {
+        blasfeo_dgese(nu[i] + nx[i], nu[i] + nx[i], 0.0, mem->qp_in->RSQrq+i, 0, 0);
+    }
+
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    ocp_nlp_timings *nlp_timings = mem->nlp_timings;
+    acados_timer timer;
+#endif
+
+    if (i < N)
+    {
+        // dynamics
+        STAGE_TIMER_TIC(timer);
+        config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i],
+                in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        STAGE_TIMER_TOC(timer, nlp_timings->time_lin_dyn_stage[i]);
+    }
+
+    // cost
+    STAGE_TIMER_TIC(timer);
+    config->cost[i]->update_qp_matrices(config->cost[i], dims->cost[i], in->cost[i],
+            opts->cost[i], mem->cost[i], work->cost[i]);
+    STAGE_TIMER_TOC(timer, nlp_timings->time_lin_cost_stage[i]);
+
+    // constraints
+    STAGE_TIMER_TIC(timer);
+    config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i],
+            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    STAGE_TIMER_TOC(timer, nlp_timings->time_lin_constr_stage[i]);
 
-        // nlp mem: ineq_adj
-        struct blasfeo_dvec *ineq_adj =
-            config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
-        blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+    if (memo != NULL)
+    {
+        ocp_nlp_memo_qp_store(config, dims, out, mem, i);
+        memo->num_eval[OCP_NLP_MEMO_QP]++;
+    }
+    else if (mem->memo != NULL)
+    {
+        ocp_nlp_memo_invalidate_stage(mem, i);
+    }
+}
+
+
+
+static void ocp_nlp_collect_stage_evaluations(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_memory *mem = args->mem;
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    // nlp mem: cost_grad
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+
+    // nlp mem: dyn_fun
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_fun
+            = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
     }
 
+    // nlp mem: dyn_adj
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+    }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
+    }
+    if (i > 0)
+    {
+        // TODO: this could be simplified by not copying pi in the dynamics module.
+        struct blasfeo_dvec *dyn_adj
+            = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+        blasfeo_daxpy(nx[i], 1.0, dyn_adj, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+            mem->dyn_adj+i, nu[i]);
+    }
+
+    // nlp mem: ineq_adj
+    struct blasfeo_dvec *ineq_adj =
+        config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
+    blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+}
+
+
+
+void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work)
+{
+    int N = dims->N;
+
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+
+    /* stage-wise multiple shooting lagrangian evaluation */
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_approximate_qp_matrices_stage, &args);
+
+    /* collect stage-wise evaluations */
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_collect_stage_evaluations, &args);
+
     collect_integrator_timings(config, dims, mem);
 }
 
@@ -2912,41 +3599,292 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
 // update QP rhs for SQP (step prim var, abs dual var)
 // - use cost gradient and dynamics residual from memory
 // - evaluate constraints wrt bounds -> allows to update all bounds between preparation and feedback phase.
+static void ocp_nlp_approximate_qp_vectors_sqp_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    // g
+    blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+
+    // b
+    if (i < N)
+        blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
+
+    // evaluate constraint residuals
+    config->constraints[i]->update_qp_vectors(config->constraints[i], dims->constraints[i],
+        in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+
+    // copy ineq function value into nlp mem, then into QP
+    struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+
+    // d
+    blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
+}
+
+
+
 void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
     ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
     int N = dims->N;
+
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_approximate_qp_vectors_sqp_stage, &args);
+}
+
+
+
+// residuals of stage i, the stage norms are stored in work->tmp_stage_res[4*i:4*i+4],
+// see ocp_nlp_res_reduce_stage_norms
+static void ocp_nlp_res_compute_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    ocp_nlp_res *res = args->res;
+    ocp_qp_dims *qp_dims = mem->qp_in->dim;
+    int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
-    // int *nu = dims->nu;
+    int *nu = dims->nu;
     int *ni = dims->ni;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+    double *stage_res = work->tmp_stage_res + 4*i;
+    double tmp;
+
+    // res_stat
+    blasfeo_daxpy(nv[i], -1.0, mem->ineq_adj + i, 0, mem->cost_grad + i, 0, res->res_stat + i, 0);
+    blasfeo_daxpy(nu[i] + nx[i], -1.0, mem->dyn_adj + i, 0, res->res_stat + i, 0, res->res_stat + i, 0);
+    blasfeo_dvecnrm_inf(nv[i], res->res_stat + i, 0, stage_res+0);
+
+    // res_eq
+    stage_res[1] = 0.0;
+    if (i < N)
     {
-        // g
-        blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+        blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, res->res_eq + i, 0);
+        blasfeo_dvecnrm_inf(nx[i + 1], res->res_eq + i, 0, stage_res+1);
+    }
 
-        // b
-        if (i < N)
-            blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, mem->qp_in->b + i, 0);
+    // res_ineq
+    stage_res[2] = 0.0;
+    for (int j = 0; j < 2*ni[i]; j++)
+    {
+        tmp = BLASFEO_DVECEL(mem->ineq_fun+i, j);
+        if (tmp > stage_res[2])
+            stage_res[2] = tmp;
+    }
 
-        // evaluate constraint residuals
-        config->constraints[i]->update_qp_vectors(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    // res_comp
+    stage_res[3] = 0.0;
+    if (opts->tau_min != 0)
+    {
+        if (ni[i] > 0)
+        {
+            blasfeo_dvecmul(2 * ni[i], out->lam + i, 0, mem->ineq_fun+i, 0, res->res_comp + i, 0);
+            blasfeo_dvecad(2 * ni[i], 1.0, &work->tmp_2ni, 0, res->res_comp + i, 0);
+            // zero out complementarities corresponding to equalities
+            int ne = qp_dims->nbue[i] + qp_dims->nbxe[i] + qp_dims->nge[i];
+            for (int j = 0; j < ne; j++)
+            {
+                BLASFEO_DVECEL(res->res_comp+i, mem->qp_in->idxe[i][j]) = 0.0;
+                BLASFEO_DVECEL(res->res_comp+i, mem->qp_in->idxe[i][j]+ni[i]) = 0.0;
+            }
+            blasfeo_dvecnrm_inf(2 * ni[i], res->res_comp + i, 0, stage_res+3);
+        }
+    }
+    else
+    {
+        blasfeo_dvecmul(2 * ni[i], out->lam + i, 0, mem->ineq_fun+i, 0, res->res_comp + i, 0);
+        blasfeo_dvecnrm_inf(2 * ni[i], res->res_comp + i, 0, stage_res+3);
+    }
+}
+
+
+
+// work->tmp_2ni has to hold tau_min for the complementarity residuals
+static void ocp_nlp_res_set_tau_min(ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_workspace *work)
+{
+    if (opts->tau_min != 0)
+    {
+        int ni_max = 0;
+        for (int i = 0; i <= dims->N; i++)
+            ni_max = ni_max > dims->ni[i] ? ni_max : dims->ni[i];
+        blasfeo_dvecse(2*ni_max, opts->tau_min, &work->tmp_2ni, 0);
+    }
+}
+
+
+
+static void ocp_nlp_res_reduce_stage_norms(ocp_nlp_dims *dims, ocp_nlp_workspace *work, ocp_nlp_res *res)
+{
+    res->inf_norm_res_stat = 0.0;
+    res->inf_norm_res_eq = 0.0;
+    res->inf_norm_res_ineq = 0.0;
+    res->inf_norm_res_comp = 0.0;
+    for (int i = 0; i <= dims->N; i++)
+    {
+        double *stage_res = work->tmp_stage_res + 4*i;
+        res->inf_norm_res_stat = fmax(res->inf_norm_res_stat, stage_res[0]);
+        res->inf_norm_res_eq = fmax(res->inf_norm_res_eq, stage_res[1]);
+        res->inf_norm_res_ineq = fmax(res->inf_norm_res_ineq, stage_res[2]);
+        res->inf_norm_res_comp = fmax(res->inf_norm_res_comp, stage_res[3]);
+    }
+}
 
-        // copy ineq function value into nlp mem, then into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
 
-        // d
-        blasfeo_dveccp(2 * ni[i], mem->ineq_fun + i, 0, mem->qp_in->d + i, 0);
+
+static void ocp_nlp_approximate_qp_fused_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int N = dims->N;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    /* linearize dynamics, cost, constraints */
+    ocp_nlp_approximate_qp_matrices_stage(args_, i);
+
+    /* collect evaluations */
+    // nlp mem: cost_grad
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+
+    // nlp mem: dyn_fun, dyn_adj
+    if (i < N)
+    {
+        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+        struct blasfeo_dvec *dyn_adj = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+        blasfeo_dveccp(nu[i] + nx[i], dyn_adj, 0, mem->dyn_adj + i, 0);
+    }
+    else
+    {
+        blasfeo_dvecse(nu[N] + nx[N], 0.0, mem->dyn_adj + N, 0);
     }
+    if (i > 0)
+    {
+        // the dynamics module of stage i-1 stores a copy of pi[i-1] at the end of its adjoint,
+        // see ocp_nlp_collect_stage_evaluations. With compute_adj it writes it during this pass
+        // and might not be evaluated yet, therefore use pi[i-1] directly. Otherwise the module
+        // does not touch it in this pass and it is read as in the unfused path.
+        int compute_adj;
+        config->dynamics[i-1]->opts_get(config->dynamics[i-1], opts->dynamics[i-1], "compute_adj", &compute_adj);
+        if (compute_adj)
+        {
+            blasfeo_daxpy(nx[i], 1.0, out->pi+i-1, 0, mem->dyn_adj+i, nu[i],
+                mem->dyn_adj+i, nu[i]);
+        }
+        else
+        {
+            struct blasfeo_dvec *dyn_adj_prev
+                = config->dynamics[i-1]->memory_get_adj_ptr(mem->dynamics[i-1]);
+            blasfeo_daxpy(nx[i], 1.0, dyn_adj_prev, nu[i-1]+nx[i-1], mem->dyn_adj+i, nu[i],
+                mem->dyn_adj+i, nu[i]);
+        }
+    }
+
+    // nlp mem: ineq_adj
+    struct blasfeo_dvec *ineq_adj = config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
+    blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
+
+    /* QP vectors */
+    ocp_nlp_approximate_qp_vectors_sqp_stage(args_, i);
+
+    /* residuals */
+    ocp_nlp_res_compute_stage(args_, i);
 }
 
+
+
+// fused alternative to
+//   ocp_nlp_approximate_qp_matrices + ocp_nlp_approximate_qp_vectors_sqp + ocp_nlp_res_compute:
+// every stage is linearized, copied into the QP and used for the residuals in a single pass,
+// while its data is still in cache.
+void ocp_nlp_approximate_qp_fused(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem,
+    ocp_nlp_workspace *work, ocp_nlp_res *res)
+{
+    int N = dims->N;
+
+    ocp_nlp_res_set_tau_min(dims, opts, work);
+
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+    args.res = res;
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_approximate_qp_fused_stage, &args);
+
+    ocp_nlp_res_reduce_stage_norms(dims, work, res);
+
+    collect_integrator_timings(config, dims, mem);
+}
+
+static void ocp_nlp_constraints_fun_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int *ni = dims->ni;
+
+    // evaluate constraint residuals
+    ocp_nlp_constraints_compute_fun_memo(config, dims, in, opts, mem, work, i, out->ux+i);
+    // copy ineq function value into QP
+    struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->qp_in->d + i, 0);
+    // copy into nlp_mem
+    blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+}
+
+
+
+static void ocp_nlp_dynamics_fun_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int *nx = dims->nx;
+
+    // dynamics
+    ocp_nlp_dynamics_compute_fun_memo(config, dims, in, opts, mem, work, i, out->ux+i, out->ux+i+1);
+
+    struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+}
+
+
+
 // zero order update QP: Update all constraint evaluations in QP
 void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
@@ -2956,36 +3894,13 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     // int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
-    int *ni = dims->ni;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // evaluate constraint residuals
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
-        // copy ineq function value into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->qp_in->d + i, 0);
-        // copy into nlp_mem
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
-    }
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<N; i++)
-    {
-        // dynamics
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_constraints_fun_stage, &args);
 
-        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
-    }
+    ocp_nlp_parallel_for(mem, N, &ocp_nlp_dynamics_fun_stage, &args);
 
     // add gradient correction
     // rqz += Hess * last_step = RQ * qp_out
@@ -2999,81 +3914,142 @@ void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
 }
 
 
+static void ocp_nlp_level_c_cost_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int *nv = dims->nv;
+
+    // nlp mem: cost_grad
+    config->cost[i]->compute_gradient(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i], mem->cost[i], work->cost[i]);
+    ocp_nlp_memo_invalidate_stage(mem, i);
+    struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
+    blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
+    blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+}
+
+
+
+static void ocp_nlp_level_c_dynamics_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+
+    // dynamics
+    // config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+    config->dynamics[i]->compute_fun_and_adj(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                                     opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    ocp_nlp_memo_invalidate_stage(mem, i);
+
+    struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
+    blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
+
+    // add adjoint contribution to gradient
+    struct blasfeo_dvec *dyn_adj = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
+    blasfeo_dvecad(nu[i] + nx[i], -1.0, dyn_adj, 0, mem->qp_in->rqz+i, 0);
+    // add adjoint contribution C * lambda_k
+    blasfeo_dgemv_n(nu[i] + nx[i], nx[i+1], -1.0, mem->qp_in->BAbt+i, 0, 0, out->pi+i, 0, 1.0, mem->qp_in->rqz+i, 0, mem->qp_in->rqz+i, 0);
+
+    // - I part is linear, so dont need to add that!
+    // blasfeo_dvecad(nx[i+1], 1.0, out->pi+i, 0, mem->qp_in->rqz+i, 0)
+
+    // DEBUG:
+    // printf("\ndyn_adj i %d\n", i);
+    // blasfeo_print_exp_tran_dvec(nu[i] + nx[i], dyn_adj, 0);
+    // blasfeo_dgemv_n(nu[i] + nx[i], nx[i+1], 1.0, mem->qp_in->BAbt+i, 0, 0, out->pi+i, 0, 0.0, &work->tmp_nv, 0, &work->tmp_nv, 0);
+    // printf("C * lam\n");
+    // blasfeo_print_exp_tran_dvec(nu[i] + nx[i], &work->tmp_nv, 0);
+}
+
+
+
 // Level C iterations Update all constraint evaluations in QP and Lagrange gradient
 void ocp_nlp_level_c_update(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
     ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
     int N = dims->N;
+
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_constraints_fun_stage, &args);
+
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_level_c_cost_stage, &args);
+
+    ocp_nlp_parallel_for(mem, N, &ocp_nlp_level_c_dynamics_stage, &args);
+
+    // TODO:
+    // - adjoint call for inequalities as for dynamics
+}
+
+
+static void ocp_nlp_update_variables_sqp_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_out *out_start = args->out;
+    ocp_nlp_out *out_destination = args->out_destination;
+    ocp_nlp_memory *mem = args->mem;
+    double alpha = args->alpha;
+    int N = dims->N;
     int *nv = dims->nv;
     int *nx = dims->nx;
     int *nu = dims->nu;
     int *ni = dims->ni;
+    int *nz = dims->nz;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+    // step in primal variables
+    blasfeo_daxpy(nv[i], alpha, mem->qp_out->ux + i, 0, out_start->ux + i, 0, out_destination->ux + i, 0);
+
+    // update dual variables
+    if (args->full_step_dual)
     {
-        // evaluate constraint residuals
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-            in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
-        // copy ineq function value into QP
-        struct blasfeo_dvec *ineq_fun = config->constraints[i]->memory_get_fun_ptr(mem->constraints[i]);
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->qp_in->d + i, 0);
-        // copy into nlp_mem
-        blasfeo_dveccp(2 * ni[i], ineq_fun, 0, mem->ineq_fun + i, 0);
+        blasfeo_dveccp(2*ni[i], mem->qp_out->lam+i, 0, out_destination->lam+i, 0);
+        if (i < N)
+        {
+            blasfeo_dveccp(nx[i+1], mem->qp_out->pi+i, 0, out_destination->pi+i, 0);
+        }
     }
-
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<=N; i++)
+    else
     {
-        // nlp mem: cost_grad
-        config->cost[i]->compute_gradient(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i], mem->cost[i], work->cost[i]);
-        struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
-        blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
-        blasfeo_dveccp(nv[i], mem->cost_grad + i, 0, mem->qp_in->rqz + i, 0);
+        // update duals with alpha step
+        blasfeo_daxpby(2*ni[i], 1.0-alpha, out_start->lam+i, 0, alpha, mem->qp_out->lam+i, 0, out_destination->lam+i, 0);
+        // blasfeo_dvecsc(2*ni[i], 1.0-alpha, out->lam+i, 0);
+        // blasfeo_daxpy(2*ni[i], alpha, mem->qp_out->lam+i, 0, out->lam+i, 0, out->lam+i, 0);
+        if (i < N)
+        {
+            // blasfeo_dvecsc(nx[i+1], 1.0-alpha, out->pi+i, 0);
+            // blasfeo_daxpy(nx[i+1], alpha, mem->qp_out->pi+i, 0, out->pi+i, 0, out->pi+i, 0);
+            blasfeo_daxpby(nx[i+1], 1.0-alpha, out_start->pi+i, 0, alpha, mem->qp_out->pi+i, 0, out_destination->pi+i, 0);
+        }
     }
 
-
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i=0; i<N; i++)
+    // linear update of algebraic variables using state and input sensitivity
+    if (i < N)
     {
-        // dynamics
-        // config->dynamics[i]->update_qp_matrices(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-        config->dynamics[i]->compute_fun_and_adj(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-
-        struct blasfeo_dvec *dyn_fun = config->dynamics[i]->memory_get_fun_ptr(mem->dynamics[i]);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->qp_in->b + i, 0);
-        blasfeo_dveccp(nx[i + 1], dyn_fun, 0, mem->dyn_fun + i, 0);
-
-        // add adjoint contribution to gradient
-        struct blasfeo_dvec *dyn_adj = config->dynamics[i]->memory_get_adj_ptr(mem->dynamics[i]);
-        blasfeo_dvecad(nu[i] + nx[i], -1.0, dyn_adj, 0, mem->qp_in->rqz+i, 0);
-        // add adjoint contribution C * lambda_k
-        blasfeo_dgemv_n(nu[i] + nx[i], nx[i+1], -1.0, mem->qp_in->BAbt+i, 0, 0, out->pi+i, 0, 1.0, mem->qp_in->rqz+i, 0, mem->qp_in->rqz+i, 0);
-
-        // - I part is linear, so dont need to add that!
-        // blasfeo_dvecad(nx[i+1], 1.0, out->pi+i, 0, mem->qp_in->rqz+i, 0)
-
-        // DEBUG:
-        // printf("\ndyn_adj i %d\n", i);
-        // blasfeo_print_exp_tran_dvec(nu[i] + nx[i], dyn_adj, 0);
-        // blasfeo_dgemv_n(nu[i] + nx[i], nx[i+1], 1.0, mem->qp_in->BAbt+i, 0, 0, out->pi+i, 0, 0.0, &work->tmp_nv, 0, &work->tmp_nv, 0);
-        // printf("C * lam\n");
-        // blasfeo_print_exp_tran_dvec(nu[i] + nx[i], &work->tmp_nv, 0);
+        // out->z = mem->z_alg + alpha * dzdux * qp_out->ux
+        blasfeo_dgemv_t(nu[i]+nx[i], nz[i], alpha, mem->dzduxt+i, 0, 0,
+                mem->qp_out->ux+i, 0, 1.0, mem->z_alg+i, 0, out_destination->z+i, 0);
     }
-
-    // TODO:
-    // - adjoint call for inequalities as for dynamics
 }
 
 
+
 /*
 calculates new iterate or trial iterate in 'out_destination' with step 'mem->qp_out',
 step size 'alpha', and current iterate 'out_start'.
@@ -3084,57 +4060,18 @@ void ocp_nlp_update_variables_sqp(void *config_, void *dims_,
             void *solver_mem, double alpha, bool full_step_dual)
 {
     ocp_nlp_dims *dims = dims_;
-    ocp_nlp_out *out_start = out_;
     ocp_nlp_memory *mem = mem_;
-    ocp_nlp_out *out_destination = out_destination_;
     // solver_mem is not used in this function, but needed for DDP
     // the function is used in the config->globalization->step_update
     int N = dims->N;
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    int *nu = dims->nu;
-    int *ni = dims->ni;
-    int *nz = dims->nz;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // step in primal variables
-        blasfeo_daxpy(nv[i], alpha, mem->qp_out->ux + i, 0, out_start->ux + i, 0, out_destination->ux + i, 0);
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config_, dims, in_, out_, opts_, mem, work_);
+    args.out_destination = out_destination_;
+    args.alpha = alpha;
+    args.full_step_dual = full_step_dual;
 
-        // update dual variables
-        if (full_step_dual)
-        {
-            blasfeo_dveccp(2*ni[i], mem->qp_out->lam+i, 0, out_destination->lam+i, 0);
-            if (i < N)
-            {
-                blasfeo_dveccp(nx[i+1], mem->qp_out->pi+i, 0, out_destination->pi+i, 0);
-            }
-        }
-        else
-        {
-            // update duals with alpha step
-            blasfeo_daxpby(2*ni[i], 1.0-alpha, out_start->lam+i, 0, alpha, mem->qp_out->lam+i, 0, out_destination->lam+i, 0);
-            // blasfeo_dvecsc(2*ni[i], 1.0-alpha, out->lam+i, 0);
-            // blasfeo_daxpy(2*ni[i], alpha, mem->qp_out->lam+i, 0, out->lam+i, 0, out->lam+i, 0);
-            if (i < N)
-            {
-                // blasfeo_dvecsc(nx[i+1], 1.0-alpha, out->pi+i, 0);
-                // blasfeo_daxpy(nx[i+1], alpha, mem->qp_out->pi+i, 0, out->pi+i, 0, out->pi+i, 0);
-                blasfeo_daxpby(nx[i+1], 1.0-alpha, out_start->pi+i, 0, alpha, mem->qp_out->pi+i, 0, out_destination->pi+i, 0);
-            }
-        }
-
-        // linear update of algebraic variables using state and input sensitivity
-        if (i < N)
-        {
-            // out->z = mem->z_alg + alpha * dzdux * qp_out->ux
-            blasfeo_dgemv_t(nu[i]+nx[i], nz[i], alpha, mem->dzduxt+i, 0, 0,
-                    mem->qp_out->ux+i, 0, 1.0, mem->z_alg+i, 0, out_destination->z+i, 0);
-        }
-    }
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_update_variables_sqp_stage, &args);
 }
 
 void ocp_nlp_initialize_qp_from_nlp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_qp_in *qp_in,
@@ -3168,59 +4105,80 @@ double ocp_nlp_compute_anderson_gamma(ocp_nlp_workspace *work, ocp_qp_out *new_q
 }
 
 
+static void ocp_nlp_convert_primaldelta_absdual_step_to_delta_step_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_out *out = args->out;
+    ocp_qp_out *step = args->step;
+    int N = dims->N;
+    int *nx = dims->nx;
+    int *ni = dims->ni;
+
+    // for all x in delta format: convert as x_step = x_step - x_iterate
+    // dual variables
+    blasfeo_dvecad(2*ni[i], -1.0, out->lam+i, 0, step->lam+i, 0);
+    if (i < N)
+    {
+        blasfeo_dvecad(nx[i+1], -1.0, out->pi+i, 0, step->pi+i, 0);
+    }
+}
+
+
+
 void ocp_nlp_convert_primaldelta_absdual_step_to_delta_step(ocp_nlp_config *config, ocp_nlp_dims *dims,
-        ocp_nlp_out *out, ocp_qp_out *step)
+        ocp_nlp_out *out, ocp_nlp_memory *mem, ocp_qp_out *step)
+{
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, NULL, out, NULL, mem, NULL);
+    args.step = step;
+    ocp_nlp_parallel_for(mem, dims->N+1, &ocp_nlp_convert_primaldelta_absdual_step_to_delta_step_stage, &args);
+}
+
+
+static void ocp_nlp_update_variables_sqp_delta_primal_dual_stage(void *args_, int i)
 {
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_out *out = args->out;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_qp_out *step = args->step;
+    double alpha = args->alpha;
     int N = dims->N;
+    int *nv = dims->nv;
     int *nx = dims->nx;
+    int *nu = dims->nu;
     int *ni = dims->ni;
+    int *nz = dims->nz;
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
+    // step in primal variables
+    blasfeo_daxpy(nv[i], alpha, step->ux+i, 0, out->ux+i, 0, out->ux+i, 0);
+
+    blasfeo_daxpy(2*ni[i], alpha, step->lam+i, 0, out->lam+i, 0, out->lam+i, 0);
+    if (i < N)
     {
-        // for all x in delta format: convert as x_step = x_step - x_iterate
-        // dual variables
-        blasfeo_dvecad(2*ni[i], -1.0, out->lam+i, 0, step->lam+i, 0);
-        if (i < N)
-        {
-            blasfeo_dvecad(nx[i+1], -1.0, out->pi+i, 0, step->pi+i, 0);
-        }
+        // update duals with alpha step
+        blasfeo_daxpy(nx[i+1], alpha, step->pi+i, 0, out->pi+i, 0, out->pi+i, 0);
+        // linear update of algebraic variables using state and input sensitivity
+        // out->z = mem->z_alg + alpha * dzdux * qp_out->ux
+        blasfeo_dgemv_t(nu[i]+nx[i], nz[i], alpha, mem->dzduxt+i, 0, 0,
+                step->ux+i, 0, 1.0, mem->z_alg+i, 0, out->z+i, 0);
     }
 }
 
 
+
 void ocp_nlp_update_variables_sqp_delta_primal_dual(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, double alpha, ocp_qp_out *step)
 {
     int N = dims->N;
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    int *nu = dims->nu;
-    int *ni = dims->ni;
-    int *nz = dims->nz;
-
 
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (int i = 0; i <= N; i++)
-    {
-        // step in primal variables
-        blasfeo_daxpy(nv[i], alpha, step->ux+i, 0, out->ux+i, 0, out->ux+i, 0);
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, out, opts, mem, work);
+    args.alpha = alpha;
+    args.step = step;
 
-        blasfeo_daxpy(2*ni[i], alpha, step->lam+i, 0, out->lam+i, 0, out->lam+i, 0);
-        if (i < N)
-        {
-            // update duals with alpha step
-            blasfeo_daxpy(nx[i+1], alpha, step->pi+i, 0, out->pi+i, 0, out->pi+i, 0);
-            // linear update of algebraic variables using state and input sensitivity
-            // out->z = mem->z_alg + alpha * dzdux * qp_out->ux
-            blasfeo_dgemv_t(nu[i]+nx[i], nz[i], alpha, mem->dzduxt+i, 0, 0,
-                    step->ux+i, 0, 1.0, mem->z_alg+i, 0, out->z+i, 0);
-        }
-    }
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_update_variables_sqp_delta_primal_dual_stage, &args);
 }
 
 
@@ -3232,6 +4190,10 @@ int ocp_nlp_precompute_common(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nl
     int status = ACADOS_SUCCESS;
     int ii, tmp;
 
+    // submodule precompute may change the memory, discard memoized evaluations and condensed QP
+    mem->memo_in = NULL;
+    mem->qp_lhs_valid = false;
+
     for (ii = 0; ii <= N; ii++)
     {
         int module_val;
@@ -3443,103 +4405,17 @@ ocp_nlp_res *ocp_nlp_res_assign(ocp_nlp_dims *dims, void *raw_memory)
 void ocp_nlp_res_compute(ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_res *res,
                          ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
-    // extract dims
     int N = dims->N;
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    int *nu = dims->nu;
-    int *ni = dims->ni;
-
-    double tmp_res;
-    double tmp;
-    ocp_qp_dims *qp_dims = mem->qp_in->dim;
-
-    // res_stat
-    for (int i = 0; i <= N; i++)
-    {
-        blasfeo_daxpy(nv[i], -1.0, mem->ineq_adj + i, 0, mem->cost_grad + i, 0,
-                      res->res_stat + i, 0);
-        blasfeo_daxpy(nu[i] + nx[i], -1.0, mem->dyn_adj + i, 0, res->res_stat + i, 0,
-                      res->res_stat + i, 0);
-        blasfeo_dvecnrm_inf(nv[i], res->res_stat + i, 0, &tmp_res);
-        blasfeo_dvecse(1, tmp_res, &res->tmp, i);
-    }
-    blasfeo_dvecnrm_inf(N+1, &res->tmp, 0, &res->inf_norm_res_stat);
-
-    // res_eq
-    for (int i = 0; i < N; i++)
-    {
-        blasfeo_dveccp(nx[i + 1], mem->dyn_fun + i, 0, res->res_eq + i, 0);
-        blasfeo_dvecnrm_inf(nx[i + 1], res->res_eq + i, 0, &tmp_res);
-        blasfeo_dvecse(1, tmp_res, &res->tmp, i);
-    }
-    blasfeo_dvecnrm_inf(N, &res->tmp, 0, &res->inf_norm_res_eq);
 
-    // res_ineq
-    res->inf_norm_res_ineq = 0.0;
-    for (int i = 0; i <= N; i++)
-    {
-        for (int j=0; j<2*ni[i]; j++)
-        {
-            tmp = BLASFEO_DVECEL(mem->ineq_fun+i, j);
-            if (tmp > res->inf_norm_res_ineq)
-            {
-                res->inf_norm_res_ineq = tmp;
-            }
-        }
-    }
+    ocp_nlp_res_set_tau_min(dims, opts, work);
 
-    // res_comp = inf_norm(lam_i * ineq_fun_i - tau_min * ones)
-    res->inf_norm_res_comp = 0.0;
-    if (opts->tau_min != 0)
-    {
-        int ni_max = 0;
-        int ne = 0;
-        for (int i = 0; i <= N; i++)
-        {
-            ni_max = ni_max > ni[i] ? ni_max : ni[i];
-        }
-        blasfeo_dvecse(2*ni_max, opts->tau_min, &work->tmp_2ni, 0);
-        for (int i = 0; i <= N; i++)
-        {
-            if (ni[i] > 0)
-            {
-            // printf("res_comp %d\n", i);
-            // printf("ineq_fun\n");
-            // blasfeo_print_exp_tran_dvec(2*ni[i], mem->ineq_fun+i, 0);
-            // printf("lam\n");
-            // blasfeo_print_exp_tran_dvec(2*ni[i], out->lam+i, 0);
-            blasfeo_dvecmul(2 * ni[i], out->lam + i, 0, mem->ineq_fun+i, 0, res->res_comp + i, 0);
-            // printf("ineq_fun * lam\n");
-            // blasfeo_print_exp_tran_dvec(2*ni[i], res->res_comp+i, 0);
-            blasfeo_dvecad(2 * ni[i], 1.0, &work->tmp_2ni, 0, res->res_comp + i, 0);
-            // printf("res_comp: + tau_min = %e\n", opts->tau_min);
-            // blasfeo_print_exp_tran_dvec(2*ni[i], res->res_comp+i, 0);
+    // the stage residuals only depend on the evaluations already collected in mem
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, NULL, dims, in, out, opts, mem, work);
+    args.res = res;
+    ocp_nlp_parallel_for(mem, N+1, &ocp_nlp_res_compute_stage, &args);
 
-            // zero out complementarities corresponding to equalities
-            ne = qp_dims->nbue[i] + qp_dims->nbxe[i] + qp_dims->nge[i];
-            for (int j = 0; j < ne; j++)
-            {
-                BLASFEO_DVECEL(res->res_comp+i, mem->qp_in->idxe[i][j]) = 0.0;
-                BLASFEO_DVECEL(res->res_comp+i, mem->qp_in->idxe[i][j]+ni[i]) = 0.0;
-            }
-            // printf("res_comp: after zeroing equalities = %e\n", opts->tau_min);
-            // blasfeo_print_exp_tran_dvec(2*ni[i], res->res_comp+i, 0);
-            blasfeo_dvecnrm_inf(2 * ni[i], res->res_comp + i, 0, &tmp_res);
-            blasfeo_dvecse(1, tmp_res, &res->tmp, i);
-            }
-        }
-    }
-    else
-    {
-        for (int i = 0; i <= N; i++)
-        {
-            blasfeo_dvecmul(2 * ni[i], out->lam + i, 0, mem->ineq_fun+i, 0, res->res_comp + i, 0);
-            blasfeo_dvecnrm_inf(2 * ni[i], res->res_comp + i, 0, &tmp_res);
-            blasfeo_dvecse(1, tmp_res, &res->tmp, i);
-        }
-    }
-    blasfeo_dvecnrm_inf(N+1, &res->tmp, 0, &res->inf_norm_res_comp);
+    ocp_nlp_res_reduce_stage_norms(dims, work, res);
 }
 
 void ocp_nlp_res_get_inf_norm(ocp_nlp_res *res, double *out)
@@ -3645,6 +4521,8 @@ void ocp_nlp_cost_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in
 
         config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i],
                     opts->cost[i], mem->cost[i], work->cost[i]);
+        // can be called between solver calls, after changes in ocp_nlp_in
+        ocp_nlp_memo_invalidate_stage(mem, i);
         tmp_cost = config->cost[i]->memory_get_fun_ptr(mem->cost[i]);
         // printf("cost at stage %d = %e, total = %e\n", i, *tmp_cost, total_cost);
         total_cost += *tmp_cost;
@@ -3730,6 +4608,45 @@ int ocp_nlp_common_setup_qp_matrices_and_factorize(ocp_nlp_config *config, ocp_n
 }
 
 
+static void ocp_nlp_params_jac_compute_stage(void *args_, int i)
+{
+    ocp_nlp_stage_loop_args *args = args_;
+    ocp_nlp_config *config = args->config;
+    ocp_nlp_dims *dims = args->dims;
+    ocp_nlp_in *in = args->in;
+    ocp_nlp_opts *opts = args->opts;
+    ocp_nlp_memory *mem = args->mem;
+    ocp_nlp_workspace *work = args->work;
+    int N = dims->N;
+    int np_global = dims->np_global;
+    int *nv = dims->nv;
+    int *nx = dims->nx;
+    int *nu = dims->nu;
+    int *ns = dims->ns;
+
+    struct blasfeo_dmat *jac_lag_stat_p_global = mem->jac_lag_stat_p_global;
+
+    if (i < N)
+    {
+        // first nx+nu rows are overwritten by dynamics -> initialize ns part
+        blasfeo_dgese(2*ns[i], np_global, 0., &jac_lag_stat_p_global[i], nx[i]+nu[i], 0);
+        config->dynamics[i]->compute_jac_hess_p(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
+                    opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+    }
+    else
+    {
+        // initialize jac_lag_stat_p_global = 0 as dynamics dont contribute
+        blasfeo_dgese(nv[i], np_global, 0., &jac_lag_stat_p_global[i], 0, 0);
+    }
+    config->cost[i]->compute_jac_p(config->cost[i], dims->cost[i], in->cost[i],
+                        opts->cost[i], mem->cost[i], work->cost[i]);
+    config->constraints[i]->compute_jac_hess_p(config->constraints[i], dims->constraints[i],
+                in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
+    ocp_nlp_memo_invalidate_stage(mem, i);
+}
+
+
+
 void ocp_nlp_params_jac_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work)
 {
     // This function sets up: jac_lag_stat_p_global, jac_ineq_p_global, jac_dyn_p_global
@@ -3743,41 +4660,9 @@ void ocp_nlp_params_jac_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_
         exit(1);
     }
 
-    int N = dims->N;
-    int np_global = dims->np_global;
-    int i;
-
-    int *nv = dims->nv;
-    int *nx = dims->nx;
-    int *nu = dims->nu;
-    int *ns = dims->ns;
-
-    struct blasfeo_dmat *jac_lag_stat_p_global = mem->jac_lag_stat_p_global;
-    // struct blasfeo_dmat *jac_ineq_p_global = mem->jac_ineq_p_global;
-    // struct blasfeo_dmat *jac_dyn_p_global = mem->jac_dyn_p_global;
-
-#if defined(ACADOS_WITH_OPENMP)
-    #pragma omp parallel for
-#endif
-    for (i = 0; i <= N; i++)
-    {
-        if (i < N)
-        {
-            // first nx+nu rows are overwritten by dynamics -> initialize ns part
-            blasfeo_dgese(2*ns[i], np_global, 0., &jac_lag_stat_p_global[i], nx[i]+nu[i], 0);
-            config->dynamics[i]->compute_jac_hess_p(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                        opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
-        }
-        else
-        {
-            // initialize jac_lag_stat_p_global = 0 as dynamics dont contribute
-            blasfeo_dgese(nv[i], np_global, 0., &jac_lag_stat_p_global[i], 0, 0);
-        }
-        config->cost[i]->compute_jac_p(config->cost[i], dims->cost[i], in->cost[i],
-                            opts->cost[i], mem->cost[i], work->cost[i]);
-        config->constraints[i]->compute_jac_hess_p(config->constraints[i], dims->constraints[i],
-                    in->constraints[i], opts->constraints[i], mem->constraints[i], work->constraints[i]);
-    }
+    ocp_nlp_stage_loop_args args;
+    ocp_nlp_stage_loop_args_init(&args, config, dims, in, NULL, opts, mem, work);
+    ocp_nlp_parallel_for(mem, dims->N+1, &ocp_nlp_params_jac_compute_stage, &args);
 }
 
 
@@ -3955,12 +4840,14 @@ void ocp_nlp_common_eval_lagr_grad_p(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                     mem->constraints[i], work->constraints[i], &work->tmp_np_global);
 
             blasfeo_dvecad(np_global, 1., &work->tmp_np_global, 0, &mem->out_np_global, 0);
+            ocp_nlp_memo_invalidate_stage(mem, i);
         }
 
         // terminal cost contribution
         config->cost[N]->eval_grad_p(config->cost[N], dims->cost[N], in->cost[N], opts->cost[N],
                                     mem->cost[N], work->cost[N], &work->tmp_np_global);
         blasfeo_dvecad(np_global, 1., &work->tmp_np_global, 0, &mem->out_np_global, 0);
+        ocp_nlp_memo_invalidate_stage(mem, N);
 
         blasfeo_unpack_dvec(np_global, &mem->out_np_global, 0, grad_p, 1);
     }
@@ -3972,6 +4859,21 @@ void ocp_nlp_common_eval_lagr_grad_p(ocp_nlp_config *config, ocp_nlp_dims *dims,
 }
 
 
+bool ocp_nlp_qp_lhs_unchanged(ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_memory *mem)
+{
+    if (!mem->qp_lhs_valid || opts->levenberg_marquardt != mem->qp_lhs_levenberg_marquardt)
+        return false;
+
+    for (int i = 0; i <= dims->N; i++)
+    {
+        if (mem->qp_lhs_changed[i])
+            return false;
+    }
+    return true;
+}
+
+
+
 int ocp_nlp_solve_qp_and_correct_dual(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *nlp_opts,
                      ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work,
                      bool precondensed_lhs, ocp_qp_in *qp_in_, ocp_qp_out *qp_out_,
@@ -4030,6 +4932,22 @@ int ocp_nlp_solve_qp_and_correct_dual(ocp_nlp_config *config, ocp_nlp_dims *dims
     double tmp_time;
     int qp_status;
 
+    // limit QP iterations such that the solve and one globalization trial fit before the deadline,
+    // only for the QP solver whose iteration limit is stored in nlp_opts->qp_iter_max;
+    // the cap is passed through the qp memory, the qp options may be shared and are not modified
+    nlp_mem->deadline_qp_iter_max = 0;
+    if (nlp_opts->deadline > 0 && xcond_solver == NULL && nlp_opts->qp_iter_max > 0 && nlp_timings->est_time_qp_iter > 0)
+    {
+        double qp_budget = ocp_nlp_deadline_remaining(nlp_opts) / nlp_opts->deadline_safety_factor
+                           - nlp_timings->est_time_glob_trial;
+        double affordable_iter = qp_budget / nlp_timings->est_time_qp_iter - 1.0;
+        if (affordable_iter < nlp_opts->qp_iter_max)
+        {
+            nlp_mem->deadline_qp_iter_max = affordable_iter < 1.0 ? 1 : (int) affordable_iter;
+        }
+    }
+    qp_solver->memory_set(qp_solver, qp_mem, "iter_max_cap", &nlp_mem->deadline_qp_iter_max);
+
     // solve qp
     acados_tic(&timer);
     if (precondensed_lhs)
@@ -4043,13 +4961,50 @@ int ocp_nlp_solve_qp_and_correct_dual(ocp_nlp_config *config, ocp_nlp_dims *dims
                 qp_in, qp_out, qp_opts, qp_mem, qp_work);
     }
     // add qp timings
-    nlp_timings->time_qp_sol += acados_toc(&timer);
+    tmp_time = acados_toc(&timer);
+    nlp_timings->time_qp_sol += tmp_time;
+
+    // other qp solves on this memory are not capped
+    if (nlp_mem->deadline_qp_iter_max > 0)
+    {
+        int no_cap = 0;
+        qp_solver->memory_set(qp_solver, qp_mem, "iter_max_cap", &no_cap);
+    }
+
+    // update per iteration estimate
+    qp_info *qp_info_;
+    ocp_qp_out_get(qp_out, "qp_info", &qp_info_);
+    ocp_nlp_timings_update_estimate(&nlp_timings->est_time_qp_iter, tmp_time / (qp_info_->num_iter + 1));
     // NOTE: timings within qp solver are added internally (lhs+rhs)
     qp_solver->memory_get(qp_solver, qp_mem, "time_qp_solver_call", &tmp_time);
     nlp_timings->time_qp_solver_call += tmp_time;
     qp_solver->memory_get(qp_solver, qp_mem, "time_qp_xcond", &tmp_time);
     nlp_timings->time_qp_xcond += tmp_time;
 
+    // the qp solver memory now holds the condensed matrices of qp_in, see ocp_nlp_qp_lhs_unchanged
+    if (xcond_solver == NULL)
+    {
+        nlp_mem->qp_lhs_valid = qp_in_ == NULL;
+        nlp_mem->qp_lhs_levenberg_marquardt = nlp_opts->levenberg_marquardt;
+        for (int i = 0; i <= dims->N; i++)
+            nlp_mem->qp_lhs_changed[i] = false;
+    }
+
+    // record the (regularized) QP as passed to the solver and its solution, before dual correction
+    if (nlp_mem->qp_recorder != NULL && xcond_solver == NULL)
+    {
+        // a failed write (e.g. disk full) stops the recording, the solve itself is not affected
+        if (ocp_qp_recorder_write_in(nlp_mem->qp_recorder, qp_in, nlp_mem->iter, qp_status)
+            || ocp_qp_recorder_write_out(nlp_mem->qp_recorder, qp_out, nlp_mem->iter, qp_status))
+        {
+            printf("\nwarning: ocp_nlp: writing the QP recording failed in iteration %d, recording stopped.\n",
+                   nlp_mem->iter);
+            ocp_qp_recorder_close(nlp_mem->qp_recorder);
+            nlp_mem->qp_recorder = NULL;
+            nlp_mem->qp_record_failed = 1;
+        }
+    }
+
     // compute correct dual solution in case of Hessian regularization
     acados_tic(&timer);
     config->regularize->correct_dual_sol(config->regularize, dims->regularize,
@@ -4202,6 +5157,22 @@ void ocp_nlp_timings_get(ocp_nlp_config *config, ocp_nlp_timings *timings, const
     {
         *value = timings->time_preparation;
     }
+    else if (!strcmp("time_lin_dyn_stage", field) || !strcmp("time_lin_cost_stage", field)
+             || !strcmp("time_lin_constr_stage", field))
+    {
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+        double *stage_time = timings->time_lin_constr_stage;
+        if (!strcmp("time_lin_dyn_stage", field))
+            stage_time = timings->time_lin_dyn_stage;
+        else if (!strcmp("time_lin_cost_stage", field))
+            stage_time = timings->time_lin_cost_stage;
+        for (int i = 0; i <= timings->N; i++)
+            value[i] = stage_time[i];
+#else
+        printf("\nerror: field %s in ocp_nlp_timings_get requires acados built with ACADOS_WITH_STAGE_TIMINGS\n", field);
+        exit(1);
+#endif
+    }
     else if (!strcmp("time_feedback", field))
     {
         if (config->is_real_time_algorithm())
@@ -4318,6 +5289,35 @@ void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const c
             }
         }
     }
+    else if (!strcmp("fill_avoided", field))
+    {
+        int *value = return_value_;
+        for (int ii=0; ii<=config->N; ii++)
+        {
+            value[ii] = nlp_mem->fill_avoided[ii];
+        }
+    }
+    else if (!strcmp("qp_lhs_reused", field))
+    {
+        int *value = return_value_;
+        *value = nlp_mem->num_qp_lhs_reused;
+    }
+    else if (!strcmp("memo_evals", field) || !strcmp("memo_hits", field))
+    {
+        // summed over the stages: dynamics, cost, constraints, QP approximation
+        int *value = return_value_;
+        bool hits = !strcmp("memo_hits", field);
+        for (int k = 0; k < OCP_NLP_MEMO_NUM; k++)
+        {
+            value[k] = 0;
+            if (nlp_mem->memo == NULL)
+                continue;
+            for (int ii=0; ii<=config->N; ii++)
+            {
+                value[k] += hits ? nlp_mem->memo[ii].num_hit[k] : nlp_mem->memo[ii].num_eval[k];
+            }
+        }
+    }
     else if (!strcmp("dual_step_norm", field))
     {
         if (nlp_mem->dual_step_norm == NULL)
@@ -4342,6 +5342,40 @@ void ocp_nlp_memory_get(ocp_nlp_config *config, ocp_nlp_memory *nlp_mem, const c
 }
 
 
+void ocp_nlp_timings_update_estimate(double *estimate, double time)
+{
+    // follow slower phases immediately, faster ones with the weighting of the AVERAGE timeout heuristic
+    *estimate = time > *estimate ? time : 0.5*time + 0.5*(*estimate);
+}
+
+
+
+double ocp_nlp_deadline_remaining(ocp_nlp_opts *opts)
+{
+    if (opts->deadline <= 0)
+        return ACADOS_INFTY;
+    return opts->deadline - acados_time_now();
+}
+
+
+
+bool ocp_nlp_deadline_fits(ocp_nlp_opts *opts, double predicted_time)
+{
+    if (opts->deadline <= 0)
+        return true;
+    return opts->deadline_safety_factor * predicted_time <= ocp_nlp_deadline_remaining(opts);
+}
+
+
+
+double ocp_nlp_deadline_predict_iteration(ocp_nlp_timings *timings)
+{
+    // linearization, a QP solve with a single iteration and one globalization trial
+    return timings->est_time_lin + 2*timings->est_time_qp_iter + timings->est_time_glob_trial;
+}
+
+
+
 void ocp_nlp_timings_reset(ocp_nlp_timings *timings)
 {
     timings->time_qp_sol = 0.0;
@@ -4353,4 +5387,206 @@ void ocp_nlp_timings_reset(ocp_nlp_timings *timings)
     timings->time_sim = 0.0;
     timings->time_sim_la = 0.0;
     timings->time_sim_ad = 0.0;
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    for (int i = 0; i <= timings->N; i++)
+    {
+        timings->time_lin_dyn_stage[i] = 0.0;
+        timings->time_lin_cost_stage[i] = 0.0;
+        timings->time_lin_constr_stage[i] = 0.0;
+    }
+#endif
+}
+
+
+
+/************************************************
+ * memory report
+ ************************************************/
+
+void ocp_nlp_memory_report_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                 ocp_nlp_in *in, int stage, acados_size_t *sizes)
+{
+    ocp_nlp_opts *opts;
+    config->opts_get(config, dims, opts_, "nlp_opts", &opts);
+
+    int i = stage;
+    int N = dims->N;
+
+    for (int k = 0; k < 7; k++)
+        sizes[k] = 0;
+
+    if (i < N)
+    {
+        ocp_nlp_dynamics_config *dynamics = config->dynamics[i];
+        sizes[0] = dynamics->memory_calculate_size(dynamics, dims->dynamics[i], opts->dynamics[i]);
+        sizes[1] = dynamics->workspace_calculate_size(dynamics, dims->dynamics[i], opts->dynamics[i]);
+        sizes[6] += dynamics->get_external_fun_workspace_requirement(dynamics, dims->dynamics[i],
+                                                        opts->dynamics[i], in->dynamics[i]);
+    }
+
+    ocp_nlp_cost_config *cost = config->cost[i];
+    sizes[2] = cost->memory_calculate_size(cost, dims->cost[i], opts->cost[i]);
+    sizes[3] = cost->workspace_calculate_size(cost, dims->cost[i], opts->cost[i]);
+    sizes[6] += cost->get_external_fun_workspace_requirement(cost, dims->cost[i], opts->cost[i], in->cost[i]);
+
+    ocp_nlp_constraints_config *constraints = config->constraints[i];
+    sizes[4] = constraints->memory_calculate_size(constraints, dims->constraints[i], opts->constraints[i]);
+    sizes[5] = constraints->workspace_calculate_size(constraints, dims->constraints[i], opts->constraints[i]);
+    sizes[6] += constraints->get_external_fun_workspace_requirement(constraints, dims->constraints[i],
+                                                        opts->constraints[i], in->constraints[i]);
+}
+
+
+
+void ocp_nlp_memory_report_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                   ocp_nlp_in *in, ocp_nlp_memory *nlp_mem, ocp_nlp_memory_report *report)
+{
+    ocp_nlp_opts *opts;
+    config->opts_get(config, dims, opts_, "nlp_opts", &opts);
+
+    ocp_qp_xcond_solver_config *xcond_solver = config->qp_solver;
+    ocp_qp_xcond_solver_dims *xcond_solver_dims = dims->qp_solver;
+    ocp_qp_xcond_solver_opts *xcond_solver_opts = opts->qp_solver_opts;
+    ocp_qp_xcond_config *xcond = xcond_solver->xcond;
+    qp_solver_config *qp_solver = xcond_solver->qp_solver;
+
+    int N = dims->N;
+
+    report->memory = config->memory_calculate_size(config, dims, opts_, in);
+    report->workspace = config->workspace_calculate_size(config, dims, opts_, in);
+
+    // original QP
+    ocp_qp_dims *qp_dims = xcond_solver_dims->orig_dims;
+    report->qp_in_out = ocp_qp_in_calculate_size(qp_dims);
+    report->qp_in_out += ocp_qp_out_calculate_size(qp_dims);
+    if (opts->with_anderson_acceleration)
+        report->qp_in_out += 2*ocp_qp_out_calculate_size(qp_dims);
+    report->qp_in_out += ocp_qp_out_calculate_size(qp_dims);  // tmp_qp_out
+    report->qp_in_out += ocp_qp_seed_calculate_size(qp_dims);  // qp_seed
+    if (opts->ext_qp_res)
+    {
+        report->qp_in_out += ocp_qp_res_calculate_size(qp_dims);
+        report->qp_in_out += ocp_qp_res_workspace_calculate_size(qp_dims);
+    }
+
+    // condensing and QP solver, as in ocp_qp_xcond_solver_memory_calculate_size
+    void *xcond_qp_dims;
+    xcond->dims_get(xcond, xcond_solver_dims->xcond_dims, "xcond_dims", &xcond_qp_dims);
+    report->xcond_memory = sizeof(ocp_qp_xcond_solver_memory)
+        + xcond->memory_calculate_size(xcond_solver_dims->xcond_dims, xcond_solver_opts->xcond_opts);
+    report->xcond_workspace = sizeof(ocp_qp_xcond_solver_workspace)
+        + xcond->workspace_calculate_size(xcond_solver_dims->xcond_dims, xcond_solver_opts->xcond_opts);
+    report->qp_solver_memory = qp_solver->memory_calculate_size(qp_solver, xcond_qp_dims,
+        xcond_solver_opts->qp_solver_opts);
+    report->qp_solver_workspace = qp_solver->workspace_calculate_size(qp_solver, xcond_qp_dims,
+        xcond_solver_opts->qp_solver_opts);
+
+    report->regularize_memory = config->regularize->memory_calculate_size(config->regularize,
+        dims->regularize, opts->regularize);
+    report->globalization_memory = config->globalization->memory_calculate_size(config->globalization, dims);
+
+    // stages
+    acados_size_t sizes[7];
+    acados_size_t module_workspace_max = report->qp_solver_workspace + report->xcond_workspace;
+    acados_size_t ext_fun_workspace_max = 0;
+    report->dynamics_memory = 0;
+    report->dynamics_workspace = 0;
+    report->cost_memory = 0;
+    report->cost_workspace = 0;
+    report->constraints_memory = 0;
+    report->constraints_workspace = 0;
+    report->ext_fun_workspace = 0;
+    for (int i = 0; i <= N; i++)
+    {
+        ocp_nlp_memory_report_stage(config, dims, opts_, in, i, sizes);
+        report->dynamics_memory += sizes[0] + (i < N ? sizeof(void *) : 0);
+        report->dynamics_workspace += sizes[1];
+        report->cost_memory += sizes[2] + sizeof(void *);
+        report->cost_workspace += sizes[3];
+        report->constraints_memory += sizes[4] + sizeof(void *);
+        report->constraints_workspace += sizes[5];
+        report->ext_fun_workspace += sizes[6];
+        for (int k = 1; k < 6; k += 2)
+            module_workspace_max = sizes[k] > module_workspace_max ? sizes[k] : module_workspace_max;
+        ext_fun_workspace_max = sizes[6] > ext_fun_workspace_max ? sizes[6] : ext_fun_workspace_max;
+    }
+
+    // as in ocp_nlp_workspace_calculate_size
+    report->module_workspace_reserved = report->xcond_workspace + report->qp_solver_workspace
+        + report->dynamics_workspace + report->cost_workspace + report->constraints_workspace;
+    report->ext_fun_workspace_reserved = report->ext_fun_workspace;
+#if !(defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL))
+    if (opts->reuse_workspace)
+    {
+        report->module_workspace_reserved = module_workspace_max;
+        report->ext_fun_workspace_reserved = ext_fun_workspace_max;
+    }
+#endif
+
+    report->iterates = 0;
+    if (opts->store_iterates)
+    {
+        report->iterates = (opts->max_iter + 1) *
+            (sizeof(struct ocp_nlp_out *) + ocp_nlp_out_calculate_size(config, dims));
+    }
+
+    // the unused part of the alignment reserves in the calculate_size functions counts as other
+    report->alignment = nlp_mem->alignment_padding + nlp_mem->workspace_alignment_padding;
+
+    acados_size_t accounted = report->qp_in_out + report->xcond_memory + report->qp_solver_memory
+        + report->regularize_memory + report->globalization_memory + report->dynamics_memory
+        + report->cost_memory + report->constraints_memory + report->iterates
+        + report->module_workspace_reserved + report->ext_fun_workspace_reserved + report->alignment;
+    acados_size_t total = report->memory + report->workspace;
+    report->other = total > accounted ? total - accounted : 0;
+}
+
+
+
+static void print_size_line(const char *name, acados_size_t memory, acados_size_t workspace)
+{
+    printf("  %-22s %12zu %12zu\n", name, (size_t) memory, (size_t) workspace);
+}
+
+
+
+void ocp_nlp_memory_report_print(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                 ocp_nlp_in *in, ocp_nlp_memory *nlp_mem, int print_stages)
+{
+    ocp_nlp_memory_report report;
+    ocp_nlp_memory_report_compute(config, dims, opts_, in, nlp_mem, &report);
+
+    printf("\nocp_nlp memory report (bytes)\n");
+    printf("  %-22s %12s %12s\n", "module", "memory", "workspace");
+    print_size_line("qp in/out", report.qp_in_out, 0);
+    print_size_line("condensing", report.xcond_memory, report.xcond_workspace);
+    print_size_line("qp solver", report.qp_solver_memory, report.qp_solver_workspace);
+    print_size_line("regularization", report.regularize_memory, 0);
+    print_size_line("globalization", report.globalization_memory, 0);
+    print_size_line("dynamics", report.dynamics_memory, report.dynamics_workspace);
+    print_size_line("cost", report.cost_memory, report.cost_workspace);
+    print_size_line("constraints", report.constraints_memory, report.constraints_workspace);
+    print_size_line("external functions", 0, report.ext_fun_workspace);
+    print_size_line("iterates", report.iterates, 0);
+    print_size_line("alignment", report.alignment, 0);
+    print_size_line("other", report.other, 0);
+    printf("  module workspace reserved %zu, external function workspace reserved %zu\n",
+        (size_t) report.module_workspace_reserved, (size_t) report.ext_fun_workspace_reserved);
+    printf("  total: memory %zu, workspace %zu\n", (size_t) report.memory, (size_t) report.workspace);
+
+    if (print_stages)
+    {
+        acados_size_t sizes[7];
+        printf("\n  %5s %10s %10s %10s %10s %10s %10s %10s\n", "stage", "dyn_mem", "dyn_work",
+            "cost_mem", "cost_work", "cons_mem", "cons_work", "ext_fun");
+        for (int i = 0; i <= dims->N; i++)
+        {
+            ocp_nlp_memory_report_stage(config, dims, opts_, in, i, sizes);
+            printf("  %5d %10zu %10zu %10zu %10zu %10zu %10zu %10zu\n", i, (size_t) sizes[0],
+                (size_t) sizes[1], (size_t) sizes[2], (size_t) sizes[3], (size_t) sizes[4],
+                (size_t) sizes[5], (size_t) sizes[6]);
+        }
+    }
+    printf("\n");
 }
+
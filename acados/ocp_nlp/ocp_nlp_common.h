@@ -60,9 +60,12 @@ extern "C" {
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/ocp_nlp/ocp_nlp_globalization_common.h"
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/ocp_qp/ocp_qp_record.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
 #include "acados/sim/sim_common.h"
 #include "acados/utils/external_function_generic.h"
+#include "acados/utils/mem.h"
+#include "acados/utils/thread_pool.h"
 #include "acados/utils/types.h"
 
 
@@ -111,6 +114,8 @@ typedef struct ocp_nlp_config
     void (*work_get)(void *config_, void *dims, void *work_, const char *field, void *return_value_);
     //
     void (*terminate)(void *config, void *mem, void *work);
+    // wait for background work of the solver started by the previous call, can be NULL
+    void (*wait_async)(void *config, void *mem);
 
     bool (*is_real_time_algorithm)();
 
@@ -124,6 +129,9 @@ typedef struct ocp_nlp_config
     ocp_nlp_reg_config *regularize;
     ocp_nlp_globalization_config *globalization;
 
+    // if not NULL, objects created with this config are placed in the arena
+    acados_arena *arena;
+
 } ocp_nlp_config;
 
 //
@@ -249,6 +257,15 @@ typedef struct ocp_nlp_in
     /// Constraint mask
     struct blasfeo_dvec *dmask;
 
+    /// Per stage counters of changes to the stage data, to its bounds only and to the cost
+    /// vectors only, see ocp_nlp_in_stage_changed and ocp_nlp_in_cost_vectors_changed.
+    int *num_changes;
+    int *num_bound_changes;
+    int *num_cost_vector_changes;
+
+    /// Asynchronous task that reads this struct, NULL if none; see ocp_nlp_in_wait_async.
+    acados_async_task *async_task;
+
     /// Pointers to cost functions (TBC).
     void **cost;
 
@@ -267,6 +284,17 @@ typedef struct ocp_nlp_in
 acados_size_t ocp_nlp_in_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims);
 //
 ocp_nlp_in *ocp_nlp_in_assign(ocp_nlp_config *config, ocp_nlp_dims *dims, void *raw_memory);
+// marks the data of a stage as changed, all stages for stage = -1; bounds_only if only bounds or
+// the constraint mask changed. The setters of the C interface call this, as does ocp_nlp_in_get of
+// "parameter_pointer"; it is only needed after writing to ocp_nlp_in directly, e.g. to global_data,
+// or through a parameter pointer obtained before the last solver call.
+void ocp_nlp_in_stage_changed(ocp_nlp_dims *dims, ocp_nlp_in *in, int stage, bool bounds_only);
+// marks the cost reference or the linear slack penalties of a stage as changed, all stages for
+// stage = -1; they only enter the cost gradient, unless the cost module reports "ref_enters_hess"
+void ocp_nlp_in_cost_vectors_changed(ocp_nlp_dims *dims, ocp_nlp_in *in, int stage);
+// waits for the asynchronous task reading in, if any, e.g. the preparation phase with rti_async_preparation;
+// the setters of the C interface call this before modifying in
+void ocp_nlp_in_wait_async(ocp_nlp_in *in);
 
 
 /************************************************
@@ -284,6 +312,8 @@ typedef struct ocp_nlp_out
     // [ lbu lbx lg lh lphi ubu ubx ug uh uphi; lsbu lsbx lsg lsh lsphi usbu usbx usg ush usphi]
     double inf_norm_res;
 
+    acados_async_task *async_task; // asynchronous task that reads this struct, NULL if none
+
     void *raw_memory; // Pointer to allocated memory, to be used for freeing
 
 } ocp_nlp_out;
@@ -293,6 +323,8 @@ acados_size_t ocp_nlp_out_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *d
 //
 ocp_nlp_out *ocp_nlp_out_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
                                 void *raw_memory);
+// waits for the asynchronous task reading out, if any, see ocp_nlp_in_wait_async
+void ocp_nlp_out_wait_async(ocp_nlp_out *out);
 
 
 
@@ -310,6 +342,7 @@ typedef struct ocp_nlp_opts
     double levenberg_marquardt;  // LM factor to be added to the hessian before regularization
     int reuse_workspace;
     int num_threads;
+    int pin_threads; // pin the workers of the thread pool to cores, off by default, see acados_thread_pool_create
     int print_level;
     int fixed_hess;
     int log_primal_step_norm; // compute and log the max norm of the primal steps
@@ -335,6 +368,16 @@ typedef struct ocp_nlp_opts
 
     bool with_anderson_acceleration;
 
+    int fuse_stage_evaluations; // linearize, fill QP and compute residuals in a single pass over the stages (SQP)
+    int with_memoization; // reuse stage evaluations if the stage is evaluated again at the same point,
+                          // also required to reuse the condensed QP matrices (SQP), see ocp_nlp_qp_lhs_unchanged
+    int num_changes; // incremented by opts_set, memoized evaluations are discarded after option changes
+    int autotune_qp; // number of timed qp solves per candidate partial condensing horizon at precompute, 0 -> off
+
+    double deadline; // absolute time (acados_time_now) by which the solver has to return, 0 -> no deadline;
+                     // QP iterations are capped for the qp solvers with an iter_max_cap memory field (HPIPM, qpOASES)
+    double deadline_safety_factor; // predicted phase times are scaled by this factor before comparing to the remaining time
+
 } ocp_nlp_opts;
 
 //
@@ -397,14 +440,53 @@ typedef struct ocp_nlp_timings
     double time_solution_sensitivities;
     double time_feedback;
     double time_preparation;
+    // running per-phase estimates used to meet opts->deadline, not reset either
+    double est_time_lin;  // linearization
+    double est_time_qp_iter;  // QP solver iteration, fixed cost of the QP solve spread as one extra iteration
+    double est_time_glob_trial;  // evaluation of one globalization trial point
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    // per shooting node linearization timings, accumulated over one solver call
+    int N;
+    double *time_lin_dyn_stage;
+    double *time_lin_cost_stage;
+    double *time_lin_constr_stage;
+#endif
 } ocp_nlp_timings;
 
 
 void ocp_nlp_timings_get(ocp_nlp_config *config, ocp_nlp_timings *timings, const char *field, void *return_value_);
+// update a running phase time estimate with a new measurement
+void ocp_nlp_timings_update_estimate(double *estimate, double time);
 
 void ocp_nlp_timings_reset(ocp_nlp_timings *timings);
 
 
+/************************************************
+ * memoization
+ ************************************************/
+
+typedef enum
+{
+    OCP_NLP_MEMO_DYN = 0,
+    OCP_NLP_MEMO_COST,
+    OCP_NLP_MEMO_CONSTR,
+    OCP_NLP_MEMO_QP,
+    OCP_NLP_MEMO_NUM,
+} ocp_nlp_memo_entry;
+
+// last evaluation of one stage, see opts->with_memoization
+typedef struct
+{
+    double *key[OCP_NLP_MEMO_NUM];  // evaluation point of the last compute_fun calls and QP approximation
+    double *fun[OCP_NLP_MEMO_QP];   // function values of dynamics, cost, constraints at key
+    int valid[OCP_NLP_MEMO_NUM];    // key holds an evaluation point, for the QP: 1 + compute_hess used
+    int num_eval[OCP_NLP_MEMO_NUM];
+    int num_hit[OCP_NLP_MEMO_NUM];
+    bool enabled;                   // false for stages with algebraic states or integrated cost
+    struct blasfeo_dmat RSQrq;      // Hessian block after the last QP approximation
+} ocp_nlp_memo;
+
+
 /************************************************
  * memory
  ************************************************/
@@ -461,6 +543,7 @@ typedef struct ocp_nlp_memory
 
     int status;
     int iter;
+    int deadline_qp_iter_max; // QP iteration limit imposed by opts->deadline in the last QP solve, 0 -> not limited
 
     double adaptive_levenberg_marquardt_mu;
     double adaptive_levenberg_marquardt_mu_bar;
@@ -468,10 +551,30 @@ typedef struct ocp_nlp_memory
     bool *set_sim_guess; // indicate if there is new explicitly provided guess for integration variables
     double *primal_step_norm;
     double *dual_step_norm;
+    int *fill_avoided; // structurally zero entries skipped in QP assembly, per stage
+    ocp_nlp_memo *memo; // per stage, NULL unless opts->with_memoization
+    ocp_nlp_in *memo_in; // ocp_nlp_in of the last call, memo entries are kept for its unchanged stages
+    int *memo_in_changes; // memo_in->num_changes at the last call, per stage
+    int *memo_in_bound_changes; // memo_in->num_bound_changes at the last call, per stage
+    int *memo_in_cost_vector_changes; // memo_in->num_cost_vector_changes at the last call, per stage
+    bool *cost_vectors_changed; // per stage, a memo hit of the QP entry has to update the cost gradient
+    int memo_opts_changes; // opts->num_changes at the last call
+    bool *qp_lhs_changed; // per stage, QP matrices possibly differ from the ones of the last QP solve
+    bool qp_lhs_valid; // the qp solver memory holds the condensed matrices of the last QP solve
+    double qp_lhs_levenberg_marquardt; // Levenberg-Marquardt term in the last QP solve
+    int num_qp_lhs_reused; // QP solves of the current call that reused the condensed matrices
 
     struct blasfeo_dvec *sim_guess;
     acados_size_t workspace_size;
 
+    acados_thread_pool *thread_pool; // solver-owned worker pool for stage loops, NULL -> OpenMP / serial
+    void *autotune_qp_mem; // qp solver memory and workspace picked by the qp autotuner, owned by the C interface
+    ocp_qp_recorder *qp_recorder; // records every QP solved by the NLP solver, NULL -> not recording
+    int qp_record_failed; // set if a write failed and the recording was stopped
+
+    acados_size_t alignment_padding; // bytes skipped by the alignments in ocp_nlp_memory_assign
+    acados_size_t workspace_alignment_padding; // same for the last ocp_nlp_workspace_assign, 0 before
+
 } ocp_nlp_memory;
 
 //
@@ -515,6 +618,8 @@ typedef struct ocp_nlp_workspace
     struct blasfeo_dvec tmp_np_global;
     // AS-RTI
     double *tmp_nv_double;
+    // fused stage evaluation: stage-wise inf norms of residuals, 4*(N+1)
+    double *tmp_stage_res;
 
     int *tmp_nins;
 
@@ -528,6 +633,52 @@ ocp_nlp_workspace *ocp_nlp_workspace_assign(ocp_nlp_config *config, ocp_nlp_dims
 
 
 
+/************************************************
+ * memory report
+ ************************************************/
+
+// bytes of solver memory and workspace by module, computed with the *_calculate_size functions
+typedef struct
+{
+    acados_size_t memory;     // total solver memory
+    acados_size_t workspace;  // total solver workspace
+
+    acados_size_t qp_in_out;  // qp_in, qp_out, seeds and residuals of the original QP
+    acados_size_t xcond_memory;
+    acados_size_t xcond_workspace;
+    acados_size_t qp_solver_memory;
+    acados_size_t qp_solver_workspace;
+    acados_size_t regularize_memory;
+    acados_size_t globalization_memory;
+    acados_size_t dynamics_memory;  // sum over stages
+    acados_size_t dynamics_workspace;
+    acados_size_t cost_memory;
+    acados_size_t cost_workspace;
+    acados_size_t constraints_memory;
+    acados_size_t constraints_workspace;
+    acados_size_t ext_fun_workspace;
+    acados_size_t iterates;  // store_iterates
+    // module workspaces are shared if reuse_workspace is set, this is what is actually reserved
+    acados_size_t module_workspace_reserved;
+    acados_size_t ext_fun_workspace_reserved;
+
+    acados_size_t alignment;  // alignment padding at nlp level, as placed by the last memory and workspace assign
+    acados_size_t other;      // nlp structs and vectors, residuals, solver statistics
+} ocp_nlp_memory_report;
+
+// opts_ are the options of the nlp solver, nlp_mem its assigned nlp memory
+void ocp_nlp_memory_report_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                   ocp_nlp_in *in, ocp_nlp_memory *nlp_mem, ocp_nlp_memory_report *report);
+// sizes[7]: dynamics memory, workspace, cost memory, workspace, constraints memory, workspace,
+// external function workspace of the stage
+void ocp_nlp_memory_report_stage(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                 ocp_nlp_in *in, int stage, acados_size_t *sizes);
+//
+void ocp_nlp_memory_report_print(ocp_nlp_config *config, ocp_nlp_dims *dims, void *opts_,
+                                 ocp_nlp_in *in, ocp_nlp_memory *nlp_mem, int print_stages);
+
+
+
 /************************************************
  * function
  ************************************************/
@@ -546,6 +697,10 @@ void ocp_nlp_approximate_qp_matrices(ocp_nlp_config *config, ocp_nlp_dims *dims,
 //
 void ocp_nlp_approximate_qp_vectors_sqp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
                  ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
+// approximate_qp_matrices + approximate_qp_vectors_sqp + res_compute in one pass over the stages
+void ocp_nlp_approximate_qp_fused(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work,
+             ocp_nlp_res *res);
 //
 void ocp_nlp_zero_order_qp_update(ocp_nlp_config *config,
     ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out, ocp_nlp_opts *opts,
@@ -560,7 +715,7 @@ void ocp_nlp_update_variables_sqp(void *config_, void *dims_,
             void *out_destination_, void *solver_mem, double alpha, bool full_step_dual);
 //
 void ocp_nlp_convert_primaldelta_absdual_step_to_delta_step(ocp_nlp_config *config, ocp_nlp_dims *dims,
-        ocp_nlp_out *out, ocp_qp_out *step);
+        ocp_nlp_out *out, ocp_nlp_memory *mem, ocp_qp_out *step);
 //
 double ocp_nlp_compute_anderson_gamma(ocp_nlp_workspace *work, ocp_qp_out *new_qp_step, ocp_qp_out *new_minus_old_qp_step);
 //
@@ -579,6 +734,25 @@ double ocp_nlp_compute_delta_dual_norm_inf(ocp_nlp_dims *dims, ocp_nlp_workspace
 //
 void copy_ocp_nlp_out(ocp_nlp_dims *dims, ocp_nlp_out *from, ocp_nlp_out *to);
 
+// compute_fun of stage i at ux (and ux1), skipped if the stage was last evaluated at the same point;
+// ux, ux1 have to be the vectors the submodule memory currently points to
+void ocp_nlp_dynamics_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux, struct blasfeo_dvec *ux1);
+//
+void ocp_nlp_cost_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux);
+//
+void ocp_nlp_constraints_compute_fun_memo(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
+            ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work, int i,
+            struct blasfeo_dvec *ux);
+// to be called after submodules of stage i were evaluated without the memo functions above,
+// or after the model data of stage i changed within a solver call
+void ocp_nlp_memo_invalidate_stage(ocp_nlp_memory *mem, int i);
+// true if the QP matrices are the ones of the last QP solve, such that their condensing can be reused;
+// only with opts->with_memoization, as without memo every QP approximation marks its stage as changed
+bool ocp_nlp_qp_lhs_unchanged(ocp_nlp_dims *dims, ocp_nlp_opts *opts, ocp_nlp_memory *mem);
 //
 void ocp_nlp_cost_compute(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
             ocp_nlp_out *out, ocp_nlp_opts *opts, ocp_nlp_memory *mem, ocp_nlp_workspace *work);
@@ -622,6 +796,12 @@ int ocp_nlp_solve_qp(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_opts *n
     ocp_nlp_memory *nlp_mem, ocp_nlp_workspace *nlp_work,
     ocp_qp_in *qp_in_, ocp_qp_out *qp_out_,
     ocp_qp_xcond_solver *xcond_solver);
+// remaining time until opts->deadline, ACADOS_INFTY without deadline
+double ocp_nlp_deadline_remaining(ocp_nlp_opts *opts);
+// check if a phase with the predicted duration can be completed before opts->deadline
+bool ocp_nlp_deadline_fits(ocp_nlp_opts *opts, double predicted_time);
+// predicted duration of the cheapest complete iteration
+double ocp_nlp_deadline_predict_iteration(ocp_nlp_timings *timings);
 //
 double ocp_nlp_compute_qp_objective_value(ocp_nlp_dims *dims, ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_nlp_workspace *nlp_work);
 //
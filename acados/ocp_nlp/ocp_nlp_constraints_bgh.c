@@ -1008,6 +1008,24 @@ void ocp_nlp_constraints_bgh_memory_set_idxe_ptr(int *idxe, void *memory_)
 }
 
 
+void ocp_nlp_constraints_bgh_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
+{
+    ocp_nlp_constraints_bgh_memory *mem = mem_;
+
+    if (!strcmp(field, "fill_avoided"))
+    {
+        int *int_ptr = value;
+        *int_ptr = mem->fill_avoided;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_constraints_bgh_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
 void ocp_nlp_constraints_bgh_memory_set_jac_lag_stat_p_global_ptr(struct blasfeo_dmat *jac_lag_stat_p_global, void *memory_)
 {
     ocp_nlp_constraints_bgh_memory *memory = memory_;
@@ -1131,11 +1149,12 @@ static void ocp_nlp_constraints_bgh_cast_workspace(void *config_, void *dims_, v
  * functions
  ************************************************/
 
-void ocp_nlp_constraints_bgh_initialize(void *config_, void *dims_, void *model_, void *opts,
+void ocp_nlp_constraints_bgh_initialize(void *config_, void *dims_, void *model_, void *opts_,
                                         void *memory_, void *work_)
 {
     ocp_nlp_constraints_bgh_dims *dims = dims_;
     ocp_nlp_constraints_bgh_model *model = model_;
+    ocp_nlp_constraints_bgh_opts *opts = opts_;
     ocp_nlp_constraints_bgh_memory *memory = memory_;
 
     // loop index
@@ -1144,8 +1163,10 @@ void ocp_nlp_constraints_bgh_initialize(void *config_, void *dims_, void *model_
     // extract dims
     int nx = dims->nx;
     int nu = dims->nu;
+    int nz = dims->nz;
     int nb = dims->nb;
     int ng = dims->ng;
+    int nh = dims->nh;
     int ns = dims->ns;
     int nbue = dims->nbue;
     int nbxe = dims->nbxe;
@@ -1173,6 +1194,20 @@ void ocp_nlp_constraints_bgh_initialize(void *config_, void *dims_, void *model_
     // initialize general constraints matrix
     blasfeo_dgecp(nu + nx, ng, &model->DCt, 0, 0, memory->DCt, 0, 0);
 
+    // structurally nonzero blocks of the h hessian;
+    // the dzduxt contribution is dense, thus the pattern is only used without algebraic variables
+    memory->fill_avoided = 0;
+    if (nh > 0 && opts->compute_hess && nz == 0)
+    {
+        external_function_get_output_nnz_pattern(model->nl_constr_h_fun_jac_hess, 2, nu+nx, nu+nx,
+                                                 &memory->hess_nnz);
+        memory->fill_avoided = (nu+nx)*(nu+nx) - external_function_nnz_pattern_numel(&memory->hess_nnz);
+    }
+    else
+    {
+        external_function_get_output_nnz_pattern(NULL, 0, nu+nx, nu+nx, &memory->hess_nnz);
+    }
+
     return;
 }
 
@@ -1300,14 +1335,17 @@ void ocp_nlp_constraints_bgh_update_qp_matrices(void *config_, void *dims_, void
             // blasfeo_dtrcp_l(nz, &work->tmp_nv_nv, 0, 0, &work->tmp_nv_nv, 0, 0);
 
 
-            // tmp_nv_nv: h hessian contribution
-            blasfeo_dgead(nu+nx, nu+nx, 1.0, &work->tmp_nv_nv, 0, 0, memory->RSQrq, 0, 0);
+            // tmp_nv_nv: h hessian contribution, restricted to its structurally nonzero blocks
+            external_function_nnz_pattern_dgead(&memory->hess_nnz, 1.0, &work->tmp_nv_nv, memory->RSQrq);
 
-            // tmp_nv_nh = dzduxt * jac_z_tran
-            blasfeo_dgemm_nn(nu+nx, nh, nz, 1.0, memory->dzduxt, 0, 0, &work->tmp_nz_nh, 0, 0, 0.0,
-                             &work->tmp_nv_nh, 0, 0, &work->tmp_nv_nh, 0, 0);
-            // update DCt
-            blasfeo_dgead(nu+nx, nh, 1.0, &work->tmp_nv_nh, 0, 0, memory->DCt, ng, 0);
+            if (nz > 0)
+            {
+                // tmp_nv_nh = dzduxt * jac_z_tran
+                blasfeo_dgemm_nn(nu+nx, nh, nz, 1.0, memory->dzduxt, 0, 0, &work->tmp_nz_nh, 0, 0, 0.0,
+                                 &work->tmp_nv_nh, 0, 0, &work->tmp_nv_nh, 0, 0);
+                // update DCt
+                blasfeo_dgead(nu+nx, nh, 1.0, &work->tmp_nv_nh, 0, 0, memory->DCt, ng, 0);
+            }
         }
         else
         {
@@ -1339,11 +1377,14 @@ void ocp_nlp_constraints_bgh_update_qp_matrices(void *config_, void *dims_, void
             // (dhdx + dhdz*dzdx)*(x - \bar{x}) +
             // (dhdu + dhdz*dzdu)*(u - \bar{u})
 
-            // tmp_nv_nh = dzduxt * jac_z_tran
-            blasfeo_dgemm_nn(nu+nx, nh, nz, 1.0, memory->dzduxt, 0, 0, &work->tmp_nz_nh, 0, 0, 0.0,
-                             &work->tmp_nv_nh, 0, 0, &work->tmp_nv_nh, 0, 0);
-            // update DCt
-            blasfeo_dgead(nu+nx, nh, 1.0, &work->tmp_nv_nh, 0, 0, memory->DCt, ng, 0);
+            if (nz > 0)
+            {
+                // tmp_nv_nh = dzduxt * jac_z_tran
+                blasfeo_dgemm_nn(nu+nx, nh, nz, 1.0, memory->dzduxt, 0, 0, &work->tmp_nz_nh, 0, 0, 0.0,
+                                 &work->tmp_nv_nh, 0, 0, &work->tmp_nv_nh, 0, 0);
+                // update DCt
+                blasfeo_dgead(nu+nx, nh, 1.0, &work->tmp_nv_nh, 0, 0, memory->DCt, ng, 0);
+            }
         }
     }
 
@@ -1735,6 +1776,7 @@ void ocp_nlp_constraints_bgh_config_initialize_default(void *config_, int stage)
     config->memory_set_idxe_ptr = &ocp_nlp_constraints_bgh_memory_set_idxe_ptr;
     config->memory_set_jac_ineq_p_global_ptr = &ocp_nlp_constraints_bgh_memory_set_jac_ineq_p_global_ptr;
     config->memory_set_jac_lag_stat_p_global_ptr = &ocp_nlp_constraints_bgh_memory_set_jac_lag_stat_p_global_ptr;
+    config->memory_get = &ocp_nlp_constraints_bgh_memory_get;
     config->workspace_calculate_size = &ocp_nlp_constraints_bgh_workspace_calculate_size;
     config->get_external_fun_workspace_requirement = &ocp_nlp_constraints_bgh_get_external_fun_workspace_requirement;
     config->set_external_fun_workspaces = &ocp_nlp_constraints_bgh_set_external_fun_workspaces;
@@ -163,6 +163,8 @@ typedef struct
     int *idxb;                   // pointer to idxb[ii] in qp_in
     int *idxs_rev;               // pointer to idxs_rev[ii] in qp_in
     int *idxe;                   // pointer to idxe[ii] in qp_in
+    external_function_nnz_pattern hess_nnz;  // structurally nonzero blocks of the h hessian
+    int fill_avoided;            // number of structurally zero entries skipped in QP assembly
 } ocp_nlp_constraints_bgh_memory;
 
 //
@@ -195,6 +197,8 @@ void ocp_nlp_constraints_bgh_memory_set_idxe_ptr(int *idxe, void *memory_);
 void ocp_nlp_constraints_bgh_memory_set_jac_lag_stat_p_global_ptr(struct blasfeo_dmat *jac_lag_stat_p_global, void *memory_);
 //
 void ocp_nlp_constraints_bgh_memory_set_jac_ineq_p_global_ptr(struct blasfeo_dmat *jac_ineq_p_global, void *memory_);
+//
+void ocp_nlp_constraints_bgh_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value);
 
 
 
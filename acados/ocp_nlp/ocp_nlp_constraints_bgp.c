@@ -1002,6 +1002,23 @@ void ocp_nlp_constraints_bgp_memory_set_jac_ineq_p_global_ptr(struct blasfeo_dma
 }
 
 
+
+void ocp_nlp_constraints_bgp_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
+{
+    if (!strcmp(field, "fill_avoided"))
+    {
+        // no structural sparsity exploited
+        int *int_ptr = value;
+        *int_ptr = 0;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_constraints_bgp_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
 /* workspace */
 
 acados_size_t ocp_nlp_constraints_bgp_workspace_calculate_size(void *config_, void *dims_, void *opts_)
@@ -1499,6 +1516,7 @@ void ocp_nlp_constraints_bgp_config_initialize_default(void *config_, int stage)
     config->memory_set_idxe_ptr = &ocp_nlp_constraints_bgp_memory_set_idxe_ptr;
     config->memory_set_jac_ineq_p_global_ptr = &ocp_nlp_constraints_bgp_memory_set_jac_ineq_p_global_ptr;
     config->memory_set_jac_lag_stat_p_global_ptr = &ocp_nlp_constraints_bgp_memory_set_jac_lag_stat_p_global_ptr;
+    config->memory_get = &ocp_nlp_constraints_bgp_memory_get;
     config->workspace_calculate_size = &ocp_nlp_constraints_bgp_workspace_calculate_size;
     config->get_external_fun_workspace_requirement = &ocp_nlp_constraints_bgp_get_external_fun_workspace_requirement;
     config->set_external_fun_workspaces = &ocp_nlp_constraints_bgp_set_external_fun_workspaces;
@@ -174,6 +174,8 @@ void ocp_nlp_constraints_bgp_memory_set_idxe_ptr(int *idxe, void *memory_);
 void ocp_nlp_constraints_bgp_memory_set_jac_lag_stat_p_global_ptr(struct blasfeo_dmat *jac_lag_stat_p_global, void *memory_);
 //
 void ocp_nlp_constraints_bgp_memory_set_jac_ineq_p_global_ptr(struct blasfeo_dmat *jac_ineq_p_global, void *memory_);
+//
+void ocp_nlp_constraints_bgp_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value);
 
 
 /* workspace */
@@ -81,6 +81,7 @@ typedef struct
     void (*memory_set_idxe_ptr)(int *idxe, void *memory);
     void (*memory_set_jac_lag_stat_p_global_ptr)(struct blasfeo_dmat *jac_lag_stat_p_global, void *memory);
     void (*memory_set_jac_ineq_p_global_ptr)(struct blasfeo_dmat *jac_ineq_p_global, void *memory);
+    void (*memory_get)(void *config, void *dims, void *mem, const char *field, void *value);
 
     void *(*memory_assign)(void *config, void *dims, void *opts, void *raw_memory);
     acados_size_t (*workspace_calculate_size)(void *config, void *dims, void *opts);
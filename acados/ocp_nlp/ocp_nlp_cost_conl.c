@@ -541,6 +541,29 @@ void ocp_nlp_cost_conl_memory_set_Z_ptr(struct blasfeo_dvec *Z, void *memory_)
 
 
 
+void ocp_nlp_cost_conl_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
+{
+    if (!strcmp(field, "fill_avoided"))
+    {
+        // no structural sparsity exploited
+        int *int_ptr = value;
+        *int_ptr = 0;
+    }
+    else if (!strcmp(field, "ref_enters_hess"))
+    {
+        // the outer Hessian is evaluated at the residual
+        int *int_ptr = value;
+        *int_ptr = 1;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_cost_conl_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
 void ocp_nlp_cost_conl_memory_set_ux_ptr(struct blasfeo_dvec *ux, void *memory_)
 {
     ocp_nlp_cost_conl_memory *memory = memory_;
@@ -1079,6 +1102,7 @@ void ocp_nlp_cost_conl_config_initialize_default(void *config_, int stage)
     config->memory_set_dzdux_tran_ptr = &ocp_nlp_cost_conl_memory_set_dzdux_tran_ptr;
     config->memory_set_RSQrq_ptr = &ocp_nlp_cost_conl_memory_set_RSQrq_ptr;
     config->memory_set_Z_ptr = &ocp_nlp_cost_conl_memory_set_Z_ptr;
+    config->memory_get = &ocp_nlp_cost_conl_memory_get;
     config->workspace_calculate_size = &ocp_nlp_cost_conl_workspace_calculate_size;
     config->get_external_fun_workspace_requirement = &ocp_nlp_cost_conl_get_external_fun_workspace_requirement;
     config->set_external_fun_workspaces = &ocp_nlp_cost_conl_set_external_fun_workspaces;
@@ -644,6 +644,29 @@ void ocp_nlp_cost_ls_memory_set_Z_ptr(struct blasfeo_dvec *Z, void *memory_)
 
 
 
+void ocp_nlp_cost_ls_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
+{
+    if (!strcmp(field, "fill_avoided"))
+    {
+        // no structural sparsity exploited
+        int *int_ptr = value;
+        *int_ptr = 0;
+    }
+    else if (!strcmp(field, "ref_enters_hess"))
+    {
+        // the Hessian is constant
+        int *int_ptr = value;
+        *int_ptr = 0;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_cost_ls_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
 void ocp_nlp_cost_ls_memory_set_ux_ptr(struct blasfeo_dvec *ux, void *memory_)
 {
     ocp_nlp_cost_ls_memory *memory = memory_;
@@ -1120,6 +1143,7 @@ void ocp_nlp_cost_ls_config_initialize_default(void *config_, int stage)
     config->memory_set_dzdux_tran_ptr = &ocp_nlp_cost_ls_memory_set_dzdux_tran_ptr;
     config->memory_set_RSQrq_ptr = &ocp_nlp_cost_ls_memory_set_RSQrq_ptr;
     config->memory_set_Z_ptr = &ocp_nlp_cost_ls_memory_set_Z_ptr;
+    config->memory_get = &ocp_nlp_cost_ls_memory_get;
     config->memory_set_jac_lag_stat_p_global_ptr = &ocp_nlp_cost_ls_memory_set_jac_lag_stat_p_global_ptr;
     config->workspace_calculate_size = &ocp_nlp_cost_ls_workspace_calculate_size;
     config->get_external_fun_workspace_requirement = &ocp_nlp_cost_ls_get_external_fun_workspace_requirement;
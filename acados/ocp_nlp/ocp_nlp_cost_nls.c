@@ -634,6 +634,29 @@ void ocp_nlp_cost_nls_memory_set_Z_ptr(struct blasfeo_dvec *Z, void *memory_)
 
 
 
+void ocp_nlp_cost_nls_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
+{
+    ocp_nlp_cost_nls_memory *mem = mem_;
+
+    if (!strcmp(field, "fill_avoided"))
+    {
+        int *int_ptr = value;
+        *int_ptr = mem->fill_avoided;
+    }
+    else if (!strcmp(field, "ref_enters_hess"))
+    {
+        int *int_ptr = value;
+        *int_ptr = mem->ref_enters_hess;
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_cost_nls_memory_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
 void ocp_nlp_cost_nls_memory_set_ux_ptr(struct blasfeo_dvec *ux, void *memory_)
 {
     ocp_nlp_cost_nls_memory *memory = memory_;
@@ -796,14 +819,41 @@ void ocp_nlp_cost_nls_initialize(void *config_, void *dims_, void *model_, void
 {
     ocp_nlp_cost_nls_dims *dims = dims_;
     ocp_nlp_cost_nls_model *model = model_;
+    ocp_nlp_cost_nls_opts *opts = opts_;
     ocp_nlp_cost_nls_memory *memory = memory_;
 
     ocp_nlp_cost_nls_cast_workspace(config_, dims_, opts_, work_);
     ocp_nlp_cost_nls_update_W_factorization(config_, dims_, model_, opts_, memory_, work_);
 
+    int nx = dims->nx;
+    int nz = dims->nz;
+    int nu = dims->nu;
+    int ny = dims->ny;
     int ns = dims->ns;
     blasfeo_dveccpsc(2*ns, model->scaling, &model->Z, 0, memory->Z, 0);
 
+    // structural sparsity of the residual jacobian and hessian;
+    // only trailing zero rows of Jt are dropped, such that all blasfeo routines keep zero offsets
+    external_function_nnz_pattern jac_nnz;
+    memory->nv_jac = nu+nx;
+    external_function_get_output_nnz_pattern(NULL, 0, nu+nx, nu+nx, &memory->hess_nnz);
+    memory->fill_avoided = 0;
+    memory->ref_enters_hess = !opts->gauss_newton_hess;
+    if (opts->integrator_cost == 0 && nz == 0)
+    {
+        external_function_get_output_nnz_pattern(model->nls_y_fun_jac, 1, nu+nx, ny, &jac_nnz);
+        memory->nv_jac = external_function_nnz_pattern_row_end(&jac_nnz);
+        memory->fill_avoided += (nu+nx-memory->nv_jac) * ny
+            + ((nu+nx)*(nu+nx+1) - memory->nv_jac*(memory->nv_jac+1)) / 2;
+        if (!opts->gauss_newton_hess)
+        {
+            external_function_get_output_nnz_pattern(model->nls_y_hess, 0, nu+nx, nu+nx,
+                                                     &memory->hess_nnz);
+            memory->fill_avoided += (nu+nx)*(nu+nx)
+                - external_function_nnz_pattern_numel(&memory->hess_nnz);
+        }
+    }
+
     return;
 }
 
@@ -825,6 +875,7 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
     int nu = dims->nu;
     int ny = dims->ny;
     int ns = dims->ns;
+    int nv_jac = memory->nv_jac;
 
     ext_fun_arg_t ext_fun_type_in[5];
     void *ext_fun_in[5];
@@ -908,12 +959,12 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
             if (model->outer_hess_is_diag)
             {
                 // tmp_nv_ny = Jt * W_chol_diag
-                blasfeo_dgemm_nd(nu + nx, ny, 1.0, &memory->Jt, 0, 0, &memory->W_chol_diag, 0, 0., &work->Cyt_tilde, 0, 0, &work->tmp_nv_ny, 0, 0);
+                blasfeo_dgemm_nd(nv_jac, ny, 1.0, &memory->Jt, 0, 0, &memory->W_chol_diag, 0, 0., &work->Cyt_tilde, 0, 0, &work->tmp_nv_ny, 0, 0);
             }
             else
             {
                 // tmp_nv_ny = Jt * W_chol, where W_chol is lower triangular
-                blasfeo_dtrmm_rlnn(nu+nx, ny, 1.0, &memory->W_chol, 0, 0, &memory->Jt, 0, 0,
+                blasfeo_dtrmm_rlnn(nv_jac, ny, 1.0, &memory->W_chol, 0, 0, &memory->Jt, 0, 0,
                                     &work->tmp_nv_ny, 0, 0);
             }
         }
@@ -934,7 +985,7 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
         if (opts->gauss_newton_hess)
         {
             // RSQrq += scaling * tmp_nv_ny * tmp_nv_ny^T
-            blasfeo_dsyrk_ln(nu+nx, ny, model->scaling, &work->tmp_nv_ny, 0, 0, &work->tmp_nv_ny, 0, 0,
+            blasfeo_dsyrk_ln(nv_jac, ny, model->scaling, &work->tmp_nv_ny, 0, 0, &work->tmp_nv_ny, 0, 0,
                             1.0, memory->RSQrq, 0, 0, memory->RSQrq, 0, 0);
         }
         else
@@ -962,9 +1013,10 @@ void ocp_nlp_cost_nls_update_qp_matrices(void *config_, void *dims_, void *model
                                     ext_fun_type_out, ext_fun_out);
 
             // RSQrq += scaling * (tmp_nv_nv + tmp_nv_ny * tmp_nv_ny^T)
-            blasfeo_dsyrk_ln(nu+nx, ny, model->scaling, &work->tmp_nv_ny, 0, 0, &work->tmp_nv_ny, 0, 0,
+            blasfeo_dsyrk_ln(nv_jac, ny, model->scaling, &work->tmp_nv_ny, 0, 0, &work->tmp_nv_ny, 0, 0,
                             1.0, memory->RSQrq, 0, 0, memory->RSQrq, 0, 0);
-            blasfeo_dgead(nu+nx, nu+nx, model->scaling, &work->tmp_nv_nv, 0, 0, memory->RSQrq, 0, 0);
+            external_function_nnz_pattern_dgead(&memory->hess_nnz, model->scaling, &work->tmp_nv_nv,
+                                                memory->RSQrq);
         }
     } // end if (opts->integrator_cost == 0)
 
@@ -1172,6 +1224,7 @@ void ocp_nlp_cost_nls_config_initialize_default(void *config_, int stage)
     config->memory_set_dzdux_tran_ptr = &ocp_nlp_cost_nls_memory_set_dzdux_tran_ptr;
     config->memory_set_RSQrq_ptr = &ocp_nlp_cost_nls_memory_set_RSQrq_ptr;
     config->memory_set_Z_ptr = &ocp_nlp_cost_nls_memory_set_Z_ptr;
+    config->memory_get = &ocp_nlp_cost_nls_memory_get;
     config->workspace_calculate_size = &ocp_nlp_cost_nls_workspace_calculate_size;
     config->get_external_fun_workspace_requirement = &ocp_nlp_cost_nls_get_external_fun_workspace_requirement;
     config->set_external_fun_workspaces = &ocp_nlp_cost_nls_set_external_fun_workspaces;
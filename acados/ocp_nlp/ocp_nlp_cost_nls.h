@@ -149,6 +149,10 @@ typedef struct
     struct blasfeo_dvec *z_alg;         ///< pointer to z in sim_out
     struct blasfeo_dmat *dzdux_tran;    ///< pointer to sensitivity of a wrt ux in sim_out
     double fun;                         ///< value of the cost function
+    int nv_jac;                         ///< number of leading rows of Jt containing structural nonzeros
+    external_function_nnz_pattern hess_nnz; ///< structurally nonzero blocks of the residual hessian
+    int fill_avoided;                   ///< number of structurally zero entries skipped in QP assembly
+    int ref_enters_hess;                ///< the exact Hessian depends on y_ref
 } ocp_nlp_cost_nls_memory;
 
 //
@@ -168,6 +172,8 @@ void ocp_nlp_cost_nls_memory_set_RSQrq_ptr(struct blasfeo_dmat *RSQrq, void *mem
 //
 void ocp_nlp_cost_nls_memory_set_Z_ptr(struct blasfeo_dvec *Z, void *memory);
 //
+void ocp_nlp_cost_nls_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value);
+//
 void ocp_nlp_cost_nls_memory_set_ux_ptr(struct blasfeo_dvec *ux, void *memory_);
 //
 void ocp_nlp_cost_nls_memory_set_z_alg_ptr(struct blasfeo_dvec *z_alg, void *memory_);
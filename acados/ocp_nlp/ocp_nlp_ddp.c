@@ -53,6 +53,7 @@
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
+#include "acados/utils/trace.h"
 #include "acados/utils/types.h"
 #include "acados/utils/strsep.h"
 #include "acados_c/ocp_qp_interface.h"
@@ -449,8 +450,8 @@ void ocp_nlp_ddp_compute_trial_iterate(void *config_, void *dims_,
         // evalutate dynamics
         // x_{i+1} = f_dyn_i(x_i, u_i)
         config->dynamics[i]->memory_set_ux_ptr(out_destination->ux+i, mem->dynamics[i]);
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i],
-            in->dynamics[i], opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        ocp_nlp_dynamics_compute_fun_memo(config, dims, in, opts, mem, work, i,
+            out_destination->ux+i, out->ux+i+1);
         config->dynamics[i]->memory_set_ux_ptr(out->ux+i, mem->dynamics[i]);
 
         // f_dyn_i(x_i, u_i) - x_{i+1}
@@ -662,8 +663,11 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         printf("'with_adaptive_levenberg_marquardt' option is set to: %s\n", opts->nlp_opts->with_adaptive_levenberg_marquardt?"true":"false");
     }
 
+    double tmp_time;
+
     for (; ddp_iter <= opts->nlp_opts->max_iter; ddp_iter++)
     {
+        ACADOS_TRACE_BEGIN("ddp_iter");
         // store current iterate
         if (nlp_opts->store_iterates)
         {
@@ -676,6 +680,7 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         {
             /* Prepare the QP data */
             // linearize NLP, update QP matrices, and add Levenberg-Marquardt term
+            ACADOS_TRACE_BEGIN("linearization");
             acados_tic(&timer1);
             ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
             if (nlp_opts->with_adaptive_levenberg_marquardt || config->globalization->needs_objective_value() == 1)
@@ -684,7 +689,10 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             }
             ocp_nlp_add_levenberg_marquardt_term(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, mem->alpha, ddp_iter, nlp_mem->qp_in);
 
-            nlp_timings->time_lin += acados_toc(&timer1);
+            tmp_time = acados_toc(&timer1);
+            nlp_timings->time_lin += tmp_time;
+            ocp_nlp_timings_update_estimate(&nlp_timings->est_time_lin, tmp_time);
+            ACADOS_TRACE_END("linearization");
 
             // update QP rhs for DDP (step prim var, abs dual var)
             // NOTE: The ddp version of approximate does not exist!
@@ -740,6 +748,26 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 #endif
             nlp_mem->iter = ddp_iter;
             nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("ddp_iter");
+            return mem->nlp_mem->status;
+        }
+
+        // anytime exit after the termination check: keep the current iterate, with its residuals,
+        // if the step and the next linearization cannot be completed before the deadline
+        if (!ocp_nlp_deadline_fits(nlp_opts, ocp_nlp_deadline_predict_iteration(nlp_timings)))
+        {
+            if (nlp_opts->print_level > 0)
+            {
+                printf("Stopped: Deadline reached in DDP iteration %d.\n", ddp_iter);
+            }
+#if defined(ACADOS_WITH_OPENMP)
+            // restore number of threads
+            omp_set_num_threads(num_threads_bkp);
+#endif
+            mem->nlp_mem->status = ACADOS_DEADLINE;
+            nlp_mem->iter = ddp_iter;
+            nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("ddp_iter");
             return mem->nlp_mem->status;
         }
 
@@ -824,6 +852,7 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             mem->nlp_mem->status = ACADOS_QP_FAILURE;
             nlp_mem->iter = ddp_iter;
             nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("ddp_iter");
 
             return mem->nlp_mem->status;
         }
@@ -851,9 +880,11 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         else
         {
             int globalization_status;
+            ACADOS_TRACE_BEGIN("globalization");
             acados_tic(&timer1);
             globalization_status = config->globalization->find_acceptable_iterate(config, dims, nlp_in, nlp_out, nlp_mem, mem, nlp_work, nlp_opts, &mem->alpha);
             nlp_timings->time_glob += acados_toc(&timer1);
+            ACADOS_TRACE_END("globalization");
 
             if (globalization_status != ACADOS_SUCCESS)
             {
@@ -861,12 +892,15 @@ int ocp_nlp_ddp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                 {
                     printf("\nFailure in globalization, got status %d!\n", globalization_status);
                 }
-                mem->nlp_mem->status = ACADOS_QP_FAILURE;
+                // the line search stops at the deadline without taking a step
+                mem->nlp_mem->status = globalization_status == ACADOS_DEADLINE ? ACADOS_DEADLINE : ACADOS_QP_FAILURE;
                 nlp_mem->iter = ddp_iter;
                 nlp_timings->time_tot = acados_toc(&timer0);
+                ACADOS_TRACE_END("ddp_iter");
                 return mem->nlp_mem->status;
             }
         }
+        ACADOS_TRACE_END("ddp_iter");
     }  // end DDP loop
 
     if (nlp_opts->print_level > 0)
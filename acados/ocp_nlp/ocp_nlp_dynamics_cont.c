@@ -41,6 +41,7 @@
 #include "blasfeo_d_blas.h"
 // acados
 #include "acados/utils/mem.h"
+#include "acados/utils/trace.h"
 
 
 
@@ -568,6 +569,12 @@ void ocp_nlp_dynamics_cont_memory_get(void *config_, void *dims_, void *mem_, co
     {
         sim->memory_get(sim, dims->sim, mem->sim_solver, field, value);
     }
+    else if (!strcmp(field, "fill_avoided"))
+    {
+        // sensitivities propagated by the integrator are dense
+        int *int_ptr = value;
+        *int_ptr = 0;
+    }
     else
     {
         printf("\nerror: ocp_nlp_dynamics_cont_memory_get: field %s not available\n", field);
@@ -805,8 +812,10 @@ void ocp_nlp_dynamics_cont_update_qp_matrices(void *config_, void *dims_, void *
     blasfeo_unpack_dvec(nx1, mem->pi, 0, work->sim_in->S_adj, 1);
 
     // call integrator
+    ACADOS_TRACE_BEGIN("integrator");
     config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
             mem->sim_solver, work->sim_solver);
+    ACADOS_TRACE_END("integrator");
 
 
     // B
@@ -930,6 +939,11 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
     config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
     config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
 
+    // evaluations for the globalization keep the step sequence of the current SQP iteration
+    bool adaptive_freeze_bkp, adaptive_freeze = true;
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze);
+
     // set all sens to false
     bool sens_all = false;
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_all);
@@ -937,13 +951,16 @@ void ocp_nlp_dynamics_cont_compute_fun(void *config_, void *dims_, void *model_,
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_all);
 
     // call integrator
+    ACADOS_TRACE_BEGIN("integrator");
     config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
             mem->sim_solver, work->sim_solver);
+    ACADOS_TRACE_END("integrator");
 
     // restore sens options
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze_bkp);
 
     // fun = integrator(x, u) - x[next_stage]
     blasfeo_pack_dvec(nx1, work->sim_out->xn, 1, &mem->fun, 0);
@@ -1005,6 +1022,11 @@ void ocp_nlp_dynamics_cont_compute_fun_and_adj(void *config_, void *dims_, void
     config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
     config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
 
+    // evaluations for the globalization keep the step sequence of the current SQP iteration
+    bool adaptive_freeze_bkp, adaptive_freeze = true;
+    config->sim_solver->opts_get(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze);
+
     // compute only adjoint sensitivities
     bool sens_tmp = false;
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_tmp);
@@ -1013,13 +1035,16 @@ void ocp_nlp_dynamics_cont_compute_fun_and_adj(void *config_, void *dims_, void
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_tmp);
 
     // call integrator
+    ACADOS_TRACE_BEGIN("integrator");
     config->sim_solver->evaluate(config->sim_solver, work->sim_in, work->sim_out, opts->sim_solver,
             mem->sim_solver, work->sim_solver);
+    ACADOS_TRACE_END("integrator");
 
     // restore sens options
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_forw", &sens_forw_bkp);
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_adj", &sens_adj_bkp);
     config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "sens_hess", &sens_hess_bkp);
+    config->sim_solver->opts_set(config->sim_solver, opts->sim_solver, "adaptive_freeze", &adaptive_freeze_bkp);
 
     // fun = integrator(x, u) - x[next_stage]
     blasfeo_pack_dvec(nx1, work->sim_out->xn, 1, &mem->fun, 0);
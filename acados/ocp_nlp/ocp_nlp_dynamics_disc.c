@@ -446,13 +446,18 @@ void ocp_nlp_dynamics_disc_memory_set_z_alg_ptr(struct blasfeo_dvec *z, void *me
 void ocp_nlp_dynamics_disc_memory_get(void *config_, void *dims_, void *mem_, const char *field, void* value)
 {
 //    ocp_nlp_dynamics_disc_dims *dims = dims_;
-//    ocp_nlp_dynamics_disc_memory *mem = mem_;
+    ocp_nlp_dynamics_disc_memory *mem = mem_;
 
     if (!strcmp(field, "time_sim") || !strcmp(field, "time_sim_ad") || !strcmp(field, "time_sim_la"))
     {
         double *ptr = value;
         *ptr = 0;
     }
+    else if (!strcmp(field, "fill_avoided"))
+    {
+        int *int_ptr = value;
+        *int_ptr = mem->fill_avoided;
+    }
     else
     {
         printf("\nerror: ocp_nlp_dynamics_disc_memory_get: field %s not available\n", field);
@@ -597,6 +602,27 @@ void ocp_nlp_dynamics_disc_model_set(void *config_, void *dims_, void *model_, c
 void ocp_nlp_dynamics_disc_initialize(void *config_, void *dims_, void *model_, void *opts_,
                                       void *mem_, void *work_)
 {
+    ocp_nlp_dynamics_disc_dims *dims = dims_;
+    ocp_nlp_dynamics_disc_opts *opts = opts_;
+    ocp_nlp_dynamics_disc_memory *memory = mem_;
+    ocp_nlp_dynamics_disc_model *model = model_;
+
+    int nx = dims->nx;
+    int nu = dims->nu;
+
+    // structurally nonzero blocks of the hessian of pi^T * phi(x, u)
+    memory->fill_avoided = 0;
+    if (opts->compute_hess)
+    {
+        external_function_get_output_nnz_pattern(model->disc_dyn_fun_jac_hess, 2, nu+nx, nu+nx,
+                                                 &memory->hess_nnz);
+        memory->fill_avoided = (nu+nx)*(nu+nx) - external_function_nnz_pattern_numel(&memory->hess_nnz);
+    }
+    else
+    {
+        external_function_get_output_nnz_pattern(NULL, 0, nu+nx, nu+nx, &memory->hess_nnz);
+    }
+
     return;
 }
 
@@ -671,8 +697,8 @@ void ocp_nlp_dynamics_disc_update_qp_matrices(void *config_, void *dims_, void *
         model->disc_dyn_fun_jac_hess->evaluate(model->disc_dyn_fun_jac_hess, ext_fun_type_in, ext_fun_in,
                 ext_fun_type_out, ext_fun_out);
 
-        // Add hessian contribution
-        blasfeo_dgead(nx+nu, nx+nu, 1.0, &work->tmp_nv_nv, 0, 0, memory->RSQrq, 0, 0);
+        // Add hessian contribution, restricted to its structurally nonzero blocks
+        external_function_nnz_pattern_dgead(&memory->hess_nnz, 1.0, &work->tmp_nv_nv, memory->RSQrq);
     }
     else
     {
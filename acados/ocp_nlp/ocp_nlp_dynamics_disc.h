@@ -112,6 +112,8 @@ typedef struct
     struct blasfeo_dvec *pi;     // pointer to pi in nlp_out at current stage
     struct blasfeo_dmat *BAbt;   // pointer to BAbt in qp_in
     struct blasfeo_dmat *RSQrq;  // pointer to RSQrq in qp_in
+    external_function_nnz_pattern hess_nnz;  // structurally nonzero blocks of the dynamics hessian
+    int fill_avoided;            // number of structurally zero entries skipped in QP assembly
 } ocp_nlp_dynamics_disc_memory;
 
 //
@@ -172,7 +172,7 @@ int ocp_nlp_globalization_fixed_step_find_acceptable_iterate(void *nlp_config_,
     if (nlp_opts->with_anderson_acceleration)
     {
         // convert qp_out to delta primal-dual step
-        ocp_nlp_convert_primaldelta_absdual_step_to_delta_step(config, dims, nlp_out, qp_out);
+        ocp_nlp_convert_primaldelta_absdual_step_to_delta_step(config, dims, nlp_out, nlp_mem, qp_out);
         if (nlp_mem->iter == 0)
         {
             // store in anderson_step, prev_qp_out
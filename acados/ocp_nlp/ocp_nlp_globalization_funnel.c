@@ -49,6 +49,7 @@
 // acados
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
+#include "acados/utils/timing.h"
 
 
 /************************************************
@@ -447,9 +448,11 @@ int backtracking_line_search(ocp_nlp_config *config,
     nlp_mem->objective_multiplier = mem->penalty_parameter;
 
     int i;
+    acados_timer timer;
 
     while (true)
     {
+        acados_tic(&timer);
         // Calculate trial iterate: trial_iterate = current_iterate + alpha * direction
         config->step_update(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem,
                                      nlp_work, nlp_work->tmp_nlp_out, solver_mem, alpha, globalization_opts->full_step_dual);
@@ -465,8 +468,8 @@ int backtracking_line_search(ocp_nlp_config *config,
         for (i=0; i<N; i++)
         {
             // dynamics: Note has to be first, because cost_integration might be used.
-            config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], nlp_in->dynamics[i],
-                                            nlp_opts->dynamics[i], nlp_mem->dynamics[i], nlp_work->dynamics[i]);
+            ocp_nlp_dynamics_compute_fun_memo(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, i,
+                                              nlp_work->tmp_nlp_out->ux+i, nlp_work->tmp_nlp_out->ux+i+1);
         }
         // compute trial objective function value
 #if defined(ACADOS_WITH_OPENMP)
@@ -475,8 +478,8 @@ int backtracking_line_search(ocp_nlp_config *config,
         for (i=0; i<=N; i++)
         {
             // cost
-            config->cost[i]->compute_fun(config->cost[i], dims->cost[i], nlp_in->cost[i], nlp_opts->cost[i],
-                                        nlp_mem->cost[i], nlp_work->cost[i]);
+            ocp_nlp_cost_compute_fun_memo(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, i,
+                                          nlp_work->tmp_nlp_out->ux+i);
         }
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
@@ -484,9 +487,8 @@ int backtracking_line_search(ocp_nlp_config *config,
         for (i=0; i<=N; i++)
         {
             // constr
-            config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                                nlp_in->constraints[i], nlp_opts->constraints[i],
-                                                nlp_mem->constraints[i], nlp_work->constraints[i]);
+            ocp_nlp_constraints_compute_fun_memo(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, i,
+                                                 nlp_work->tmp_nlp_out->ux+i);
         }
         // reset evaluation point to SQP iterate
         ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, nlp_in, nlp_out, nlp_mem);
@@ -500,6 +502,7 @@ int backtracking_line_search(ocp_nlp_config *config,
             trial_cost += *tmp_fun;
         }
         trial_infeasibility = ocp_nlp_get_l1_infeasibility(config, dims, nlp_mem);
+        ocp_nlp_timings_update_estimate(&nlp_mem->nlp_timings->est_time_glob_trial, acados_toc(&timer));
 
         ///////////////////////////////////////////////////////////////////////
         // Evaluate merit function at trial point
@@ -530,6 +533,11 @@ int backtracking_line_search(ocp_nlp_config *config,
             return ACADOS_MINSTEP;
         }
 
+        if (!ocp_nlp_deadline_fits(nlp_opts, nlp_mem->nlp_timings->est_time_glob_trial))
+        {
+            return ACADOS_DEADLINE;
+        }
+
         alpha *= globalization_opts->alpha_reduction;
     }
 }
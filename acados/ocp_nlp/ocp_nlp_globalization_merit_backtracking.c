@@ -44,6 +44,8 @@
 #include "acados/ocp_nlp/ocp_nlp_globalization_common.h"
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
+#include "acados/utils/trace.h"
 
 // blasfeo
 #include "blasfeo_d_aux.h"
@@ -365,13 +367,18 @@ static int ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
     //     break;
     // }
 
+    acados_timer timer;
     for (j=0; alpha*reduction_factor > globalization_opts->alpha_min; j++)
     {
+        ACADOS_TRACE_BEGIN("line_search_trial");
+        acados_tic(&timer);
         // tmp_nlp_out = out + alpha * qp_out
         for (i = 0; i <= N; i++)
             blasfeo_daxpy(nv[i], alpha, qp_out->ux+i, 0, out->ux+i, 0, work->tmp_nlp_out->ux+i, 0);
 
         merit_fun1 = ocp_nlp_evaluate_merit_fun(config, dims, in, out, opts, mem, work);
+        ocp_nlp_timings_update_estimate(&mem->nlp_timings->est_time_glob_trial, acados_toc(&timer));
+        ACADOS_TRACE_END("line_search_trial");
         if (opts->print_level > 1)
         {
             printf("backtracking %d alpha = %f, merit_fun1 = %e, merit_fun0 %e\n", j, alpha, merit_fun1, merit_fun0);
@@ -392,6 +399,12 @@ static int ocp_nlp_line_search(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_n
         {
             alpha *= reduction_factor;
         }
+
+        if (!ocp_nlp_deadline_fits(opts, mem->nlp_timings->est_time_glob_trial))
+        {
+            // no step is taken, the current iterate is kept
+            return ACADOS_DEADLINE;
+        }
     }
 
     *alpha_reference = alpha;
@@ -769,8 +782,8 @@ double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
     for (int i=0; i<N; i++)
     {
         // dynamics: Note has to be first, because cost_integration might be used.
-        config->dynamics[i]->compute_fun(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
-                                         opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        ocp_nlp_dynamics_compute_fun_memo(config, dims, in, opts, mem, work, i,
+                                          work->tmp_nlp_out->ux+i, work->tmp_nlp_out->ux+i+1);
     }
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
@@ -778,8 +791,7 @@ double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
     for (int i=0; i<=N; i++)
     {
         // cost
-        config->cost[i]->compute_fun(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i],
-                                    mem->cost[i], work->cost[i]);
+        ocp_nlp_cost_compute_fun_memo(config, dims, in, opts, mem, work, i, work->tmp_nlp_out->ux+i);
     }
 #if defined(ACADOS_WITH_OPENMP)
     #pragma omp parallel for
@@ -787,9 +799,7 @@ double ocp_nlp_evaluate_merit_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
     for (int i=0; i<=N; i++)
     {
         // constr
-        config->constraints[i]->compute_fun(config->constraints[i], dims->constraints[i],
-                                            in->constraints[i], opts->constraints[i],
-                                            mem->constraints[i], work->constraints[i]);
+        ocp_nlp_constraints_compute_fun_memo(config, dims, in, opts, mem, work, i, work->tmp_nlp_out->ux+i);
     }
     // reset evaluation point to SQP iterate
     ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, in, out, mem);
@@ -914,9 +924,11 @@ static int ocp_nlp_ddp_backtracking_line_search(ocp_nlp_config *config, ocp_nlp_
     double *tmp_fun;
 
     int i;
+    acados_timer timer;
 
     while (true)
     {
+        acados_tic(&timer);
         // Do the DDP forward sweep to get the trial iterate
         config->step_update(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem,
                                      nlp_work, nlp_work->tmp_nlp_out, solver_mem, alpha, globalization_opts->full_step_dual);
@@ -932,8 +944,8 @@ static int ocp_nlp_ddp_backtracking_line_search(ocp_nlp_config *config, ocp_nlp_
         for (i=0; i<=N; i++)
         {
             // cost
-            config->cost[i]->compute_fun(config->cost[i], dims->cost[i], nlp_in->cost[i], nlp_opts->cost[i],
-                                        nlp_mem->cost[i], nlp_work->cost[i]);
+            ocp_nlp_cost_compute_fun_memo(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, i,
+                                          nlp_work->tmp_nlp_out->ux+i);
         }
         ocp_nlp_set_primal_variable_pointers_in_submodules(config, dims, nlp_in, nlp_out, nlp_mem);
         trial_cost = 0.0;
@@ -942,6 +954,7 @@ static int ocp_nlp_ddp_backtracking_line_search(ocp_nlp_config *config, ocp_nlp_
             tmp_fun = config->cost[i]->memory_get_fun_ptr(nlp_mem->cost[i]);
             trial_cost += *tmp_fun;
         }
+        ocp_nlp_timings_update_estimate(&nlp_mem->nlp_timings->est_time_glob_trial, acados_toc(&timer));
 
         negative_ared = trial_cost - nlp_mem->cost_value;
         // Check Armijo sufficient decrease condition
@@ -965,6 +978,12 @@ static int ocp_nlp_ddp_backtracking_line_search(ocp_nlp_config *config, ocp_nlp_
             mem->alpha = 0.0; // set to zero such that regularization is increased
             return ACADOS_MINSTEP;
         }
+
+        if (!ocp_nlp_deadline_fits(nlp_opts, nlp_mem->nlp_timings->est_time_glob_trial))
+        {
+            mem->alpha = 0.0;
+            return ACADOS_DEADLINE;
+        }
     }
 }
 
@@ -995,6 +1014,10 @@ int ocp_nlp_globalization_merit_backtracking_find_acceptable_iterate_for_ddp(voi
         copy_ocp_nlp_out(nlp_dims, nlp_work->tmp_nlp_out, nlp_out);
         return ACADOS_SUCCESS;
     }
+    else if (linesearch_success == ACADOS_DEADLINE)
+    {
+        return ACADOS_DEADLINE;
+    }
     return ACADOS_MINSTEP;
 }
 
@@ -1032,6 +1055,11 @@ int ocp_nlp_globalization_merit_backtracking_find_acceptable_iterate(void *nlp_c
             nlp_mem->status = ACADOS_NAN_DETECTED;
             return nlp_mem->status;
         }
+        if (line_search_status == ACADOS_DEADLINE)
+        {
+            *step_size = 0.0;
+            return ACADOS_DEADLINE;
+        }
     }
 
     // update variables
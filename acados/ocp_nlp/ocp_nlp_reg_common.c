@@ -39,6 +39,13 @@
 
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_blas.h"
+
+#if defined(ACADOS_WITH_OPENMP)
+#include <omp.h>
+#endif
+
 
 
 /************************************************
@@ -162,6 +169,68 @@ void ocp_nlp_reg_dims_set(void *config_, ocp_nlp_reg_dims *dims, int stage, char
  * regularization help functions
  ************************************************/
 
+// true if all eigenvalues of the symmetric matrix A (lower triangle) are larger than shift,
+// i.e. if the cholesky factorization of A - shift * I succeeds; L is workspace of size dim x dim
+bool acados_reg_eig_above(int dim, struct blasfeo_dmat *A, int ai, int aj, double shift,
+                          struct blasfeo_dmat *L)
+{
+    int i;
+
+    blasfeo_dtrcp_l(dim, A, ai, aj, L, 0, 0);
+    blasfeo_ddiare(dim, -shift, L, 0, 0);
+    blasfeo_dpotrf_l(dim, L, 0, 0, L, 0, 0);
+
+    // blasfeo sets the diagonal to zero at the first non-positive pivot
+    for (i = 0; i < dim; i++)
+    {
+        if (!(BLASFEO_DMATEL(L, i, i) > 0.0))
+            return false;
+    }
+
+    return true;
+}
+
+
+
+// Gershgorin bound on the largest absolute eigenvalue of the symmetric matrix A (lower triangle)
+double acados_reg_eig_abs_bound(int dim, struct blasfeo_dmat *A, int ai, int aj)
+{
+    int i, j;
+    double row, bound = 0.0;
+
+    for (i = 0; i < dim; i++)
+    {
+        row = 0.0;
+        for (j = 0; j <= i; j++)
+            row += fabs(BLASFEO_DMATEL(A, ai+i, aj+j));
+        for (j = i+1; j < dim; j++)
+            row += fabs(BLASFEO_DMATEL(A, ai+j, aj+i));
+        bound = MAX(bound, row);
+    }
+
+    return bound;
+}
+
+
+
+// run fun(args, ii) for ii = 0, ..., n-1 on the solver thread pool (or OpenMP / serially)
+void ocp_nlp_reg_parallel_for(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args)
+{
+#if defined(ACADOS_WITH_THREAD_POOL)
+    acados_thread_pool_run(pool, n, fun, args);
+#else
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < n; i++)
+    {
+        fun(args, i);
+    }
+#endif
+}
+
+
+
 // reconstruct A = V * d * V'
 void acados_reconstruct_A(int dim, double *A, double *V, double *d)
 {
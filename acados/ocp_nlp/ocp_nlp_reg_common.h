@@ -43,6 +43,7 @@ extern "C" {
 #endif
 
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/thread_pool.h"
 
 
 
@@ -114,6 +115,11 @@ void acados_mirror(int dim, double *A, double *V, double *d, double *e, double e
 void acados_mirror_adaptive_eps(int dim, double *A, double *V, double *d, double *e, double max_cond_block, double min_eps);
 void acados_project(int dim, double *A, double *V, double *d, double *e, double epsilon);
 void acados_project_adaptive_eps(int dim, double *A, double *V, double *d, double *e, double max_cond_block, double min_eps);
+// cholesky-with-shift test, used to skip the eigen decomposition of blocks that need no regularization
+bool acados_reg_eig_above(int dim, struct blasfeo_dmat *A, int ai, int aj, double shift, struct blasfeo_dmat *L);
+double acados_reg_eig_abs_bound(int dim, struct blasfeo_dmat *A, int ai, int aj);
+// stage loop on the solver thread pool
+void ocp_nlp_reg_parallel_for(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args);
 
 
 #ifdef __cplusplus
@@ -496,6 +496,10 @@ void ocp_nlp_reg_convexify_memory_set(void *config_, ocp_nlp_reg_dims *dims, voi
         struct blasfeo_dvec *lam = value;
         ocp_nlp_reg_convexify_memory_set_lam_ptr(dims, lam, memory_);
     }
+    else if(!strcmp(field, "thread_pool"))
+    {
+        // backward recursion over the stages, regularized serially
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_convexify_set\n", field);
@@ -518,7 +522,7 @@ void ocp_nlp_reg_convexify_regularize(void *config, ocp_nlp_reg_dims *dims, void
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -579,13 +583,8 @@ void ocp_nlp_reg_convexify_regularize(void *config, ocp_nlp_reg_dims *dims, void
         // printf("BAQ\n");
         // blasfeo_print_dmat(nx+nu, nx, &BAQ, 0, 0);
 
-        blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R has an eigenvalue below 1e-10 iff its shifted cholesky factorization fails
+        bool needs_regularization = !acados_reg_eig_above(nu[ii], mem->RSQrq[ii], 0, 0, 1e-10, &mem->L);
 
         if (needs_regularization)
         {
@@ -657,7 +656,7 @@ void ocp_nlp_reg_convexify_regularize_lhs(void *config, ocp_nlp_reg_dims *dims,
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -691,13 +690,8 @@ void ocp_nlp_reg_convexify_regularize_lhs(void *config, ocp_nlp_reg_dims *dims,
 
         // blasfeo_drowex(nu[ii]+nx[ii], 1.0, mem->RSQrq[ii], nu[ii]+nx[ii], 0, mem->rq[ii], 0);
 
-        blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R has an eigenvalue below 1e-10 iff its shifted cholesky factorization fails
+        bool needs_regularization = !acados_reg_eig_above(nu[ii], mem->RSQrq[ii], 0, 0, 1e-10, &mem->L);
 
         if (needs_regularization)
         {
@@ -744,7 +738,7 @@ void ocp_nlp_reg_convexify_regularize_rhs(void *config, ocp_nlp_reg_dims *dims,
     ocp_nlp_reg_convexify_memory *mem = mem_;
     ocp_nlp_reg_convexify_opts *opts = opts_;
 
-    int ii, jj;
+    int ii;
 
     int *nx = dims->nx;
     int *nu = dims->nu;
@@ -782,13 +776,8 @@ void ocp_nlp_reg_convexify_regularize_rhs(void *config, ocp_nlp_reg_dims *dims,
 
         blasfeo_drowex(nu[ii]+nx[ii], 1.0, mem->RSQrq[ii], nu[ii]+nx[ii], 0, mem->rq[ii], 0);
 
-        blasfeo_unpack_dmat(nu[ii], nu[ii], mem->RSQrq[ii], 0, 0, mem->R, nu[ii]);
-        acados_eigen_decomposition(nu[ii], mem->R, mem->V, mem->d, mem->e);
-
-        bool needs_regularization = false;
-        for (jj = 0; jj < nu[ii]; jj++)
-            if (mem->d[jj] < 1e-10)
-                needs_regularization = true;
+        // R has an eigenvalue below 1e-10 iff its shifted cholesky factorization fails
+        bool needs_regularization = !acados_reg_eig_above(nu[ii], mem->RSQrq[ii], 0, 0, 1e-10, &mem->L);
 
         if (needs_regularization)
         {
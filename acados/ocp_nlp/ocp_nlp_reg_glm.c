@@ -227,6 +227,12 @@ void ocp_nlp_reg_glm_memory_set_lam_ptr(ocp_nlp_reg_dims *dims, struct blasfeo_d
 void ocp_nlp_reg_glm_memory_set(void *config_, ocp_nlp_reg_dims *dims, void *memory_, char *field, void *value)
 {
     // TODO: remove this function in all regularizaiton modules
+    if(!strcmp(field, "thread_pool"))
+    {
+        // gershgorin estimates only, cheap enough to run serially
+        return;
+    }
+
     printf("\nerror: field %s not available in ocp_nlp_reg_glm_set\n", field);
     exit(1);
 
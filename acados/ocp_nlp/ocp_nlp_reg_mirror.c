@@ -38,6 +38,7 @@
 
 #include "acados/ocp_nlp/ocp_nlp_reg_common.h"
 #include "acados/utils/math.h"
+#include "acados/utils/mem.h"
 
 #include "blasfeo_d_aux.h"
 #include "blasfeo_d_blas.h"
@@ -124,21 +125,23 @@ acados_size_t ocp_nlp_reg_mirror_memory_calculate_size(void *config_, ocp_nlp_re
 
     int ii;
 
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
-
     acados_size_t size = 0;
 
     size += sizeof(ocp_nlp_reg_mirror_memory);
 
-    size += nuxM*nuxM*sizeof(double);  // reg_hess
-    size += nuxM*nuxM*sizeof(double);  // V
-    size += 2*nuxM*sizeof(double);     // d e
+    size += 4*(N+1)*sizeof(double *);  // reg_hess V d e
+    size += (N+1)*sizeof(struct blasfeo_dmat);  // L
     size += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
 
+    for(ii=0; ii<=N; ii++)
+    {
+        size += 2*(nu[ii]+nx[ii])*(nu[ii]+nx[ii])*sizeof(double);  // reg_hess V
+        size += 2*(nu[ii]+nx[ii])*sizeof(double);  // d e
+        size += blasfeo_memsize_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii]);  // L
+    }
+
+    size += 1 * 64;  // blasfeo_mem align
+
     return size;
 }
 
@@ -150,34 +153,53 @@ void *ocp_nlp_reg_mirror_memory_assign(void *config_, ocp_nlp_reg_dims *dims, vo
     int *nu = dims->nu;
     int N = dims->N;
 
-    int ii;
-
-    int nuxM = nu[0]+nx[0];
-    for(ii=1; ii<=N; ii++)
-    {
-        nuxM = nu[ii]+nx[ii]>nuxM ? nu[ii]+nx[ii] : nuxM;
-    }
+    int ii, nux;
 
     char *c_ptr = (char *) raw_memory;
 
     ocp_nlp_reg_mirror_memory *mem = (ocp_nlp_reg_mirror_memory *) c_ptr;
     c_ptr += sizeof(ocp_nlp_reg_mirror_memory);
 
-    mem->reg_hess = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // reg_hess
+    mem->reg_hess = (double **) c_ptr;
+    c_ptr += (N+1)*sizeof(double *);  // reg_hess
+
+    mem->V = (double **) c_ptr;
+    c_ptr += (N+1)*sizeof(double *);  // V
 
-    mem->V = (double *) c_ptr;
-    c_ptr += nuxM*nuxM*sizeof(double);  // V
+    mem->d = (double **) c_ptr;
+    c_ptr += (N+1)*sizeof(double *);  // d
 
-    mem->d = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // d
+    mem->e = (double **) c_ptr;
+    c_ptr += (N+1)*sizeof(double *);  // e
 
-    mem->e = (double *) c_ptr;
-    c_ptr += nuxM*sizeof(double); // e
+    mem->L = (struct blasfeo_dmat *) c_ptr;
+    c_ptr += (N+1)*sizeof(struct blasfeo_dmat);  // L
 
     mem->RSQrq = (struct blasfeo_dmat **) c_ptr;
     c_ptr += (N+1)*sizeof(struct blasfeo_dmat *); // RSQrq
 
+    for(ii=0; ii<=N; ii++)
+    {
+        nux = nu[ii]+nx[ii];
+        mem->reg_hess[ii] = (double *) c_ptr;
+        c_ptr += nux*nux*sizeof(double);
+        mem->V[ii] = (double *) c_ptr;
+        c_ptr += nux*nux*sizeof(double);
+        mem->d[ii] = (double *) c_ptr;
+        c_ptr += nux*sizeof(double);
+        mem->e[ii] = (double *) c_ptr;
+        c_ptr += nux*sizeof(double);
+    }
+
+    align_char_to(64, &c_ptr);
+
+    for(ii=0; ii<=N; ii++)
+    {
+        assign_and_advance_blasfeo_dmat_mem(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->L+ii, &c_ptr);
+    }
+
+    mem->thread_pool = NULL;
+
     assert((char *) mem + ocp_nlp_reg_mirror_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -270,6 +292,11 @@ void ocp_nlp_reg_mirror_memory_set(void *config_, ocp_nlp_reg_dims *dims, void *
         struct blasfeo_dmat *RSQrq = value;
         ocp_nlp_reg_mirror_memory_set_RSQrq_ptr(dims, RSQrq, memory_);
     }
+    else if(!strcmp(field, "thread_pool"))
+    {
+        ocp_nlp_reg_mirror_memory *memory = memory_;
+        memory->thread_pool = value;
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_mirror_set\n", field);
@@ -285,45 +312,67 @@ void ocp_nlp_reg_mirror_memory_set(void *config_, ocp_nlp_reg_dims *dims, void *
  * functions
  ************************************************/
 
-void ocp_nlp_reg_mirror_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
+typedef struct
 {
-    ocp_nlp_reg_mirror_memory *mem = (ocp_nlp_reg_mirror_memory *) mem_;
-    ocp_nlp_reg_mirror_opts *opts = opts_;
+    ocp_nlp_reg_dims *dims;
+    ocp_nlp_reg_mirror_opts *opts;
+    ocp_nlp_reg_mirror_memory *mem;
+} ocp_nlp_reg_mirror_stage_args;
 
-    int ii;
 
-    int *nx = dims->nx;
-    int *nu = dims->nu;
-    // int N = dims->N;
 
-    for(ii=0; ii<=dims->N; ii++)
+static void ocp_nlp_reg_mirror_regularize_stage(void *args_, int ii)
+{
+    ocp_nlp_reg_mirror_stage_args *args = args_;
+    ocp_nlp_reg_mirror_memory *mem = args->mem;
+    ocp_nlp_reg_mirror_opts *opts = args->opts;
+
+    int nux = args->dims->nu[ii]+args->dims->nx[ii];
+
+    // make symmetric
+    blasfeo_dtrtr_l(nux, mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
+
+    // all eigenvalues above the (largest possible) threshold: mirroring leaves the block unchanged
+    double eps = opts->epsilon;
+    if (opts->adaptive_eps)
+        eps = MAX(acados_reg_eig_abs_bound(nux, mem->RSQrq[ii], 0, 0)/opts->max_cond_block, opts->min_epsilon);
+    if (acados_reg_eig_above(nux, mem->RSQrq[ii], 0, 0, eps, mem->L+ii))
+        return;
+
+    // regularize
+    blasfeo_unpack_dmat(nux, nux, mem->RSQrq[ii], 0, 0, mem->reg_hess[ii], nux);
+    if (opts->adaptive_eps)
+    {
+        acados_mirror_adaptive_eps(nux, mem->reg_hess[ii], mem->V[ii], mem->d[ii], mem->e[ii], opts->max_cond_block, opts->min_epsilon);
+    }
+    else
     {
-        // make symmetric
-        blasfeo_dtrtr_l(nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->RSQrq[ii], 0, 0);
-
-        // regularize
-        blasfeo_unpack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0, mem->reg_hess, nu[ii]+nx[ii]);
-        if (opts->adaptive_eps)
-        {
-            acados_mirror_adaptive_eps(nu[ii]+nx[ii], mem->reg_hess, mem->V, mem->d, mem->e, opts->max_cond_block, opts->min_epsilon);
-        }
-        else
-        {
-            acados_mirror(nu[ii]+nx[ii], mem->reg_hess, mem->V, mem->d, mem->e, opts->epsilon);
-        }
-        blasfeo_pack_dmat(nu[ii]+nx[ii], nu[ii]+nx[ii], mem->reg_hess, nu[ii]+nx[ii], mem->RSQrq[ii], 0, 0);
+        acados_mirror(nux, mem->reg_hess[ii], mem->V[ii], mem->d[ii], mem->e[ii], opts->epsilon);
     }
+    blasfeo_pack_dmat(nux, nux, mem->reg_hess[ii], nux, mem->RSQrq[ii], 0, 0);
 }
 
 
 
+void ocp_nlp_reg_mirror_regularize(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
+{
+    ocp_nlp_reg_mirror_memory *mem = (ocp_nlp_reg_mirror_memory *) mem_;
+
+    ocp_nlp_reg_mirror_stage_args args;
+    args.dims = dims;
+    args.opts = opts_;
+    args.mem = mem;
+
+    ocp_nlp_reg_parallel_for(mem->thread_pool, dims->N+1, &ocp_nlp_reg_mirror_regularize_stage, &args);
+}
+
+
 void ocp_nlp_reg_mirror_regularize_lhs(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
 {
     ocp_nlp_reg_mirror_regularize(config, dims, opts_, mem_);
 }
 
 
-
 void ocp_nlp_reg_mirror_regularize_rhs(void *config, ocp_nlp_reg_dims *dims, void *opts_, void *mem_)
 {
     return;
@@ -367,3 +416,4 @@ void ocp_nlp_reg_mirror_config_initialize_default(ocp_nlp_reg_config *config)
     config->regularize_lhs = &ocp_nlp_reg_mirror_regularize_lhs;
     config->correct_dual_sol = &ocp_nlp_reg_mirror_correct_dual_sol;
 }
+
@@ -86,10 +86,14 @@ void ocp_nlp_reg_mirror_opts_set(void *config_, void *opts_, const char *field,
 
 typedef struct
 {
-    double *reg_hess; // TODO move to workspace
-    double *V; // TODO move to workspace
-    double *d; // TODO move to workspace
-    double *e; // TODO move to workspace
+    // per stage, such that the stages can be regularized in parallel
+    double **reg_hess; // TODO move to workspace
+    double **V; // TODO move to workspace
+    double **d; // TODO move to workspace
+    double **e; // TODO move to workspace
+    struct blasfeo_dmat *L;  // cholesky-with-shift test
+
+    acados_thread_pool *thread_pool;  // not owned, NULL -> OpenMP / serial
 
     // giaf's
     struct blasfeo_dmat **RSQrq;  // pointer to RSQrq in qp_in
@@ -167,6 +167,11 @@ void ocp_nlp_reg_noreg_memory_set_lam_ptr(ocp_nlp_reg_dims *dims, struct blasfeo
 
 void ocp_nlp_reg_noreg_memory_set(void *config_, ocp_nlp_reg_dims *dims, void *memory_, char *field, void *value)
 {
+    if(!strcmp(field, "thread_pool"))
+    {
+        // nothing to regularize
+        return;
+    }
 
     printf("\nerror: field %s not available in ocp_nlp_reg_noreg_set\n", field);
     exit(1);
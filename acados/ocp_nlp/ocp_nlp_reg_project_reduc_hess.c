@@ -314,6 +314,10 @@ void ocp_nlp_reg_project_reduc_hess_memory_set(void *config_, ocp_nlp_reg_dims *
         struct blasfeo_dmat *BAbt = value;
         ocp_nlp_reg_project_reduc_hess_memory_set_BAbt_ptr(dims, BAbt, memory_);
     }
+    else if(!strcmp(field, "thread_pool"))
+    {
+        // backward recursion over the stages, regularized serially
+    }
     else
     {
         printf("\nerror: field %s not available in ocp_nlp_reg_project_reduc_hess_set\n", field);
@@ -373,33 +377,36 @@ void ocp_nlp_reg_project_reduc_hess_regularize(void *config, ocp_nlp_reg_dims *d
         blasfeo_dgese(nu[ss]+nx[ss], nu[ss]+nx[ss], 0.0, L3, 0, 0);
         blasfeo_dgecp(nu[ss]+nx[ss], nu[ss], L, 0, 0, L3, 0, 0);
 
-        // project L_R
-        blasfeo_unpack_dmat(nu[ss], nu[ss], L, 0, 0, mem->reg_hess, nu[ss]);
-        acados_eigen_decomposition(nu[ss], mem->reg_hess, mem->V, mem->d, mem->e);
+        // project L_R, skip the eigen decomposition if all eigenvalues are above thr_eig
         do_reg = 0;
-        for(jj=0; jj<nu[ss]; jj++)
+        if(!acados_reg_eig_above(nu[ss], L, 0, 0, opts->thr_eig, L2))
         {
-            if(mem->d[jj]<opts->thr_eig)
+            blasfeo_unpack_dmat(nu[ss], nu[ss], L, 0, 0, mem->reg_hess, nu[ss]);
+            acados_eigen_decomposition(nu[ss], mem->reg_hess, mem->V, mem->d, mem->e);
+            for(jj=0; jj<nu[ss]; jj++)
             {
-                mem->e[jj] = opts->min_eig - mem->d[jj];
-                do_reg = 1;
+                if(mem->d[jj]<opts->thr_eig)
+                {
+                    mem->e[jj] = opts->min_eig - mem->d[jj];
+                    do_reg = 1;
+                }
+                else
+                {
+                    mem->e[jj] = 0.0;
+                }
             }
-            else
+            if(do_reg)
             {
-                mem->e[jj] = 0.0;
+                acados_reconstruct_A(nu[ss], mem->reg_hess, mem->V, mem->e);
+                blasfeo_dgese(nu[ss]+nx[ss], nu[ss]+nx[ss], 0.0, L2, 0, 0);
+                blasfeo_pack_dmat(nu[ss], nu[ss], mem->reg_hess, nu[ss], L2, 0, 0);
+
+                // apply reg to R
+                blasfeo_dgead(nu[ss], nu[ss], 1.0, L2, 0, 0, mem->RSQrq[ss], 0, 0);
+                // apply reg to L
+                blasfeo_dgead(nu[ss], nu[ss], 1.0, L2, 0, 0, L, 0, 0);
             }
         }
-        if(do_reg)
-        {
-            acados_reconstruct_A(nu[ss], mem->reg_hess, mem->V, mem->e);
-            blasfeo_dgese(nu[ss]+nx[ss], nu[ss]+nx[ss], 0.0, L2, 0, 0);
-            blasfeo_pack_dmat(nu[ss], nu[ss], mem->reg_hess, nu[ss], L2, 0, 0);
-
-            // apply reg to R
-            blasfeo_dgead(nu[ss], nu[ss], 1.0, L2, 0, 0, mem->RSQrq[ss], 0, 0);
-            // apply reg to L
-            blasfeo_dgead(nu[ss], nu[ss], 1.0, L2, 0, 0, L, 0, 0);
-        }
 
         // compute reg_schur
         blasfeo_dgecp(nu[ss]+nx[ss], nu[ss], L, 0, 0, L2, 0, 0);
@@ -492,18 +499,22 @@ void ocp_nlp_reg_project_reduc_hess_regularize(void *config, ocp_nlp_reg_dims *d
     blasfeo_dgemm_nt(nu[ss]+nx[ss], nx[ss+1], nx[ss+1], 1.0, mem->BAbt[ss], 0, 0, P, 0, 0, 0.0, AL, 0, 0, AL, 0, 0); // TODO symm
     blasfeo_dsyrk_ln(nu[ss]+nx[ss], nx[ss+1], 1.0, AL, 0, 0, mem->BAbt[ss], 0, 0, 1.0, mem->RSQrq[ss], 0, 0, L, 0, 0);
     blasfeo_dtrtr_l(nu[ss]+nx[ss], L, 0, 0, L, 0, 0); // necessary ???
-    blasfeo_unpack_dmat(nu[ss]+nx[ss], nu[ss]+nx[ss], L, 0, 0, mem->reg_hess, nu[ss]+nx[ss]);
-    acados_eigen_decomposition(nu[ss]+nx[ss], mem->reg_hess, mem->V, mem->d, mem->e);
-    for(jj=0; jj<nu[ss]+nx[ss]; jj++)
+    // the correction is zero if all eigenvalues are above thr_eig
+    if(!acados_reg_eig_above(nu[ss]+nx[ss], L, 0, 0, opts->thr_eig, L2))
     {
-        if(mem->d[jj]<opts->thr_eig)
-            mem->e[jj] = opts->min_eig - mem->d[jj];
-        else
-            mem->e[jj] = 0.0;
+        blasfeo_unpack_dmat(nu[ss]+nx[ss], nu[ss]+nx[ss], L, 0, 0, mem->reg_hess, nu[ss]+nx[ss]);
+        acados_eigen_decomposition(nu[ss]+nx[ss], mem->reg_hess, mem->V, mem->d, mem->e);
+        for(jj=0; jj<nu[ss]+nx[ss]; jj++)
+        {
+            if(mem->d[jj]<opts->thr_eig)
+                mem->e[jj] = opts->min_eig - mem->d[jj];
+            else
+                mem->e[jj] = 0.0;
+        }
+        acados_reconstruct_A(nu[ss]+nx[ss], mem->reg_hess, mem->V, mem->e);
+        blasfeo_pack_dmat(nu[ss]+nx[ss], nu[ss]+nx[ss], mem->reg_hess, nu[ss]+nx[ss], L2, 0, 0);
+        blasfeo_dgead(nu[ss]+nx[ss], nu[ss]+nx[ss], 1.0, L2, 0, 0, mem->RSQrq[ss], 0, 0);
     }
-    acados_reconstruct_A(nu[ss]+nx[ss], mem->reg_hess, mem->V, mem->e);
-    blasfeo_pack_dmat(nu[ss]+nx[ss], nu[ss]+nx[ss], mem->reg_hess, nu[ss]+nx[ss], L2, 0, 0);
-    blasfeo_dgead(nu[ss]+nx[ss], nu[ss]+nx[ss], 1.0, L2, 0, 0, mem->RSQrq[ss], 0, 0);
 
 
 //    printf("\nhessian after\n");
@@ -54,6 +54,7 @@
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
+#include "acados/utils/trace.h"
 #include "acados/utils/types.h"
 #include "acados/utils/strsep.h"
 #include "acados_c/ocp_qp_interface.h"
@@ -593,9 +594,11 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
     double timeout_previous_time_tot = 0.;
     double timeout_time_prev_iter = 0.;
+    double tmp_time;
 
     for (; nlp_mem->iter <= opts->nlp_opts->max_iter; nlp_mem->iter++) // <= needed such that after last iteration KKT residuals are checked before max_iter is thrown.
     {
+        ACADOS_TRACE_BEGIN("sqp_iter");
         // We always evaluate the residuals until the last iteration
         // If the option "eval_residual_at_max_iter" is set, we also
         // evaluate the residuals after the last iteration.
@@ -608,20 +611,33 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             }
             /* Prepare the QP data */
             // linearize NLP and update QP matrices
+            ACADOS_TRACE_BEGIN("linearization");
             acados_tic(&timer1);
-            ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
-            // update QP rhs for SQP (step prim var, abs dual var)
-            ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+            if (nlp_opts->fuse_stage_evaluations)
+            {
+                // linearize, update QP and compute nlp residuals in one pass over the stages
+                ocp_nlp_approximate_qp_fused(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, nlp_res);
+            }
+            else
+            {
+                ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+                // update QP rhs for SQP (step prim var, abs dual var)
+                ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
+            }
 
             if (nlp_opts->with_adaptive_levenberg_marquardt || config->globalization->needs_objective_value() == 1)
             {
                 ocp_nlp_get_cost_value_from_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
             }
             ocp_nlp_add_levenberg_marquardt_term(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, mem->alpha, nlp_mem->iter, nlp_mem->qp_in);
-            nlp_timings->time_lin += acados_toc(&timer1);
+            tmp_time = acados_toc(&timer1);
+            nlp_timings->time_lin += tmp_time;
+            ocp_nlp_timings_update_estimate(&nlp_timings->est_time_lin, tmp_time);
+            ACADOS_TRACE_END("linearization");
 
             // compute nlp residuals
-            ocp_nlp_res_compute(dims, nlp_opts, nlp_in, nlp_out, nlp_res, nlp_mem, nlp_work);
+            if (!nlp_opts->fuse_stage_evaluations)
+                ocp_nlp_res_compute(dims, nlp_opts, nlp_in, nlp_out, nlp_res, nlp_mem, nlp_work);
             ocp_nlp_res_get_inf_norm(nlp_res, &nlp_out->inf_norm_res);
         }
 
@@ -702,6 +718,25 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             omp_set_num_threads(num_threads_bkp);
 #endif
             nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("sqp_iter");
+            return nlp_mem->status;
+        }
+
+        // anytime exit after the termination check: keep the current iterate, with its residuals,
+        // if the step and the next linearization cannot be completed before the deadline
+        if (!ocp_nlp_deadline_fits(nlp_opts, ocp_nlp_deadline_predict_iteration(nlp_timings)))
+        {
+            if (nlp_opts->print_level > 0)
+            {
+                printf("Stopped: Deadline reached in SQP iteration %d.\n", nlp_mem->iter);
+            }
+#if defined(ACADOS_WITH_OPENMP)
+            // restore number of threads
+            omp_set_num_threads(num_threads_bkp);
+#endif
+            nlp_mem->status = ACADOS_DEADLINE;
+            nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("sqp_iter");
             return nlp_mem->status;
         }
 
@@ -733,7 +768,18 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 #if defined(ACADOS_DEBUG_SQP_PRINT_QPS_TO_FILE)
         ocp_nlp_dump_qp_in_to_file(qp_in, nlp_mem->iter, 0);
 #endif
-        qp_status = ocp_nlp_solve_qp_and_correct_dual(config, dims, nlp_opts, nlp_mem, nlp_work, false, NULL, NULL, NULL);
+        // reuse the condensed QP matrices of the previous solve if no stage changed them
+        bool reuse_qp_lhs = !(nlp_mem->iter == 0 && opts->warm_start_first_qp_from_nlp) &&
+                            ocp_nlp_qp_lhs_unchanged(dims, nlp_opts, nlp_mem);
+        if (reuse_qp_lhs)
+        {
+            nlp_mem->num_qp_lhs_reused++;
+            // condense_rhs_and_solve accumulates into the qp timings
+            ocp_qp_out_get(qp_out, "qp_info", &qp_info_);
+            qp_info_->condensing_time = 0.0;
+            qp_info_->total_time = 0.0;
+        }
+        qp_status = ocp_nlp_solve_qp_and_correct_dual(config, dims, nlp_opts, nlp_mem, nlp_work, reuse_qp_lhs, NULL, NULL, NULL);
 
         // restore default warm start
         if (nlp_mem->iter==0)
@@ -799,6 +845,7 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
             nlp_mem->status = ACADOS_QP_FAILURE;
             nlp_timings->time_tot = acados_toc(&timer0);
+            ACADOS_TRACE_END("sqp_iter");
 
             return nlp_mem->status;
         }
@@ -827,9 +874,11 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
         /* globalization */
         // NOTE on timings: currently all within globalization is accounted for within time_glob.
         //   QP solver times could be also attributed there alternatively. Cleanest would be to save them seperately.
+        ACADOS_TRACE_BEGIN("globalization");
         acados_tic(&timer1);
         globalization_status = config->globalization->find_acceptable_iterate(config, dims, nlp_in, nlp_out, nlp_mem, mem, nlp_work, nlp_opts, &mem->alpha);
         nlp_timings->time_glob += acados_toc(&timer1);
+        ACADOS_TRACE_END("globalization");
 
         if (globalization_status != ACADOS_SUCCESS)
         {
@@ -843,10 +892,12 @@ int ocp_nlp_sqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             // restore number of threads
             omp_set_num_threads(num_threads_bkp);
 #endif
+            ACADOS_TRACE_END("sqp_iter");
             return nlp_mem->status;
         }
         if (nlp_mem->iter+1 < mem->stat_m)
             mem->stat[mem->stat_n*(nlp_mem->iter+1)+6] = mem->alpha;
+        ACADOS_TRACE_END("sqp_iter");
 
     }  // end SQP loop
 
@@ -910,6 +961,7 @@ void ocp_nlp_sqp_memory_reset_qp_solver(void *config_, void *dims_, void *nlp_in
     config->qp_solver->memory_reset(qp_solver, dims->qp_solver,
         nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
         nlp_mem->qp_solver_mem, nlp_work->qp_work);
+    nlp_mem->qp_lhs_valid = false;
 }
 
 
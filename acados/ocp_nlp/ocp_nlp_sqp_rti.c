@@ -53,6 +53,7 @@
 #include "acados/utils/mem.h"
 #include "acados/utils/print.h"
 #include "acados/utils/timing.h"
+#include "acados/utils/trace.h"
 #include "acados/utils/types.h"
 #include "acados/utils/strsep.h"
 // acados_c
@@ -121,6 +122,7 @@ void ocp_nlp_sqp_rti_opts_initialize_default(void *config_,
     opts->as_rti_iter = 0;
     opts->rti_log_residuals = 0;
     opts->rti_log_only_available_residuals = 0;
+    opts->rti_async_preparation = 0;
 
     return;
 }
@@ -191,6 +193,11 @@ void ocp_nlp_sqp_rti_opts_set(void *config_, void *opts_,
             int* rti_log_only_available_residuals = (int *) value;
             opts->rti_log_only_available_residuals = *rti_log_only_available_residuals;
         }
+        else if (!strcmp(field, "rti_async_preparation"))
+        {
+            int* rti_async_preparation = (int *) value;
+            opts->rti_async_preparation = *rti_async_preparation;
+        }
         else if (!strcmp(field, "warm_start_first_qp_from_nlp"))
         {
             bool* warm_start_first_qp_from_nlp = (bool *) value;
@@ -259,6 +266,11 @@ acados_size_t ocp_nlp_sqp_rti_memory_calculate_size(void *config_,
         stat_n += 4;  // qp_res
     size += stat_n*stat_m*sizeof(double);
 
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    // stage timings of the asynchronous preparation
+    size += 3*(dims->N+1)*sizeof(double);
+#endif
+
     size += 8;  // initial align
 
     make_int_multiple_of(8, &size);
@@ -307,6 +319,18 @@ void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_,
     mem->nlp_mem->status = ACADOS_READY;
     mem->is_first_call = true;
 
+    mem->timings = mem->nlp_mem->nlp_timings;
+
+    mem->async_task = NULL;
+    mem->async_preparation_pending = false;
+    mem->async_time_preparation = 0.0;
+    mem->async_timings = *mem->timings;
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    assign_and_advance_double(dims->N+1, &mem->async_timings.time_lin_dyn_stage, &c_ptr);
+    assign_and_advance_double(dims->N+1, &mem->async_timings.time_lin_cost_stage, &c_ptr);
+    assign_and_advance_double(dims->N+1, &mem->async_timings.time_lin_constr_stage, &c_ptr);
+#endif
+
     assert((char *) raw_memory+ocp_nlp_sqp_rti_memory_calculate_size(
         config, dims, opts, in) >= c_ptr);
 
@@ -413,6 +437,7 @@ static void prepare_full_residual_computation(ocp_nlp_config *config,
         // dynamics: evaluate function and adjoint
         config->dynamics[i]->compute_fun_and_adj(config->dynamics[i], dims->dynamics[i], in->dynamics[i],
                                          opts->dynamics[i], mem->dynamics[i], work->dynamics[i]);
+        ocp_nlp_memo_invalidate_stage(mem, i);
     }
 
     for (int i=0; i <= N; i++)
@@ -420,6 +445,7 @@ static void prepare_full_residual_computation(ocp_nlp_config *config,
         // constraints: evaluate function and adjoint
         config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i], in->constraints[i],
                                          opts->constraints[i], mem->constraints[i], work->constraints[i]);
+        ocp_nlp_memo_invalidate_stage(mem, i);
         struct blasfeo_dvec *ineq_adj =
             config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
         blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
@@ -432,6 +458,7 @@ static void prepare_full_residual_computation(ocp_nlp_config *config,
     {
         // nlp mem: cost_grad
         config->cost[i]->compute_gradient(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i], mem->cost[i], work->cost[i]);
+        ocp_nlp_memo_invalidate_stage(mem, i);
         struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
         blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
 
@@ -464,7 +491,8 @@ static void prepare_full_residual_computation(ocp_nlp_config *config,
  ************************************************/
 
 static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
-    ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
+    ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work,
+    rti_phase_t rti_phase, bool reset_stats)
 {
     acados_timer timer1;
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
@@ -474,7 +502,9 @@ static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dim
     ocp_nlp_workspace *nlp_work = work->nlp_work;
     ocp_nlp_timings *timings = nlp_mem->nlp_timings;
 
-    reset_stats_and_sub_timers(mem);
+    ACADOS_TRACE_BEGIN("rti_preparation");
+    if (reset_stats)
+        reset_stats_and_sub_timers(mem);
 #if defined(ACADOS_WITH_OPENMP)
     // backup number of threads
     int num_threads_bkp = omp_get_num_threads();
@@ -486,14 +516,19 @@ static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dim
     ocp_nlp_initialize_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
 
     // linearize NLP and update QP matrices
+    ACADOS_TRACE_BEGIN("linearization");
     acados_tic(&timer1);
     ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
     ocp_nlp_add_levenberg_marquardt_term(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, 1.0, 0, nlp_mem->qp_in);
 
-    timings->time_lin += acados_toc(&timer1);
+    double tmp_time = acados_toc(&timer1);
+    timings->time_lin += tmp_time;
+    ocp_nlp_timings_update_estimate(&timings->est_time_lin, tmp_time);
+    ACADOS_TRACE_END("linearization");
 
-    if (opts->rti_phase == PREPARATION)
+    // rti_phase is passed explicitly, since opts->rti_phase may be set during an asynchronous preparation
+    if (rti_phase != PREPARATION_AND_FEEDBACK)
     {
         // regularize Hessian
         acados_tic(&timer1);
@@ -501,16 +536,19 @@ static void ocp_nlp_sqp_rti_preparation_step(ocp_nlp_config *config, ocp_nlp_dim
             dims->regularize, opts->nlp_opts->regularize, nlp_mem->regularize);
         timings->time_reg += acados_toc(&timer1);
         // condense lhs
+        ACADOS_TRACE_BEGIN("condensing_lhs");
         acados_tic(&timer1);
         qp_solver->condense_lhs(qp_solver, dims->qp_solver,
             nlp_mem->qp_in, nlp_mem->qp_out, opts->nlp_opts->qp_solver_opts,
             nlp_mem->qp_solver_mem, nlp_work->qp_work);
         timings->time_qp_sol += acados_toc(&timer1);
+        ACADOS_TRACE_END("condensing_lhs");
     }
 #if defined(ACADOS_WITH_OPENMP)
     // restore number of threads
     omp_set_num_threads(num_threads_bkp);
 #endif
+    ACADOS_TRACE_END("rti_preparation");
 
     return;
 }
@@ -563,6 +601,15 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
     }
     timings->time_reg += acados_toc(&timer1);
 
+    // skip the QP if not even a single QP iteration and the step can be completed before the deadline
+    if (!ocp_nlp_deadline_fits(nlp_opts, 2*timings->est_time_qp_iter + timings->est_time_glob_trial))
+    {
+        mem->stat[mem->stat_n * nlp_mem->iter+0] = ACADOS_DEADLINE;
+        mem->stat[mem->stat_n * nlp_mem->iter+1] = 0;
+        mem->nlp_mem->status = ACADOS_DEADLINE;
+        return;
+    }
+
     if (nlp_opts->print_level > 0) {
         printf("\n------- qp_in --------\n");
         print_ocp_qp_in(nlp_mem->qp_in);
@@ -647,6 +694,11 @@ static void ocp_nlp_sqp_rti_feedback_step(ocp_nlp_config *config, ocp_nlp_dims *
         }
     }
     mem->nlp_mem->status = ACADOS_SUCCESS;
+    if (globalization_status == ACADOS_DEADLINE || (qp_status == ACADOS_MAXITER && nlp_mem->deadline_qp_iter_max > 0))
+    {
+        // QP iterations or step were cut short to meet the deadline
+        mem->nlp_mem->status = ACADOS_DEADLINE;
+    }
     mem->is_first_call = false;
 
     if (opts->rti_log_residuals && !opts->rti_log_only_available_residuals)
@@ -717,8 +769,8 @@ static void as_rti_advance_problem(ocp_nlp_config *config, ocp_nlp_dims *dims, o
     else if (opts->as_rti_advancement_strategy == SIMULATE_ADVANCE)
     {
         // dyn_fun = phi(x_0, u_0) - x_1
-        config->dynamics[0]->compute_fun(config->dynamics[0], dims->dynamics[0], nlp_in->dynamics[0],
-                            nlp_opts->dynamics[0], nlp_mem->dynamics[0], nlp_work->dynamics[0]);
+        ocp_nlp_dynamics_compute_fun_memo(config, dims, nlp_in, nlp_opts, nlp_mem, nlp_work, 0,
+                            nlp_out->ux+0, nlp_out->ux+1);
         struct blasfeo_dvec *dyn_fun = config->dynamics[0]->memory_get_fun_ptr(nlp_mem->dynamics[0]);
         // dyn_fun += x_1
         blasfeo_daxpy(dims->nx[0], +1.0, nlp_out->ux+1, dims->nu[1], dyn_fun, 0, dyn_fun, 0);
@@ -729,6 +781,7 @@ static void as_rti_advance_problem(ocp_nlp_config *config, ocp_nlp_dims *dims, o
     {
         ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "lbx", nlp_work->tmp_nv_double);
         ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "ubx", nlp_work->tmp_nv_double);
+        ocp_nlp_memo_invalidate_stage(nlp_mem, 0);
     }
     // printf("advanced x value\n");
     // blasfeo_print_exp_tran_dvec(dims->nx[1], nlp_out->ux+1, dims->nu[1]);
@@ -752,6 +805,7 @@ static void level_c_prepare_residual_computation(ocp_nlp_config *config,
         // constraints: evaluate function and adjoint
         config->constraints[i]->update_qp_matrices(config->constraints[i], dims->constraints[i], in->constraints[i],
                                          opts->constraints[i], mem->constraints[i], work->constraints[i]);
+        ocp_nlp_memo_invalidate_stage(mem, i);
         struct blasfeo_dvec *ineq_adj =
             config->constraints[i]->memory_get_adj_ptr(mem->constraints[i]);
         blasfeo_dveccp(nv[i], ineq_adj, 0, mem->ineq_adj + i, 0);
@@ -764,6 +818,7 @@ static void level_c_prepare_residual_computation(ocp_nlp_config *config,
     {
         // nlp mem: cost_grad
         config->cost[i]->compute_gradient(config->cost[i], dims->cost[i], in->cost[i], opts->cost[i], mem->cost[i], work->cost[i]);
+        ocp_nlp_memo_invalidate_stage(mem, i);
         struct blasfeo_dvec *cost_grad = config->cost[i]->memory_get_grad_ptr(mem->cost[i]);
         blasfeo_dveccp(nv[i], cost_grad, 0, mem->cost_grad + i, 0);
 
@@ -791,6 +846,17 @@ static void level_c_prepare_residual_computation(ocp_nlp_config *config,
 
 
 
+// check if one more AS-RTI iteration and the linearization of the RTI preparation fit before the deadline
+static bool as_rti_iteration_fits(ocp_nlp_opts *nlp_opts, ocp_nlp_timings *timings, bool with_linearization)
+{
+    double predicted_time = timings->est_time_lin + 2*timings->est_time_qp_iter + timings->est_time_glob_trial;
+    if (with_linearization)
+        predicted_time += timings->est_time_lin;
+    return ocp_nlp_deadline_fits(nlp_opts, predicted_time);
+}
+
+
+
 static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *nlp_in,
     ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts, ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
 {
@@ -828,7 +894,12 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
     }
 
     // if AS_RTI-A and not first call!
-    if (opts->as_rti_level == LEVEL_A && !mem->is_first_call)
+    if (opts->as_rti_level == LEVEL_A && !mem->is_first_call && !as_rti_iteration_fits(nlp_opts, timings, false))
+    {
+        // skip the advanced step QP, the RTI preparation is done at the current iterate
+        nlp_mem->status = ACADOS_DEADLINE;
+    }
+    else if (opts->as_rti_level == LEVEL_A && !mem->is_first_call)
     {
         // load iterate from tmp
         copy_ocp_nlp_out(dims, tmp_nlp_out, nlp_out);
@@ -892,6 +963,11 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
         // perform zero-order iterations
         for (; nlp_mem->iter < opts->as_rti_iter; nlp_mem->iter++)
         {
+            if (!as_rti_iteration_fits(nlp_opts, timings, false))
+            {
+                nlp_mem->status = ACADOS_DEADLINE;
+                break;
+            }
             acados_tic(&timer1);
             // zero order QP update
             ocp_nlp_zero_order_qp_update(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
@@ -961,6 +1037,11 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
         // perform iterations
         for (; nlp_mem->iter < opts->as_rti_iter; nlp_mem->iter++)
         {
+            if (!as_rti_iteration_fits(nlp_opts, timings, false))
+            {
+                nlp_mem->status = ACADOS_DEADLINE;
+                break;
+            }
             // double norm, tmp_norm = 0.0;
             acados_tic(&timer1);
             // QP update
@@ -1032,6 +1113,11 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
         // perform k full SQP iterations
         for (; nlp_mem->iter < opts->as_rti_iter; nlp_mem->iter++)
         {
+            if (!as_rti_iteration_fits(nlp_opts, timings, true))
+            {
+                nlp_mem->status = ACADOS_DEADLINE;
+                break;
+            }
             acados_tic(&timer1);
             // linearize NLP
             ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
@@ -1039,7 +1125,9 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
             ocp_nlp_add_levenberg_marquardt_term(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, 1.0, 0, nlp_mem->qp_in);
             ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in,
                 nlp_out, nlp_opts, nlp_mem, nlp_work);
-            timings->time_lin += acados_toc(&timer1);
+            double tmp_time = acados_toc(&timer1);
+            timings->time_lin += tmp_time;
+            ocp_nlp_timings_update_estimate(&timings->est_time_lin, tmp_time);
 
             if (opts->rti_log_residuals)
             {
@@ -1093,7 +1181,9 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
     ocp_nlp_approximate_qp_matrices(config, dims, nlp_in,
         nlp_out, nlp_opts, nlp_mem, nlp_work);
     ocp_nlp_add_levenberg_marquardt_term(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work, 1.0, 0, nlp_mem->qp_in);
-    timings->time_lin += acados_toc(&timer1);
+    double lin_time = acados_toc(&timer1);
+    timings->time_lin += lin_time;
+    ocp_nlp_timings_update_estimate(&timings->est_time_lin, lin_time);
 
     // regularize Hessian
     acados_tic(&timer1);
@@ -1120,6 +1210,111 @@ static void ocp_nlp_sqp_rti_preparation_advanced_step(ocp_nlp_config *config, oc
     return;
 }
 
+static void ocp_nlp_sqp_rti_async_preparation_task(void *args, int index)
+{
+    void **async_args = args;
+    ocp_nlp_sqp_rti_memory *mem = async_args[5];
+
+    acados_timer timer;
+    acados_tic(&timer);
+    // timings go to mem->async_timings, stats are reset once the preparation is completed
+    ocp_nlp_sqp_rti_preparation_step(async_args[0], async_args[1], async_args[2], async_args[3],
+        async_args[4], mem, async_args[6], PREPARATION, false);
+    mem->async_time_preparation = acados_toc(&timer);
+}
+
+
+
+static void ocp_nlp_sqp_rti_async_timings_merge(ocp_nlp_timings *dst, ocp_nlp_timings *src)
+{
+    dst->time_qp_sol += src->time_qp_sol;
+    dst->time_qp_solver_call += src->time_qp_solver_call;
+    dst->time_qp_xcond += src->time_qp_xcond;
+    dst->time_lin += src->time_lin;
+    dst->time_reg += src->time_reg;
+    dst->time_glob += src->time_glob;
+    dst->time_sim += src->time_sim;
+    dst->time_sim_la += src->time_sim_la;
+    dst->time_sim_ad += src->time_sim_ad;
+    dst->est_time_lin = src->est_time_lin;
+    dst->est_time_qp_iter = src->est_time_qp_iter;
+    dst->est_time_glob_trial = src->est_time_glob_trial;
+#if defined(ACADOS_WITH_STAGE_TIMINGS)
+    for (int i = 0; i <= dst->N; i++)
+    {
+        dst->time_lin_dyn_stage[i] += src->time_lin_dyn_stage[i];
+        dst->time_lin_cost_stage[i] += src->time_lin_cost_stage[i];
+        dst->time_lin_constr_stage[i] += src->time_lin_constr_stage[i];
+    }
+#endif
+}
+
+
+
+static void ocp_nlp_sqp_rti_async_preparation_start(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out, ocp_nlp_sqp_rti_opts *opts,
+    ocp_nlp_sqp_rti_memory *mem, ocp_nlp_sqp_rti_workspace *work)
+{
+    if (mem->async_task == NULL)
+        mem->async_task = acados_async_task_create();
+
+    mem->async_args[0] = config;
+    mem->async_args[1] = dims;
+    mem->async_args[2] = nlp_in;
+    mem->async_args[3] = nlp_out;
+    mem->async_args[4] = opts;
+    mem->async_args[5] = mem;
+    mem->async_args[6] = work;
+
+    // the preparation thread only writes its private timings, which start from the current estimates
+    ocp_nlp_timings_reset(&mem->async_timings);
+    mem->async_timings.est_time_lin = mem->timings->est_time_lin;
+    mem->async_timings.est_time_qp_iter = mem->timings->est_time_qp_iter;
+    mem->async_timings.est_time_glob_trial = mem->timings->est_time_glob_trial;
+    mem->nlp_mem->nlp_timings = &mem->async_timings;
+
+    // the setters of nlp_in and nlp_out wait for the preparation, see ocp_nlp_in_wait_async
+    nlp_in->async_task = mem->async_task;
+    nlp_out->async_task = mem->async_task;
+
+    mem->async_preparation_pending = true;
+    acados_async_task_start(mem->async_task, ocp_nlp_sqp_rti_async_preparation_task, mem->async_args);
+}
+
+
+
+// returns true if a preparation was pending and is completed now
+static bool ocp_nlp_sqp_rti_async_preparation_wait(ocp_nlp_sqp_rti_memory *mem)
+{
+    if (!mem->async_preparation_pending)
+        return false;
+
+    ACADOS_TRACE_BEGIN("rti_async_wait");
+    acados_async_task_wait(mem->async_task);
+    ACADOS_TRACE_END("rti_async_wait");
+    mem->async_preparation_pending = false;
+    ((ocp_nlp_in *) mem->async_args[2])->async_task = NULL;
+    ((ocp_nlp_out *) mem->async_args[3])->async_task = NULL;
+    mem->nlp_mem->nlp_timings = mem->timings;
+
+    // stats of the previous feedback were readable until now
+    reset_stats_and_sub_timers(mem);
+    ocp_nlp_sqp_rti_async_timings_merge(mem->timings, &mem->async_timings);
+    mem->timings->time_preparation = mem->async_time_preparation;
+
+    return true;
+}
+
+
+
+void ocp_nlp_sqp_rti_wait_async(void *config_, void *mem_)
+{
+    ocp_nlp_sqp_rti_memory *mem = mem_;
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
+}
+
+
+
 int ocp_nlp_sqp_rti_setup_qp_matrices_and_factorize(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
                 void *opts_, void *mem_, void *work_)
 {
@@ -1127,6 +1322,7 @@ int ocp_nlp_sqp_rti_setup_qp_matrices_and_factorize(void *config_, void *dims_,
     ocp_nlp_sqp_rti_memory *mem = mem_;
     ocp_nlp_sqp_rti_workspace *work = work_;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     return ocp_nlp_common_setup_qp_matrices_and_factorize(config_, dims_, nlp_in_, nlp_out_, opts->nlp_opts, mem->nlp_mem, work->nlp_work);
 }
 
@@ -1145,23 +1341,44 @@ int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     ocp_nlp_in *nlp_in = nlp_in_;
     ocp_nlp_out *nlp_out = nlp_out_;
     ocp_nlp_sqp_rti_workspace *work = work_;
-    ocp_nlp_timings *timings = mem->nlp_mem->nlp_timings;
+    // not nlp_mem->nlp_timings, which is private to a pending asynchronous preparation
+    ocp_nlp_timings *timings = mem->timings;
 
     int rti_phase = opts->rti_phase;
 
+    if (opts->rti_async_preparation && opts->as_rti_level != STANDARD_RTI)
+    {
+        printf("ocp_nlp_sqp_rti: rti_async_preparation not supported with AS-RTI (opts->as_rti_level != STANDARD_RTI).\n\n");
+        exit(1);
+    }
+
     if (rti_phase == FEEDBACK)
     {
+        ocp_nlp_sqp_rti_async_preparation_wait(mem);
+        ACADOS_TRACE_BEGIN("rti_feedback");
         ocp_nlp_sqp_rti_feedback_step(config, dims, nlp_in, nlp_out, opts, mem, work);
+        ACADOS_TRACE_END("rti_feedback");
         timings->time_feedback = acados_toc(&timer);
+        if (opts->rti_async_preparation)
+        {
+            // linearize at the new iterate while the caller applies the feedback
+            ocp_nlp_sqp_rti_async_preparation_start(config, dims, nlp_in, nlp_out, opts, mem, work);
+        }
     }
     else if (rti_phase == PREPARATION && opts->as_rti_level == STANDARD_RTI)
     {
-        ocp_nlp_sqp_rti_preparation_step(config, dims, nlp_in, nlp_out, opts, mem, work);
-        timings->time_preparation = acados_toc(&timer);
+        // a pending asynchronous preparation is only completed
+        if (!ocp_nlp_sqp_rti_async_preparation_wait(mem))
+        {
+            ocp_nlp_sqp_rti_preparation_step(config, dims, nlp_in, nlp_out, opts, mem, work, PREPARATION, true);
+            timings->time_preparation = acados_toc(&timer);
+        }
     }
     else if (rti_phase == PREPARATION)
     {
+        ACADOS_TRACE_BEGIN("rti_preparation");
         ocp_nlp_sqp_rti_preparation_advanced_step(config, dims, nlp_in, nlp_out, opts, mem, work);
+        ACADOS_TRACE_END("rti_preparation");
         timings->time_preparation = acados_toc(&timer);
     }
     else if (rti_phase == PREPARATION_AND_FEEDBACK && opts->as_rti_level != STANDARD_RTI)
@@ -1172,12 +1389,16 @@ int ocp_nlp_sqp_rti(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
     else if (rti_phase == PREPARATION_AND_FEEDBACK)
     {
         // rti_phase == PREPARATION_AND_FEEDBACK
-        ocp_nlp_sqp_rti_preparation_step(config, dims, nlp_in, nlp_out, opts, mem, work);
+        ocp_nlp_sqp_rti_async_preparation_wait(mem);
+        ocp_nlp_sqp_rti_preparation_step(config, dims, nlp_in, nlp_out, opts, mem, work,
+            PREPARATION_AND_FEEDBACK, true);
         timings->time_preparation = acados_toc(&timer);
 
         acados_timer timer_feedback;
         acados_tic(&timer_feedback);
+        ACADOS_TRACE_BEGIN("rti_feedback");
         ocp_nlp_sqp_rti_feedback_step(config, dims, nlp_in, nlp_out, opts, mem, work);
+        ACADOS_TRACE_END("rti_feedback");
         timings->time_feedback = acados_toc(&timer_feedback);
     }
     timings->time_tot = acados_toc(&timer);
@@ -1201,6 +1422,7 @@ void ocp_nlp_sqp_rti_eval_kkt_residual(void *config_, void *dims_, void *nlp_in_
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     ocp_nlp_initialize_submodules(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
     ocp_nlp_approximate_qp_matrices(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
     ocp_nlp_approximate_qp_vectors_sqp(config, dims, nlp_in, nlp_out, nlp_opts, nlp_mem, nlp_work);
@@ -1220,6 +1442,7 @@ void ocp_nlp_sqp_rti_memory_reset_qp_solver(void *config_, void *dims_, void *nl
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     mem->is_first_call = true;
 
     config->qp_solver->memory_reset(qp_solver, dims->qp_solver,
@@ -1239,6 +1462,7 @@ int ocp_nlp_sqp_rti_precompute(void *config_, void *dims_, void *nlp_in_,
     ocp_nlp_out *nlp_out = nlp_out_;
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     nlp_mem->workspace_size = ocp_nlp_workspace_calculate_size(config, dims, opts->nlp_opts, nlp_in);
 
     ocp_nlp_sqp_rti_workspace *work = work_;
@@ -1267,10 +1491,11 @@ void ocp_nlp_sqp_rti_eval_param_sens(void *config_, void *dims_, void *opts_,
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     ocp_nlp_common_eval_param_sens(config, dims, opts->nlp_opts, nlp_mem, nlp_work,
                                  field, stage, index, sens_nlp_out);
 
-    mem->nlp_mem->nlp_timings->time_solution_sensitivities = acados_toc(&timer0);
+    mem->timings->time_solution_sensitivities = acados_toc(&timer0);
 
     return;
 }
@@ -1289,6 +1514,7 @@ void ocp_nlp_sqp_rti_eval_lagr_grad_p(void *config_, void *dims_, void *nlp_in_,
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_workspace *nlp_work = work->nlp_work;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     ocp_nlp_common_eval_lagr_grad_p(config, dims, nlp_in, opts->nlp_opts, nlp_mem, nlp_work, field, grad_p);
 
     return;
@@ -1306,6 +1532,7 @@ void ocp_nlp_sqp_rti_eval_solution_sens_adj_p(void *config_, void *dims_,
     ocp_nlp_memory *nlp_mem = mem->nlp_mem;
     ocp_nlp_sqp_rti_workspace *work = work_;
     ocp_nlp_workspace *nlp_work = work->nlp_work;
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
     ocp_nlp_common_eval_solution_sens_adj_p(config, dims,
                         opts->nlp_opts, nlp_mem, nlp_work,
                         sens_nlp_out, field, stage, grad_p);
@@ -1328,7 +1555,7 @@ void ocp_nlp_sqp_rti_get(void *config_, void *dims_, void *mem_,
     if ( ptr_module!=NULL && (!strcmp(ptr_module, "time")) )
     {
         // call timings getter
-        ocp_nlp_timings_get(config, mem->nlp_mem->nlp_timings, field, return_value_);
+        ocp_nlp_timings_get(config, mem->timings, field, return_value_);
     }
     else if (!strcmp("stat", field))
     {
@@ -1413,6 +1640,10 @@ void ocp_nlp_sqp_rti_terminate(void *config_, void *mem_, void *work_)
     ocp_nlp_sqp_rti_memory *mem = mem_;
     ocp_nlp_sqp_rti_workspace *work = work_;
 
+    ocp_nlp_sqp_rti_async_preparation_wait(mem);
+    acados_async_task_destroy(mem->async_task);
+    mem->async_task = NULL;
+
     config->qp_solver->terminate(config->qp_solver, mem->nlp_mem->qp_solver_mem, work->nlp_work->qp_work);
 }
 
@@ -1447,6 +1678,7 @@ void ocp_nlp_sqp_rti_config_initialize_default(void *config_)
     config->opts_get = &ocp_nlp_sqp_rti_opts_get;
     config->work_get = &ocp_nlp_sqp_rti_work_get;
     config->terminate = &ocp_nlp_sqp_rti_terminate;
+    config->wait_async = &ocp_nlp_sqp_rti_wait_async;
     config->step_update = &ocp_nlp_update_variables_sqp;
     config->is_real_time_algorithm = &ocp_nlp_sqp_rti_is_real_time_algorithm;
     config->eval_kkt_residual = &ocp_nlp_sqp_rti_eval_kkt_residual;
@@ -88,6 +88,8 @@ typedef struct
     int as_rti_iter;
     int rti_log_residuals;
     int rti_log_only_available_residuals;
+    int rti_async_preparation; // run the preparation of the next step in the background after each feedback,
+                               // linearizing at the returned iterate without shifting it
 
 } ocp_nlp_sqp_rti_opts;
 
@@ -123,6 +125,17 @@ typedef struct
 
     bool is_first_call;
 
+    // timings reported to the user; nlp_mem->nlp_timings points to async_timings
+    // while an asynchronous preparation is pending
+    ocp_nlp_timings *timings;
+
+    // asynchronous preparation
+    acados_async_task *async_task;
+    bool async_preparation_pending;
+    double async_time_preparation;
+    ocp_nlp_timings async_timings; // private to the preparation thread, merged after completion
+    void *async_args[7]; // config, dims, nlp_in, nlp_out, opts, mem, work
+
 } ocp_nlp_sqp_rti_memory;
 
 //
@@ -130,6 +143,8 @@ acados_size_t ocp_nlp_sqp_rti_memory_calculate_size(void *config_, void *dims_,
 //
 void *ocp_nlp_sqp_rti_memory_assign(void *config_, void *dims_, void *opts_, void *in_,
     void *raw_memory);
+//
+void ocp_nlp_sqp_rti_wait_async(void *config_, void *mem_);
 
 
 
@@ -248,6 +248,11 @@ void ocp_nlp_sqp_wfqp_opts_set(void *config_, void *opts_, const char *field, vo
             bool* allow_direction_mode_switch_to_nominal = (bool *) value;
             opts->allow_direction_mode_switch_to_nominal = *allow_direction_mode_switch_to_nominal;
         }
+        else if (!strcmp(field, "autotune_qp"))
+        {
+            // the relaxed qp solver shares the qp solver options, its memory is sized for the initial horizon
+            printf("Warning: autotune_qp is not supported by SQP_WITH_FEASIBLE_QP, ignoring it.\n");
+        }
         else
         {
             ocp_nlp_opts_set(config, nlp_opts, field, value);
@@ -1614,7 +1619,9 @@ int ocp_nlp_sqp_wfqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
 
             setup_hessian_matrices_for_qps(config, dims, nlp_in, nlp_out, opts, mem, nlp_work);
             //
-            nlp_timings->time_lin += acados_toc(&timer1);
+            double tmp_time = acados_toc(&timer1);
+            nlp_timings->time_lin += tmp_time;
+            ocp_nlp_timings_update_estimate(&nlp_timings->est_time_lin, tmp_time);
             // compute nlp residuals
             ocp_nlp_res_compute(dims, nlp_opts, nlp_in, nlp_out, nlp_res, nlp_mem, nlp_work);
             ocp_nlp_res_get_inf_norm(nlp_res, &nlp_out->inf_norm_res);
@@ -1655,6 +1662,19 @@ int ocp_nlp_sqp_wfqp(void *config_, void *dims_, void *nlp_in_, void *nlp_out_,
             return mem->nlp_mem->status;
         }
 
+        // anytime exit after the termination check: keep the current iterate, with its residuals,
+        // if the step and the next linearization cannot be completed before the deadline
+        if (!ocp_nlp_deadline_fits(nlp_opts, ocp_nlp_deadline_predict_iteration(nlp_timings)))
+        {
+#if defined(ACADOS_WITH_OPENMP)
+            // restore number of threads
+            omp_set_num_threads(num_threads_bkp);
+#endif
+            nlp_mem->status = ACADOS_DEADLINE;
+            nlp_timings->time_tot = acados_toc(&timer_tot);
+            return nlp_mem->status;
+        }
+
         if (config->globalization->needs_objective_value() == 1)
         {
             mem->l1_infeasibility = ocp_nlp_get_l1_infeasibility(config, dims, nlp_mem);
@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+// acados
+#include "acados/ocp_nlp/ocp_nlp_warm_start_cache.h"
+#include "acados/utils/mem.h"
+
+
+
+/************************************************
+ * opts
+ ************************************************/
+
+void ocp_nlp_warm_start_cache_opts_initialize_default(ocp_nlp_warm_start_cache_opts *opts)
+{
+    opts->budget = 1 << 20;
+    opts->eviction = WARM_START_CACHE_EVICT_LRU;
+    opts->insert_tol = 0.0;
+    opts->lookup_tol = 0.0;
+    opts->with_params = 1;
+}
+
+
+
+/************************************************
+ * memory
+ ************************************************/
+
+static int ocp_nlp_warm_start_cache_nbx0(ocp_nlp_config *config, ocp_nlp_dims *dims)
+{
+    int nbx0;
+    config->constraints[0]->dims_get(config->constraints[0], dims->constraints[0], "nbx", &nbx0);
+    return nbx0;
+}
+
+
+
+static int ocp_nlp_warm_start_cache_key_dim(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                            ocp_nlp_warm_start_cache_opts *opts)
+{
+    int key_dim = ocp_nlp_warm_start_cache_nbx0(config, dims);
+    if (opts->with_params)
+    {
+        for (int i = 0; i <= dims->N; i++)
+            key_dim += dims->np[i];
+    }
+    return key_dim;
+}
+
+
+
+// bytes of one entry: iterate, key and bookkeeping
+static acados_size_t ocp_nlp_warm_start_cache_entry_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                         int key_dim)
+{
+    acados_size_t size = ocp_nlp_out_calculate_size(config, dims);
+    size += 2 * key_dim * sizeof(double);  // keys, kd_keys
+    size += sizeof(ocp_nlp_out *);
+    size += 2 * sizeof(unsigned long);  // inserted, last_use
+    size += 3 * sizeof(int);  // kd_perm, kd_node, pending
+    make_int_multiple_of(8, &size);
+    return size;
+}
+
+
+
+static int ocp_nlp_warm_start_cache_capacity(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                             ocp_nlp_warm_start_cache_opts *opts)
+{
+    int key_dim = ocp_nlp_warm_start_cache_key_dim(config, dims, opts);
+    acados_size_t entry_size = ocp_nlp_warm_start_cache_entry_size(config, dims, key_dim);
+    int capacity = opts->budget / entry_size;
+    if (capacity < 1)
+    {
+        printf("\nerror: ocp_nlp_warm_start_cache: budget %zu bytes below the size of one entry (%zu bytes)\n",
+               (size_t) opts->budget, (size_t) entry_size);
+        exit(1);
+    }
+    return capacity;
+}
+
+
+
+acados_size_t ocp_nlp_warm_start_cache_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                      ocp_nlp_warm_start_cache_opts *opts)
+{
+    int key_dim = ocp_nlp_warm_start_cache_key_dim(config, dims, opts);
+    int capacity = ocp_nlp_warm_start_cache_capacity(config, dims, opts);
+
+    acados_size_t size = sizeof(ocp_nlp_warm_start_cache);
+
+    size += 2 * capacity * key_dim * sizeof(double);  // keys, kd_keys
+    size += 2 * key_dim * sizeof(double);  // scale, key_tmp
+    size += capacity * sizeof(ocp_nlp_out *);  // iterates
+    size += 2 * capacity * sizeof(unsigned long);  // inserted, last_use
+    size += 3 * capacity * sizeof(int);  // kd_perm, kd_node, pending
+    size += capacity * ocp_nlp_out_calculate_size(config, dims);  // iterates
+
+    size += 2 * 8;  // align
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+ocp_nlp_warm_start_cache *ocp_nlp_warm_start_cache_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                          ocp_nlp_warm_start_cache_opts *opts, void *raw_memory)
+{
+    char *c_ptr = (char *) raw_memory;
+
+    int key_dim = ocp_nlp_warm_start_cache_key_dim(config, dims, opts);
+    int capacity = ocp_nlp_warm_start_cache_capacity(config, dims, opts);
+
+    ocp_nlp_warm_start_cache *cache = (ocp_nlp_warm_start_cache *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_warm_start_cache);
+
+    cache->opts = *opts;
+    cache->key_dim = key_dim;
+    cache->nbx0 = ocp_nlp_warm_start_cache_nbx0(config, dims);
+    cache->capacity = capacity;
+
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(capacity * key_dim, &cache->keys, &c_ptr);
+    assign_and_advance_double(capacity * key_dim, &cache->kd_keys, &c_ptr);
+    assign_and_advance_double(key_dim, &cache->scale, &c_ptr);
+    assign_and_advance_double(key_dim, &cache->key_tmp, &c_ptr);
+
+    cache->iterates = (ocp_nlp_out **) c_ptr;
+    c_ptr += capacity * sizeof(ocp_nlp_out *);
+
+    cache->inserted = (unsigned long *) c_ptr;
+    c_ptr += capacity * sizeof(unsigned long);
+    cache->last_use = (unsigned long *) c_ptr;
+    c_ptr += capacity * sizeof(unsigned long);
+
+    assign_and_advance_int(capacity, &cache->kd_perm, &c_ptr);
+    assign_and_advance_int(capacity, &cache->kd_node, &c_ptr);
+    assign_and_advance_int(capacity, &cache->pending, &c_ptr);
+
+    align_char_to(8, &c_ptr);
+
+    for (int k = 0; k < capacity; k++)
+    {
+        cache->iterates[k] = ocp_nlp_out_assign(config, dims, c_ptr);
+        c_ptr += ocp_nlp_out_calculate_size(config, dims);
+    }
+
+    for (int j = 0; j < key_dim; j++)
+        cache->scale[j] = 1.0;
+
+    ocp_nlp_warm_start_cache_clear(cache);
+
+    assert((char *) raw_memory + ocp_nlp_warm_start_cache_calculate_size(config, dims, opts) >= c_ptr);
+
+    return cache;
+}
+
+
+
+void ocp_nlp_warm_start_cache_clear(ocp_nlp_warm_start_cache *cache)
+{
+    cache->num_entries = 0;
+    cache->clock = 0;
+    cache->kd_size = 0;
+    cache->num_pending = 0;
+    cache->num_lookups = 0;
+    cache->num_hits = 0;
+    cache->num_rebuilds = 0;
+}
+
+
+
+void ocp_nlp_warm_start_cache_set(ocp_nlp_warm_start_cache *cache, const char *field, void *value)
+{
+    if (!strcmp(field, "scale"))
+    {
+        double *scale = value;
+        for (int j = 0; j < cache->key_dim; j++)
+        {
+            if (scale[j] <= 0.0)
+            {
+                printf("\nerror: ocp_nlp_warm_start_cache_set: scale must be positive, got %e at %d\n",
+                       scale[j], j);
+                exit(1);
+            }
+            // stored keys are normalised with the old scale
+            for (int k = 0; k < cache->num_entries; k++)
+                cache->keys[k * cache->key_dim + j] *= cache->scale[j] / scale[j];
+            cache->scale[j] = scale[j];
+        }
+        // all keys moved
+        cache->kd_size = 0;
+        cache->num_pending = cache->num_entries;
+        for (int k = 0; k < cache->num_entries; k++)
+        {
+            cache->kd_node[k] = -1;
+            cache->pending[k] = k;
+        }
+    }
+    else
+    {
+        printf("\nerror: ocp_nlp_warm_start_cache_set: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
+void ocp_nlp_warm_start_cache_get(ocp_nlp_warm_start_cache *cache, const char *field, void *value)
+{
+    int *int_ptr = value;
+
+    if (!strcmp(field, "key_dim"))
+        *int_ptr = cache->key_dim;
+    else if (!strcmp(field, "capacity"))
+        *int_ptr = cache->capacity;
+    else if (!strcmp(field, "num_entries"))
+        *int_ptr = cache->num_entries;
+    else if (!strcmp(field, "num_lookups"))
+        *int_ptr = cache->num_lookups;
+    else if (!strcmp(field, "num_hits"))
+        *int_ptr = cache->num_hits;
+    else if (!strcmp(field, "num_rebuilds"))
+        *int_ptr = cache->num_rebuilds;
+    else
+    {
+        printf("\nerror: ocp_nlp_warm_start_cache_get: field %s not available\n", field);
+        exit(1);
+    }
+}
+
+
+
+/************************************************
+ * k-d tree
+ ************************************************/
+
+static double ocp_nlp_warm_start_cache_dist2(int key_dim, double *a, double *b)
+{
+    double dist2 = 0.0;
+    for (int j = 0; j < key_dim; j++)
+        dist2 += (a[j] - b[j]) * (a[j] - b[j]);
+    return dist2;
+}
+
+
+
+// partially sorts perm[lo:hi] such that perm[mid] holds the median in dimension dim
+static void ocp_nlp_warm_start_cache_select(ocp_nlp_warm_start_cache *cache, int lo, int hi, int mid, int dim)
+{
+    int *perm = cache->kd_perm;
+    double *keys = cache->keys;
+    int key_dim = cache->key_dim;
+    int tmp;
+
+    hi--;
+    while (lo < hi)
+    {
+        double pivot = keys[perm[mid] * key_dim + dim];
+        int i = lo;
+        int j = hi;
+        while (i <= j)
+        {
+            while (keys[perm[i] * key_dim + dim] < pivot) i++;
+            while (keys[perm[j] * key_dim + dim] > pivot) j--;
+            if (i <= j)
+            {
+                tmp = perm[i]; perm[i] = perm[j]; perm[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (mid <= j)
+            hi = j;
+        else if (mid >= i)
+            lo = i;
+        else
+            break;
+    }
+}
+
+
+
+static void ocp_nlp_warm_start_cache_build(ocp_nlp_warm_start_cache *cache, int lo, int hi, int depth)
+{
+    if (hi - lo <= 1)
+        return;
+
+    int mid = (lo + hi) / 2;
+    ocp_nlp_warm_start_cache_select(cache, lo, hi, mid, depth % cache->key_dim);
+    ocp_nlp_warm_start_cache_build(cache, lo, mid, depth + 1);
+    ocp_nlp_warm_start_cache_build(cache, mid + 1, hi, depth + 1);
+}
+
+
+
+static void ocp_nlp_warm_start_cache_search(ocp_nlp_warm_start_cache *cache, double *key, int lo, int hi,
+                                            int depth, int *best, double *best_dist2)
+{
+    if (lo >= hi)
+        return;
+
+    int key_dim = cache->key_dim;
+    int mid = (lo + hi) / 2;
+    int dim = depth % key_dim;
+    double *key_mid = cache->kd_keys + mid * key_dim;
+
+    // entries whose key changed since the build still split the space, but are not candidates
+    int k = cache->kd_perm[mid];
+    if (cache->kd_node[k] == mid)
+    {
+        double dist2 = ocp_nlp_warm_start_cache_dist2(key_dim, key, key_mid);
+        if (dist2 < *best_dist2)
+        {
+            *best_dist2 = dist2;
+            *best = k;
+        }
+    }
+
+    double diff = key[dim] - key_mid[dim];
+    if (diff < 0)
+    {
+        ocp_nlp_warm_start_cache_search(cache, key, lo, mid, depth + 1, best, best_dist2);
+        if (diff * diff < *best_dist2)
+            ocp_nlp_warm_start_cache_search(cache, key, mid + 1, hi, depth + 1, best, best_dist2);
+    }
+    else
+    {
+        ocp_nlp_warm_start_cache_search(cache, key, mid + 1, hi, depth + 1, best, best_dist2);
+        if (diff * diff < *best_dist2)
+            ocp_nlp_warm_start_cache_search(cache, key, lo, mid, depth + 1, best, best_dist2);
+    }
+}
+
+
+
+static void ocp_nlp_warm_start_cache_rebuild(ocp_nlp_warm_start_cache *cache)
+{
+    int n = cache->num_entries;
+    int key_dim = cache->key_dim;
+
+    for (int k = 0; k < n; k++)
+        cache->kd_perm[k] = k;
+    ocp_nlp_warm_start_cache_build(cache, 0, n, 0);
+
+    for (int m = 0; m < n; m++)
+    {
+        int k = cache->kd_perm[m];
+        for (int j = 0; j < key_dim; j++)
+            cache->kd_keys[m * key_dim + j] = cache->keys[k * key_dim + j];
+        cache->kd_node[k] = m;
+    }
+
+    cache->kd_size = n;
+    cache->num_pending = 0;
+    cache->num_rebuilds++;
+}
+
+
+
+// moves entry k from the tree to the pending list before its key is overwritten
+static void ocp_nlp_warm_start_cache_detach(ocp_nlp_warm_start_cache *cache, int k)
+{
+    if (cache->kd_node[k] >= 0)
+    {
+        cache->kd_node[k] = -1;
+        cache->pending[cache->num_pending] = k;
+        cache->num_pending++;
+    }
+}
+
+
+
+// index of the entry nearest to key, -1 if the cache is empty
+static int ocp_nlp_warm_start_cache_nearest(ocp_nlp_warm_start_cache *cache, double *key, double *dist2)
+{
+    int key_dim = cache->key_dim;
+
+    if (cache->num_entries == 0)
+        return -1;
+
+    // an empty key has no dimension to split on, all entries are at distance 0
+    if (key_dim == 0)
+    {
+        *dist2 = 0.0;
+        return 0;
+    }
+
+    // a short pending list is cheaper to scan than to rebuild the tree
+    if (cache->num_pending > 8 + cache->kd_size / 8)
+        ocp_nlp_warm_start_cache_rebuild(cache);
+
+    int best = -1;
+    *dist2 = INFINITY;
+    ocp_nlp_warm_start_cache_search(cache, key, 0, cache->kd_size, 0, &best, dist2);
+
+    for (int m = 0; m < cache->num_pending; m++)
+    {
+        int k = cache->pending[m];
+        double d2 = ocp_nlp_warm_start_cache_dist2(key_dim, key, cache->keys + k * key_dim);
+        if (d2 < *dist2)
+        {
+            *dist2 = d2;
+            best = k;
+        }
+    }
+
+    return best;
+}
+
+
+
+/************************************************
+ * functions
+ ************************************************/
+
+void ocp_nlp_warm_start_cache_compute_key(ocp_nlp_warm_start_cache *cache, ocp_nlp_config *config,
+                                          ocp_nlp_dims *dims, ocp_nlp_in *nlp_in, double *key)
+{
+    int nbx0 = cache->nbx0;
+
+    // initial state, from the bounds of stage 0
+    config->constraints[0]->model_get(config->constraints[0], dims->constraints[0],
+                                      nlp_in->constraints[0], "lbx", key);
+
+    if (cache->opts.with_params)
+    {
+        int offset = nbx0;
+        for (int i = 0; i <= dims->N; i++)
+        {
+            for (int j = 0; j < dims->np[i]; j++)
+                key[offset + j] = nlp_in->parameter_values[i][j];
+            offset += dims->np[i];
+        }
+    }
+
+    for (int j = 0; j < cache->key_dim; j++)
+        key[j] /= cache->scale[j];
+}
+
+
+
+int ocp_nlp_warm_start_cache_lookup(ocp_nlp_warm_start_cache *cache, ocp_nlp_dims *dims,
+                                    double *key, ocp_nlp_out *out)
+{
+    double dist2;
+
+    cache->num_lookups++;
+
+    int k = ocp_nlp_warm_start_cache_nearest(cache, key, &dist2);
+    if (k < 0)
+        return 0;
+    if (cache->opts.lookup_tol > 0 && dist2 > cache->opts.lookup_tol * cache->opts.lookup_tol)
+        return 0;
+
+    copy_ocp_nlp_out(dims, cache->iterates[k], out);
+    cache->last_use[k] = ++cache->clock;
+    cache->num_hits++;
+
+    return 1;
+}
+
+
+
+void ocp_nlp_warm_start_cache_insert(ocp_nlp_warm_start_cache *cache, ocp_nlp_dims *dims,
+                                     double *key, ocp_nlp_out *out)
+{
+    double dist2;
+    int k = ocp_nlp_warm_start_cache_nearest(cache, key, &dist2);
+
+    if (k >= 0 && dist2 <= cache->opts.insert_tol * cache->opts.insert_tol)
+    {
+        // replace the entry with a (nearly) identical key, the tree is only stale if the key moved
+        if (dist2 > 0)
+            ocp_nlp_warm_start_cache_detach(cache, k);
+    }
+    else if (cache->num_entries < cache->capacity)
+    {
+        k = cache->num_entries;
+        cache->num_entries++;
+        cache->kd_node[k] = -1;
+        cache->pending[cache->num_pending] = k;
+        cache->num_pending++;
+    }
+    else
+    {
+        // evict
+        unsigned long *age = cache->opts.eviction == WARM_START_CACHE_EVICT_FIFO ?
+                             cache->inserted : cache->last_use;
+        k = 0;
+        for (int j = 1; j < cache->num_entries; j++)
+        {
+            if (age[j] < age[k])
+                k = j;
+        }
+        ocp_nlp_warm_start_cache_detach(cache, k);
+    }
+
+    for (int j = 0; j < cache->key_dim; j++)
+        cache->keys[k * cache->key_dim + j] = key[j];
+    copy_ocp_nlp_out(dims, out, cache->iterates[k]);
+
+    cache->clock++;
+    cache->inserted[k] = cache->clock;
+    cache->last_use[k] = cache->clock;
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_OCP_NLP_OCP_NLP_WARM_START_CACHE_H_
+#define ACADOS_OCP_NLP_OCP_NLP_WARM_START_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/utils/types.h"
+
+
+
+// Cache of converged iterates (ux, z, pi, lam) keyed by the stage 0 bounds on x (i.e. x0)
+// and optionally the stage parameters. Lookups return the iterate with the nearest
+// normalised key, found with a k-d tree over a snapshot of the keys plus a linear scan over
+// the entries inserted or overwritten since; the tree is rebuilt once that list grows too long.
+// The cache is not thread safe.
+
+typedef enum
+{
+    WARM_START_CACHE_EVICT_LRU,   // least recently inserted or returned by a lookup
+    WARM_START_CACHE_EVICT_FIFO,  // least recently inserted
+} ocp_nlp_warm_start_cache_eviction_t;
+
+
+
+typedef struct
+{
+    acados_size_t budget;  // memory budget in bytes for keys and iterates
+    ocp_nlp_warm_start_cache_eviction_t eviction;
+    double insert_tol;  // an insertion closer than this to a stored key replaces that entry
+    double lookup_tol;  // lookups farther than this from all keys miss, <= 0: no limit
+    int with_params;  // include the stage parameters in the key
+} ocp_nlp_warm_start_cache_opts;
+
+
+
+typedef struct
+{
+    ocp_nlp_warm_start_cache_opts opts;
+    int key_dim;
+    int nbx0;
+    int capacity;
+    int num_entries;
+
+    double *keys;  // capacity * key_dim, normalised
+    double *scale;  // key_dim, key = raw key / scale
+    double *key_tmp;
+    ocp_nlp_out **iterates;
+    unsigned long *inserted;
+    unsigned long *last_use;
+    unsigned long clock;
+
+    // implicit k-d tree: permutation of the entries, split dimension = depth % key_dim
+    int *kd_perm;
+    double *kd_keys;  // capacity * key_dim, keys in tree order at build time
+    int *kd_node;  // capacity, tree position of an entry, -1 if its key changed since the build
+    int kd_size;
+    // entries not (or no longer) represented in the tree, searched linearly
+    int *pending;
+    int num_pending;
+
+    int num_lookups;
+    int num_hits;
+    int num_rebuilds;
+} ocp_nlp_warm_start_cache;
+
+
+
+//
+void ocp_nlp_warm_start_cache_opts_initialize_default(ocp_nlp_warm_start_cache_opts *opts);
+//
+acados_size_t ocp_nlp_warm_start_cache_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                      ocp_nlp_warm_start_cache_opts *opts);
+//
+ocp_nlp_warm_start_cache *ocp_nlp_warm_start_cache_assign(ocp_nlp_config *config, ocp_nlp_dims *dims,
+                                                          ocp_nlp_warm_start_cache_opts *opts, void *raw_memory);
+// fields: "scale" (double[key_dim])
+void ocp_nlp_warm_start_cache_set(ocp_nlp_warm_start_cache *cache, const char *field, void *value);
+// fields: "key_dim", "capacity", "num_entries", "num_lookups", "num_hits", "num_rebuilds" (int)
+void ocp_nlp_warm_start_cache_get(ocp_nlp_warm_start_cache *cache, const char *field, void *value);
+// normalised key of nlp_in, written to key[key_dim]
+void ocp_nlp_warm_start_cache_compute_key(ocp_nlp_warm_start_cache *cache, ocp_nlp_config *config,
+                                          ocp_nlp_dims *dims, ocp_nlp_in *nlp_in, double *key);
+// copies the nearest stored iterate to out; returns 1 on a hit, 0 otherwise
+int ocp_nlp_warm_start_cache_lookup(ocp_nlp_warm_start_cache *cache, ocp_nlp_dims *dims,
+                                    double *key, ocp_nlp_out *out);
+//
+void ocp_nlp_warm_start_cache_insert(ocp_nlp_warm_start_cache *cache, ocp_nlp_dims *dims,
+                                     double *key, ocp_nlp_out *out);
+//
+void ocp_nlp_warm_start_cache_clear(ocp_nlp_warm_start_cache *cache);
+
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_NLP_OCP_NLP_WARM_START_CACHE_H_
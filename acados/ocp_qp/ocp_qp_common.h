@@ -69,6 +69,7 @@ typedef struct
     acados_size_t (*memory_calculate_size)(void *config, void *dims, void *opts);
     void *(*memory_assign)(void *config, void *dims, void *opts, void *raw_memory);
     void (*memory_get)(void *config_, void *mem_, const char *field, void* value);
+    void (*memory_set)(void *config_, void *mem_, const char *field, void* value);  // optional, NULL if not implemented
     acados_size_t (*workspace_calculate_size)(void *config, void *dims, void *opts);
     int (*evaluate)(void *config, void *qp_in, void *qp_out, void *opts, void *mem, void *work);
     void (*solver_get)(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *mem_, const char *field, int stage, void* value, int size1, int size2);
@@ -96,6 +97,7 @@ typedef struct
     acados_size_t (*memory_calculate_size)(void *dims, void *opts);
     void *(*memory_assign)(void *dims, void *opts, void *raw_memory);
     void (*memory_get)(void *config, void *mem, const char *field, void* value);
+    void (*memory_set)(void *config, void *mem, const char *field, void* value);
     acados_size_t (*workspace_calculate_size)(void *dims, void *opts);
     int (*condensing)(void *qp_in, void *x_cond_qp_in, void *opts, void *mem, void *work);
     int (*condense_rhs)(void *qp_in, void *x_cond_qp_in, void *opts, void *mem, void *work);
@@ -134,6 +134,12 @@ void ocp_qp_full_condensing_dims_get(void *config_, void *dims_, const char *fie
         dense_qp_dims **ptr = value;
         *ptr = dims->fcond_dims;
     }
+    else if(!strcmp(field, "cond_N"))
+    {
+        // the dense qp is a single stage
+        int *ptr = value;
+        *ptr = 0;
+    }
     else
     {
         printf("\nerror: ocp_qp_full_condensing_dims_get: field %s not available\n", field);
@@ -430,6 +436,23 @@ void ocp_qp_full_condensing_memory_get(void *config_, void *mem_, const char *fi
 
 
 
+void ocp_qp_full_condensing_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    if (!strcmp(field, "thread_pool"))
+    {
+        // single block, condensed serially
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_full_condensing_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -658,6 +681,7 @@ void ocp_qp_full_condensing_config_initialize_default(void *config_)
     config->memory_calculate_size = &ocp_qp_full_condensing_memory_calculate_size;
     config->memory_assign = &ocp_qp_full_condensing_memory_assign;
     config->memory_get = &ocp_qp_full_condensing_memory_get;
+    config->memory_set = &ocp_qp_full_condensing_memory_set;
     config->workspace_calculate_size = &ocp_qp_full_condensing_workspace_calculate_size;
     config->condensing = &ocp_qp_full_condensing;
     config->condense_rhs = &ocp_qp_full_condensing_condense_rhs;
@@ -102,6 +102,8 @@ acados_size_t ocp_qp_full_condensing_memory_calculate_size(void *dims, void *opt
 //
 void *ocp_qp_full_condensing_memory_assign(void *dims, void *opts_, void *raw_memory);
 //
+void ocp_qp_full_condensing_memory_set(void *config_, void *mem_, const char *field, void* value);
+//
 acados_size_t ocp_qp_full_condensing_workspace_calculate_size(void *dims, void *opts_);
 //
 int ocp_qp_full_condensing(void *in, void *out, void *opts, void *mem, void *work);
@@ -37,6 +37,14 @@
 #include "hpipm/include/hpipm_d_ocp_qp.h"
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
 #include "hpipm/include/hpipm_d_ocp_qp_sol.h"
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
+// blasfeo
+#include "blasfeo/include/blasfeo_m_aux.h"
+#endif
 
 // uncomment to codegen QP
 // #include "hpipm/include/hpipm_d_ocp_qp_utils.h"
@@ -51,6 +59,68 @@
 
 
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+// the float dims share the dimension arrays of the double dims
+static void ocp_qp_hpipm_single_dim_alias(ocp_qp_dims *dims, struct s_ocp_qp_dim *s_dim)
+{
+    s_dim->nx = dims->nx;
+    s_dim->nu = dims->nu;
+    s_dim->nb = dims->nb;
+    s_dim->nbx = dims->nbx;
+    s_dim->nbu = dims->nbu;
+    s_dim->ng = dims->ng;
+    s_dim->ns = dims->ns;
+    s_dim->nsbx = dims->nsbx;
+    s_dim->nsbu = dims->nsbu;
+    s_dim->nsg = dims->nsg;
+    s_dim->nbxe = dims->nbxe;
+    s_dim->nbue = dims->nbue;
+    s_dim->nge = dims->nge;
+    s_dim->N = dims->N;
+    s_dim->memsize = 0;
+}
+
+
+
+// copy the double arguments to the float ones, tolerances are clipped to float accuracy
+static void ocp_qp_hpipm_opts_sync_single(ocp_qp_hpipm_opts *opts)
+{
+    struct d_ocp_qp_ipm_arg *arg = opts->hpipm_opts;
+    struct s_ocp_qp_ipm_arg *s_arg = opts->s_hpipm_opts;
+    double tol_min = OCP_QP_HPIPM_SINGLE_TOL_MIN;
+
+    s_arg->mu0 = arg->mu0;
+    s_arg->alpha_min = arg->alpha_min;
+    s_arg->res_g_max = arg->res_g_max > tol_min ? arg->res_g_max : tol_min;
+    s_arg->res_b_max = arg->res_b_max > tol_min ? arg->res_b_max : tol_min;
+    s_arg->res_d_max = arg->res_d_max > tol_min ? arg->res_d_max : tol_min;
+    s_arg->res_m_max = arg->res_m_max > tol_min ? arg->res_m_max : tol_min;
+    s_arg->reg_prim = arg->reg_prim;
+    s_arg->lam_min = arg->lam_min;
+    s_arg->t_min = arg->t_min;
+    s_arg->tau_min = arg->tau_min;
+    s_arg->iter_max = arg->iter_max;
+    s_arg->stat_max = arg->stat_max;
+    s_arg->pred_corr = arg->pred_corr;
+    s_arg->cond_pred_corr = arg->cond_pred_corr;
+    s_arg->itref_pred_max = arg->itref_pred_max;
+    s_arg->itref_corr_max = arg->itref_corr_max;
+    s_arg->warm_start = arg->warm_start;
+    s_arg->square_root_alg = arg->square_root_alg;
+    s_arg->lq_fact = arg->lq_fact;
+    s_arg->abs_form = arg->abs_form;
+    s_arg->comp_dual_sol_eq = arg->comp_dual_sol_eq;
+    s_arg->comp_res_exit = arg->comp_res_exit;
+    s_arg->comp_res_pred = arg->comp_res_pred;
+    s_arg->split_step = arg->split_step;
+    s_arg->var_init_scheme = arg->var_init_scheme;
+    s_arg->t_lam_min = arg->t_lam_min;
+    s_arg->mode = arg->mode;
+}
+#endif
+
+
+
 /************************************************
  * opts
  ************************************************/
@@ -64,6 +134,14 @@ acados_size_t ocp_qp_hpipm_opts_calculate_size(void *config_, void *dims_)
     size += sizeof(struct d_ocp_qp_ipm_arg);
     size += d_ocp_qp_ipm_arg_memsize(dims);
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    struct s_ocp_qp_dim s_dim;
+    ocp_qp_hpipm_single_dim_alias(dims, &s_dim);
+    size += sizeof(struct s_ocp_qp_ipm_arg);
+    size += s_ocp_qp_ipm_arg_memsize(&s_dim);
+    size += 1 * 8;
+#endif
+
     size += 1 * 8;
     make_int_multiple_of(8, &size);
 
@@ -91,6 +169,18 @@ void *ocp_qp_hpipm_opts_assign(void *config_, void *dims_, void *raw_memory)
     d_ocp_qp_ipm_arg_create(dims, opts->hpipm_opts, c_ptr);
     c_ptr += d_ocp_qp_ipm_arg_memsize(dims);
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    ocp_qp_hpipm_single_dim_alias(dims, &opts->s_dim);
+
+    opts->s_hpipm_opts = (struct s_ocp_qp_ipm_arg *) c_ptr;
+    c_ptr += sizeof(struct s_ocp_qp_ipm_arg);
+
+    align_char_to(8, &c_ptr);
+
+    s_ocp_qp_ipm_arg_create(&opts->s_dim, opts->s_hpipm_opts, c_ptr);
+    c_ptr += s_ocp_qp_ipm_arg_memsize(&opts->s_dim);
+#endif
+
     assert((char *) raw_memory + ocp_qp_hpipm_opts_calculate_size(config_, dims) >= c_ptr);
 
     return (void *) opts;
@@ -122,6 +212,14 @@ void ocp_qp_hpipm_opts_initialize_default(void *config_, void *dims_, void *opts
 
     ocp_qp_hpipm_opts_overwrite_mode_opts(opts);
     opts->print_level = 0;
+    opts->single_precision = 0;
+    opts->mixed_precision = 0;
+    opts->mixed_precision_refine_max = 3;
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    s_ocp_qp_ipm_arg_set_default(BALANCE, opts->s_hpipm_opts);
+    ocp_qp_hpipm_opts_sync_single(opts);
+#endif
 
     return;
 }
@@ -162,11 +260,46 @@ void ocp_qp_hpipm_opts_set(void *config_, void *opts_, const char *field, void *
         int* print_level = (int *) value;
         opts->print_level = *print_level;
     }
+    else if (!strcmp(field, "single_precision"))
+    {
+        int* single_precision = (int *) value;
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+        opts->single_precision = *single_precision;
+#else
+        if (*single_precision)
+        {
+            printf("\nerror: ocp_qp_hpipm_opts_set: single_precision requires acados to be compiled with ACADOS_WITH_SINGLE_PRECISION\n");
+            exit(1);
+        }
+#endif
+    }
+    else if (!strcmp(field, "mixed_precision"))
+    {
+        int* mixed_precision = (int *) value;
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+        opts->mixed_precision = *mixed_precision;
+#else
+        if (*mixed_precision)
+        {
+            printf("\nerror: ocp_qp_hpipm_opts_set: mixed_precision requires acados to be compiled with ACADOS_WITH_SINGLE_PRECISION\n");
+            exit(1);
+        }
+#endif
+    }
+    else if (!strcmp(field, "mixed_precision_refine_max"))
+    {
+        int* refine_max = (int *) value;
+        opts->mixed_precision_refine_max = *refine_max;
+    }
     else
     {
         d_ocp_qp_ipm_arg_set((char *) field, value, opts->hpipm_opts);
     }
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    ocp_qp_hpipm_opts_sync_single(opts);
+#endif
+
     return;
 }
 
@@ -198,6 +331,35 @@ acados_size_t ocp_qp_hpipm_memory_calculate_size(void *config_, void *dims_, voi
 
     size += d_ocp_qp_ipm_ws_memsize(dims, opts->hpipm_opts);
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (opts->single_precision || opts->mixed_precision)
+    {
+        struct s_ocp_qp_dim s_dim;
+        ocp_qp_hpipm_single_dim_alias(dims, &s_dim);
+
+        size += sizeof(struct s_ocp_qp);
+        size += s_ocp_qp_memsize(&s_dim);
+        size += sizeof(struct s_ocp_qp_sol);
+        size += s_ocp_qp_sol_memsize(&s_dim);
+        size += sizeof(struct s_ocp_qp_ipm_ws);
+        size += s_ocp_qp_ipm_ws_memsize(&s_dim, opts->s_hpipm_opts);
+        size += 3 * 8;
+    }
+    if (opts->mixed_precision)
+    {
+        struct s_ocp_qp_dim s_dim;
+        ocp_qp_hpipm_single_dim_alias(dims, &s_dim);
+
+        size += ocp_qp_res_calculate_size(dims);
+        size += ocp_qp_res_workspace_calculate_size(dims);
+        size += sizeof(struct s_ocp_qp_seed);
+        size += s_ocp_qp_seed_memsize(&s_dim);
+        size += sizeof(struct s_ocp_qp_sol);
+        size += s_ocp_qp_sol_memsize(&s_dim);
+        size += 4 * 8;
+    }
+#endif
+
     size += 1 * 8;
     make_int_multiple_of(8, &size);
 
@@ -230,6 +392,69 @@ void *ocp_qp_hpipm_memory_assign(void *config_, void *dims_, void *opts_, void *
     d_ocp_qp_ipm_ws_create(dims, opts->hpipm_opts, ipm_workspace, c_ptr);
     c_ptr += ipm_workspace->memsize;
 
+    mem->iter_max_cap = 0;
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    mem->s_qp_in = NULL;
+    mem->s_qp_out = NULL;
+    mem->s_hpipm_workspace = NULL;
+    mem->qp_res = NULL;
+    mem->res_ws = NULL;
+    mem->s_seed = NULL;
+    mem->s_step = NULL;
+    mem->refine_iter = 0;
+    if (opts->single_precision || opts->mixed_precision)
+    {
+        // dims may have been updated since the opts were created
+        ocp_qp_hpipm_single_dim_alias(dims, &opts->s_dim);
+        struct s_ocp_qp_dim *s_dim = &opts->s_dim;
+
+        mem->s_qp_in = (struct s_ocp_qp *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp);
+        mem->s_qp_out = (struct s_ocp_qp_sol *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_sol);
+        mem->s_hpipm_workspace = (struct s_ocp_qp_ipm_ws *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_ipm_ws);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_create(s_dim, mem->s_qp_in, c_ptr);
+        c_ptr += mem->s_qp_in->memsize;
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_sol_create(s_dim, mem->s_qp_out, c_ptr);
+        c_ptr += mem->s_qp_out->memsize;
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_ipm_ws_create(s_dim, opts->s_hpipm_opts, mem->s_hpipm_workspace, c_ptr);
+        c_ptr += mem->s_hpipm_workspace->memsize;
+    }
+    if (opts->mixed_precision)
+    {
+        struct s_ocp_qp_dim *s_dim = &opts->s_dim;
+
+        align_char_to(8, &c_ptr);
+        mem->qp_res = ocp_qp_res_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_calculate_size(dims);
+
+        align_char_to(8, &c_ptr);
+        mem->res_ws = ocp_qp_res_workspace_assign(dims, c_ptr);
+        c_ptr += ocp_qp_res_workspace_calculate_size(dims);
+
+        mem->s_seed = (struct s_ocp_qp_seed *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_seed);
+        mem->s_step = (struct s_ocp_qp_sol *) c_ptr;
+        c_ptr += sizeof(struct s_ocp_qp_sol);
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_seed_create(s_dim, mem->s_seed, c_ptr);
+        c_ptr += mem->s_seed->memsize;
+
+        align_char_to(8, &c_ptr);
+        s_ocp_qp_sol_create(s_dim, mem->s_step, c_ptr);
+        c_ptr += mem->s_step->memsize;
+    }
+#endif
+
     assert((char *) raw_memory + ocp_qp_hpipm_memory_calculate_size(config_, dims, opts_) >= c_ptr);
 
     return mem;
@@ -257,9 +482,25 @@ void ocp_qp_hpipm_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->status;
     }
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    else if (!strcmp(field, "mixed_precision_refine_iter"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->refine_iter;
+    }
+#endif
     else if (!strcmp(field, "tau_iter"))
     {
         double *tmp_ptr = value;
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+        if (mem->s_hpipm_workspace != NULL)
+        {
+            float tau_iter;
+            s_ocp_qp_ipm_get_tau_iter(mem->s_hpipm_workspace, &tau_iter);
+            *tmp_ptr = tau_iter;
+            return;
+        }
+#endif
         d_ocp_qp_ipm_get_tau_iter(mem->hpipm_workspace, tmp_ptr);
     }
     else
@@ -274,6 +515,26 @@ void ocp_qp_hpipm_memory_get(void *config_, void *mem_, const char *field, void*
 
 
 
+void ocp_qp_hpipm_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_hpipm_memory *mem = mem_;
+
+    if (!strcmp(field, "iter_max_cap"))
+    {
+        int *tmp_ptr = value;
+        mem->iter_max_cap = *tmp_ptr;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_hpipm_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -285,6 +546,284 @@ acados_size_t ocp_qp_hpipm_workspace_calculate_size(void *config_, void *dims_,
 
 
 
+/************************************************
+ * single precision conversions
+ ************************************************/
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+static void ocp_qp_hpipm_qp_in_to_single(ocp_qp_in *qp_in, struct s_ocp_qp *s_qp_in)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    int N = dims->N;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nx = dims->nx[ii];
+        int nu = dims->nu[ii];
+        int nb = dims->nb[ii];
+        int ng = dims->ng[ii];
+        int ns = dims->ns[ii];
+        int ne = dims->nbxe[ii] + dims->nbue[ii] + dims->nge[ii];
+        int ni = 2 * (nb + ng + ns);
+
+        if (ii < N)
+        {
+            blasfeo_cvt_d2s_mat(nu+nx+1, dims->nx[ii+1], qp_in->BAbt+ii, 0, 0, s_qp_in->BAbt+ii, 0, 0);
+            blasfeo_cvt_d2s_vec(dims->nx[ii+1], qp_in->b+ii, 0, s_qp_in->b+ii, 0);
+        }
+        blasfeo_cvt_d2s_mat(nu+nx+1, nu+nx, qp_in->RSQrq+ii, 0, 0, s_qp_in->RSQrq+ii, 0, 0);
+        blasfeo_cvt_d2s_vec(nu+nx+2*ns, qp_in->rqz+ii, 0, s_qp_in->rqz+ii, 0);
+        blasfeo_cvt_d2s_mat(nu+nx, ng, qp_in->DCt+ii, 0, 0, s_qp_in->DCt+ii, 0, 0);
+        blasfeo_cvt_d2s_vec(ni, qp_in->d+ii, 0, s_qp_in->d+ii, 0);
+        blasfeo_cvt_d2s_vec(ni, qp_in->d_mask+ii, 0, s_qp_in->d_mask+ii, 0);
+        blasfeo_cvt_d2s_vec(ni, qp_in->m+ii, 0, s_qp_in->m+ii, 0);
+        blasfeo_cvt_d2s_vec(2*ns, qp_in->Z+ii, 0, s_qp_in->Z+ii, 0);
+
+        for (int jj = 0; jj < nb; jj++)
+            s_qp_in->idxb[ii][jj] = qp_in->idxb[ii][jj];
+        for (int jj = 0; jj < nb+ng; jj++)
+            s_qp_in->idxs_rev[ii][jj] = qp_in->idxs_rev[ii][jj];
+        for (int jj = 0; jj < ne; jj++)
+            s_qp_in->idxe[ii][jj] = qp_in->idxe[ii][jj];
+        s_qp_in->diag_H_flag[ii] = qp_in->diag_H_flag[ii];
+    }
+}
+
+
+
+// to_single == 1: qp_out -> s_qp_out (initial guess), else s_qp_out -> qp_out
+static void ocp_qp_hpipm_qp_out_convert(ocp_qp_dims *dims, ocp_qp_out *qp_out,
+                                        struct s_ocp_qp_sol *s_qp_out, int to_single)
+{
+    int N = dims->N;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = dims->nu[ii] + dims->nx[ii] + 2 * dims->ns[ii];
+        int ni = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+        int npi = ii < N ? dims->nx[ii+1] : 0;
+
+        if (to_single)
+        {
+            blasfeo_cvt_d2s_vec(nv, qp_out->ux+ii, 0, s_qp_out->ux+ii, 0);
+            blasfeo_cvt_d2s_vec(npi, qp_out->pi+ii, 0, s_qp_out->pi+ii, 0);
+            blasfeo_cvt_d2s_vec(ni, qp_out->lam+ii, 0, s_qp_out->lam+ii, 0);
+            blasfeo_cvt_d2s_vec(ni, qp_out->t+ii, 0, s_qp_out->t+ii, 0);
+        }
+        else
+        {
+            blasfeo_cvt_s2d_vec(nv, s_qp_out->ux+ii, 0, qp_out->ux+ii, 0);
+            blasfeo_cvt_s2d_vec(npi, s_qp_out->pi+ii, 0, qp_out->pi+ii, 0);
+            blasfeo_cvt_s2d_vec(ni, s_qp_out->lam+ii, 0, qp_out->lam+ii, 0);
+            blasfeo_cvt_s2d_vec(ni, s_qp_out->t+ii, 0, qp_out->t+ii, 0);
+        }
+    }
+}
+
+
+
+// v += alpha * sv
+static void ocp_qp_hpipm_svec_axpy(int m, double alpha, struct blasfeo_svec *sv, struct blasfeo_dvec *v)
+{
+    for (int ii = 0; ii < m; ii++)
+        BLASFEO_DVECEL(v, ii) += alpha * BLASFEO_SVECEL(sv, ii);
+}
+
+
+
+static void ocp_qp_hpipm_step_update(ocp_qp_dims *dims, double alpha, struct s_ocp_qp_sol *s_step,
+                                     ocp_qp_out *qp_out)
+{
+    int N = dims->N;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int nv = dims->nu[ii] + dims->nx[ii] + 2 * dims->ns[ii];
+        int ni = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+        int npi = ii < N ? dims->nx[ii+1] : 0;
+
+        ocp_qp_hpipm_svec_axpy(nv, alpha, s_step->ux+ii, qp_out->ux+ii);
+        ocp_qp_hpipm_svec_axpy(npi, alpha, s_step->pi+ii, qp_out->pi+ii);
+        ocp_qp_hpipm_svec_axpy(ni, alpha, s_step->lam+ii, qp_out->lam+ii);
+        ocp_qp_hpipm_svec_axpy(ni, alpha, s_step->t+ii, qp_out->t+ii);
+    }
+}
+
+
+
+// largest alpha in (0, 1] such that lam and t stay positive, with fraction to the boundary tau
+static double ocp_qp_hpipm_step_length(ocp_qp_dims *dims, struct s_ocp_qp_sol *s_step, ocp_qp_out *qp_out,
+                                       double tau)
+{
+    int N = dims->N;
+    double alpha = 1.0;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        int ni = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+        for (int jj = 0; jj < ni; jj++)
+        {
+            // masked constraints have lam = t = 0 and are not moved
+            double lam = BLASFEO_DVECEL(qp_out->lam+ii, jj);
+            double dlam = BLASFEO_SVECEL(s_step->lam+ii, jj);
+            if (lam > 0.0 && dlam < 0.0 && -tau * lam / dlam < alpha)
+                alpha = -tau * lam / dlam;
+
+            double t = BLASFEO_DVECEL(qp_out->t+ii, jj);
+            double dt = BLASFEO_SVECEL(s_step->t+ii, jj);
+            if (t > 0.0 && dt < 0.0 && -tau * t / dt < alpha)
+                alpha = -tau * t / dt;
+        }
+    }
+
+    return alpha;
+}
+
+
+
+static double ocp_qp_hpipm_res_max(double res[4])
+{
+    double res_max = res[0];
+    for (int ii = 1; ii < 4; ii++)
+        res_max = res[ii] > res_max ? res[ii] : res_max;
+    return res_max;
+}
+
+
+
+// Iterative refinement of the float solution: the KKT residuals are computed in double and
+// the correction is obtained from the factorization of the last float IPM iteration, by
+// solving for the sensitivity of the solution with the residuals as seed; the step is shortened
+// such that lam and t stay positive.
+// Returns 1 if the double tolerances are met.
+static int ocp_qp_hpipm_refine(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_hpipm_opts *opts,
+                               ocp_qp_hpipm_memory *mem)
+{
+    ocp_qp_dims *dims = qp_in->dim;
+    struct d_ocp_qp_ipm_arg *arg = opts->hpipm_opts;
+    ocp_qp_res *qp_res = mem->qp_res;
+    struct s_ocp_qp_seed *s_seed = mem->s_seed;
+    int N = dims->N;
+
+    double tol[4] = {arg->res_g_max, arg->res_b_max, arg->res_d_max, arg->res_m_max};
+    double res[4], res_new[4];
+
+    ocp_qp_res_compute(qp_in, qp_out, qp_res, mem->res_ws);
+    ocp_qp_res_compute_nrm_inf(qp_res, res);
+
+    mem->refine_iter = 0;
+    while (res[0] > tol[0] || res[1] > tol[1] || res[2] > tol[2] || res[3] > tol[3])
+    {
+        if (mem->refine_iter >= opts->mixed_precision_refine_max)
+            return 0;
+
+        for (int ii = 0; ii <= N; ii++)
+        {
+            int nv = dims->nu[ii] + dims->nx[ii] + 2 * dims->ns[ii];
+            int ni = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+            int npi = ii < N ? dims->nx[ii+1] : 0;
+
+            blasfeo_cvt_d2s_vec(nv, qp_res->res_g+ii, 0, s_seed->seed_g+ii, 0);
+            blasfeo_cvt_d2s_vec(npi, qp_res->res_b+ii, 0, s_seed->seed_b+ii, 0);
+            blasfeo_cvt_d2s_vec(ni, qp_res->res_d+ii, 0, s_seed->seed_d+ii, 0);
+            blasfeo_cvt_d2s_vec(ni, qp_res->res_m+ii, 0, s_seed->seed_m+ii, 0);
+        }
+        s_ocp_qp_ipm_sens_frw(mem->s_qp_in, s_seed, mem->s_step, opts->s_hpipm_opts,
+                              mem->s_hpipm_workspace);
+
+        double alpha = ocp_qp_hpipm_step_length(dims, mem->s_step, qp_out, 0.995);
+        ocp_qp_hpipm_step_update(dims, alpha, mem->s_step, qp_out);
+        ocp_qp_res_compute(qp_in, qp_out, qp_res, mem->res_ws);
+        ocp_qp_res_compute_nrm_inf(qp_res, res_new);
+
+        // stop at float accuracy of the factorization
+        if (ocp_qp_hpipm_res_max(res_new) >= ocp_qp_hpipm_res_max(res))
+        {
+            ocp_qp_hpipm_step_update(dims, -alpha, mem->s_step, qp_out);
+            return 0;
+        }
+
+        for (int ii = 0; ii < 4; ii++)
+            res[ii] = res_new[ii];
+        mem->refine_iter++;
+    }
+
+    return 1;
+}
+
+
+
+static int ocp_qp_hpipm_single(ocp_qp_in *qp_in, ocp_qp_out *qp_out, ocp_qp_hpipm_opts *opts,
+                               ocp_qp_hpipm_memory *mem)
+{
+    qp_info *info = qp_out->misc;
+    acados_timer tot_timer, qp_timer, interface_timer;
+
+    acados_tic(&tot_timer);
+
+    // convert QP and initial guess
+    acados_tic(&interface_timer);
+    ocp_qp_hpipm_qp_in_to_single(qp_in, mem->s_qp_in);
+    ocp_qp_hpipm_qp_out_convert(qp_in->dim, qp_out, mem->s_qp_out, 1);
+    info->interface_time = acados_toc(&interface_timer);
+
+    // solve ipm, the iteration cap is applied to a copy of the (possibly shared) options
+    struct s_ocp_qp_ipm_arg s_arg_capped;
+    struct s_ocp_qp_ipm_arg *s_arg = opts->s_hpipm_opts;
+    if (mem->iter_max_cap > 0 && mem->iter_max_cap < s_arg->iter_max)
+    {
+        s_arg_capped = *s_arg;
+        s_arg_capped.iter_max = mem->iter_max_cap;
+        s_arg = &s_arg_capped;
+    }
+    acados_tic(&qp_timer);
+    s_ocp_qp_ipm_solve(mem->s_qp_in, mem->s_qp_out, s_arg, mem->s_hpipm_workspace);
+    s_ocp_qp_ipm_get_status(mem->s_hpipm_workspace, &mem->status);
+    info->solve_QP_time = acados_toc(&qp_timer);
+
+    // convert solution
+    acados_tic(&interface_timer);
+    ocp_qp_hpipm_qp_out_convert(qp_in->dim, qp_out, mem->s_qp_out, 0);
+    info->interface_time += acados_toc(&interface_timer);
+
+    if (mem->qp_res != NULL)
+    {
+        acados_tic(&qp_timer);
+        if (ocp_qp_hpipm_refine(qp_in, qp_out, opts, mem))
+            mem->status = 0;
+        else if (mem->status == 0)
+            mem->status = 1;  // double tolerances not met: refinement stalled or refine_max reached
+        info->solve_QP_time += acados_toc(&qp_timer);
+    }
+
+    info->total_time = acados_toc(&tot_timer);
+    info->num_iter = mem->s_hpipm_workspace->iter;
+    info->t_computed = 1;
+
+    mem->time_qp_solver_call = info->solve_QP_time;
+    mem->iter = mem->s_hpipm_workspace->iter;
+
+#ifndef BLASFEO_EXT_DEP_OFF
+    if (opts->print_level > 0)
+    {
+        float *stat; s_ocp_qp_ipm_get_stat(mem->s_hpipm_workspace, &stat);
+        int stat_m; s_ocp_qp_ipm_get_stat_m(mem->s_hpipm_workspace, &stat_m);
+        printf("\nsingle precision HPIPM\n");
+        s_print_exp_tran_mat(stat_m, mem->iter+1, stat, stat_m);
+    }
+#endif
+
+    int acados_status = mem->status;
+    if (mem->status == 0) acados_status = ACADOS_SUCCESS;
+    if (mem->status == 1) acados_status = ACADOS_MAXITER;
+    if (mem->status == 2) acados_status = ACADOS_MINSTEP;
+
+    return acados_status;
+}
+#endif
+
+
+
 /************************************************
  * functions
  ************************************************/
@@ -314,10 +853,23 @@ int ocp_qp_hpipm(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *
         blasfeo_dvecse(nu[ii]+nx[ii]+2*ns[ii], 0.0, qp_out->ux+ii, 0);
     }
 
-    // solve ipm
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (mem->s_hpipm_workspace != NULL)
+        return ocp_qp_hpipm_single(qp_in, qp_out, opts, mem);
+#endif
+
+    // solve ipm, the iteration cap is applied to a copy of the (possibly shared) options
+    struct d_ocp_qp_ipm_arg arg_capped;
+    struct d_ocp_qp_ipm_arg *arg = opts->hpipm_opts;
+    if (mem->iter_max_cap > 0 && mem->iter_max_cap < arg->iter_max)
+    {
+        arg_capped = *arg;
+        arg_capped.iter_max = mem->iter_max_cap;
+        arg = &arg_capped;
+    }
     acados_tic(&qp_timer);
     // print_ocp_qp_in(qp_in);
-    d_ocp_qp_ipm_solve(qp_in, qp_out, opts->hpipm_opts, mem->hpipm_workspace);
+    d_ocp_qp_ipm_solve(qp_in, qp_out, arg, mem->hpipm_workspace);
     d_ocp_qp_ipm_get_status(mem->hpipm_workspace, &mem->status);
 
     /* use this to send some QPs to Gianluca :) */
@@ -397,6 +949,14 @@ void ocp_qp_hpipm_solver_get(void *config_, void *qp_in_, void *qp_out_, void *o
     int nx = qp_in->dim->nx[stage];
     int nu = qp_in->dim->nu[stage];
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (mem->s_hpipm_workspace != NULL)
+    {
+        printf("\nerror: ocp_qp_hpipm_solver_get: field %s not available in single precision\n", field);
+        exit(1);
+    }
+#endif
+
     if (!strcmp(field, "P"))
     {
         if ((size1 != nx) || (size2 != nx))
@@ -458,6 +1018,14 @@ void ocp_qp_hpipm_eval_forw_sens(void *config_, void *param_qp_in_, void *seed,
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (mem->s_hpipm_workspace != NULL)
+    {
+        printf("\nerror: ocp_qp_hpipm: sensitivities not available in single precision\n");
+        exit(1);
+    }
+#endif
+
     d_ocp_qp_ipm_sens_frw(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
@@ -472,6 +1040,14 @@ void ocp_qp_hpipm_eval_adj_sens(void *config_, void *param_qp_in_, void *seed, v
     ocp_qp_hpipm_opts *opts = opts_;
     ocp_qp_hpipm_memory *mem = mem_;
 
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (mem->s_hpipm_workspace != NULL)
+    {
+        printf("\nerror: ocp_qp_hpipm: sensitivities not available in single precision\n");
+        exit(1);
+    }
+#endif
+
     d_ocp_qp_ipm_sens_adj(param_qp_in, seed, sens_qp_out, opts->hpipm_opts, mem->hpipm_workspace);
 
     return;
@@ -500,6 +1076,7 @@ void ocp_qp_hpipm_config_initialize_default(void *config_)
     config->memory_calculate_size = &ocp_qp_hpipm_memory_calculate_size;
     config->memory_assign = &ocp_qp_hpipm_memory_assign;
     config->memory_get = &ocp_qp_hpipm_memory_get;
+    config->memory_set = &ocp_qp_hpipm_memory_set;
     config->workspace_calculate_size = &ocp_qp_hpipm_workspace_calculate_size;
     config->evaluate = &ocp_qp_hpipm;
     config->solver_get = &ocp_qp_hpipm_solver_get;
@@ -38,6 +38,16 @@ extern "C" {
 
 // hpipm
 #include "hpipm/include/hpipm_d_ocp_qp_ipm.h"
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+#include "hpipm/include/hpipm_s_ocp_qp.h"
+#include "hpipm/include/hpipm_s_ocp_qp_dim.h"
+#include "hpipm/include/hpipm_s_ocp_qp_ipm.h"
+#include "hpipm/include/hpipm_s_ocp_qp_seed.h"
+#include "hpipm/include/hpipm_s_ocp_qp_sol.h"
+
+// lower bound on the float IPM tolerances, below float accuracy they are never met
+#define OCP_QP_HPIPM_SINGLE_TOL_MIN 1e-5
+#endif
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
 #include "acados/utils/types.h"
@@ -49,6 +59,13 @@ typedef struct ocp_qp_hpipm_opts_
 {
     struct d_ocp_qp_ipm_arg *hpipm_opts;
     int print_level;
+    int single_precision;  // solve in float, the QP is converted at entry and exit
+    int mixed_precision;  // solve in float, then refine with double residuals
+    int mixed_precision_refine_max;  // max number of refinement steps
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    struct s_ocp_qp_dim s_dim;  // aliases the arrays of the double dims
+    struct s_ocp_qp_ipm_arg *s_hpipm_opts;  // mirrors hpipm_opts
+#endif
 } ocp_qp_hpipm_opts;
 
 
@@ -57,9 +74,22 @@ typedef struct ocp_qp_hpipm_opts_
 typedef struct ocp_qp_hpipm_memory_
 {
     struct d_ocp_qp_ipm_ws *hpipm_workspace;
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    // only allocated if opts->single_precision, NULL otherwise
+    struct s_ocp_qp *s_qp_in;
+    struct s_ocp_qp_sol *s_qp_out;
+    struct s_ocp_qp_ipm_ws *s_hpipm_workspace;
+    // only allocated if opts->mixed_precision, NULL otherwise
+    ocp_qp_res *qp_res;
+    ocp_qp_res_ws *res_ws;
+    struct s_ocp_qp_seed *s_seed;
+    struct s_ocp_qp_sol *s_step;
+    int refine_iter;
+#endif
     double time_qp_solver_call;
     int iter;
     int status;
+    int iter_max_cap;  // upper bound on iter_max for the next solves, 0: no bound
 
 } ocp_qp_hpipm_memory;
 
@@ -80,6 +110,8 @@ acados_size_t ocp_qp_hpipm_memory_calculate_size(void *config, void *dims, void
 //
 void *ocp_qp_hpipm_memory_assign(void *config, void *dims, void *opts_, void *raw_memory);
 //
+void ocp_qp_hpipm_memory_set(void *config_, void *mem_, const char *field, void* value);
+//
 acados_size_t ocp_qp_hpipm_workspace_calculate_size(void *config, void *dims, void *opts_);
 //
 int ocp_qp_hpipm(void *config, void *qp_in, void *qp_out, void *opts_, void *mem_, void *work_);
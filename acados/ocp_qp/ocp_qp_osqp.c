@@ -285,10 +285,8 @@ static int acados_osqp_nnzmax_P(const ocp_qp_dims *dims)
 
     for (int ii = 0; ii <= N; ii++)
     {
-        nnz += nx[ii] * nx[ii];      // Q
-        nnz += nu[ii] * nu[ii];      // R
-        nnz += 2 * nx[ii] * nu[ii];  // S // TODO 1*, likely only the L or U are needed
-        nnz += 2 * ns[ii];           // Z
+        nnz += (nx[ii] + nu[ii]) * (nx[ii] + nu[ii] + 1) / 2;  // upper triangle of RSQ
+        nnz += 2 * ns[ii];                                    // Z
     }
 
     return nnz;
@@ -350,6 +348,21 @@ static void update_gradient(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 
 
 
+// writes val to x[idx] and records the index if the value changed
+static void update_csc_entry(c_float val, c_int idx, c_float *x, c_int *upd_idx, c_float *upd_x,
+                             c_int *n_upd)
+{
+    if (x[idx] != val)
+    {
+        x[idx] = val;
+        upd_idx[*n_upd] = idx;
+        upd_x[*n_upd] = val;
+        (*n_upd)++;
+    }
+}
+
+
+
 static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
@@ -362,7 +375,9 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
     int ii, jj, kk;
 
     // CSC format: P_i are row indices and P_p are column pointers
-    c_int nn = 0, offset = 0, col = 0;
+    // the pattern is the union of the nonzeros of RSQ over all calls, entries that become zero
+    // are kept as explicit zeros; the diagonal is always kept
+    c_int nn = 0, offset = 0, col = 0, cc = 0;
     for (kk = 0; kk <= N; kk++)
     {
         // write RSQ[kk]
@@ -374,8 +389,14 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
             for (ii = 0; ii <= jj; ii++)
             {
                 // we write only the upper triangular part
-                mem->P_i[nn] = offset + ii;
-                nn++;
+                mem->P_mask[cc] |= ii == jj || BLASFEO_DMATEL(in->RSQrq+kk, jj, ii) != 0.0;
+                if (mem->P_mask[cc])
+                {
+                    mem->P_i[nn] = offset + ii;
+                    mem->P_x[nn] = 0.0;
+                    nn++;
+                }
+                cc++;
             }
         }
         offset += nx[kk] + nu[kk];
@@ -388,6 +409,7 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
             // diagonal
             mem->P_i[nn] = offset + jj;
+            mem->P_x[nn] = 0.0;
             nn++;
         }
 
@@ -399,7 +421,8 @@ static void update_hessian_structure(const ocp_qp_in *in, ocp_qp_osqp_memory *me
 
 
 
-static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+// returns 1 if an entry outside of the stored pattern became nonzero
+static int update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
 
@@ -408,26 +431,47 @@ static void update_hessian_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
     int *nu = dims->nu;
     int *ns = dims->ns;
 
-    int ii, kk;
+    int ii, jj, kk;
+    int pattern_changed = 0;
+
+    mem->P_nupd = 0;
 
     // Traversing the matrix in column-major order
-    c_int nn = 0;
+    c_int nn = 0, cc = 0;
     for (kk = 0; kk <= N; kk++)
     {
         // writing RSQ[kk]
         // we write the lower triangular part in row-major order
         // that's the same as writing the upper triangular part in
         // column-major order
-        for (ii = 0; ii < nx[kk] + nu[kk]; ii++)
+        for (jj = 0; jj < nx[kk] + nu[kk]; jj++)
         {
-            blasfeo_unpack_dmat(1, ii+1, in->RSQrq+kk, ii, 0, mem->P_x+nn, 1);
-            nn += ii+1;
+            for (ii = 0; ii <= jj; ii++)
+            {
+                c_float val = BLASFEO_DMATEL(in->RSQrq+kk, jj, ii);
+                if (mem->P_mask[cc])
+                {
+                    update_csc_entry(val, nn, mem->P_x, mem->P_upd_idx, mem->P_upd_x, &mem->P_nupd);
+                    nn++;
+                }
+                else if (val != 0.0)
+                {
+                    pattern_changed = 1;
+                }
+                cc++;
+            }
         }
 
         // write Z[kk]
-        blasfeo_unpack_dvec(2*ns[kk], in->Z+kk, 0, mem->P_x+nn, 1);
-        nn += 2*ns[kk];
+        for (jj = 0; jj < 2*ns[kk]; jj++)
+        {
+            update_csc_entry(BLASFEO_DVECEL(in->Z+kk, jj), nn, mem->P_x, mem->P_upd_idx,
+                             mem->P_upd_x, &mem->P_nupd);
+            nn++;
+        }
     }
+
+    return pattern_changed;
 }
 
 
@@ -460,7 +504,9 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
     slk_start += con_start;
 
     // CSC format: A_i are row indices and A_p are column pointers
-    c_int nn = 0, col = 0;
+    // the pattern is the union of the nonzeros of B, A, D and C over all calls, entries that
+    // become zero are kept as explicit zeros; cc counts these candidate entries
+    c_int nn = 0, col = 0, cc = 0;
     for (kk = 0; kk <= N; kk++)
     {
 
@@ -485,8 +531,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                 // write column from B
                 for (ii = 0; ii < nx[kk + 1]; ii++)
                 {
-                    mem->A_i[nn] = row_offset_dyn + ii;
-                    nn++;
+                    mem->A_mask[cc] |= BLASFEO_DMATEL(in->BAbt+kk, jj, ii) != 0.0;
+                    if (mem->A_mask[cc])
+                    {
+                        mem->A_i[nn] = row_offset_dyn + ii;
+                        nn++;
+                    }
+                    cc++;
                 }
             }
 
@@ -505,8 +556,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
             // write column from D
             for (ii = 0; ii < ng[kk]; ii++)
             {
-                mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ii;
-                nn++;
+                mem->A_mask[cc] |= BLASFEO_DMATEL(in->DCt+kk, jj, ii) != 0.0;
+                if (mem->A_mask[cc])
+                {
+                    mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ii;
+                    nn++;
+                }
+                cc++;
             }
 
             // replicated softed bound on u
@@ -535,8 +591,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                 {
                     if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                     {
-                        mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ng[kk] + nsb + itmp;
-                        nn++;
+                        mem->A_mask[cc] |= BLASFEO_DMATEL(in->DCt+kk, jj, ii) != 0.0;
+                        if (mem->A_mask[cc])
+                        {
+                            mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ng[kk] + nsb + itmp;
+                            nn++;
+                        }
+                        cc++;
                         itmp++;
                     }
                 }
@@ -562,8 +623,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                 // write column from A
                 for (ii = 0; ii < nx[kk + 1]; ii++)
                 {
-                    mem->A_i[nn] = row_offset_dyn + ii;
-                    nn++;
+                    mem->A_mask[cc] |= BLASFEO_DMATEL(in->BAbt+kk, nu[kk]+jj, ii) != 0.0;
+                    if (mem->A_mask[cc])
+                    {
+                        mem->A_i[nn] = row_offset_dyn + ii;
+                        nn++;
+                    }
+                    cc++;
                 }
             }
 
@@ -582,8 +648,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
             // write column from C
             for (ii = 0; ii < ng[kk]; ii++)
             {
-                mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ii;
-                nn++;
+                mem->A_mask[cc] |= BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii) != 0.0;
+                if (mem->A_mask[cc])
+                {
+                    mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ii;
+                    nn++;
+                }
+                cc++;
             }
 
             // replicated softed bound on x
@@ -612,8 +683,13 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
                 {
                     if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                     {
-                        mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ng[kk] + nsb + itmp;
-                        nn++;
+                        mem->A_mask[cc] |= BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii) != 0.0;
+                        if (mem->A_mask[cc])
+                        {
+                            mem->A_i[nn] = con_start + row_offset_con + nb[kk] + ng[kk] + nsb + itmp;
+                            nn++;
+                        }
+                        cc++;
                         itmp++;
                     }
                 }
@@ -677,12 +753,36 @@ static void update_constraints_matrix_structure(const ocp_qp_in *in, ocp_qp_osqp
 
     // end of matrix
     mem->A_p[col] = nn;
+
+    for (ii = 0; ii < nn; ii++)
+    {
+        mem->A_x[ii] = 0.0;
+    }
 }
 
 
 
-// TODO move constant stuff like I to structure routine
-static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
+// writes a candidate entry of B, A, D or C, returns 1 if it is nonzero but not part of the pattern
+static int update_constraints_matrix_candidate(c_float val, c_int *nn, c_int *cc, ocp_qp_osqp_memory *mem)
+{
+    int pattern_changed = 0;
+    if (mem->A_mask[*cc])
+    {
+        update_csc_entry(val, *nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
+        (*nn)++;
+    }
+    else if (val != 0.0)
+    {
+        pattern_changed = 1;
+    }
+    (*cc)++;
+    return pattern_changed;
+}
+
+
+
+// returns 1 if an entry outside of the stored pattern became nonzero
+static int update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memory *mem)
 {
     ocp_qp_dims *dims = in->dim;
 
@@ -694,10 +794,12 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
     int *ns = dims->ns;
 
     int ii, jj, kk;
+    int pattern_changed = 0;
 
+    mem->A_nupd = 0;
 
     // Traverse matrix in column-major order
-    c_int nn = 0;
+    c_int nn = 0, cc = 0;
     for (kk = 0; kk <= N; kk++)
     {
 
@@ -707,8 +809,11 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             if (kk < dims->N)
             {
                 // write column from B
-                blasfeo_unpack_dmat(1, nx[kk+1], in->BAbt+kk, jj, 0, mem->A_x+nn, 1);
-                nn += nx[kk+1];
+                for (ii = 0; ii < nx[kk + 1]; ii++)
+                {
+                    pattern_changed |= update_constraints_matrix_candidate(
+                        BLASFEO_DMATEL(in->BAbt+kk, jj, ii), &nn, &cc, mem);
+                }
             }
 
             // write bound on u
@@ -716,7 +821,7 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == jj)
                 {
-                    mem->A_x[nn] = 1.0;
+                    update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                     break;
                 }
@@ -724,15 +829,18 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             int idxbu = ii;
 
             // write column from D
-            blasfeo_unpack_dmat(1, ng[kk], in->DCt+kk, jj, 0, mem->A_x+nn, 1);
-            nn += ng[kk];
+            for (ii = 0; ii < ng[kk]; ii++)
+            {
+                pattern_changed |= update_constraints_matrix_candidate(
+                    BLASFEO_DMATEL(in->DCt+kk, jj, ii), &nn, &cc, mem);
+            }
 
             // replicated softed bound on u
             if (idxbu<nb[kk]) // bounded input
             {
                 if (in->idxs_rev[kk][idxbu]>=0) // softed bounded input
                 {
-                    mem->A_x[nn] = 1.0;
+                    update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                 }
             }
@@ -742,8 +850,8 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                 {
-                    mem->A_x[nn] = BLASFEO_DMATEL(in->DCt+kk, jj, ii);
-                    nn++;
+                    pattern_changed |= update_constraints_matrix_candidate(
+                        BLASFEO_DMATEL(in->DCt+kk, jj, ii), &nn, &cc, mem);
                 }
             }
 
@@ -755,15 +863,18 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             if (kk > 0)
             {
                 // write column from -I
-                mem->A_x[nn] = -1.0;
+                update_csc_entry(-1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                 nn++;
             }
 
             if (kk < N)
             {
                 // write column from A
-                blasfeo_unpack_dmat(1, nx[kk+1], in->BAbt+kk, nu[kk]+jj, 0, mem->A_x+nn, 1);
-                nn += nx[kk+1];
+                for (ii = 0; ii < nx[kk + 1]; ii++)
+                {
+                    pattern_changed |= update_constraints_matrix_candidate(
+                        BLASFEO_DMATEL(in->BAbt+kk, nu[kk]+jj, ii), &nn, &cc, mem);
+                }
             }
 
             // write bound on x
@@ -771,7 +882,7 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxb[kk][ii] == dims->nu[kk] + jj)
                 {
-                    mem->A_x[nn] = 1.0;
+                    update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                     break;
                 }
@@ -779,15 +890,18 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             int idxbx = ii;
 
             // write column from C
-            blasfeo_unpack_dmat(1, ng[kk], in->DCt+kk, nu[kk]+jj, 0, mem->A_x+nn, 1);
-            nn += ng[kk];
+            for (ii = 0; ii < ng[kk]; ii++)
+            {
+                pattern_changed |= update_constraints_matrix_candidate(
+                    BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii), &nn, &cc, mem);
+            }
 
             // replicated softed bound on x
             if (idxbx<nb[kk]) // bounded input
             {
                 if (in->idxs_rev[kk][idxbx]>=0) // softed bounded input
                 {
-                    mem->A_x[nn] = 1.0;
+                    update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                 }
             }
@@ -797,8 +911,8 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][nb[kk]+ii]>=0) // softed
                 {
-                    mem->A_x[nn] = BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii);
-                    nn++;
+                    pattern_changed |= update_constraints_matrix_candidate(
+                        BLASFEO_DMATEL(in->DCt+kk, nu[kk]+jj, ii), &nn, &cc, mem);
                 }
             }
 
@@ -813,14 +927,14 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][ii]==jj)
                 {
-                    mem->A_x[nn] = 1.0;
+                    update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                     // no break, there could possibly be multiple
                 }
             }
 
             // nonnegativity constraint
-            mem->A_x[nn] = 1.0;
+            update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
             nn++;
         }
 
@@ -833,19 +947,20 @@ static void update_constraints_matrix_data(const ocp_qp_in *in, ocp_qp_osqp_memo
             {
                 if (in->idxs_rev[kk][ii]==jj)
                 {
-                    mem->A_x[nn] = -1.0;
+                    update_csc_entry(-1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
                     nn++;
                     // no break, there could possibly be multiple
                 }
             }
 
             // nonnegativity constraint
-            mem->A_x[nn] = 1.0;
+            update_csc_entry(1.0, nn, mem->A_x, mem->A_upd_idx, mem->A_upd_x, &mem->A_nupd);
             nn++;
         }
 
     }
 
+    return pattern_changed;
 }
 
 
@@ -940,8 +1055,18 @@ static void ocp_qp_osqp_update_memory(const ocp_qp_in *in, const ocp_qp_osqp_opt
 
     update_bounds(in, mem);
     update_gradient(in, mem);
-    update_hessian_data(in, mem);
-    update_constraints_matrix_data(in, mem);
+    mem->pattern_changed = update_hessian_data(in, mem);
+    mem->pattern_changed |= update_constraints_matrix_data(in, mem);
+
+    if (mem->pattern_changed)
+    {
+        // new structural nonzeros: grow the pattern
+        mem->pattern_setups++;
+        update_hessian_structure(in, mem);
+        update_constraints_matrix_structure(in, mem);
+        update_hessian_data(in, mem);
+        update_constraints_matrix_data(in, mem);
+    }
 
     //printf("\nP\n");
     //print_csc_as_dns(mem->osqp_data->P);
@@ -1174,10 +1299,16 @@ acados_size_t ocp_qp_osqp_memory_calculate_size(void *config_, void *dims_, void
     size += P_nnzmax * sizeof(c_float);  // P_x
     size += P_nnzmax * sizeof(c_int);    // P_i
     size += (n + 1) * sizeof(c_int);     // P_p
+    size += P_nnzmax * sizeof(c_float);  // P_upd_x
+    size += P_nnzmax * sizeof(c_int);    // P_upd_idx
+    size += P_nnzmax * sizeof(char);     // P_mask
 
     size += A_nnzmax * sizeof(c_float);  // A_x
     size += A_nnzmax * sizeof(c_int);    // A_i
     size += (n + 1) * sizeof(c_int);     // A_p
+    size += A_nnzmax * sizeof(c_float);  // A_upd_x
+    size += A_nnzmax * sizeof(c_int);    // A_upd_idx
+    size += A_nnzmax * sizeof(char);     // A_mask
 
     size += sizeof(OSQPData);
     size += 2 * sizeof(csc);  // matrices P and A
@@ -1493,7 +1624,11 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
 
     mem->P_nnzmax = P_nnzmax;
     mem->A_nnzmax = A_nnzmax;
+    mem->P_nupd = 0;
+    mem->A_nupd = 0;
     mem->first_run = 1;
+    mem->pattern_setups = 0;
+    mem->pattern_changed = 0;
 
     align_char_to(8, &c_ptr);
 
@@ -1513,6 +1648,12 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_x = (c_float *) c_ptr;
     c_ptr += (mem->A_nnzmax) * sizeof(c_float);
 
+    mem->P_upd_x = (c_float *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_float);
+
+    mem->A_upd_x = (c_float *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_float);
+
     // ints
     mem->P_i = (c_int *) c_ptr;
     c_ptr += (mem->P_nnzmax) * sizeof(c_int);
@@ -1526,6 +1667,27 @@ void *ocp_qp_osqp_memory_assign(void *config_, void *dims_, void *opts_, void *r
     mem->A_p = (c_int *) c_ptr;
     c_ptr += (n + 1) * sizeof(c_int);
 
+    mem->P_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(c_int);
+
+    mem->A_upd_idx = (c_int *) c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(c_int);
+
+    // chars
+    mem->P_mask = c_ptr;
+    c_ptr += (mem->P_nnzmax) * sizeof(char);
+
+    mem->A_mask = c_ptr;
+    c_ptr += (mem->A_nnzmax) * sizeof(char);
+
+    // empty patterns, grown on the first call
+    for (int ii = 0; ii < mem->P_nnzmax; ii++)
+        mem->P_mask[ii] = 0;
+    for (int ii = 0; ii < mem->A_nnzmax; ii++)
+        mem->A_mask[ii] = 0;
+
+    align_char_to(8, &c_ptr);
+
     mem->osqp_data = (OSQPData *) c_ptr;
     c_ptr += sizeof(OSQPData);
 
@@ -1579,6 +1741,11 @@ void ocp_qp_osqp_memory_get(void *config_, void *mem_, const char *field, void*
         int *tmp_ptr = value;
         *tmp_ptr = mem->status;
     }
+    else if (!strcmp(field, "pattern_setups"))
+    {
+        int *tmp_ptr = value;
+        *tmp_ptr = mem->pattern_setups;
+    }
     else
     {
         printf("\nerror: ocp_qp_osqp_memory_get: field %s not available\n", field);
@@ -1730,20 +1897,38 @@ int ocp_qp_osqp(void *config_, void *qp_in_, void *qp_out_, void *opts_, void *m
     acados_tic(&qp_timer);
 
     // update osqp workspace with new data
-    if (!mem->first_run)
-    {
-        osqp_update_lin_cost(mem->osqp_work, mem->q);
-        osqp_update_P_A(mem->osqp_work, mem->P_x, NULL, mem->P_nnzmax, mem->A_x, NULL,
-                        mem->A_nnzmax);
-        osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
-        // TODO(oj): update OSQP options here if they were updated?
-    }
-    else
+    if (mem->first_run)
     {
         // mem->osqp_work = osqp_setup(mem->osqp_data, opts->osqp_opts);
         osqp_init_data(mem->osqp_data, opts->osqp_opts, mem->osqp_work);
         mem->first_run = 0;
     }
+    else if (mem->pattern_changed)
+    {
+        // sparsity pattern of P or A changed: setup OSQP again (cold start)
+        mem->osqp_work->linsys_solver->free(mem->osqp_work->linsys_solver);
+        osqp_init_data(mem->osqp_data, opts->osqp_opts, mem->osqp_work);
+    }
+    else
+    {
+        osqp_update_lin_cost(mem->osqp_work, mem->q);
+        // only pass changed entries, the KKT system is refactorized only if P or A changed
+        if (mem->P_nupd > 0 && mem->A_nupd > 0)
+        {
+            osqp_update_P_A(mem->osqp_work, mem->P_upd_x, mem->P_upd_idx, mem->P_nupd,
+                            mem->A_upd_x, mem->A_upd_idx, mem->A_nupd);
+        }
+        else if (mem->P_nupd > 0)
+        {
+            osqp_update_P(mem->osqp_work, mem->P_upd_x, mem->P_upd_idx, mem->P_nupd);
+        }
+        else if (mem->A_nupd > 0)
+        {
+            osqp_update_A(mem->osqp_work, mem->A_upd_x, mem->A_upd_idx, mem->A_nupd);
+        }
+        osqp_update_bounds(mem->osqp_work, mem->l, mem->u);
+        // TODO(oj): update OSQP options here if they were updated?
+    }
 
     // check settings:
     // OSQPSettings *settings = mem->osqp_work->settings;
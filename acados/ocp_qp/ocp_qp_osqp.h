@@ -61,11 +61,22 @@ typedef struct ocp_qp_osqp_memory_
     c_int *P_i;
     c_int *P_p;
     c_float *P_x;
+    char *P_mask;       // candidate entries of RSQ that are part of the sparsity pattern
+    c_int *P_upd_idx;   // indices of P_x changed since the last call
+    c_float *P_upd_x;   // corresponding values
+    c_int P_nupd;
 
     c_int A_nnzmax;
     c_int *A_i;
     c_int *A_p;
     c_float *A_x;
+    char *A_mask;       // candidate entries of B, A, D, C that are part of the sparsity pattern
+    c_int *A_upd_idx;   // indices of A_x changed since the last call
+    c_float *A_upd_x;   // corresponding values
+    c_int A_nupd;
+
+    int pattern_changed;
+    int pattern_setups;  // number of OSQP setups after the pattern grew, excluding the first one
 
     OSQPData *osqp_data;
     OSQPWorkspace *osqp_work;
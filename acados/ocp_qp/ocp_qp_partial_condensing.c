@@ -40,6 +40,7 @@
 #include "hpipm/include/hpipm_d_ocp_qp_red.h"
 // hpipm
 #include "hpipm/include/hpipm_d_cond.h"
+#include "hpipm/include/hpipm_d_cond_aux.h"
 #include "hpipm/include/hpipm_d_dense_qp.h"
 #include "hpipm/include/hpipm_d_dense_qp_sol.h"
 #include "hpipm/include/hpipm_d_ocp_qp.h"
@@ -144,6 +145,17 @@ void ocp_qp_partial_condensing_dims_get(void *config_, void *dims_, const char *
         ocp_qp_dims **ptr = value;
         *ptr = dims->pcond_dims;
     }
+    else if(!strcmp(field, "cond_N"))
+    {
+        int *ptr = value;
+        *ptr = dims->pcond_dims->N;
+    }
+    else if(!strcmp(field, "block_size"))
+    {
+        int *ptr = value;
+        for (int i = 0; i < dims->pcond_dims->N+1; i++)
+            ptr[i] = dims->block_size[i];
+    }
     else
     {
         printf("\nerror: ocp_qp_partial_condensing_dims_get: field %s not available\n", field);
@@ -290,6 +302,9 @@ void ocp_qp_partial_condensing_opts_set(void *opts_, const char *field, void* va
     if(!strcmp(field, "N"))
     {
         int *tmp_ptr = value;
+        // block sizes set for another horizon do not apply anymore
+        if (*tmp_ptr != opts->N2)
+            opts->block_size_was_set = false;
         opts->N2 = *tmp_ptr;
     }
     else if(!strcmp(field, "N_bkp"))
@@ -390,6 +405,8 @@ acados_size_t ocp_qp_partial_condensing_memory_calculate_size(void *dims_, void
     size += sizeof(struct d_ocp_qp_reduce_eq_dof_ws);
     size += d_ocp_qp_reduce_eq_dof_ws_memsize(dims->orig_dims);
 
+    size += (opts->N2+1)*sizeof(int); // block_start
+
     size += 2*8;
     make_int_multiple_of(8, &size);
 
@@ -451,6 +468,13 @@ void *ocp_qp_partial_condensing_memory_assign(void *dims_, void *opts_, void *ra
 
     mem->dims = dims;
 
+    assign_and_advance_int(dims->pcond_dims->N+1, &mem->block_start, &c_ptr);
+    mem->block_start[0] = 0;
+    for (int ii = 0; ii < dims->pcond_dims->N; ii++)
+        mem->block_start[ii+1] = mem->block_start[ii] + dims->block_size[ii];
+
+    mem->thread_pool = NULL;
+
     assert((char *) raw_memory + ocp_qp_partial_condensing_memory_calculate_size(dims, opts) >= c_ptr);
 
     return mem;
@@ -499,6 +523,25 @@ void ocp_qp_partial_condensing_memory_get(void *config_, void *mem_, const char
 
 
 
+void ocp_qp_partial_condensing_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_partial_condensing_memory *mem = mem_;
+
+    if (!strcmp(field, "thread_pool"))
+    {
+        mem->thread_pool = value;
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_partial_condensing_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -510,6 +553,216 @@ acados_size_t ocp_qp_partial_condensing_workspace_calculate_size(void *dims_, vo
 
 
 
+/************************************************
+ * blockwise condensing
+ ************************************************/
+
+// The blocks of the partially condensed qp are condensed and expanded independently, each with
+// its own hpipm cond workspace. The loops of d_part_cond_qp_cond* and d_part_cond_qp_expand_sol
+// are reproduced here per block, such that the blocks can be processed in parallel with results
+// identical to the serial hpipm routines.
+
+typedef struct
+{
+    ocp_qp_in *red_qp;
+    ocp_qp_in *pcond_qp;
+    ocp_qp_out *red_sol;
+    ocp_qp_out *pcond_sol;
+    struct d_part_cond_qp_arg *arg;
+    struct d_part_cond_qp_ws *ws;
+    int *block_start;
+    int *block_size;
+    int N2;
+} ocp_qp_partial_condensing_block_args;
+
+
+
+// alias of the stages block_start, ..., block_start+bs of qp as qp with horizon bs
+static void ocp_qp_partial_condensing_alias_block(ocp_qp_in *qp, int first, int bs,
+    struct d_ocp_qp_dim *block_dim, struct d_ocp_qp *block_qp)
+{
+    struct d_ocp_qp_dim *dim = qp->dim;
+
+    *block_dim = *dim;
+    block_dim->N = bs;
+    block_dim->nx = dim->nx+first;
+    block_dim->nu = dim->nu+first;
+    block_dim->nb = dim->nb+first;
+    block_dim->nbx = dim->nbx+first;
+    block_dim->nbu = dim->nbu+first;
+    block_dim->ng = dim->ng+first;
+    block_dim->ns = dim->ns+first;
+    block_dim->nsbx = dim->nsbx+first;
+    block_dim->nsbu = dim->nsbu+first;
+    block_dim->nsg = dim->nsg+first;
+    block_dim->nbxe = dim->nbxe+first;
+    block_dim->nbue = dim->nbue+first;
+    block_dim->nge = dim->nge+first;
+
+    *block_qp = *qp;
+    block_qp->dim = block_dim;
+    block_qp->BAbt = qp->BAbt+first;
+    block_qp->b = qp->b+first;
+    block_qp->RSQrq = qp->RSQrq+first;
+    block_qp->rqz = qp->rqz+first;
+    block_qp->DCt = qp->DCt+first;
+    block_qp->d = qp->d+first;
+    block_qp->d_mask = qp->d_mask+first;
+    block_qp->m = qp->m+first;
+    block_qp->Z = qp->Z+first;
+    block_qp->idxb = qp->idxb+first;
+    block_qp->idxs_rev = qp->idxs_rev+first;
+    block_qp->idxe = qp->idxe+first;
+    block_qp->diag_H_flag = qp->diag_H_flag+first;
+}
+
+
+
+static void ocp_qp_partial_condensing_block_cond(void *args_, int ii)
+{
+    ocp_qp_partial_condensing_block_args *args = args_;
+    ocp_qp_in *pcond_qp = args->pcond_qp;
+    struct d_cond_qp_arg *cond_arg = args->arg->cond_arg+ii;
+    struct d_cond_qp_ws *cond_ws = args->ws->cond_workspace+ii;
+
+    struct d_ocp_qp_dim block_dim;
+    struct d_ocp_qp block_qp;
+    ocp_qp_partial_condensing_alias_block(args->red_qp, args->block_start[ii], args->block_size[ii],
+                                          &block_dim, &block_qp);
+
+    if (ii < args->N2)
+        d_cond_BAbt(&block_qp, pcond_qp->BAbt+ii, pcond_qp->b+ii, cond_arg, cond_ws);
+    d_cond_RSQrq(&block_qp, pcond_qp->RSQrq+ii, pcond_qp->rqz+ii, cond_arg, cond_ws);
+    d_cond_DCtd(&block_qp, pcond_qp->idxb[ii], pcond_qp->DCt+ii, pcond_qp->d+ii, pcond_qp->d_mask+ii,
+                pcond_qp->idxs_rev[ii], pcond_qp->Z+ii, pcond_qp->rqz+ii, cond_arg, cond_ws);
+}
+
+
+
+static void ocp_qp_partial_condensing_block_cond_lhs(void *args_, int ii)
+{
+    ocp_qp_partial_condensing_block_args *args = args_;
+    ocp_qp_in *pcond_qp = args->pcond_qp;
+    struct d_cond_qp_arg *cond_arg = args->arg->cond_arg+ii;
+    struct d_cond_qp_ws *cond_ws = args->ws->cond_workspace+ii;
+
+    struct d_ocp_qp_dim block_dim;
+    struct d_ocp_qp block_qp;
+    ocp_qp_partial_condensing_alias_block(args->red_qp, args->block_start[ii], args->block_size[ii],
+                                          &block_dim, &block_qp);
+
+    if (ii < args->N2)
+        d_cond_BAt(&block_qp, pcond_qp->BAbt+ii, cond_arg, cond_ws);
+    d_cond_RSQ(&block_qp, pcond_qp->RSQrq+ii, cond_arg, cond_ws);
+    d_cond_DCt(&block_qp, pcond_qp->idxb[ii], pcond_qp->DCt+ii, pcond_qp->idxs_rev[ii],
+               pcond_qp->Z+ii, cond_arg, cond_ws);
+}
+
+
+
+static void ocp_qp_partial_condensing_block_cond_rhs(void *args_, int ii)
+{
+    ocp_qp_partial_condensing_block_args *args = args_;
+    ocp_qp_in *pcond_qp = args->pcond_qp;
+    struct d_cond_qp_arg *cond_arg = args->arg->cond_arg+ii;
+    struct d_cond_qp_ws *cond_ws = args->ws->cond_workspace+ii;
+
+    struct d_ocp_qp_dim block_dim;
+    struct d_ocp_qp block_qp;
+    ocp_qp_partial_condensing_alias_block(args->red_qp, args->block_start[ii], args->block_size[ii],
+                                          &block_dim, &block_qp);
+
+    if (ii < args->N2)
+        d_cond_b(&block_qp, pcond_qp->b+ii, cond_arg, cond_ws);
+    d_cond_rq(&block_qp, pcond_qp->rqz+ii, cond_arg, cond_ws);
+    d_cond_d(&block_qp, pcond_qp->d+ii, pcond_qp->d_mask+ii, pcond_qp->rqz+ii, cond_arg, cond_ws);
+}
+
+
+
+static void ocp_qp_partial_condensing_block_expand_sol(void *args_, int ii)
+{
+    ocp_qp_partial_condensing_block_args *args = args_;
+    ocp_qp_out *red_sol = args->red_sol;
+    ocp_qp_out *pcond_sol = args->pcond_sol;
+    int first = args->block_start[ii];
+    int bs = args->block_size[ii];
+
+    struct d_ocp_qp_dim block_dim;
+    struct d_ocp_qp block_qp;
+    ocp_qp_partial_condensing_alias_block(args->red_qp, first, bs, &block_dim, &block_qp);
+
+    struct d_ocp_qp_sol block_sol = *red_sol;
+    block_sol.dim = &block_dim;
+    block_sol.ux = red_sol->ux+first;
+    block_sol.pi = red_sol->pi+first;
+    block_sol.lam = red_sol->lam+first;
+    block_sol.t = red_sol->t+first;
+
+    // stage ii of the partially condensed solution as dense qp solution
+    struct d_dense_qp_sol dense_sol;
+    memset(&dense_sol, 0, sizeof(dense_sol));
+    dense_sol.v = pcond_sol->ux+ii;
+    dense_sol.pi = pcond_sol->pi+ii;
+    dense_sol.lam = pcond_sol->lam+ii;
+    dense_sol.t = pcond_sol->t+ii;
+
+    d_expand_sol(&block_qp, &dense_sol, &block_sol, args->arg->cond_arg+ii, args->ws->cond_workspace+ii);
+
+    // multipliers of the dynamics linking block ii to block ii+1
+    if (ii < args->N2)
+        blasfeo_dveccp(red_sol->dim->nx[first+bs], pcond_sol->pi+ii, 0, red_sol->pi+first+bs-1, 0);
+}
+
+
+
+// true if the blocks are condensed by the functions above, otherwise the serial hpipm routines are used
+static bool ocp_qp_partial_condensing_blockwise(ocp_qp_partial_condensing_memory *mem)
+{
+    if (mem->dims->pcond_dims->N < 1)
+        return false;
+#if defined(ACADOS_WITH_THREAD_POOL)
+    return mem->thread_pool != NULL && acados_thread_pool_num_threads(mem->thread_pool) > 1;
+#elif defined(ACADOS_WITH_OPENMP)
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+static void ocp_qp_partial_condensing_run_blocks(ocp_qp_partial_condensing_memory *mem,
+    ocp_qp_partial_condensing_opts *opts, ocp_qp_in *pcond_qp, ocp_qp_out *pcond_sol,
+    acados_parallel_fun fun)
+{
+    ocp_qp_partial_condensing_block_args args;
+    args.red_qp = mem->red_qp;
+    args.pcond_qp = pcond_qp;
+    args.red_sol = mem->red_sol;
+    args.pcond_sol = pcond_sol;
+    args.arg = opts->hpipm_pcond_opts;
+    args.ws = mem->hpipm_pcond_work;
+    args.block_start = mem->block_start;
+    args.block_size = mem->dims->block_size;
+    args.N2 = mem->dims->pcond_dims->N;
+
+    int n = args.N2+1;
+#if defined(ACADOS_WITH_THREAD_POOL)
+    acados_thread_pool_run(mem->thread_pool, n, fun, &args);
+#else
+#if defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for
+#endif
+    for (int ii = 0; ii < n; ii++)
+    {
+        fun(&args, ii);
+    }
+#endif
+}
+
+
+
 /************************************************
  * functions
  ************************************************/
@@ -541,7 +794,10 @@ int ocp_qp_partial_condensing(void *qp_in_, void *pcond_qp_in_, void *opts_, voi
 //exit(1);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (ocp_qp_partial_condensing_blockwise(mem))
+        ocp_qp_partial_condensing_run_blocks(mem, opts, pcond_qp_in, NULL, &ocp_qp_partial_condensing_block_cond);
+    else
+        d_part_cond_qp_cond(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond = acados_toc(&timer);
@@ -584,7 +840,10 @@ int ocp_qp_partial_condensing_condense_lhs(void *qp_in_, void *pcond_qp_in_, voi
     acados_tic(&timer);
 
     d_ocp_qp_reduce_eq_dof_lhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
-    d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (ocp_qp_partial_condensing_blockwise(mem))
+        ocp_qp_partial_condensing_run_blocks(mem, opts, pcond_qp_in, NULL, &ocp_qp_partial_condensing_block_cond_lhs);
+    else
+        d_part_cond_qp_cond_lhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     mem->time_qp_xcond = acados_toc(&timer);
 
@@ -615,7 +874,10 @@ int ocp_qp_partial_condensing_condense_rhs(void *qp_in_, void *pcond_qp_in_, voi
     d_ocp_qp_reduce_eq_dof_rhs(qp_in, mem->red_qp, opts->hpipm_red_opts, mem->hpipm_red_work);
 
     // convert to partially condensed qp structure
-    d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (ocp_qp_partial_condensing_blockwise(mem))
+        ocp_qp_partial_condensing_run_blocks(mem, opts, pcond_qp_in, NULL, &ocp_qp_partial_condensing_block_cond_rhs);
+    else
+        d_part_cond_qp_cond_rhs(mem->red_qp, pcond_qp_in, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // stop timer
     mem->time_qp_xcond += acados_toc(&timer);
@@ -671,7 +933,10 @@ int ocp_qp_partial_expansion(void *pcond_qp_out_, void *qp_out_, void *opts_, vo
 
     // expand solution
     // TODO only if N2<N
-    d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
+    if (ocp_qp_partial_condensing_blockwise(mem))
+        ocp_qp_partial_condensing_run_blocks(mem, opts, NULL, pcond_qp_out, &ocp_qp_partial_condensing_block_expand_sol);
+    else
+        d_part_cond_qp_expand_sol(mem->red_qp, pcond_qp_out, mem->red_sol, opts->hpipm_pcond_opts, mem->hpipm_pcond_work);
 
     // restore solution
     d_ocp_qp_restore_eq_dof(mem->ptr_qp_in, mem->red_sol, qp_out, opts->hpipm_red_opts, mem->hpipm_red_work);
@@ -726,6 +991,7 @@ void ocp_qp_partial_condensing_config_initialize_default(void *config_)
     config->memory_calculate_size = &ocp_qp_partial_condensing_memory_calculate_size;
     config->memory_assign = &ocp_qp_partial_condensing_memory_assign;
     config->memory_get = &ocp_qp_partial_condensing_memory_get;
+    config->memory_set = &ocp_qp_partial_condensing_memory_set;
     config->workspace_calculate_size = &ocp_qp_partial_condensing_workspace_calculate_size;
     config->condensing = &ocp_qp_partial_condensing;
     config->condense_lhs = &ocp_qp_partial_condensing_condense_lhs;
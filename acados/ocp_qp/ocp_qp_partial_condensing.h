@@ -40,6 +40,7 @@ extern "C" {
 #include "hpipm/include/hpipm_d_ocp_qp_red.h"
 // acados
 #include "acados/ocp_qp/ocp_qp_common.h"
+#include "acados/utils/thread_pool.h"
 
 
 
@@ -86,6 +87,8 @@ typedef struct ocp_qp_partial_condensing_memory_
     ocp_qp_seed *ptr_qp_seed;
     qp_info *qp_out_info; // info in pcond_qp_in
     ocp_qp_partial_condensing_dims *dims;
+    int *block_start; // first stage of each block of the reduced qp
+    acados_thread_pool *thread_pool; // condense and expand the blocks in parallel, not owned
     double time_qp_xcond;
 } ocp_qp_partial_condensing_memory;
 
@@ -106,6 +109,8 @@ acados_size_t ocp_qp_partial_condensing_memory_calculate_size(void *dims, void *
 //
 void *ocp_qp_partial_condensing_memory_assign(void *dims, void *opts, void *raw_memory);
 //
+void ocp_qp_partial_condensing_memory_set(void *config_, void *mem_, const char *field, void* value);
+//
 acados_size_t ocp_qp_partial_condensing_workspace_calculate_size(void *dims, void *opts_);
 //
 int ocp_qp_partial_condensing(void *in, void *out, void *opts, void *mem, void *work);
@@ -0,0 +1,691 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "acados/ocp_qp/ocp_qp_record.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blasfeo_d_aux.h"
+
+#include "acados/utils/mem.h"
+
+
+
+#define OCP_QP_RECORD_MAGIC "ACQPREC1"
+#define OCP_QP_RECORD_VERSION 1
+#define OCP_QP_RECORD_FLAG_COMPRESS 1
+#define OCP_QP_RECORD_MAGIC_RECORD 0x43525051u  // "QPRC"
+
+// encoding of a record payload
+#define OCP_QP_RECORD_ENC_RAW 0
+#define OCP_QP_RECORD_ENC_DELTA 1
+
+// per stage dimensions stored in the file header
+enum
+{
+    REC_NX, REC_NU, REC_NBX, REC_NBU, REC_NG, REC_NS, REC_NSBX, REC_NSBU, REC_NSG,
+    REC_NBXE, REC_NBUE, REC_NGE, REC_NUM_DIMS
+};
+
+static const char *ocp_qp_record_dims_fields[REC_NUM_DIMS] =
+{
+    "nx", "nu", "nbx", "nbu", "ng", "ns", "nsbx", "nsbu", "nsg", "nbxe", "nbue", "nge"
+};
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    int32_t N;
+    int32_t num_dims;
+} ocp_qp_record_file_header;
+
+typedef struct
+{
+    uint32_t magic;
+    int32_t kind;
+    int32_t tag;
+    int32_t status;
+    int32_t encoding;
+    int32_t reserved;
+    uint64_t num_words;  // payload length in 8 byte words
+} ocp_qp_record_header;
+
+
+
+/************************************************
+ * payload layout
+ ************************************************/
+
+#define DIM(ii, k) (dims[(ii) * REC_NUM_DIMS + (k)])
+
+static size_t ocp_qp_record_payload_size(int kind, int N, int *dims)
+{
+    size_t size = 0;
+    int nux, nb, ng, ns;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nb = DIM(ii, REC_NBX) + DIM(ii, REC_NBU);
+        ng = DIM(ii, REC_NG);
+        ns = DIM(ii, REC_NS);
+        if (kind == OCP_QP_RECORD_IN)
+        {
+            if (ii < N)
+                size += (nux + 1) * DIM(ii+1, REC_NX) + DIM(ii+1, REC_NX);  // BAbt b
+            size += (nux + 1) * nux;                  // RSQrq
+            size += nux + 2 * ns;                     // rqz
+            size += nux * ng;                         // DCt
+            size += 3 * (2 * nb + 2 * ng + 2 * ns);   // d d_mask m
+            size += 2 * ns;                           // Z
+            size += nb + (nb + ng);                   // idxb idxs_rev
+            size += DIM(ii, REC_NBXE) + DIM(ii, REC_NBUE) + DIM(ii, REC_NGE);  // idxe
+            size += 1;                                // diag_H_flag
+        }
+        else
+        {
+            size += nux + 2 * ns;                     // ux
+            if (ii < N)
+                size += DIM(ii+1, REC_NX);            // pi
+            size += 2 * (2 * nb + 2 * ng + 2 * ns);   // lam t
+        }
+    }
+
+    return size;
+}
+
+
+
+static void ocp_qp_record_pack_int(int n, int *v, double **ptr)
+{
+    for (int jj = 0; jj < n; jj++)
+        (*ptr)[jj] = (double) v[jj];
+    *ptr += n;
+}
+
+
+
+static void ocp_qp_record_unpack_int(int n, double **ptr, int *v)
+{
+    for (int jj = 0; jj < n; jj++)
+        v[jj] = (int) (*ptr)[jj];
+    *ptr += n;
+}
+
+
+
+static void ocp_qp_record_pack_in(ocp_qp_in *qp_in, int N, int *dims, double *buf)
+{
+    double *ptr = buf;
+    int nux, nx1, nb, ng, ns, ne;
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nx1 = DIM(ii+1, REC_NX);
+        blasfeo_unpack_dmat(nux + 1, nx1, qp_in->BAbt + ii, 0, 0, ptr, nux + 1);
+        ptr += (nux + 1) * nx1;
+        blasfeo_unpack_dvec(nx1, qp_in->b + ii, 0, ptr);
+        ptr += nx1;
+    }
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nb = DIM(ii, REC_NBX) + DIM(ii, REC_NBU);
+        ng = DIM(ii, REC_NG);
+        ns = DIM(ii, REC_NS);
+        ne = DIM(ii, REC_NBXE) + DIM(ii, REC_NBUE) + DIM(ii, REC_NGE);
+
+        blasfeo_unpack_dmat(nux + 1, nux, qp_in->RSQrq + ii, 0, 0, ptr, nux + 1);
+        ptr += (nux + 1) * nux;
+        blasfeo_unpack_dvec(nux + 2 * ns, qp_in->rqz + ii, 0, ptr);
+        ptr += nux + 2 * ns;
+        blasfeo_unpack_dmat(nux, ng, qp_in->DCt + ii, 0, 0, ptr, nux);
+        ptr += nux * ng;
+        blasfeo_unpack_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->d + ii, 0, ptr);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_unpack_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->d_mask + ii, 0, ptr);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_unpack_dvec(2 * nb + 2 * ng + 2 * ns, qp_in->m + ii, 0, ptr);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_unpack_dvec(2 * ns, qp_in->Z + ii, 0, ptr);
+        ptr += 2 * ns;
+
+        ocp_qp_record_pack_int(nb, qp_in->idxb[ii], &ptr);
+        ocp_qp_record_pack_int(nb + ng, qp_in->idxs_rev[ii], &ptr);
+        ocp_qp_record_pack_int(ne, qp_in->idxe[ii], &ptr);
+        ocp_qp_record_pack_int(1, qp_in->diag_H_flag + ii, &ptr);
+    }
+}
+
+
+
+static void ocp_qp_record_unpack_in(double *buf, int N, int *dims, ocp_qp_in *qp_in)
+{
+    double *ptr = buf;
+    int nux, nx1, nb, ng, ns, ne;
+
+    for (int ii = 0; ii < N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nx1 = DIM(ii+1, REC_NX);
+        blasfeo_pack_dmat(nux + 1, nx1, ptr, nux + 1, qp_in->BAbt + ii, 0, 0);
+        ptr += (nux + 1) * nx1;
+        blasfeo_pack_dvec(nx1, ptr, qp_in->b + ii, 0);
+        ptr += nx1;
+    }
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nb = DIM(ii, REC_NBX) + DIM(ii, REC_NBU);
+        ng = DIM(ii, REC_NG);
+        ns = DIM(ii, REC_NS);
+        ne = DIM(ii, REC_NBXE) + DIM(ii, REC_NBUE) + DIM(ii, REC_NGE);
+
+        blasfeo_pack_dmat(nux + 1, nux, ptr, nux + 1, qp_in->RSQrq + ii, 0, 0);
+        ptr += (nux + 1) * nux;
+        blasfeo_pack_dvec(nux + 2 * ns, ptr, qp_in->rqz + ii, 0);
+        ptr += nux + 2 * ns;
+        blasfeo_pack_dmat(nux, ng, ptr, nux, qp_in->DCt + ii, 0, 0);
+        ptr += nux * ng;
+        blasfeo_pack_dvec(2 * nb + 2 * ng + 2 * ns, ptr, qp_in->d + ii, 0);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_pack_dvec(2 * nb + 2 * ng + 2 * ns, ptr, qp_in->d_mask + ii, 0);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_pack_dvec(2 * nb + 2 * ng + 2 * ns, ptr, qp_in->m + ii, 0);
+        ptr += 2 * nb + 2 * ng + 2 * ns;
+        blasfeo_pack_dvec(2 * ns, ptr, qp_in->Z + ii, 0);
+        ptr += 2 * ns;
+
+        ocp_qp_record_unpack_int(nb, &ptr, qp_in->idxb[ii]);
+        ocp_qp_record_unpack_int(nb + ng, &ptr, qp_in->idxs_rev[ii]);
+        ocp_qp_record_unpack_int(ne, &ptr, qp_in->idxe[ii]);
+        ocp_qp_record_unpack_int(1, &ptr, qp_in->diag_H_flag + ii);
+    }
+}
+
+
+
+static void ocp_qp_record_pack_out(ocp_qp_out *qp_out, int N, int *dims, double *buf)
+{
+    double *ptr = buf;
+    int nux, nbg2;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nbg2 = 2 * (DIM(ii, REC_NBX) + DIM(ii, REC_NBU) + DIM(ii, REC_NG) + DIM(ii, REC_NS));
+
+        blasfeo_unpack_dvec(nux + 2 * DIM(ii, REC_NS), qp_out->ux + ii, 0, ptr);
+        ptr += nux + 2 * DIM(ii, REC_NS);
+        if (ii < N)
+        {
+            blasfeo_unpack_dvec(DIM(ii+1, REC_NX), qp_out->pi + ii, 0, ptr);
+            ptr += DIM(ii+1, REC_NX);
+        }
+        blasfeo_unpack_dvec(nbg2, qp_out->lam + ii, 0, ptr);
+        ptr += nbg2;
+        blasfeo_unpack_dvec(nbg2, qp_out->t + ii, 0, ptr);
+        ptr += nbg2;
+    }
+}
+
+
+
+static void ocp_qp_record_unpack_out(double *buf, int N, int *dims, ocp_qp_out *qp_out)
+{
+    double *ptr = buf;
+    int nux, nbg2;
+
+    for (int ii = 0; ii <= N; ii++)
+    {
+        nux = DIM(ii, REC_NU) + DIM(ii, REC_NX);
+        nbg2 = 2 * (DIM(ii, REC_NBX) + DIM(ii, REC_NBU) + DIM(ii, REC_NG) + DIM(ii, REC_NS));
+
+        blasfeo_pack_dvec(nux + 2 * DIM(ii, REC_NS), ptr, qp_out->ux + ii, 0);
+        ptr += nux + 2 * DIM(ii, REC_NS);
+        if (ii < N)
+        {
+            blasfeo_pack_dvec(DIM(ii+1, REC_NX), ptr, qp_out->pi + ii, 0);
+            ptr += DIM(ii+1, REC_NX);
+        }
+        blasfeo_pack_dvec(nbg2, ptr, qp_out->lam + ii, 0);
+        ptr += nbg2;
+        blasfeo_pack_dvec(nbg2, ptr, qp_out->t + ii, 0);
+        ptr += nbg2;
+    }
+}
+
+#undef DIM
+
+
+
+/************************************************
+ * delta compression
+ ************************************************/
+
+// worst case length of an encoded payload of n words
+static size_t ocp_qp_record_encoded_capacity(size_t n)
+{
+    return n + n / 2 + 2;
+}
+
+
+
+// encode cur XOR prev as tokens (number of zero words << 32 | number of literals) followed by
+// the literal words, set prev = cur; returns the encoded length in words
+static size_t ocp_qp_record_encode(size_t n, const double *cur, uint64_t *prev, uint64_t *enc)
+{
+    size_t k = 0, i = 0;
+    uint64_t w, nzero, nlit;
+
+    while (i < n)
+    {
+        nzero = 0;
+        while (i < n)
+        {
+            memcpy(&w, cur + i, sizeof(w));
+            if (w != prev[i] || nzero == UINT32_MAX)
+                break;
+            nzero++;
+            i++;
+        }
+        nlit = 0;
+        while (i < n && nlit < UINT32_MAX)
+        {
+            memcpy(&w, cur + i, sizeof(w));
+            if (w == prev[i])
+                break;
+            enc[k + 1 + nlit] = w ^ prev[i];
+            prev[i] = w;
+            nlit++;
+            i++;
+        }
+        enc[k] = (nzero << 32) | nlit;
+        k += 1 + nlit;
+    }
+
+    return k;
+}
+
+
+
+// inverse of ocp_qp_record_encode; returns 0 on success
+static int ocp_qp_record_decode(size_t n, const uint64_t *enc, size_t num_words, uint64_t *prev,
+                                double *cur)
+{
+    size_t k = 0, i = 0;
+    uint64_t nzero, nlit;
+
+    while (k < num_words)
+    {
+        nzero = enc[k] >> 32;
+        nlit = enc[k] & 0xffffffffu;
+        k++;
+        if (i + nzero + nlit > n || k + nlit > num_words)
+            return -1;
+        i += nzero;
+        for (uint64_t j = 0; j < nlit; j++)
+        {
+            prev[i] ^= enc[k++];
+            i++;
+        }
+    }
+    memcpy(cur, prev, n * sizeof(double));
+
+    return 0;
+}
+
+
+
+/************************************************
+ * recorder
+ ************************************************/
+
+struct ocp_qp_recorder_
+{
+    FILE *file;
+    int N;
+    int *dims;
+    int compress;
+    size_t size[2];     // payload length of qp_in and qp_out records in words
+    double *raw;
+    uint64_t *prev[2];  // last payload of each kind, for delta compression
+    uint64_t *enc;
+};
+
+
+
+static void ocp_qp_record_dims_from_qp_dims(ocp_qp_dims *qp_dims, int *dims)
+{
+    for (int ii = 0; ii <= qp_dims->N; ii++)
+    {
+        for (int k = 0; k < REC_NUM_DIMS; k++)
+        {
+            ocp_qp_dims_get(NULL, qp_dims, ii, ocp_qp_record_dims_fields[k],
+                            &dims[ii * REC_NUM_DIMS + k]);
+        }
+    }
+}
+
+
+
+ocp_qp_recorder *ocp_qp_recorder_open(const char *filename, ocp_qp_dims *qp_dims, int compress)
+{
+    FILE *file = fopen(filename, "wb");
+    if (file == NULL)
+        return NULL;
+
+    int N = qp_dims->N;
+
+    ocp_qp_recorder *rec = calloc(1, sizeof(ocp_qp_recorder));
+    rec->file = file;
+    rec->N = N;
+    rec->compress = compress;
+    rec->dims = calloc(REC_NUM_DIMS * (N + 1) + 1, sizeof(int));  // +1: 8 byte padding
+    ocp_qp_record_dims_from_qp_dims(qp_dims, rec->dims);
+
+    rec->size[OCP_QP_RECORD_IN] = ocp_qp_record_payload_size(OCP_QP_RECORD_IN, N, rec->dims);
+    rec->size[OCP_QP_RECORD_OUT] = ocp_qp_record_payload_size(OCP_QP_RECORD_OUT, N, rec->dims);
+    size_t size_max = rec->size[0] > rec->size[1] ? rec->size[0] : rec->size[1];
+
+    rec->raw = malloc(size_max * sizeof(double));
+    if (compress)
+    {
+        rec->prev[0] = calloc(rec->size[0], sizeof(uint64_t));
+        rec->prev[1] = calloc(rec->size[1], sizeof(uint64_t));
+        rec->enc = malloc(ocp_qp_record_encoded_capacity(size_max) * sizeof(uint64_t));
+    }
+
+    ocp_qp_record_file_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, OCP_QP_RECORD_MAGIC, 8);
+    header.version = OCP_QP_RECORD_VERSION;
+    header.flags = compress ? OCP_QP_RECORD_FLAG_COMPRESS : 0;
+    header.N = N;
+    header.num_dims = REC_NUM_DIMS;
+
+    int num_dims_padded = (REC_NUM_DIMS * (N + 1) + 1) / 2 * 2;
+    if (fwrite(&header, sizeof(header), 1, file) != 1
+        || fwrite(rec->dims, sizeof(int), num_dims_padded, file) != (size_t) num_dims_padded)
+    {
+        ocp_qp_recorder_close(rec);
+        return NULL;
+    }
+
+    return rec;
+}
+
+
+
+static int ocp_qp_recorder_write(ocp_qp_recorder *rec, int kind, int tag, int status)
+{
+    size_t n = rec->size[kind];
+
+    ocp_qp_record_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = OCP_QP_RECORD_MAGIC_RECORD;
+    header.kind = kind;
+    header.tag = tag;
+    header.status = status;
+
+    void *payload = rec->raw;
+    header.encoding = OCP_QP_RECORD_ENC_RAW;
+    header.num_words = n;
+    if (rec->compress)
+    {
+        size_t num_enc = ocp_qp_record_encode(n, rec->raw, rec->prev[kind], rec->enc);
+        if (num_enc < n)
+        {
+            payload = rec->enc;
+            header.encoding = OCP_QP_RECORD_ENC_DELTA;
+            header.num_words = num_enc;
+        }
+    }
+
+    if (fwrite(&header, sizeof(header), 1, rec->file) != 1)
+        return 1;
+    if (fwrite(payload, sizeof(uint64_t), header.num_words, rec->file) != header.num_words)
+        return 1;
+
+    return 0;
+}
+
+
+
+int ocp_qp_recorder_write_in(ocp_qp_recorder *rec, ocp_qp_in *qp_in, int tag, int status)
+{
+    ocp_qp_record_pack_in(qp_in, rec->N, rec->dims, rec->raw);
+    return ocp_qp_recorder_write(rec, OCP_QP_RECORD_IN, tag, status);
+}
+
+
+
+int ocp_qp_recorder_write_out(ocp_qp_recorder *rec, ocp_qp_out *qp_out, int tag, int status)
+{
+    ocp_qp_record_pack_out(qp_out, rec->N, rec->dims, rec->raw);
+    return ocp_qp_recorder_write(rec, OCP_QP_RECORD_OUT, tag, status);
+}
+
+
+
+int ocp_qp_recorder_close(ocp_qp_recorder *rec)
+{
+    if (rec == NULL)
+        return 0;
+    int status = fclose(rec->file) != 0;
+    free(rec->dims);
+    free(rec->raw);
+    free(rec->prev[0]);
+    free(rec->prev[1]);
+    free(rec->enc);
+    free(rec);
+    return status;
+}
+
+
+
+/************************************************
+ * reader
+ ************************************************/
+
+struct ocp_qp_record_reader_
+{
+    FILE *file;
+    long data_start;
+    int N;
+    int *dims;
+    size_t size[2];
+    int num_records[2];
+    double *raw;
+    uint64_t *prev[2];
+    uint64_t *enc;
+};
+
+
+
+ocp_qp_record_reader *ocp_qp_record_reader_open(const char *filename)
+{
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL)
+        return NULL;
+
+    ocp_qp_record_file_header header;
+    if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, OCP_QP_RECORD_MAGIC, 8)
+        || header.version != OCP_QP_RECORD_VERSION || header.num_dims != REC_NUM_DIMS || header.N < 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    int N = header.N;
+    int num_dims_padded = (REC_NUM_DIMS * (N + 1) + 1) / 2 * 2;
+
+    ocp_qp_record_reader *reader = calloc(1, sizeof(ocp_qp_record_reader));
+    reader->file = file;
+    reader->N = N;
+    reader->dims = calloc(num_dims_padded, sizeof(int));
+    if (fread(reader->dims, sizeof(int), num_dims_padded, file) != (size_t) num_dims_padded)
+    {
+        ocp_qp_record_reader_close(reader);
+        return NULL;
+    }
+    reader->data_start = ftell(file);
+
+    reader->size[OCP_QP_RECORD_IN] = ocp_qp_record_payload_size(OCP_QP_RECORD_IN, N, reader->dims);
+    reader->size[OCP_QP_RECORD_OUT] = ocp_qp_record_payload_size(OCP_QP_RECORD_OUT, N, reader->dims);
+    size_t size_max = reader->size[0] > reader->size[1] ? reader->size[0] : reader->size[1];
+
+    reader->raw = malloc(size_max * sizeof(double));
+    reader->prev[0] = calloc(reader->size[0], sizeof(uint64_t));
+    reader->prev[1] = calloc(reader->size[1], sizeof(uint64_t));
+    reader->enc = malloc(ocp_qp_record_encoded_capacity(size_max) * sizeof(uint64_t));
+
+    // count records, stop at the first truncated one
+    ocp_qp_record_header rh;
+    while (fread(&rh, sizeof(rh), 1, file) == 1)
+    {
+        if (rh.magic != OCP_QP_RECORD_MAGIC_RECORD || (rh.kind != OCP_QP_RECORD_IN && rh.kind != OCP_QP_RECORD_OUT))
+            break;
+        if (fseek(file, (long) (rh.num_words * sizeof(uint64_t)), SEEK_CUR))
+            break;
+        reader->num_records[rh.kind]++;
+    }
+
+    ocp_qp_record_reader_rewind(reader);
+
+    return reader;
+}
+
+
+
+int ocp_qp_record_reader_N(ocp_qp_record_reader *reader)
+{
+    return reader->N;
+}
+
+
+
+void ocp_qp_record_reader_dims_set(ocp_qp_record_reader *reader, ocp_qp_dims *dims)
+{
+    for (int ii = 0; ii <= reader->N; ii++)
+    {
+        for (int k = 0; k < REC_NUM_DIMS; k++)
+        {
+            ocp_qp_dims_set(NULL, dims, ii, ocp_qp_record_dims_fields[k],
+                            &reader->dims[ii * REC_NUM_DIMS + k]);
+        }
+    }
+}
+
+
+
+int ocp_qp_record_reader_num_records(ocp_qp_record_reader *reader, int kind)
+{
+    return reader->num_records[kind];
+}
+
+
+
+int ocp_qp_record_reader_next(ocp_qp_record_reader *reader, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                              int *kind, int *tag, int *status)
+{
+    ocp_qp_record_header header;
+    if (fread(&header, sizeof(header), 1, reader->file) != 1)
+        return 1;
+
+    if (header.magic != OCP_QP_RECORD_MAGIC_RECORD
+        || (header.kind != OCP_QP_RECORD_IN && header.kind != OCP_QP_RECORD_OUT))
+        return -1;
+
+    size_t n = reader->size[header.kind];
+    if (header.encoding == OCP_QP_RECORD_ENC_RAW)
+    {
+        if (header.num_words != n || fread(reader->raw, sizeof(double), n, reader->file) != n)
+            return -1;
+        memcpy(reader->prev[header.kind], reader->raw, n * sizeof(double));
+    }
+    else if (header.encoding == OCP_QP_RECORD_ENC_DELTA)
+    {
+        if (header.num_words > ocp_qp_record_encoded_capacity(n)
+            || fread(reader->enc, sizeof(uint64_t), header.num_words, reader->file) != header.num_words)
+            return -1;
+        if (ocp_qp_record_decode(n, reader->enc, header.num_words, reader->prev[header.kind], reader->raw))
+            return -1;
+    }
+    else
+    {
+        return -1;
+    }
+
+    if (header.kind == OCP_QP_RECORD_IN && qp_in != NULL)
+        ocp_qp_record_unpack_in(reader->raw, reader->N, reader->dims, qp_in);
+    else if (header.kind == OCP_QP_RECORD_OUT && qp_out != NULL)
+        ocp_qp_record_unpack_out(reader->raw, reader->N, reader->dims, qp_out);
+
+    if (kind != NULL)
+        *kind = header.kind;
+    if (tag != NULL)
+        *tag = header.tag;
+    if (status != NULL)
+        *status = header.status;
+
+    return 0;
+}
+
+
+
+void ocp_qp_record_reader_rewind(ocp_qp_record_reader *reader)
+{
+    fseek(reader->file, reader->data_start, SEEK_SET);
+    memset(reader->prev[0], 0, reader->size[0] * sizeof(uint64_t));
+    memset(reader->prev[1], 0, reader->size[1] * sizeof(uint64_t));
+}
+
+
+
+void ocp_qp_record_reader_close(ocp_qp_record_reader *reader)
+{
+    if (reader == NULL)
+        return;
+    fclose(reader->file);
+    free(reader->dims);
+    free(reader->raw);
+    free(reader->prev[0]);
+    free(reader->prev[1]);
+    free(reader->enc);
+    free(reader);
+}
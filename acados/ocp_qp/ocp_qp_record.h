@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_OCP_QP_OCP_QP_RECORD_H_
+#define ACADOS_OCP_QP_OCP_QP_RECORD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "acados/ocp_qp/ocp_qp_common.h"
+
+/* Binary recording of ocp_qp_in / ocp_qp_out streams, e.g. one qp per SQP iteration, for offline
+ * replay with any ocp_qp_xcond_solver (see bench/bench_qp_replay.c).
+ *
+ * File layout, native byte order, all sections 8 byte aligned:
+ *   file header    "ACQPREC1", version, flags, N, then per stage
+ *                  nx nu nbx nbu ng ns nsbx nsbu nsg nbxe nbue nge
+ *   records        record header (kind, tag, status, encoding, sizes) followed by the payload
+ *
+ * A payload is an array of doubles in a fixed order (integer data such as idxb is stored as
+ * doubles as well):
+ *   qp_in:  BAbt (nu+nx+1 x nx1, col-major) and b for stages 0..N-1, then for stages 0..N
+ *           RSQrq (nu+nx+1 x nu+nx), rqz, DCt, d, d_mask, m, Z, idxb, idxs_rev, idxe, diag_H_flag
+ *   qp_out: ux, pi (stages 0..N-1), lam, t
+ * Uncompressed records have a fixed size, such that the file can be memory mapped and indexed
+ * directly. Compressed records store the XOR difference to the previous record of the same
+ * kind as runs of zero words and literal words, they have to be decoded in order.
+ */
+
+#define OCP_QP_RECORD_IN 0
+#define OCP_QP_RECORD_OUT 1
+
+typedef struct ocp_qp_recorder_ ocp_qp_recorder;
+typedef struct ocp_qp_record_reader_ ocp_qp_record_reader;
+
+// create filename and write the file header, compress != 0 enables delta compression;
+// returns NULL if the file cannot be opened or written
+ocp_qp_recorder *ocp_qp_recorder_open(const char *filename, ocp_qp_dims *dims, int compress);
+// append a record, tag and status are stored with it (e.g. SQP iteration and qp status);
+// returns 0 on success, 1 if the record could not be written completely
+int ocp_qp_recorder_write_in(ocp_qp_recorder *rec, ocp_qp_in *qp_in, int tag, int status);
+int ocp_qp_recorder_write_out(ocp_qp_recorder *rec, ocp_qp_out *qp_out, int tag, int status);
+// flush and close the file, free the recorder; returns 0 on success, 1 if flushing failed
+int ocp_qp_recorder_close(ocp_qp_recorder *rec);
+
+// open a recording; returns NULL if the file cannot be opened or has no valid header
+ocp_qp_record_reader *ocp_qp_record_reader_open(const char *filename);
+//
+int ocp_qp_record_reader_N(ocp_qp_record_reader *reader);
+// set the dimensions of dims, created with ocp_qp_dims_create(N), to the recorded ones
+void ocp_qp_record_reader_dims_set(ocp_qp_record_reader *reader, ocp_qp_dims *dims);
+// number of records of kind OCP_QP_RECORD_IN or OCP_QP_RECORD_OUT in the file
+int ocp_qp_record_reader_num_records(ocp_qp_record_reader *reader, int kind);
+// read the next record into qp_in or qp_out (depending on its kind, NULL to skip);
+// returns 0 on success, 1 at the end of the file, -1 for a corrupt record
+int ocp_qp_record_reader_next(ocp_qp_record_reader *reader, ocp_qp_in *qp_in, ocp_qp_out *qp_out,
+                              int *kind, int *tag, int *status);
+// restart at the first record
+void ocp_qp_record_reader_rewind(ocp_qp_record_reader *reader);
+//
+void ocp_qp_record_reader_close(ocp_qp_record_reader *reader);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_OCP_QP_OCP_QP_RECORD_H_
@@ -39,6 +39,7 @@
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/timing.h"
+#include "acados/utils/trace.h"
 #include "acados/utils/types.h"
 #include "acados/utils/print.h"
 #include "acados/utils/strsep.h"
@@ -430,7 +431,8 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
-    else if (!strcmp(field, "iter"))
+    else if (!strcmp(field, "iter") || !strcmp(field, "mixed_precision_refine_iter") ||
+             !strcmp(field, "pattern_setups"))
     {
         qp_solver->memory_get(qp_solver, mem->solver_memory, field, value);
     }
@@ -454,6 +456,35 @@ void ocp_qp_xcond_solver_memory_get(void *config_, void *mem_, const char *field
 
 
 
+void ocp_qp_xcond_solver_memory_set(void *config_, void *mem_, const char *field, void* value)
+{
+    ocp_qp_xcond_solver_config *config = config_;
+    ocp_qp_xcond_config *xcond = config->xcond;
+
+    ocp_qp_xcond_solver_memory *mem = mem_;
+
+    if (!strcmp(field, "thread_pool"))
+    {
+        xcond->memory_set(xcond, mem->xcond_memory, field, value);
+    }
+    else if (!strcmp(field, "iter_max_cap"))
+    {
+        // optional, qp solvers without the hook ignore the cap
+        qp_solver_config *qp_solver = config->qp_solver;
+        if (qp_solver->memory_set != NULL)
+            qp_solver->memory_set(qp_solver, mem->solver_memory, field, value);
+    }
+    else
+    {
+        printf("\nerror: ocp_qp_xcond_solver_memory_set: field %s not available\n", field);
+        exit(1);
+    }
+
+    return;
+}
+
+
+
 /************************************************
  * workspace
  ************************************************/
@@ -534,9 +565,11 @@ int ocp_qp_xcond_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
 
     int solver_status = ACADOS_SUCCESS;
     // condensing
+    ACADOS_TRACE_BEGIN("condensing");
     acados_tic(&cond_timer);
     xcond->condensing(qp_in, memory->xcond_qp_in, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
     info->condensing_time = acados_toc(&cond_timer);
+    ACADOS_TRACE_END("condensing");
 
     if (opts->initialize_next_xcond_qp_from_qp_out)
     {
@@ -552,13 +585,17 @@ int ocp_qp_xcond_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     }
 
     // solve qp
+    ACADOS_TRACE_BEGIN("qp_solver");
     solver_status = qp_solver->evaluate(qp_solver, memory->xcond_qp_in, memory->xcond_qp_out,
                                 opts->qp_solver_opts, memory->solver_memory, work->qp_solver_work);
+    ACADOS_TRACE_END("qp_solver");
 
     // expansion
+    ACADOS_TRACE_BEGIN("expansion");
     acados_tic(&cond_timer);
     xcond->expansion(memory->xcond_qp_out, qp_out, opts->xcond_opts, memory->xcond_memory, work->xcond_work);
     info->condensing_time += acados_toc(&cond_timer);
+    ACADOS_TRACE_END("expansion");
 
     // output qp info
     qp_info *info_mem;
@@ -569,6 +606,7 @@ int ocp_qp_xcond_solve(void *config_, ocp_qp_xcond_solver_dims *dims, ocp_qp_in
     info->interface_time = info_mem->interface_time;
     info->num_iter = info_mem->num_iter;
     info->t_computed = info_mem->t_computed;
+    ACADOS_TRACE_COUNTER("qp_iter", info->num_iter);
 
     return solver_status;
 }
@@ -743,6 +781,7 @@ void ocp_qp_xcond_solver_config_initialize_default(void *config_)
     config->memory_calculate_size = &ocp_qp_xcond_solver_memory_calculate_size;
     config->memory_assign = &ocp_qp_xcond_solver_memory_assign;
     config->memory_get = &ocp_qp_xcond_solver_memory_get;
+    config->memory_set = &ocp_qp_xcond_solver_memory_set;
     config->solver_get = &ocp_qp_xcond_solver_get;
     config->memory_reset = &ocp_qp_xcond_solver_memory_reset; // TODO: unused?
     config->workspace_calculate_size = &ocp_qp_xcond_solver_workspace_calculate_size;
@@ -753,6 +792,9 @@ void ocp_qp_xcond_solver_config_initialize_default(void *config_)
     config->eval_adj_sens = &ocp_qp_xcond_solver_eval_adj_sens;
     config->terminate = &ocp_qp_xcond_solver_terminate;
 
+    // optional hook, set by the qp solvers that implement it
+    config->qp_solver->memory_set = NULL;
+
     return;
 }
 
@@ -332,132 +332,398 @@ static void gauss_radau_iia_nodes(int ns, double *nodes, void *work)
     }
 }
 
-// acados_size_t gauss_simplified_work_calculate_size(int ns)
-// {
-//     acados_size_t size = 0;
-
-//     size += 1 * 2 * ns * sizeof(double);   // D
-//     size += 3 * ns * ns * sizeof(double);  // T, T_inv, lu_work
-
-//     size += 1 * ns * sizeof(int);  // perm
-
-//     return size;
-// }
-
-
-// // TODO(all): understand how this works and leave a comment!
-// void gauss_simplified(int ns, Newton_scheme *scheme, void *work)
-// {
-//     char *c_ptr = work;
-
-//     // D
-//     double *D = (double *) c_ptr;
-//     c_ptr += 2 * ns * sizeof(double);
-//     // T
-//     double *T = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // T_inv
-//     double *T_inv = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // lu_work
-//     double *lu_work = (double *) c_ptr;
-//     c_ptr += ns * ns * sizeof(double);
-//     // perm
-//     int *perm = (int *) c_ptr;
-//     c_ptr += ns * sizeof(int);
-
-//     assert((char *) work + gauss_simplified_work_calculate_size(ns) >= c_ptr);
-
-//     char simplified[MAX_STR_LEN];
-
-//     snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "D");
-//     read_matrix(simplified, D, ns, 2);
-
-//     snprintf(simplified, sizeof(simplified), "simplified/GL%d_simpl_%s.txt", 2 * ns, "T");
-//     read_matrix(simplified, T, ns, ns);
-
-//     scheme->single = false;
-//     scheme->low_tria = 0;
-//     for (int i = 0; i < ns; i++)
-//     {
-//         scheme->eig[i] = D[i];
-//     }
-//     for (int i = 0; i < ns * ns; i++)
-//     {
-//         scheme->transf2[i] = T[i];
-//     }
-//     // transf1_T:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         if ((i + 1) < ns)
-//         {  // complex conjugate pair of eigenvalues
-//             for (int i1 = i; i1 < i + 2; i1++)
-//             {
-//                 for (int i2 = 0; i2 < ns; i2++)
-//                 {
-//                     scheme->transf1_T[i2 * ns + i1] = 0.0;
-//                     for (int i3 = 0; i3 < 2; i3++)
-//                     {
-//                         scheme->transf1_T[i2 * ns + i1] +=
-//                             D[(i1 - i) * ns + (i + i3)] * T[(i + i3) * ns + i2];
-//                     }
-//                 }
-//             }
-//             i++;
-//         }
-//         else
-//         {  // real eigenvalue
-//             for (int i2 = 0; i2 < ns; i2++)
-//             {
-//                 scheme->transf1_T[i2 * ns + i] = D[i] * T[i * ns + i2];
-//             }
-//         }
-//     }
-
-//     for (int i = 0; i < ns; i++)
-//     {
-//         T_inv[i * (ns + 1)] = 1.0;
-//     }
-
-//     lu_system_solve(T, T_inv, perm, ns, ns, lu_work);
-
-//     // transf1:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         if ((i + 1) < ns)
-//         {  // complex conjugate pair of eigenvalues
-//             for (int i1 = i; i1 < i + 2; i1++)
-//             {
-//                 for (int i2 = 0; i2 < ns; i2++)
-//                 {
-//                     scheme->transf1[i2 * ns + i1] = 0.0;
-//                     for (int i3 = 0; i3 < 2; i3++)
-//                     {
-//                         scheme->transf1[i2 * ns + i1] += D[i3 * ns + i1] * T_inv[i2 * ns + i + i3];
-//                     }
-//                 }
-//             }
-//             i++;
-//         }
-//         else
-//         {  // real eigenvalue
-//             for (int i2 = 0; i2 < ns; i2++)
-//             {
-//                 scheme->transf1[i2 * ns + i] = D[i] * T_inv[i2 * ns + i];
-//             }
-//         }
-//     }
-//     // transf2_T:
-//     for (int i = 0; i < ns; i++)
-//     {
-//         for (int i2 = 0; i2 < ns; i2++)
-//         {
-//             scheme->transf2_T[i2 * ns + i] = T_inv[i * ns + i2];
-//         }
-//     }
-
-//     return;
-// }
+acados_size_t simplified_newton_transform_work_calculate_size(int ns)
+{
+    acados_size_t size = 0;
+
+    size += 2 * ns * ns * sizeof(double);          // A_inv, hess
+    size += 4 * ns * ns * sizeof(double);          // lhs of the (real or complex) shifted system
+    size += 2 * 2 * ns * sizeof(double);           // rhs, lu_work
+    size += 2 * ns * sizeof(int);                  // perm
+
+    size += 3 * ns * ns * sizeof(double);          // T_inv, residual, lu_work for inversion
+    size += 3 * ns * sizeof(double);               // eig_re, eig_im, householder vector
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+// reduces the ns x ns (column-major) matrix H to upper Hessenberg form by
+// similarity transformations with Householder reflectors
+static void hessenberg_reduction(int ns, double *H, double *u)
+{
+    double alpha, beta, nrm, dot;
+    int i, j, k;
+
+    for (k = 0; k < ns - 2; k++)
+    {
+        nrm = 0.0;
+        for (i = k + 1; i < ns; i++)
+            nrm += H[i + k * ns] * H[i + k * ns];
+        nrm = sqrt(nrm);
+        if (nrm == 0.0)
+            continue;
+
+        alpha = H[k + 1 + k * ns] > 0 ? -nrm : nrm;
+        for (i = k + 1; i < ns; i++)
+            u[i] = H[i + k * ns];
+        u[k + 1] -= alpha;
+        beta = 0.0;
+        for (i = k + 1; i < ns; i++)
+            beta += u[i] * u[i];
+        if (beta == 0.0)
+            continue;
+        beta = 2.0 / beta;
+
+        // H = P * H
+        for (j = k; j < ns; j++)
+        {
+            dot = 0.0;
+            for (i = k + 1; i < ns; i++)
+                dot += u[i] * H[i + j * ns];
+            for (i = k + 1; i < ns; i++)
+                H[i + j * ns] -= beta * u[i] * dot;
+        }
+        // H = H * P
+        for (i = 0; i < ns; i++)
+        {
+            dot = 0.0;
+            for (j = k + 1; j < ns; j++)
+                dot += H[i + j * ns] * u[j];
+            for (j = k + 1; j < ns; j++)
+                H[i + j * ns] -= beta * dot * u[j];
+        }
+        for (i = k + 2; i < ns; i++)
+            H[i + k * ns] = 0.0;
+    }
+}
+
+
+
+// applies the reflector I - beta * u * u^T acting on rows/cols r0, ..., r0+len-1
+// of the active window [lo, hi] of the Hessenberg matrix H from both sides
+static void hessenberg_apply_reflector(int ns, double *H, int lo, int hi, int r0, int len,
+                                       double *u, double beta)
+{
+    double dot;
+    int i, j;
+    int j0 = r0 - 1 > lo ? r0 - 1 : lo;
+    int i1 = r0 + len < hi ? r0 + len : hi;
+
+    for (j = j0; j <= hi; j++)
+    {
+        dot = 0.0;
+        for (i = 0; i < len; i++)
+            dot += u[i] * H[r0 + i + j * ns];
+        for (i = 0; i < len; i++)
+            H[r0 + i + j * ns] -= beta * u[i] * dot;
+    }
+    for (i = lo; i <= i1; i++)
+    {
+        dot = 0.0;
+        for (j = 0; j < len; j++)
+            dot += H[i + (r0 + j) * ns] * u[j];
+        for (j = 0; j < len; j++)
+            H[i + (r0 + j) * ns] -= beta * dot * u[j];
+    }
+}
+
+
+
+static double householder_vector(int len, double *v)
+{
+    double nrm = 0.0;
+    for (int i = 0; i < len; i++)
+        nrm += v[i] * v[i];
+    nrm = sqrt(nrm);
+    if (nrm == 0.0)
+        return 0.0;
+    v[0] += v[0] > 0 ? nrm : -nrm;
+    double beta = 0.0;
+    for (int i = 0; i < len; i++)
+        beta += v[i] * v[i];
+    return 2.0 / beta;
+}
+
+
+
+// eigenvalues of the upper Hessenberg matrix H (destroyed) by the Francis
+// double-shift QR iteration; complex conjugate pairs are stored next to each other,
+// the one with positive imaginary part first. Returns 0 on success.
+static int hessenberg_eigenvalues(int ns, double *H, double *eig_re, double *eig_im)
+{
+    double v[3];
+    double s, t, p, disc, beta;
+    int lo, k, len;
+    int hi = ns - 1;
+    int its = 0;
+
+    while (hi >= 0)
+    {
+        // look for a negligible subdiagonal element
+        for (lo = hi; lo > 0; lo--)
+        {
+            s = fabs(H[lo - 1 + (lo - 1) * ns]) + fabs(H[lo + lo * ns]);
+            if (fabs(H[lo + (lo - 1) * ns]) <= 1e-15 * s)
+            {
+                H[lo + (lo - 1) * ns] = 0.0;
+                break;
+            }
+        }
+
+        if (lo == hi)
+        {
+            // one real eigenvalue deflated
+            eig_re[hi] = H[hi + hi * ns];
+            eig_im[hi] = 0.0;
+            hi -= 1;
+            its = 0;
+        }
+        else if (lo == hi - 1)
+        {
+            // 2x2 block deflated
+            s = 0.5 * (H[hi - 1 + (hi - 1) * ns] + H[hi + hi * ns]);
+            p = 0.5 * (H[hi - 1 + (hi - 1) * ns] - H[hi + hi * ns]);
+            disc = p * p + H[hi - 1 + hi * ns] * H[hi + (hi - 1) * ns];
+            if (disc >= 0.0)
+            {
+                eig_re[hi - 1] = s + sqrt(disc);
+                eig_re[hi] = s - sqrt(disc);
+                eig_im[hi - 1] = 0.0;
+                eig_im[hi] = 0.0;
+            }
+            else
+            {
+                eig_re[hi - 1] = s;
+                eig_re[hi] = s;
+                eig_im[hi - 1] = sqrt(-disc);
+                eig_im[hi] = -sqrt(-disc);
+            }
+            hi -= 2;
+            its = 0;
+        }
+        else
+        {
+            its++;
+            if (its > 30 * ns)
+                return 1;
+
+            // shifts from the trailing 2x2 block, exceptional shifts every 10 iterations
+            if (its % 10 == 0)
+            {
+                s = 1.5 * (fabs(H[hi + (hi - 1) * ns]) + fabs(H[hi - 1 + (hi - 2) * ns]));
+                t = s * s / 2.25;
+            }
+            else
+            {
+                s = H[hi - 1 + (hi - 1) * ns] + H[hi + hi * ns];
+                t = H[hi - 1 + (hi - 1) * ns] * H[hi + hi * ns]
+                    - H[hi - 1 + hi * ns] * H[hi + (hi - 1) * ns];
+            }
+
+            // first column of (H - s1 I) (H - s2 I)
+            v[0] = H[lo + lo * ns] * H[lo + lo * ns] + H[lo + (lo + 1) * ns] * H[lo + 1 + lo * ns]
+                   - s * H[lo + lo * ns] + t;
+            v[1] = H[lo + 1 + lo * ns] * (H[lo + lo * ns] + H[lo + 1 + (lo + 1) * ns] - s);
+            v[2] = H[lo + 1 + lo * ns] * H[lo + 2 + (lo + 1) * ns];
+
+            // chase the bulge
+            for (k = lo; k <= hi - 1; k++)
+            {
+                len = k + 2 <= hi ? 3 : 2;
+                beta = householder_vector(len, v);
+                if (beta != 0.0)
+                    hessenberg_apply_reflector(ns, H, lo, hi, k, len, v, beta);
+                if (k > lo)
+                {
+                    // entries annihilated by the reflector
+                    H[k + 1 + (k - 1) * ns] = 0.0;
+                    if (len == 3)
+                        H[k + 2 + (k - 1) * ns] = 0.0;
+                }
+                if (k < hi - 1)
+                {
+                    v[0] = H[k + 1 + k * ns];
+                    v[1] = H[k + 2 + k * ns];
+                    if (k + 3 <= hi)
+                        v[2] = H[k + 3 + k * ns];
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+// solves (M - (re + i*im) I) (vr + i*vi) = rhs for the eigenvector approximation,
+// written as a real system of size 2*ns in case im != 0
+static void shifted_system_solve(int ns, double *M, double re, double im, double *lhs, double *rhs,
+                                 int *perm, double *lu_work)
+{
+    int n = im == 0.0 ? ns : 2 * ns;
+    int i, j;
+
+    for (i = 0; i < n * n; i++)
+        lhs[i] = 0.0;
+    for (j = 0; j < ns; j++)
+    {
+        for (i = 0; i < ns; i++)
+        {
+            lhs[i + j * n] = M[i + j * ns];
+            if (n > ns)
+                lhs[ns + i + (ns + j) * n] = M[i + j * ns];
+        }
+        lhs[j + j * n] -= re;
+        if (n > ns)
+        {
+            lhs[ns + j + (ns + j) * n] -= re;
+            lhs[j + (ns + j) * n] = im;
+            lhs[ns + j + j * n] = -im;
+        }
+    }
+
+    lu_system_solve(lhs, rhs, perm, n, 1, lu_work);
+}
+
+
+
+int calculate_simplified_newton_transform(int ns, double *A_mat, double *eig, double *T,
+                                          double *T_in, void *work)
+{
+    int i, j, k, it, n;
+    double nrm, shift;
+
+    char *c_ptr = work;
+
+    double *A_inv = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *hess = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *lhs = (double *) c_ptr;
+    c_ptr += 4 * ns * ns * sizeof(double);
+    double *rhs = (double *) c_ptr;
+    c_ptr += 2 * ns * sizeof(double);
+    double *lu_work = (double *) c_ptr;
+    c_ptr += 2 * ns * sizeof(double);
+    double *T_inv = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *res = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *lu_work_inv = (double *) c_ptr;
+    c_ptr += ns * ns * sizeof(double);
+    double *eig_re = (double *) c_ptr;
+    c_ptr += ns * sizeof(double);
+    double *eig_im = (double *) c_ptr;
+    c_ptr += ns * sizeof(double);
+    double *u = (double *) c_ptr;
+    c_ptr += ns * sizeof(double);
+    int *perm = (int *) c_ptr;
+    c_ptr += 2 * ns * sizeof(int);
+
+    assert((char *) work + simplified_newton_transform_work_calculate_size(ns) >= c_ptr);
+
+    // A_inv = A_mat^{-1}
+    for (i = 0; i < ns * ns; i++)
+    {
+        lhs[i] = A_mat[i];
+        A_inv[i] = 0.0;
+    }
+    for (i = 0; i < ns; i++)
+        A_inv[i * (ns + 1)] = 1.0;
+    lu_system_solve(lhs, A_inv, perm, ns, ns, lu_work_inv);
+
+    // eigenvalues of A_inv
+    for (i = 0; i < ns * ns; i++)
+        hess[i] = A_inv[i];
+    hessenberg_reduction(ns, hess, u);
+    if (hessenberg_eigenvalues(ns, hess, eig_re, eig_im))
+        return 1;
+
+    // real basis of eigenvectors by inverse iteration, such that
+    // A_inv * T = T * D, with D block diagonal and 2x2 blocks [re, im; -im, re]
+    for (k = 0; k < ns; k++)
+    {
+        eig[2 * k] = eig_re[k];
+        eig[2 * k + 1] = eig_im[k];
+
+        if (eig_im[k] < 0.0)  // second of a pair, handled with the first one
+            continue;
+
+        n = eig_im[k] == 0.0 ? ns : 2 * ns;
+        // perturb the shift slightly to keep the shifted system nonsingular
+        shift = eig_re[k] + 1e-10 * (1.0 + fabs(eig_re[k]) + fabs(eig_im[k]));
+
+        for (i = 0; i < n; i++)
+            rhs[i] = 1.0 / (1.0 + i);
+        for (it = 0; it < 2; it++)
+        {
+            shifted_system_solve(ns, A_inv, shift, eig_im[k], lhs, rhs, perm, lu_work);
+            nrm = 0.0;
+            for (i = 0; i < n; i++)
+                nrm += rhs[i] * rhs[i];
+            nrm = 1.0 / sqrt(nrm);
+            for (i = 0; i < n; i++)
+                rhs[i] *= nrm;
+        }
+
+        for (i = 0; i < ns; i++)
+        {
+            T[i + k * ns] = rhs[i];
+            if (n > ns)
+                T[i + (k + 1) * ns] = rhs[ns + i];
+        }
+    }
+
+    // T_in = T^{-1} * A_inv
+    for (i = 0; i < ns * ns; i++)
+    {
+        lhs[i] = T[i];
+        T_inv[i] = 0.0;
+    }
+    for (i = 0; i < ns; i++)
+        T_inv[i * (ns + 1)] = 1.0;
+    lu_system_solve(lhs, T_inv, perm, ns, ns, lu_work_inv);
+
+    for (j = 0; j < ns; j++)
+    {
+        for (i = 0; i < ns; i++)
+        {
+            T_in[i + j * ns] = 0.0;
+            for (k = 0; k < ns; k++)
+                T_in[i + j * ns] += T_inv[i + k * ns] * A_inv[k + j * ns];
+        }
+    }
+
+    // check A_inv * T = T * D
+    for (j = 0; j < ns * ns; j++)
+        res[j] = 0.0;
+    for (j = 0; j < ns; j++)
+    {
+        for (i = 0; i < ns; i++)
+        {
+            for (k = 0; k < ns; k++)
+                res[i + j * ns] += A_inv[i + k * ns] * T[k + j * ns];
+            if (eig[2 * j + 1] == 0.0)
+                res[i + j * ns] -= eig[2 * j] * T[i + j * ns];
+            else if (eig[2 * j + 1] > 0.0)
+                res[i + j * ns] -= eig[2 * j] * T[i + j * ns] - eig[2 * j + 1] * T[i + (j + 1) * ns];
+            else
+                res[i + j * ns] -= -eig[2 * j + 1] * T[i + (j - 1) * ns] + eig[2 * j] * T[i + j * ns];
+        }
+    }
+    nrm = 0.0;
+    for (i = 0; i < ns * ns; i++)
+        nrm = fabs(res[i]) > nrm ? fabs(res[i]) : nrm;
+    if (nrm > 1e-8 * (1.0 + fabs(eig[0]) + fabs(eig[1])))
+        return 1;
+
+    return 0;
+}
 
 
 
@@ -40,31 +40,6 @@ extern "C" {
 
 
 
-// enum Newton_type_collocation
-// {
-//     exact = 0,
-//     simplified_in,
-//     simplified_inis
-// };
-
-
-
-// typedef struct
-// {
-//     enum Newton_type_collocation type;
-//     double *eig;
-//     double *low_tria;
-//     bool single;
-//     bool freeze;
-
-//     double *transf1;
-//     double *transf2;
-
-//     double *transf1_T;
-//     double *transf2_T;
-// } Newton_scheme;
-
-
 typedef enum
 {
     GAUSS_LEGENDRE,
@@ -78,9 +53,12 @@ typedef enum
 //
 // void gauss_legendre_nodes(int ns, double *nodes, void *raw_memory);
 //
-// acados_size_t gauss_simplified_work_calculate_size(int ns);
-// //
-// void gauss_simplified(int ns, Newton_scheme *scheme, void *work);
+acados_size_t simplified_newton_transform_work_calculate_size(int ns);
+// computes eig (2*ns, real and imaginary parts of the eigenvalues of A_mat^{-1}), T (ns*ns) and
+// T_in = T^{-1} * A_mat^{-1}, such that A_mat^{-1} = T * D * T^{-1} with D block diagonal;
+// returns 0 on success
+int calculate_simplified_newton_transform(int ns, double *A_mat, double *eig, double *T,
+                                          double *T_in, void *work);
 //
 acados_size_t butcher_tableau_work_calculate_size(int ns);
 //
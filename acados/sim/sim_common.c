@@ -31,6 +31,7 @@
 
 // standard
 #include <assert.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,6 +64,10 @@ sim_config *sim_config_assign(void *raw_memory)
     sim_config *config = (sim_config *) c_ptr;
     c_ptr += sizeof(sim_config);
 
+    // optional
+    config->evaluate_batch = NULL;
+    config->batch_workspace_calculate_size = NULL;
+
     assert((char *) raw_memory + sim_config_calculate_size() >= c_ptr);
 
     return config;
@@ -528,6 +533,26 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value)
         double *newton_tol = value;
         opts->newton_tol = *newton_tol;
     }
+    else if (!strcmp(field, "adaptive_steps"))
+    {
+        bool *adaptive_steps = (bool *) value;
+        opts->adaptive_steps = *adaptive_steps;
+    }
+    else if (!strcmp(field, "adaptive_tol"))
+    {
+        double *adaptive_tol = value;
+        if (*adaptive_tol <= 0.0)
+        {
+            printf("\nerror: sim_opts_set_: adaptive_tol must be positive, got %e\n", *adaptive_tol);
+            exit(1);
+        }
+        opts->adaptive_tol = *adaptive_tol;
+    }
+    else if (!strcmp(field, "adaptive_freeze"))
+    {
+        bool *adaptive_freeze = (bool *) value;
+        opts->adaptive_freeze = *adaptive_freeze;
+    }
     else
     {
         printf("\nerror: field %s not available in sim_opts_set_\n", field);
@@ -561,6 +586,11 @@ void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *
         int *int_ptr = value;
         *int_ptr = opts->cost_computation;
     }
+    else if (!strcmp(field, "adaptive_freeze"))
+    {
+        bool *adaptive_freeze = value;
+        *adaptive_freeze = opts->adaptive_freeze;
+    }
     else
     {
         printf("sim_opts_get_: field %s not supported \n", field);
@@ -569,3 +599,146 @@ void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *
 
     return;
 }
+
+
+
+/************************************************
+ * adaptive steps
+ ************************************************/
+
+acados_size_t sim_adaptive_steps_work_calculate_size(int nx)
+{
+    acados_size_t size = 0;
+
+    size += 4 * nx * sizeof(double);  // x, x_full, x_half, x_two_halves
+
+    make_int_multiple_of(8, &size);
+
+    return size;
+}
+
+
+
+int sim_adaptive_steps_select(sim_opts *opts, int nx, double T, int order, sim_nominal_step_fun step_fun,
+                              void *step_ctx, double *x0, double *step_sizes, int *num_steps_used,
+                              void *work)
+{
+    char *c_ptr = (char *) work;
+
+    double *x = (double *) c_ptr;
+    c_ptr += nx * sizeof(double);
+    double *x_full = (double *) c_ptr;
+    c_ptr += nx * sizeof(double);
+    double *x_half = (double *) c_ptr;
+    c_ptr += nx * sizeof(double);
+    double *x_two_halves = (double *) c_ptr;
+    c_ptr += nx * sizeof(double);
+
+    assert((char *) work + sim_adaptive_steps_work_calculate_size(nx) >= c_ptr);
+
+    int num_steps_max = opts->num_steps;
+    int num_steps_prev = *num_steps_used;
+
+    // the error of one full step is (x_two_halves - x_full) * 2^p / (2^p - 1)
+    double err_scale = pow(2.0, order) / (pow(2.0, order) - 1.0);
+    double t = 0.0;
+    double step_proposal = T;
+    double step, err, fac;
+    int k = 0;
+
+    for (int i = 0; i < nx; i++)
+        x[i] = x0[i];
+
+    while (t < T * (1.0 - 1e-12))
+    {
+        if (k >= num_steps_max)
+            return 1;
+
+        // reuse the sequence of the previous call, allow it to grow by at most a factor 2
+        step = step_proposal;
+        if (k < num_steps_prev)
+            step = fmax(step_sizes[k], fmin(step_proposal, 2.0 * step_sizes[k]));
+        if (t + step > T * (1.0 - 1e-12))
+            step = T - t;
+
+        while (1)
+        {
+            step_fun(step_ctx, t, x, step, x_full);
+            step_fun(step_ctx, t, x, 0.5 * step, x_half);
+            step_fun(step_ctx, t + 0.5 * step, x_half, 0.5 * step, x_two_halves);
+
+            err = 0.0;
+            for (int i = 0; i < nx; i++)
+                err = fmax(err, fabs(x_two_halves[i] - x_full[i]) / (1.0 + fabs(x_full[i])));
+            err *= err_scale / opts->adaptive_tol;
+
+            fac = err > 0.0 ? 0.9 * pow(err, -1.0 / (order + 1)) : 5.0;
+            fac = fmin(5.0, fmax(0.2, fac));
+
+            if (err <= 1.0)
+                break;
+
+            if (isnan(err) || step < 1e-10 * T)
+                return 1;
+            step *= fac;
+        }
+
+        // accept: the sensitivity sweep repeats exactly this full step
+        step_sizes[k] = step;
+        for (int i = 0; i < nx; i++)
+            x[i] = x_full[i];
+        t += step;
+        k++;
+        step_proposal = step * fac;
+    }
+
+    *num_steps_used = k;
+
+    return 0;
+}
+
+
+
+int sim_adaptive_steps_update(sim_opts *opts, int nx, double T, int order, sim_nominal_step_fun step_fun,
+                              void *step_ctx, double *x0, double *step_sizes, double *step_t0,
+                              int *num_steps_used, int *status, void *work)
+{
+    int num_steps = opts->num_steps;
+
+    if (opts->adaptive_steps)
+    {
+        // frozen sequences are only reused if they cover the same interval length
+        double T_prev = 0.0;
+        for (int k = 0; k < *num_steps_used; k++)
+            T_prev += step_sizes[k];
+
+        if (opts->adaptive_freeze && *num_steps_used > 0 && fabs(T_prev - T) <= 1e-10 * T)
+            return *status;
+
+        if (*num_steps_used > num_steps || fabs(T_prev - T) > 1e-10 * T)
+            *num_steps_used = 0;
+
+        if (!sim_adaptive_steps_select(opts, nx, T, order, step_fun, step_ctx, x0, step_sizes,
+                                       num_steps_used, work))
+        {
+            step_t0[0] = 0.0;
+            for (int k = 1; k < *num_steps_used; k++)
+                step_t0[k] = step_t0[k-1] + step_sizes[k-1];
+            *status = ACADOS_SUCCESS;
+            return *status;
+        }
+    }
+
+    double step = T / num_steps;
+    for (int k = 0; k < num_steps; k++)
+    {
+        step_sizes[k] = step;
+        step_t0[k] = k * step;
+    }
+    *num_steps_used = num_steps;
+
+    // tolerance not met within num_steps steps: the finest uniform grid is used
+    *status = opts->adaptive_steps ? ACADOS_MAXITER : ACADOS_SUCCESS;
+
+    return *status;
+}
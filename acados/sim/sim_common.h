@@ -147,10 +147,22 @@ typedef struct
     // && jac_reuse=false
     int newton_iter;
     bool jac_reuse;
-    // Newton_scheme *scheme;
+    // IRK only: Newton iterations with the stage Jacobian evaluated at the first stage,
+    // decoupled into real and complex-pair blocks by diagonalizing A_mat
+    bool simplified_newton;
+    double *simplified_eig;   // (re, im) of the eigenvalues of A_mat^{-1}, 2*ns
+    double *simplified_T;     // real eigenbasis of A_mat^{-1}, ns*ns
+    double *simplified_T_in;  // T^{-1} * A_mat^{-1}, ns*ns
 
     double newton_tol; // optinally used in implicit integrators
 
+    bool single_precision; // ERK only: stage trajectory and RK updates in float
+
+    // ERK and IRK only: error-controlled step sizes, num_steps is the maximum number of steps
+    bool adaptive_steps;
+    double adaptive_tol;   // local error tolerance, relative to (1 + |x|)
+    bool adaptive_freeze;  // reuse the step sequence of the previous call without error control
+
     // workspace
     void *work;
 
@@ -162,6 +174,11 @@ typedef struct
 {
     int (*evaluate)(void *config_, sim_in *in, sim_out *out, void *opts, void *mem, void *work);
     int (*precompute)(void *config_, sim_in *in, sim_out *out, void *opts, void *mem, void *work);
+    // batch of independent instances with same dims and opts, NULL if not supported (only ERK
+    // implements it, sim_solve_batch calls evaluate per instance otherwise)
+    int (*evaluate_batch)(void *config_, sim_in **in, sim_out **out, int num_instances, void *opts,
+                          void *mem, void *work);
+    acados_size_t (*batch_workspace_calculate_size)(void *config, void *dims, void *opts);
     // opts
     acados_size_t (*opts_calculate_size)(void *config_, void *dims);
     void *(*opts_assign)(void *config_, void *dims, void *raw_memory);
@@ -226,4 +243,22 @@ void sim_opts_set_(sim_opts *opts, const char *field, void *value);
 //
 void sim_opts_get_(sim_config *config, sim_opts *opts, const char *field, void *value);
 
+/* adaptive steps */
+// one step of the integration method without sensitivities, t relative to the start of the interval
+typedef void (*sim_nominal_step_fun)(void *ctx, double t, double *x, double step, double *x_next);
+//
+acados_size_t sim_adaptive_steps_work_calculate_size(int nx);
+// selects step_sizes by step doubling with the method of the given order;
+// on entry, the first num_steps_used[0] step_sizes are the sequence of the previous call (initial guess);
+// returns 0 on success, 1 if the tolerance cannot be met within opts->num_steps steps
+int sim_adaptive_steps_select(sim_opts *opts, int nx, double T, int order, sim_nominal_step_fun step_fun,
+                              void *step_ctx, double *x0, double *step_sizes, int *num_steps_used,
+                              void *work);
+// fills step_sizes and step_t0 (step start times relative to t0) for the current call;
+// status is ACADOS_MAXITER if adaptive_tol cannot be met within opts->num_steps steps and the uniform grid
+// with opts->num_steps steps is used instead, ACADOS_SUCCESS otherwise; a frozen sequence keeps its status
+int sim_adaptive_steps_update(sim_opts *opts, int nx, double T, int order, sim_nominal_step_fun step_fun,
+                              void *step_ctx, double *x0, double *step_sizes, double *step_t0,
+                              int *num_steps_used, int *status, void *work);
+
 #endif  // ACADOS_SIM_SIM_COMMON_H_
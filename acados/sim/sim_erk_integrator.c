@@ -248,7 +248,24 @@ void *sim_erk_opts_assign(void *config_, void *dims, void *raw_memory)
 void sim_erk_opts_set(void *config_, void *opts_, const char *field, void *value)
 {
     sim_opts *opts = (sim_opts *) opts_;
-    sim_opts_set_(opts, field, value);
+
+    if (!strcmp(field, "single_precision"))
+    {
+        bool *single_precision = (bool *) value;
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+        opts->single_precision = *single_precision;
+#else
+        if (*single_precision)
+        {
+            printf("\nerror: sim_erk_opts_set: single_precision requires acados to be compiled with ACADOS_WITH_SINGLE_PRECISION\n");
+            exit(1);
+        }
+#endif
+    }
+    else
+    {
+        sim_opts_set_(opts, field, value);
+    }
 }
 
 
@@ -288,6 +305,12 @@ void sim_erk_opts_initialize_default(void *config_, void *dims_, void *opts_)
 
     opts->output_z = false;
     opts->sens_algebraic = false;
+
+    opts->single_precision = false;
+
+    opts->adaptive_steps = false;
+    opts->adaptive_tol = 1e-6;
+    opts->adaptive_freeze = false;
 }
 
 
@@ -324,8 +347,15 @@ void sim_erk_opts_update(void *config_, void *dims, void *opts_)
 
 acados_size_t sim_erk_memory_calculate_size(void *config, void *dims, void *opts_)
 {
+    sim_opts *opts = opts_;
+
     acados_size_t size = sizeof(sim_erk_memory);
 
+    size += 2 * opts->num_steps * sizeof(double);  // step_sizes, step_t0
+
+    make_int_multiple_of(8, &size);
+    size += 1 * 8;
+
     return size;
 }
 
@@ -333,11 +363,22 @@ acados_size_t sim_erk_memory_calculate_size(void *config, void *dims, void *opts
 
 void *sim_erk_memory_assign(void *config, void *dims, void *opts_, void *raw_memory)
 {
+    sim_opts *opts = opts_;
+
     char *c_ptr = (char *) raw_memory;
 
     sim_erk_memory *mem = (sim_erk_memory *) c_ptr;
     c_ptr += sizeof(sim_erk_memory);
 
+    align_char_to(8, &c_ptr);
+
+    assign_and_advance_double(opts->num_steps, &mem->step_sizes, &c_ptr);
+    assign_and_advance_double(opts->num_steps, &mem->step_t0, &c_ptr);
+    mem->num_steps_used = 0;
+    mem->adaptive_status = ACADOS_SUCCESS;
+
+    assert((char *) raw_memory + sim_erk_memory_calculate_size(config, dims, opts_) >= c_ptr);
+
     return mem;
 }
 
@@ -389,6 +430,16 @@ void sim_erk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_steps_used"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_steps_used;
+    }
+    else if (!strcmp(field, "adaptive_status"))
+    {
+        int *ptr = value;
+        *ptr = mem->adaptive_status;
+    }
     else
     {
         printf("sim_erk_memory_get field %s is not supported! \n", field);
@@ -421,7 +472,20 @@ acados_size_t sim_erk_workspace_calculate_size(void *config_, void *dims_, void
 
     size += (nX + nu) * sizeof(double);  // rhs_forw_in
 
-    if (opts->sens_adj | opts->sens_hess)
+    if (opts->adaptive_steps)
+    {
+        size += (nx + nu) * sizeof(double);  // adaptive_rhs_in
+        size += ns * nx * sizeof(double);    // adaptive_K
+        size += sim_adaptive_steps_work_calculate_size(nx);
+    }
+
+    if (opts->single_precision)
+    {
+        size += nX * sizeof(double);      // K_traj, one stage
+        size += ns * nX * sizeof(float);  // K_traj_single
+        size += nX * sizeof(float);       // forw_traj_single
+    }
+    else if (opts->sens_adj | opts->sens_hess)
     {
         size += num_steps * ns * nX * sizeof(double);   // K_traj
         size += (num_steps + 1) * nX * sizeof(double);  // out_forw_traj
@@ -479,7 +543,31 @@ static void *sim_erk_cast_workspace(void *config_, sim_erk_dims *dims, sim_opts
     work->rhs_forw_in = d_ptr;
     d_ptr += (nX+nu);
 
-    if (opts->sens_adj | opts->sens_hess)
+    if (opts->adaptive_steps)
+    {
+        work->adaptive_rhs_in = d_ptr;
+        d_ptr += nx+nu;
+        work->adaptive_K = d_ptr;
+        d_ptr += ns*nx;
+        work->adaptive_work = d_ptr;
+        d_ptr += sim_adaptive_steps_work_calculate_size(nx) / sizeof(double);
+    }
+
+    if (opts->single_precision)
+    {
+        work->K_traj = d_ptr;
+        d_ptr += nX;
+        float *f_ptr = (float *) d_ptr;
+        work->K_traj_single = f_ptr;
+        f_ptr += ns*nX;
+        work->forw_traj_single = f_ptr;
+        f_ptr += nX;
+        // forward only, no adjoint workspace
+        c_ptr = (char *) f_ptr;
+        assert((char *) raw_memory + mem->workspace_size >= c_ptr);
+        return (void *) work;
+    }
+    else if (opts->sens_adj | opts->sens_hess)
     {
         //
         //assign_and_advance_double(ns * num_steps * nX, &workspace->K_traj, &c_ptr);
@@ -581,6 +669,179 @@ int sim_erk_precompute(void *config_, sim_in *in, sim_out *out, void *opts_, voi
 
 
 
+typedef struct
+{
+    sim_opts *opts;
+    erk_model *model;
+    int nx;
+    int nu;
+    double *rhs_in;  // x, u
+    double *K;
+} sim_erk_nominal_step_ctx;
+
+
+
+// one ERK step of the ODE without sensitivities, for the step size selection
+static void sim_erk_nominal_step(void *ctx_, double t, double *x, double step, double *x_next)
+{
+    sim_erk_nominal_step_ctx *ctx = ctx_;
+
+    int ns = ctx->opts->ns;
+    int nx = ctx->nx;
+    double *A_mat = ctx->opts->A_mat;
+    double *b_vec = ctx->opts->b_vec;
+    double *rhs_in = ctx->rhs_in;
+    double *K = ctx->K;
+    double a;
+
+    ext_fun_arg_t type_in[2] = {COLMAJ, COLMAJ};
+    void *in[2] = {rhs_in, rhs_in + nx};
+    ext_fun_arg_t type_out[1] = {COLMAJ};
+    void *out[1];
+
+    for (int s = 0; s < ns; s++)
+    {
+        for (int i = 0; i < nx; i++)
+            rhs_in[i] = x[i];
+        for (int j = 0; j < s; j++)
+        {
+            a = A_mat[j * ns + s];
+            if (a != 0)
+            {
+                a *= step;
+                for (int i = 0; i < nx; i++)
+                    rhs_in[i] += a * K[j * nx + i];
+            }
+        }
+        out[0] = K + s * nx;
+        ctx->model->expl_ode_fun->evaluate(ctx->model->expl_ode_fun, type_in, in, type_out, out);
+    }
+
+    for (int i = 0; i < nx; i++)
+        x_next[i] = x[i];
+    for (int s = 0; s < ns; s++)
+    {
+        for (int i = 0; i < nx; i++)
+            x_next[i] += step * b_vec[s] * K[s * nx + i];
+    }
+}
+
+
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+// simulation and forward sensitivities with the state and stage trajectory in float;
+// the model functions are evaluated in double on the converted stage input
+static int sim_erk_single(sim_erk_dims *dims, sim_in *in, sim_out *out, sim_opts *opts,
+                          sim_erk_workspace *work, double *timing_ad)
+{
+    acados_timer timer_ad;
+
+    int i, j, s, istep;
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+
+    int nf = opts->num_forw_sens;
+    if (!opts->sens_forw) nf = 0;
+    int nX = nx + nx * nf;
+
+    int num_steps = opts->num_steps;
+    double step = in->T / num_steps;
+
+    float a_s[NS_MAX];
+    float b_s[NS_MAX];
+    for (s = 0; s < ns; s++)
+        b_s[s] = (float) (step * opts->b_vec[s]);
+
+    float *K_traj = work->K_traj_single;
+    float *forw_traj = work->forw_traj_single;
+    double *K_stage = work->K_traj;
+    double *rhs_forw_in = work->rhs_forw_in;
+
+    erk_model *model = in->model;
+
+    ext_fun_arg_t expl_vde_type_in[4];
+    void *expl_vde_in[4];
+    ext_fun_arg_t expl_vde_type_out[3];
+    void *expl_vde_out[3];
+    for (i = 0; i < 4; i++)
+        expl_vde_type_in[i] = COLMAJ;
+    for (i = 0; i < 3; i++)
+        expl_vde_type_out[i] = COLMAJ;
+
+    expl_vde_in[0] = rhs_forw_in;  // x: nx
+    expl_vde_out[0] = K_stage;  // fun: nx
+    if (opts->sens_forw)
+    {
+        expl_vde_in[1] = rhs_forw_in + nx;  // Sx: nx*nx
+        expl_vde_in[2] = rhs_forw_in + nx * nx + nx;  // Su: nx*nu
+        expl_vde_in[3] = rhs_forw_in + nx * nx + nx + nx * nu;  // u: nu
+        expl_vde_out[1] = K_stage + nx;  // Sx: nx*nx
+        expl_vde_out[2] = K_stage + nx * nx + nx;  // Su: nx*nu
+    }
+    else
+    {
+        if (model->expl_ode_fun == 0)
+        {
+            printf("sim ERK: expl_ode_fun is not provided. Exiting.\n");
+            exit(1);
+        }
+        expl_vde_in[1] = rhs_forw_in + nx;  // u: nu
+    }
+
+    // initialize integrator variables
+    for (i = 0; i < nx; i++)
+        forw_traj[i] = (float) in->x[i];
+    for (i = 0; i < nx * nf; i++)
+        forw_traj[nx + i] = (float) in->S_forw[i];
+    for (i = 0; i < nu; i++)
+        rhs_forw_in[nX + i] = in->u[i];
+
+    for (istep = 0; istep < num_steps; istep++)
+    {
+        for (s = 0; s < ns; s++)
+        {
+            for (j = 0; j < s; j++)
+                a_s[j] = (float) (step * opts->A_mat[j * ns + s]);
+
+            for (i = 0; i < nX; i++)
+            {
+                float tmp = forw_traj[i];
+                for (j = 0; j < s; j++)
+                    tmp += a_s[j] * K_traj[j * nX + i];
+                rhs_forw_in[i] = tmp;
+            }
+
+            acados_tic(&timer_ad);
+            if (opts->sens_forw)
+                model->expl_vde_for->evaluate(model->expl_vde_for, expl_vde_type_in, expl_vde_in,
+                                              expl_vde_type_out, expl_vde_out);
+            else
+                model->expl_ode_fun->evaluate(model->expl_ode_fun, expl_vde_type_in, expl_vde_in,
+                                              expl_vde_type_out, expl_vde_out);
+            *timing_ad += acados_toc(&timer_ad);
+
+            for (i = 0; i < nX; i++)
+                K_traj[s * nX + i] = (float) K_stage[i];
+        }
+        for (s = 0; s < ns; s++)
+        {
+            for (i = 0; i < nX; i++)
+                forw_traj[i] += b_s[s] * K_traj[s * nX + i];  // ERK step
+        }
+    }
+
+    for (i = 0; i < nx; i++)
+        out->xn[i] = (double) forw_traj[i];
+    for (i = 0; i < nx * nf; i++)
+        out->S_forw[i] = (double) forw_traj[nx + i];
+
+    return ACADOS_SUCCESS;
+}
+#endif
+
+
+
 int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_)
 {
     acados_timer timer, timer_ad;
@@ -626,6 +887,35 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
         exit(1);
     }
 
+    double timing_ad = 0.0;
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (opts->single_precision)
+    {
+        if (opts->adaptive_steps)
+        {
+            printf("sim_erk: adaptive_steps not supported in single precision\n");
+            exit(1);
+        }
+        if (opts->sens_adj || opts->sens_hess)
+        {
+            printf("sim_erk: adjoint and hessian propagation not supported in single precision\n");
+            exit(1);
+        }
+        sim_erk_single(dims, in, out, opts, work, &timing_ad);
+
+        out->info->CPUtime = acados_toc(&timer);
+        out->info->LAtime = 0.0;
+        out->info->ADtime = timing_ad;
+
+        mem->time_sim = out->info->CPUtime;
+        mem->time_ad = out->info->ADtime;
+        mem->time_la = out->info->LAtime;
+
+        return 0;
+    }
+#endif
+
     int nf = opts->num_forw_sens;
     if (!opts->sens_forw) nf = 0;
 
@@ -635,8 +925,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     double *x = in->x;
     double *u = in->u;
     double *S_forw_in = in->S_forw;
-    int num_steps = opts->num_steps;
-    double step = in->T / num_steps;
+    double step;
 
     double *S_adj_in = in->S_adj;
 
@@ -697,7 +986,34 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
     erk_model *model = in->model;
 
-    double timing_ad = 0.0;
+    /************************************************
+     * step sequence
+     ************************************************/
+
+    sim_erk_nominal_step_ctx step_ctx;
+    if (opts->adaptive_steps)
+    {
+        if (model->expl_ode_fun == 0)
+        {
+            printf("sim ERK: adaptive_steps requires expl_ode_fun. Exiting.\n");
+            exit(1);
+        }
+        step_ctx.opts = opts;
+        step_ctx.model = model;
+        step_ctx.nx = nx;
+        step_ctx.nu = nu;
+        step_ctx.rhs_in = work->adaptive_rhs_in;
+        step_ctx.K = work->adaptive_K;
+        for (i = 0; i < nu; i++)
+            step_ctx.rhs_in[nx + i] = u[i];
+    }
+    acados_tic(&timer_ad);
+    sim_adaptive_steps_update(opts, nx, in->T, ns, &sim_erk_nominal_step, &step_ctx, x,
+                              mem->step_sizes, mem->step_t0, &mem->num_steps_used,
+                              &mem->adaptive_status, work->adaptive_work);
+    if (opts->adaptive_steps)
+        timing_ad += acados_toc(&timer_ad);
+    int num_steps = mem->num_steps_used;
 
     /************************************************
      * forward sweep
@@ -713,6 +1029,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
     for (istep = 0; istep < num_steps; istep++)
     {
+        step = mem->step_sizes[istep];
         if (opts->sens_adj | opts->sens_hess)
         {
             K_traj = work->K_traj + istep * ns * nX;
@@ -804,6 +1121,7 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
             K_traj = work->K_traj + istep * ns * nX;
             forw_traj = work->out_forw_traj + istep*nX;
+            step = mem->step_sizes[istep];
 
             for (s = ns - 1; s >= 0; s--)
             {
@@ -924,10 +1242,263 @@ int sim_erk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
-    return 0;
+    return mem->adaptive_status;
 }
 
 
+/************************************************
+ * batch
+ ************************************************/
+
+// lane-interleaved storage: entry i of lane l is at [i*SIM_ERK_BATCH_LANES + l]
+#define LANES SIM_ERK_BATCH_LANES
+
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config_, void *dims_, void *opts_)
+{
+    sim_opts *opts = opts_;
+    sim_erk_dims *dims = (sim_erk_dims *) dims_;
+
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nf = opts->sens_forw ? opts->num_forw_sens : 0;
+    int nX = nx * (1 + nf);
+
+    acados_size_t size = 0;
+
+    size += LANES * sizeof(double);                // step
+    size += LANES * nX * sizeof(double);           // forw_traj
+    size += LANES * nX * sizeof(double);           // rhs_forw_in
+    size += LANES * ns * nX * sizeof(double);      // K_traj
+    size += LANES * (nX + nu) * sizeof(double);    // rhs_lane
+    size += LANES * nX * sizeof(double);           // K_lane
+
+    size += 1 * 64;
+
+    return size;
+}
+
+
+
+int sim_erk_batch(void *config_, sim_in **in, sim_out **out, int num_instances, void *opts_,
+                  void *mem_, void *work_)
+{
+    acados_timer timer, timer_ad;
+
+    sim_opts *opts = opts_;
+    sim_erk_memory *mem = mem_;
+
+    if (opts->sens_adj || opts->sens_hess)
+    {
+        printf("sim_erk_batch: adjoint and hessian propagation not supported\n");
+        exit(1);
+    }
+    if (opts->adaptive_steps)
+    {
+        printf("sim_erk_batch: adaptive_steps not supported\n");
+        exit(1);
+    }
+    if (opts->single_precision)
+    {
+        printf("sim_erk_batch: single precision not supported\n");
+        exit(1);
+    }
+    if ( opts->ns != opts->tableau_size )
+    {
+        printf("Error in sim_erk_batch: the Butcher tableau size does not match ns\n");
+        exit(1);
+    }
+    if (num_instances <= 0)
+        return ACADOS_SUCCESS;
+
+    sim_erk_dims *dims = (sim_erk_dims *) in[0]->dims;
+
+    int ns = opts->ns;
+    int nx = dims->nx;
+    int nu = dims->nu;
+    int nf = opts->sens_forw ? opts->num_forw_sens : 0;
+    int nX = nx * (1 + nf);
+    int num_steps = opts->num_steps;
+
+    double *A_mat = opts->A_mat;
+    double *b_vec = opts->b_vec;
+
+    int nx_squared_plus_nx = nx * nx + nx;
+    int nx_times_nu = nx * nu;
+
+    // workspace
+    char *c_ptr = (char *) work_;
+    align_char_to(64, &c_ptr);
+    double *d_ptr = (double *) c_ptr;
+
+    double *step = d_ptr;
+    d_ptr += LANES;
+    double *forw_traj = d_ptr;
+    d_ptr += LANES * nX;
+    double *rhs_forw_in = d_ptr;
+    d_ptr += LANES * nX;
+    double *K_traj = d_ptr;
+    d_ptr += LANES * ns * nX;
+    double *rhs_lane = d_ptr;
+    d_ptr += LANES * (nX + nu);
+    double *K_lane = d_ptr;
+    d_ptr += LANES * nX;
+
+    assert((char *) work_ + sim_erk_batch_workspace_calculate_size(config_, dims, opts) >= (char *) d_ptr);
+
+    ext_fun_arg_t expl_vde_type_in[4];
+    void *expl_vde_in[4];
+    ext_fun_arg_t expl_vde_type_out[3];
+    void *expl_vde_out[3];
+    for (int k = 0; k < 4; k++)
+        expl_vde_type_in[k] = COLMAJ;
+    for (int k = 0; k < 3; k++)
+        expl_vde_type_out[k] = COLMAJ;
+
+    int i, j, l, s, istep;
+    double a, b;
+
+    double time_sim = 0.0;
+
+    for (int i0 = 0; i0 < num_instances; i0 += LANES)
+    {
+        acados_tic(&timer);
+        int num_lanes = num_instances - i0 < LANES ? num_instances - i0 : LANES;
+        double timing_ad[LANES] = {0.0};
+
+        // initialize integrator variables, unused lanes integrate zeros with zero step
+        for (l = 0; l < LANES; l++)
+        {
+            if (l < num_lanes)
+            {
+                sim_in *in_l = in[i0 + l];
+                double *rhs_l = rhs_lane + l * (nX + nu);
+                step[l] = in_l->T / num_steps;
+                for (i = 0; i < nx; i++)
+                    forw_traj[i*LANES + l] = in_l->x[i];
+                for (i = 0; i < nx * nf; i++)
+                    forw_traj[(nx + i)*LANES + l] = in_l->S_forw[i];
+                for (i = 0; i < nu; i++)
+                    rhs_l[nX + i] = in_l->u[i];
+            }
+            else
+            {
+                step[l] = 0.0;
+                for (i = 0; i < nX; i++)
+                    forw_traj[i*LANES + l] = 0.0;
+            }
+        }
+
+        for (istep = 0; istep < num_steps; istep++)
+        {
+            for (s = 0; s < ns; s++)
+            {
+                for (i = 0; i < nX * LANES; i++)
+                    rhs_forw_in[i] = forw_traj[i];
+                for (j = 0; j < s; j++)
+                {
+                    a = A_mat[j * ns + s];
+                    if (a != 0)
+                    {
+                        double *K_j = K_traj + j * nX * LANES;
+                        for (i = 0; i < nX; i++)
+                            for (l = 0; l < LANES; l++)
+                                rhs_forw_in[i*LANES + l] += a * step[l] * K_j[i*LANES + l];
+                    }
+                }
+
+                // evaluate the model of each instance on its own contiguous arguments
+                for (l = 0; l < num_lanes; l++)
+                {
+                    erk_model *model = in[i0 + l]->model;
+                    double *rhs_l = rhs_lane + l * (nX + nu);
+                    double *K_l = K_lane + l * nX;
+                    for (i = 0; i < nX; i++)
+                        rhs_l[i] = rhs_forw_in[i*LANES + l];
+
+                    acados_tic(&timer_ad);
+                    if (opts->sens_forw)
+                    {
+                        expl_vde_in[0] = rhs_l;  // x: nx
+                        expl_vde_in[1] = rhs_l + nx;  // Sx: nx*nx
+                        expl_vde_in[2] = rhs_l + nx_squared_plus_nx;  // Su: nx*nu
+                        expl_vde_in[3] = rhs_l + nx_squared_plus_nx + nx_times_nu;  // u: nu
+                        expl_vde_out[0] = K_l;  // fun: nx
+                        expl_vde_out[1] = K_l + nx;  // Sx: nx*nx
+                        expl_vde_out[2] = K_l + nx_squared_plus_nx;  // Su: nx*nu
+                        model->expl_vde_for->evaluate(model->expl_vde_for, expl_vde_type_in, expl_vde_in,
+                                                      expl_vde_type_out, expl_vde_out);
+                    }
+                    else
+                    {
+                        if (model->expl_ode_fun == 0)
+                        {
+                            printf("sim ERK: expl_ode_fun is not provided. Exiting.\n");
+                            exit(1);
+                        }
+                        expl_vde_in[0] = rhs_l;  // x: nx
+                        expl_vde_in[1] = rhs_l + nx;  // u: nu
+                        expl_vde_out[0] = K_l;  // fun: nx
+                        model->expl_ode_fun->evaluate(model->expl_ode_fun, expl_vde_type_in, expl_vde_in,
+                                                      expl_vde_type_out, expl_vde_out);
+                    }
+                    timing_ad[l] += acados_toc(&timer_ad);
+                }
+
+                double *K_s = K_traj + s * nX * LANES;
+                for (l = 0; l < num_lanes; l++)
+                {
+                    double *K_l = K_lane + l * nX;
+                    for (i = 0; i < nX; i++)
+                        K_s[i*LANES + l] = K_l[i];
+                }
+                for (l = num_lanes; l < LANES; l++)
+                {
+                    for (i = 0; i < nX; i++)
+                        K_s[i*LANES + l] = 0.0;
+                }
+            }
+
+            for (s = 0; s < ns; s++)
+            {
+                b = b_vec[s];
+                double *K_s = K_traj + s * nX * LANES;
+                for (i = 0; i < nX; i++)
+                    for (l = 0; l < LANES; l++)
+                        forw_traj[i*LANES + l] += b * step[l] * K_s[i*LANES + l];  // ERK step
+            }
+        }
+
+        // store trajectory and forward sensitivities
+        for (l = 0; l < num_lanes; l++)
+        {
+            sim_out *out_l = out[i0 + l];
+            for (i = 0; i < nx; i++)
+                out_l->xn[i] = forw_traj[i*LANES + l];
+            for (i = 0; i < nx * nf; i++)
+                out_l->S_forw[i] = forw_traj[(nx + i)*LANES + l];
+        }
+
+        double time_group = acados_toc(&timer);
+        time_sim += time_group;
+        for (l = 0; l < num_lanes; l++)
+        {
+            sim_out *out_l = out[i0 + l];
+            out_l->info->CPUtime = time_group / num_lanes;
+            out_l->info->ADtime = timing_ad[l];
+            out_l->info->LAtime = out_l->info->CPUtime - timing_ad[l];
+        }
+    }
+
+    mem->time_sim = time_sim;
+
+    return ACADOS_SUCCESS;
+}
+
+#undef LANES
+
+
+
 void sim_erk_config_initialize_default(void *config_)
 {
     sim_config *config = config_;
@@ -950,6 +1521,8 @@ void sim_erk_config_initialize_default(void *config_)
     config->model_assign = &sim_erk_model_assign;
     config->model_set = &sim_erk_model_set;
     config->evaluate = &sim_erk;
+    config->evaluate_batch = &sim_erk_batch;
+    config->batch_workspace_calculate_size = &sim_erk_batch_workspace_calculate_size;
     config->precompute = &sim_erk_precompute;
     config->config_initialize_default = &sim_erk_config_initialize_default;
     config->dims_calculate_size = &sim_erk_dims_calculate_size;
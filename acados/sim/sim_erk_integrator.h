@@ -39,6 +39,11 @@ extern "C" {
 #include "acados/sim/sim_common.h"
 #include "acados/utils/types.h"
 
+// number of instances integrated in lockstep by sim_erk_batch, e.g. 8 for AVX-512 builds
+#ifndef SIM_ERK_BATCH_LANES
+#define SIM_ERK_BATCH_LANES 4
+#endif
+
 
 
 typedef struct
@@ -74,6 +79,12 @@ typedef struct
     double time_la;
     acados_size_t workspace_size;
 
+    // step sequence, uniform or selected by opts->adaptive_steps (num_steps)
+    double *step_sizes;
+    double *step_t0;
+    int num_steps_used;
+    int adaptive_status;  // ACADOS_MAXITER if adaptive_tol was not met and the uniform grid is used
+
 } sim_erk_memory;
 
 
@@ -90,6 +101,15 @@ typedef struct
     double *out_adj_tmp;
     double *adj_traj;
 
+    // single precision: K_traj only holds the model output of one stage
+    float *K_traj_single;     // stages*nX
+    float *forw_traj_single;  // nX
+
+    // only if opts->adaptive_steps: nominal steps for the step size selection
+    double *adaptive_rhs_in;  // nx + nu
+    double *adaptive_K;       // stages*nx
+    void *adaptive_work;
+
 } sim_erk_workspace;
 
 
@@ -133,6 +153,15 @@ void sim_erk_set_external_fun_workspaces(void *config_, void *dims_, void *opts_
 
 //
 int sim_erk(void *config, sim_in *in, sim_out *out, void *opts_, void *mem_, void *work_);
+// batch: simulation and forward sensitivities of independent instances;
+// only the RK stage combinations are vectorized across lanes, expl_ode_fun and expl_vde_for
+// are called per instance on a de-interleaved copy, as generated model code is single-instance.
+// The gain over sim_erk is therefore bounded by the share of the RK combinations in the step,
+// see ERK_batch against ERK_per_instance in bench_sim; there is no batch mode for IRK
+acados_size_t sim_erk_batch_workspace_calculate_size(void *config, void *dims, void *opts_);
+//
+int sim_erk_batch(void *config, sim_in **in, sim_out **out, int num_instances, void *opts_,
+                  void *mem_, void *work_);
 //
 void sim_erk_config_initialize_default(void *config);
 
@@ -237,6 +237,32 @@ int sim_irk_model_set(void *model_, const char *field, void *value)
  * opts
  ************************************************/
 
+static acados_size_t sim_irk_opts_work_calculate_size(int ns_max)
+{
+    acados_size_t size_tableau = butcher_tableau_work_calculate_size(ns_max);
+    acados_size_t size_simplified = simplified_newton_transform_work_calculate_size(ns_max);
+
+    return size_tableau > size_simplified ? size_tableau : size_simplified;
+}
+
+
+
+static void sim_irk_opts_update_simplified_newton(sim_opts *opts)
+{
+    if (!opts->simplified_newton)
+        return;
+
+    if (calculate_simplified_newton_transform(opts->ns, opts->A_mat, opts->simplified_eig,
+            opts->simplified_T, opts->simplified_T_in, opts->work))
+    {
+        printf("\nerror: sim_irk: simplified_newton: could not diagonalize the Butcher matrix,"
+               " use a collocation type with invertible A_mat.\n");
+        exit(1);
+    }
+}
+
+
+
 acados_size_t sim_irk_opts_calculate_size(void *config_, void *dims)
 {
     int ns_max = NS_MAX;
@@ -249,7 +275,10 @@ acados_size_t sim_irk_opts_calculate_size(void *config_, void *dims)
     size += ns_max * sizeof(double);           // b_vec
     size += ns_max * sizeof(double);           // c_vec
 
-    size += butcher_tableau_work_calculate_size(ns_max);
+    size += 2 * ns_max * sizeof(double);           // simplified_eig
+    size += 2 * ns_max * ns_max * sizeof(double);  // simplified_T, simplified_T_in
+
+    size += sim_irk_opts_work_calculate_size(ns_max);
 
     make_int_multiple_of(8, &size);
     size += 1 * 8;
@@ -270,12 +299,16 @@ void *sim_irk_opts_assign(void *config_, void *dims, void *raw_memory)
 
     // work
     opts->work = c_ptr;
-    c_ptr += butcher_tableau_work_calculate_size(ns_max);
+    c_ptr += sim_irk_opts_work_calculate_size(ns_max);
 
     assign_and_advance_double(ns_max * ns_max, &opts->A_mat, &c_ptr);
     assign_and_advance_double(ns_max, &opts->b_vec, &c_ptr);
     assign_and_advance_double(ns_max, &opts->c_vec, &c_ptr);
 
+    assign_and_advance_double(2 * ns_max, &opts->simplified_eig, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->simplified_T, &c_ptr);
+    assign_and_advance_double(ns_max * ns_max, &opts->simplified_T_in, &c_ptr);
+
     assert((char *) raw_memory + sim_irk_opts_calculate_size(config_, dims) >= c_ptr);
 
     return (void *) opts;
@@ -297,6 +330,10 @@ void sim_irk_opts_initialize_default(void *config_, void *dims_, void *opts_)
     opts->sens_adj = false;
     opts->sens_hess = false;
     opts->jac_reuse = true;
+    opts->simplified_newton = false;
+    opts->adaptive_steps = false;
+    opts->adaptive_tol = 1e-6;
+    opts->adaptive_freeze = false;
     opts->exact_z_output = false;
     opts->ns = 3;
     opts->collocation_type = GAUSS_LEGENDRE;
@@ -337,6 +374,8 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
 
     opts->tableau_size = opts->ns;
 
+    sim_irk_opts_update_simplified_newton(opts);
+
     // for debugging: print butcher tableau
     // printf("Butcher tableau\n");
     // printf("\nc_vec:\n");
@@ -360,7 +399,19 @@ void sim_irk_opts_update(void *config_, void *dims, void *opts_)
 void sim_irk_opts_set(void *config_, void *opts_, const char *field, void *value)
 {
     sim_opts *opts = (sim_opts *) opts_;
-    sim_opts_set_(opts, field, value);
+
+    if (!strcmp(field, "simplified_newton"))
+    {
+        bool *simplified_newton = (bool *) value;
+        opts->simplified_newton = *simplified_newton;
+        // transformation is recomputed in opts_update if ns or collocation_type change
+        if (opts->tableau_size == opts->ns)
+            sim_irk_opts_update_simplified_newton(opts);
+    }
+    else
+    {
+        sim_opts_set_(opts, field, value);
+    }
 }
 
 
@@ -392,6 +443,7 @@ acados_size_t sim_irk_memory_calculate_size(void *config, void *dims_, void *opt
 
     size += nx * sizeof(double); // xdot
     size += nz * sizeof(double); // z
+    size += 2 * opts->num_steps * sizeof(double);  // step_sizes, step_t0
     size += 8;  // corresponds to memory alignment
 
     if (opts->cost_computation)
@@ -432,6 +484,10 @@ void *sim_irk_memory_assign(void *config, void *dims_, void *opts_, void *raw_me
     // assign doubles
     assign_and_advance_double(nz, &mem->z, &c_ptr);
     assign_and_advance_double(nx, &mem->xdot, &c_ptr);
+    assign_and_advance_double(opts->num_steps, &mem->step_sizes, &c_ptr);
+    assign_and_advance_double(opts->num_steps, &mem->step_t0, &c_ptr);
+    mem->num_steps_used = 0;
+    mem->adaptive_status = ACADOS_SUCCESS;
 
     if (opts->cost_computation)
     {
@@ -565,6 +621,16 @@ void sim_irk_memory_get(void *config_, void *dims_, void *mem_, const char *fiel
         double *ptr = value;
         *ptr = mem->time_la;
     }
+    else if (!strcmp(field, "num_steps_used"))
+    {
+        int *ptr = value;
+        *ptr = mem->num_steps_used;
+    }
+    else if (!strcmp(field, "adaptive_status"))
+    {
+        int *ptr = value;
+        *ptr = mem->adaptive_status;
+    }
     else if (!strcmp(field, "cost_hess"))
     {
         struct blasfeo_dmat **ptr = value;
@@ -624,6 +690,28 @@ acados_size_t sim_irk_workspace_calculate_size(void *config_, void *dims_, void
         size += (4 * steps + 1) * sizeof(struct blasfeo_dmat);  // dG_dxu, dG_dK, dK_dxu, S_forw
     }
 
+    if (opts->simplified_newton)
+    {
+        size += ns * sizeof(struct blasfeo_dmat);  // simplified_jac
+        size += 1 * sizeof(struct blasfeo_dvec);   // simplified_rG
+        size += nK * sizeof(int);                  // simplified_ipiv
+        for (int jj = 0; jj < ns; jj++)
+        {
+            if (opts->simplified_eig[2*jj+1] == 0.0)
+                size += blasfeo_memsize_dmat(nx + nz, nx + nz);
+            else if (opts->simplified_eig[2*jj+1] > 0.0)
+                size += blasfeo_memsize_dmat(2 * (nx + nz), 2 * (nx + nz));
+        }
+        size += blasfeo_memsize_dvec(nK);
+    }
+
+    if (opts->adaptive_steps)
+    {
+        size += 1 * sizeof(struct blasfeo_dvec);  // adaptive_K
+        size += blasfeo_memsize_dvec(nK);         // adaptive_K
+        size += sim_adaptive_steps_work_calculate_size(nx);
+    }
+
     if (opts->cost_computation)
     {
         size += 4 * sizeof(struct blasfeo_dmat);  // J_y_tilde, tmp_nux_ny, S_forw_stage, tmp_nux_ny2
@@ -745,6 +833,14 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->xt, &c_ptr);
     assign_and_advance_blasfeo_dvec_structs(1, &workspace->xn, &c_ptr);
 
+    if (opts->simplified_newton)
+    {
+        assign_and_advance_blasfeo_dmat_structs(ns, &workspace->simplified_jac, &c_ptr);
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->simplified_rG, &c_ptr);
+    }
+    if (opts->adaptive_steps)
+        assign_and_advance_blasfeo_dvec_structs(1, &workspace->adaptive_K, &c_ptr);
+
     if (opts->cost_computation)
     {
         assign_and_advance_blasfeo_dmat_structs(1, &workspace->J_y_tilde, &c_ptr);
@@ -811,6 +907,19 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nu, &workspace->dk0_dxu, &c_ptr);
     }
 
+    if (opts->simplified_newton)
+    {
+        for (int jj = 0; jj < ns; jj++)
+        {
+            if (opts->simplified_eig[2*jj+1] == 0.0)
+                assign_and_advance_blasfeo_dmat_mem(nx + nz, nx + nz,
+                                                    &workspace->simplified_jac[jj], &c_ptr);
+            else if (opts->simplified_eig[2*jj+1] > 0.0)
+                assign_and_advance_blasfeo_dmat_mem(2 * (nx + nz), 2 * (nx + nz),
+                                                    &workspace->simplified_jac[jj], &c_ptr);
+        }
+    }
+
     if (opts->cost_computation)
     {
         assign_and_advance_blasfeo_dvec_mem(ny, workspace->tmp_ny, &c_ptr);
@@ -824,6 +933,14 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
     assign_and_advance_blasfeo_dvec_mem(nx, &workspace->xtdot, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nx + nu, workspace->lambda, &c_ptr);
     assign_and_advance_blasfeo_dvec_mem(nK, workspace->lambdaK, &c_ptr);
+    if (opts->simplified_newton)
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->simplified_rG, &c_ptr);
+    if (opts->adaptive_steps)
+    {
+        assign_and_advance_blasfeo_dvec_mem(nK, workspace->adaptive_K, &c_ptr);
+        workspace->adaptive_work = c_ptr;
+        c_ptr += sim_adaptive_steps_work_calculate_size(nx);
+    }
 
 
     if ( opts->sens_adj || opts->sens_hess ){
@@ -845,6 +962,9 @@ static void *sim_irk_workspace_cast(void *config_, void *dims_, void *opts_, voi
         assign_and_advance_int(steps * nK, &workspace->ipiv, &c_ptr);
     }
 
+    if (opts->simplified_newton)
+        assign_and_advance_int(nK, &workspace->simplified_ipiv, &c_ptr);
+
     // printf("\npointer moved - size calculated = %d bytes\n", c_ptr- (char*)raw_memory -
     // sim_irk_calculate_workspace_size(dims, opts_));
 
@@ -1104,6 +1224,199 @@ void sim_irk_compute_z_and_algebraic_sens(sim_irk_dims *dims, sim_opts *opts, si
 }
 
 
+
+/* simplified Newton: with the Jacobians df_dx, df_dxdot, df_dz of the first stage, the Newton
+ * system for W = (w_1, ..., w_ns), w_i = (dk_i, dz_i), reads
+ *      M0 * W + step * M1 * W * A^T = R,   M0 = [df_dxdot, df_dz], M1 = [df_dx, 0].
+ * With A^{-1} = T * D * T^{-1} and W = Wt * T^T it decouples into
+ *      M0 * Wt * D^T + step * M1 * Wt = R * (T^{-1} * A^{-1})^T,
+ * i.e. one system of size nx+nz per real eigenvalue and one of size 2*(nx+nz) per complex pair. */
+static void sim_irk_simplified_newton_factorize(sim_opts *opts, int nx, int nz, double step,
+                                                sim_irk_workspace *workspace)
+{
+    int ns = opts->ns;
+    int n = nx + nz;
+    double *eig = opts->simplified_eig;
+    double alpha, beta;
+    struct blasfeo_dmat *jac;
+
+    for (int jj = 0; jj < ns; jj++)
+    {
+        jac = &workspace->simplified_jac[jj];
+        alpha = eig[2*jj];
+        beta = eig[2*jj+1];
+
+        if (beta < 0.0)  // second eigenvalue of a pair
+            continue;
+
+        int nb = beta == 0.0 ? 1 : 2;
+        blasfeo_dgese(nb * n, nb * n, 0.0, jac, 0, 0);
+        for (int kk = 0; kk < nb; kk++)
+        {
+            // alpha * M0 + step * M1
+            blasfeo_dgead(n, nx, alpha, &workspace->df_dxdot, 0, 0, jac, kk*n, kk*n);
+            blasfeo_dgead(n, nz, alpha, &workspace->df_dz, 0, 0, jac, kk*n, kk*n + nx);
+            blasfeo_dgead(n, nx, step, &workspace->df_dx, 0, 0, jac, kk*n, kk*n);
+        }
+        if (nb == 2)
+        {
+            // [., beta * M0; -beta * M0, .]
+            blasfeo_dgead(n, nx, beta, &workspace->df_dxdot, 0, 0, jac, 0, n);
+            blasfeo_dgead(n, nz, beta, &workspace->df_dz, 0, 0, jac, 0, n + nx);
+            blasfeo_dgead(n, nx, -beta, &workspace->df_dxdot, 0, 0, jac, n, 0);
+            blasfeo_dgead(n, nz, -beta, &workspace->df_dz, 0, 0, jac, n, nx);
+        }
+        blasfeo_dgetrf_rp(nb * n, nb * n, jac, 0, 0, jac, 0, 0, workspace->simplified_ipiv + jj*n);
+    }
+}
+
+
+
+// overwrites the stage-wise residual rG with the Newton step in the layout of K
+static void sim_irk_simplified_newton_solve(sim_opts *opts, int nx, int nz,
+                                            sim_irk_workspace *workspace)
+{
+    int ns = opts->ns;
+    int n = nx + nz;
+    int nK = n * ns;
+    double *T = opts->simplified_T;
+    double *T_in = opts->simplified_T_in;
+    struct blasfeo_dvec *rG = workspace->rG;
+    struct blasfeo_dvec *rGt = workspace->simplified_rG;
+
+    // transformed residual
+    blasfeo_dvecse(nK, 0.0, rGt, 0);
+    for (int jj = 0; jj < ns; jj++)
+    {
+        for (int ii = 0; ii < ns; ii++)
+            blasfeo_daxpy(n, T_in[jj + ns*ii], rG, ii*n, rGt, jj*n, rGt, jj*n);
+    }
+
+    // decoupled block solves
+    for (int jj = 0; jj < ns; jj++)
+    {
+        if (opts->simplified_eig[2*jj+1] < 0.0)
+            continue;
+
+        int nb = opts->simplified_eig[2*jj+1] == 0.0 ? n : 2 * n;
+        blasfeo_dvecpe(nb, workspace->simplified_ipiv + jj*n, rGt, jj*n);
+        blasfeo_dtrsv_lnu(nb, &workspace->simplified_jac[jj], 0, 0, rGt, jj*n, rGt, jj*n);
+        blasfeo_dtrsv_unn(nb, &workspace->simplified_jac[jj], 0, 0, rGt, jj*n, rGt, jj*n);
+    }
+
+    // back transformation, K = (k_1,..., k_{ns},z_1,..., z_{ns})
+    blasfeo_dvecse(nK, 0.0, rG, 0);
+    for (int ii = 0; ii < ns; ii++)
+    {
+        for (int jj = 0; jj < ns; jj++)
+        {
+            blasfeo_daxpy(nx, T[ii + ns*jj], rGt, jj*n, rG, ii*nx, rG, ii*nx);
+            blasfeo_daxpy(nz, T[ii + ns*jj], rGt, jj*n + nx, rG, ns*nx + ii*nz, rG, ns*nx + ii*nz);
+        }
+    }
+}
+
+
+
+typedef struct
+{
+    sim_opts *opts;
+    irk_model *model;
+    sim_irk_workspace *workspace;
+    int nx;
+    int nz;
+    double *u;
+    double t0;
+} sim_irk_nominal_step_ctx;
+
+
+
+// one IRK step without sensitivities (exact Newton, starting from the integrator guess),
+// for the step size selection
+static void sim_irk_nominal_step(void *ctx_, double t, double *x, double step, double *x_next)
+{
+    sim_irk_nominal_step_ctx *ctx = ctx_;
+    sim_opts *opts = ctx->opts;
+    sim_irk_workspace *workspace = ctx->workspace;
+    irk_model *model = ctx->model;
+
+    int ns = opts->ns;
+    int nx = ctx->nx;
+    int nz = ctx->nz;
+    int nK = (nx + nz) * ns;
+
+    double *A_mat = opts->A_mat;
+    struct blasfeo_dvec *K = workspace->adaptive_K;
+    struct blasfeo_dvec *rG = workspace->rG;
+    struct blasfeo_dvec *xt = workspace->xt;
+    struct blasfeo_dmat *dG_dK = &workspace->dG_dK[0];
+    int *ipiv = workspace->ipiv;
+
+    double a, t_current;
+
+    struct blasfeo_dvec_args xdot_in, z_in, res_out;
+    xdot_in.x = K;
+    z_in.x = K;
+    res_out.x = rG;
+
+    ext_fun_arg_t type_in[5] = {BLASFEO_DVEC, BLASFEO_DVEC_ARGS, COLMAJ, BLASFEO_DVEC_ARGS, COLMAJ};
+    void *fun_in[5] = {xt, &xdot_in, ctx->u, &z_in, &t_current};
+    ext_fun_arg_t type_out[4] = {BLASFEO_DVEC_ARGS, BLASFEO_DMAT, BLASFEO_DMAT, BLASFEO_DMAT};
+    void *fun_out[4] = {&res_out, &workspace->df_dx, &workspace->df_dxdot, &workspace->df_dz};
+
+    blasfeo_dveccp(nK, workspace->K, 0, K, 0);
+
+    for (int iter = 0; iter < opts->newton_iter; iter++)
+    {
+        blasfeo_dgese(nK, nK, 0.0, dG_dK, 0, 0);
+        for (int ii = 0; ii < ns; ii++)
+        {
+            blasfeo_pack_dvec(nx, x, 1, xt, 0);
+            for (int jj = 0; jj < ns; jj++)
+            {
+                a = A_mat[ii + ns * jj] * step;
+                blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
+            }
+            t_current = ctx->t0 + t + opts->c_vec[ii] * step;
+            xdot_in.xi = ii * nx;
+            z_in.xi = ns * nx + ii * nz;
+            res_out.xi = ii * (nx + nz);
+
+            model->impl_ode_fun_jac_x_xdot_z->evaluate(model->impl_ode_fun_jac_x_xdot_z,
+                                                       type_in, fun_in, type_out, fun_out);
+
+            for (int jj = 0; jj < ns; jj++)
+            {
+                a = A_mat[ii + ns * jj] * step;
+                blasfeo_dgead(nx + nz, nx, a, &workspace->df_dx, 0, 0, dG_dK, ii * (nx + nz), jj * nx);
+            }
+            blasfeo_dgead(nx + nz, nx, 1.0, &workspace->df_dxdot, 0, 0, dG_dK, ii * (nx + nz), ii * nx);
+            blasfeo_dgead(nx + nz, nz, 1.0, &workspace->df_dz, 0, 0, dG_dK, ii * (nx + nz),
+                          nx * ns + ii * nz);
+        }
+
+        blasfeo_dgetrf_rp(nK, nK, dG_dK, 0, 0, dG_dK, 0, 0, ipiv);
+        blasfeo_dvecpe(nK, ipiv, rG, 0);
+        blasfeo_dtrsv_lnu(nK, dG_dK, 0, 0, rG, 0, rG, 0);
+        blasfeo_dtrsv_unn(nK, dG_dK, 0, 0, rG, 0, rG, 0);
+        blasfeo_daxpy(nK, -1.0, rG, 0, K, 0, K, 0);
+
+        if (opts->newton_tol > 0)
+        {
+            blasfeo_dvecnrm_inf(nK, rG, 0, &a);
+            if (a < opts->newton_tol)
+                break;
+        }
+    }
+
+    blasfeo_pack_dvec(nx, x, 1, xt, 0);
+    for (int ii = 0; ii < ns; ii++)
+        blasfeo_daxpy(nx, step * opts->b_vec[ii], K, ii * nx, xt, 0, xt, 0);
+    blasfeo_unpack_dvec(nx, xt, 0, x_next, 1);
+}
+
+
+
 /************************************************
  * integrator
  ************************************************/
@@ -1159,8 +1472,8 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     int newton_iter = opts->newton_iter;
     double *A_mat = opts->A_mat;
     double *b_vec = opts->b_vec;
-    int num_steps = opts->num_steps;
-    double step = in->T / num_steps;
+    int num_steps;
+    double step;
 
     int *ipiv = workspace->ipiv;
 
@@ -1334,6 +1647,33 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // blasfeo_print_exp_dvec(nK, K, 0);
     // exit(1);
 
+    // step sequence
+    sim_irk_nominal_step_ctx step_ctx;
+    int order = opts->ns;
+    if (opts->adaptive_steps)
+    {
+        if (model->impl_ode_fun_jac_x_xdot_z == 0)
+        {
+            printf("sim IRK: adaptive_steps requires impl_ode_fun_jac_x_xdot_z. Exiting.\n");
+            exit(1);
+        }
+        step_ctx.opts = opts;
+        step_ctx.model = model;
+        step_ctx.workspace = workspace;
+        step_ctx.nx = nx;
+        step_ctx.nz = nz;
+        step_ctx.u = u;
+        step_ctx.t0 = t0;
+        if (opts->collocation_type == GAUSS_LEGENDRE)
+            order = 2 * opts->ns;
+        else if (opts->collocation_type == GAUSS_RADAU_IIA)
+            order = 2 * opts->ns - 1;
+    }
+    sim_adaptive_steps_update(opts, nx, in->T, order, &sim_irk_nominal_step, &step_ctx, in->x,
+                              mem->step_sizes, mem->step_t0, &mem->num_steps_used,
+                              &mem->adaptive_status, workspace->adaptive_work);
+    num_steps = mem->num_steps_used;
+
     // TODO(dimitris, FreyJo): implement NF (number of forward sensis) properly, instead of nx+nu?
 
     /************************************************
@@ -1347,6 +1687,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     // start the loop
     for (int ss = 0; ss < num_steps; ss++)
     {
+        step = mem->step_sizes[ss];
 
         // decide whether results from forward sensitivity propagation are stored,
         // or if memory has to be reused --> set pointers accordingly
@@ -1382,7 +1723,11 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
         for (int iter = 0; iter < newton_iter; iter++)
         {
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            // with adaptive steps, a reused jacobian has to be rebuilt when the step size changes
+            bool update_jac = (opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse)
+                || (opts->jac_reuse && (iter == 0) && (ss > 0) && (step != mem->step_sizes[ss-1]));
+
+            if (update_jac && !opts->simplified_newton)
             {
                 // if new jacobian gets computed, initialize dG_dK_ss with zeros
                 blasfeo_dgese(nK, nK, 0.0, dG_dK_ss, 0, 0);
@@ -1392,7 +1737,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {  // ii-th row of tableau
                 // take x(n); copy a strvec into a strvec
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
 
                 for (int jj = 0; jj < ns; jj++)
                 {  // jj-th col of tableau
@@ -1407,7 +1752,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 impl_ode_res_out.xi = ii * (nx + nz);  // store output in this position of rG
 
                 // compute the residual of implicit ode at time t_ii
-                if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+                if (update_jac && opts->simplified_newton && ii == 0)
+                {   // simplified Newton: jacobian only at the first stage
+                    acados_tic(&timer_ad);
+                    model->impl_ode_fun_jac_x_xdot_z->evaluate(
+                        model->impl_ode_fun_jac_x_xdot_z, impl_ode_type_in, impl_ode_in,
+                        impl_ode_fun_jac_x_xdot_z_type_out, impl_ode_fun_jac_x_xdot_z_out);
+                    timing_ad += acados_toc(&timer_ad);
+                }
+                else if (update_jac && !opts->simplified_newton)
                 {   // evaluate the ode function & jacobian w.r.t. x, xdot;
                     // &  compute jacobian dG_dK_ss;
                     acados_tic(&timer_ad);
@@ -1442,26 +1795,35 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             }  // end ii
 
             acados_tic(&timer_la);
-            // DGETRF computes an LU factorization of a general M-by-N matrix A
-            // using partial pivoting with row interchanges.
-            // printf("dG_dK_ss = (IRK) \n");
-            // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
-            if ((opts->jac_reuse && (ss == 0) && (iter == 0)) || (!opts->jac_reuse))
+            if (opts->simplified_newton)
             {
-                blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
-            }
+                if (update_jac)
+                    sim_irk_simplified_newton_factorize(opts, nx, nz, step, workspace);
 
-            // permute also the r.h.s
-            blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
+                sim_irk_simplified_newton_solve(opts, nx, nz, workspace);
+            }
+            else
+            {
+                // DGETRF computes an LU factorization of a general M-by-N matrix A
+                // using partial pivoting with row interchanges.
+                // printf("dG_dK_ss = (IRK) \n");
+                // blasfeo_print_exp_dmat((nz+nx) *ns, (nz+nx) *ns, dG_dK_ss, 0, 0);
+                if (update_jac)
+                {
+                    blasfeo_dgetrf_rp(nK, nK, dG_dK_ss, 0, 0, dG_dK_ss, 0, 0, ipiv_ss);
+                }
 
-            // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
-            // (u)nit trian
-            blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // permute also the r.h.s
+                blasfeo_dvecpe(nK, ipiv_ss, rG, 0);
 
-            // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
-            // (n)o unit trian , and store x in rG
-            blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+                // solve dG_dK_ss * y = rG, dG_dK_ss on the (l)eft, (l)ower-trian, (n)o-trans
+                // (u)nit trian
+                blasfeo_dtrsv_lnu(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
 
+                // solve dG_dK_ss * x = rG, dG_dK_ss on the (l)eft, (u)pper-trian, (n)o-trans
+                // (n)o unit trian , and store x in rG
+                blasfeo_dtrsv_unn(nK, dG_dK_ss, 0, 0, rG, 0, rG, 0);
+            }
             timing_la += acados_toc(&timer_la);
 
             // scale and add a generic strmat into a generic strmat // K = K - rG, where rG is
@@ -1503,7 +1865,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // xt = xt + T_int * a[i,j]*K_j
                     blasfeo_daxpy(nx, a, K, jj * nx, xt, 0, xt, 0);
                 }
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
 
                 acados_tic(&timer_ad);
                 model->impl_ode_jac_x_xdot_u_z->evaluate(
@@ -1590,7 +1952,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1645,17 +2007,17 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     }
 
                     // cost_grad += b * tmp_ny^T * tmp_ny_nux = b * tmp_ny_nux^T * tmp_ny
-                    blasfeo_dgemv_n(nx+nu, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_ny, 0,
+                    blasfeo_dgemv_n(nx+nu, ny, b_vec[ii] * step / in->T, tmp_nux_ny2, 0, 0, tmp_ny, 0,
                                     1.0, cost_grad, 0, cost_grad, 0);
 
                     // cost_hess += b * tmp_nux_ny_2 * tmp_nux_ny_2^T
                     // TODO: use syrk (exploit symmetry)
-                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dgemm_nt(nx+nu, nx+nu, ny, b_vec[ii] * step / in->T, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                                     1.0, cost_hess, 0, 0, cost_hess, 0, 0);
 
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                    mem->cost_fun[0] += 0.5 * b_vec[ii] * step / in->T * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
                 } // end ii
             } // end cost propagation NLS COST
             else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1697,7 +2059,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                 {
                     impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
                     // compute x at stage (xt) and sensitivity (S_forw_stage)
                     blasfeo_dveccp(nx, xn, 0, xt, 0);
                     blasfeo_dgecp(nx, nx+nu, S_forw_ss, 0, 0, S_forw_stage, 0, 0);
@@ -1735,7 +2097,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         //         &workspace->Jt_z, 0, 0, 1.0, &workspace->tmp_nux_ny, 0, 0, &Jt_ux_tilde, 0, 0);
 
                         // // cost_grad += b * Jt_ux_tilde * tmp_ny
-                        // blasfeo_dgemv_n(nu+nx, ny, b_vec[ii]/num_steps, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
+                        // blasfeo_dgemv_n(nu+nx, ny, b_vec[ii] * step / in->T, &Jt_ux_tilde, 0, 0, tmp_ny, 0,
                         //                 1.0, cost_grad, 0, cost_grad, 0);
 
                         // // tmp_nv_ny = Jt_ux_tilde * W_chol
@@ -1773,15 +2135,15 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                         }
 
                         // cost_grad += b * J_y_tilde^T * tmp_ny
-                        blasfeo_dgemv_t(ny, nx+nu, b_vec[ii]/num_steps, J_y_tilde, 0, 0, tmp_ny, 0,
+                        blasfeo_dgemv_t(ny, nx+nu, b_vec[ii] * step / in->T, J_y_tilde, 0, 0, tmp_ny, 0,
                                         1.0, cost_grad, 0, cost_grad, 0);
                     }
                     // cost_hess += b * tmp_nux_ny2 * tmp_nux_ny2^T
-                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii]/num_steps, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
+                    blasfeo_dsyrk_ln(nu+nx, ny, b_vec[ii] * step / in->T, tmp_nux_ny2, 0, 0, tmp_nux_ny2, 0, 0,
                             1.0, cost_hess, 0, 0, cost_hess, 0, 0);
                     // cost function value
                     // NOTE: slack contribution and scaling done in cost module
-                    mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                    mem->cost_fun[0] += b_vec[ii] * step / in->T * a;
                 }
             }
 
@@ -1816,7 +2178,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1844,7 +2206,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += 0.5 * b_vec[ii]/num_steps * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
+                mem->cost_fun[0] += 0.5 * b_vec[ii] * step / in->T * blasfeo_ddot(ny, tmp_ny, 0, tmp_ny, 0);
             }
         } // end NLS cost_computation without sens
         else if (opts->cost_computation && opts->cost_type == CONVEX_OVER_NONLINEAR)
@@ -1876,7 +2238,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
             {
                 impl_ode_z_in.xi = ns * nx + ii * nz;
 
-                t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
                 // compute x at stage (xt)
                 blasfeo_dveccp(nx, xn, 0, xt, 0);
                 for (int jj = 0; jj < ns; jj++)
@@ -1891,7 +2253,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
 
                 // cost function value
                 // NOTE: slack contribution and scaling done in cost module
-                mem->cost_fun[0] += b_vec[ii]/num_steps * a;
+                mem->cost_fun[0] += b_vec[ii] * step / in->T * a;
             }
         } // end NLS cost_computation without sens
 
@@ -1932,6 +2294,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     {
         for (int ss = num_steps - 1; ss > -1; ss--)
         {
+            step = mem->step_sizes[ss];
             if (opts->sens_hess){
                 dK_dxu_ss = &dK_dxu[ss];
                 dG_dK_ss = &dG_dK[ss];
@@ -1965,7 +2328,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use k_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_z_in.xi    = ns * nx + ii * nz;
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
 
                     // build stage value
                     blasfeo_dveccp(nx, &xn_traj[ss], 0, xt, 0);
@@ -2074,7 +2437,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
                     // use z_i of K = (k_1,..., k_{ns},z_1,..., z_{ns})
                     impl_ode_hess_lambda_in.xi = ii * (nx + nz);
 
-                    t_current = t0 + ss * step + opts->c_vec[ii] * step;
+                    t_current = t0 + mem->step_t0[ss] + opts->c_vec[ii] * step;
 
                     // eval hessian function at stage ii
                     // printf("dxkzu_dw0 = (IRK, ss = %d) \n", ss);
@@ -2122,7 +2485,7 @@ int sim_irk(void *config_, sim_in *in, sim_out *out, void *opts_, void *mem_, vo
     mem->time_ad = out->info->ADtime;
     mem->time_la = out->info->LAtime;
 
-    return ACADOS_SUCCESS;
+    return mem->adaptive_status;
 }
 
 
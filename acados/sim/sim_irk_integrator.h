@@ -127,6 +127,17 @@ typedef struct
     //              pivot vectors for dG_dxu
     int *ipiv;  // index of pivot vector
 
+    // only allocated if (opts->simplified_newton)
+    // simplified_jac: one block per real eigenvalue (nx+nz, nx+nz) and per complex pair
+    //                 (2*(nx+nz), 2*(nx+nz)) of A_mat^{-1}, stored at the first stage of the block
+    struct blasfeo_dmat *simplified_jac;
+    struct blasfeo_dvec *simplified_rG;  // transformed residuals ((nx+nz)*ns)
+    int *simplified_ipiv;                // pivot vectors of the blocks ((nx+nz)*ns)
+
+    // only allocated if (opts->adaptive_steps): nominal steps for the step size selection
+    struct blasfeo_dvec *adaptive_K;  // ((nx+nz)*ns)
+    void *adaptive_work;
+
     // xn_traj, K_traj only available if( opts->sens_adj || opts->sens_hess )
     struct blasfeo_dvec *xn_traj;  // xn trajectory
     struct blasfeo_dvec *K_traj;   // K trajectory
@@ -172,6 +183,12 @@ typedef struct
     struct blasfeo_dvec *cost_grad;
     struct blasfeo_dmat *cost_hess;
 
+    // step sequence, uniform or selected by opts->adaptive_steps (num_steps)
+    double *step_sizes;
+    double *step_t0;
+    int num_steps_used;
+    int adaptive_status;  // ACADOS_MAXITER if adaptive_tol was not met and the uniform grid is used
+
 } sim_irk_memory;
 
 
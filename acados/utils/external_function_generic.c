@@ -42,12 +42,14 @@ void external_function_opts_copy(external_function_opts *from, external_function
 {
     to->external_workspace = from->external_workspace;
     to->with_global_data = from->with_global_data;
+    to->zero_copy = from->zero_copy;
 }
 
 void external_function_opts_set_to_default(external_function_opts *opts)
 {
     opts->external_workspace = false;
     opts->with_global_data = false;
+    opts->zero_copy = false;
 }
 
 size_t external_function_get_workspace_requirement_if_defined(external_function_generic *fun)
@@ -64,6 +66,167 @@ void external_function_set_fun_workspace_if_defined(external_function_generic *f
         fun->set_external_workspace(fun, work_);
 }
 
+const int *external_function_get_output_sparsity_if_defined(external_function_generic *fun, int idx_out)
+{
+    // the sparsity is only known for casadi functions, which are identified by their wrapper
+    if (fun == NULL)
+        return NULL;
+    else if (fun->evaluate == &external_function_casadi_wrapper ||
+             fun->evaluate == &external_function_casadi_wrapper_zero_copy)
+        return external_function_casadi_get_output_sparsity(fun, idx_out);
+    else if (fun->evaluate == &external_function_param_casadi_wrapper ||
+             fun->evaluate == &external_function_param_casadi_wrapper_zero_copy)
+        return external_function_param_casadi_get_output_sparsity(fun, idx_out);
+    else if (fun->evaluate == &external_function_external_param_casadi_wrapper ||
+             fun->evaluate == &external_function_external_param_casadi_wrapper_zero_copy)
+        return external_function_external_param_casadi_get_output_sparsity(fun, idx_out);
+    else
+        return NULL;
+}
+
+
+
+static int nnz_box_numel(external_function_nnz_box *box)
+{
+    return box->nrow * box->ncol;
+}
+
+
+
+// number of entries added when merging the column-adjacent blocks ii and ii+1
+static int nnz_pattern_merge_fill(external_function_nnz_pattern *pattern, int ii)
+{
+    external_function_nnz_box *b0 = pattern->block + ii;
+    external_function_nnz_box *b1 = pattern->block + ii + 1;
+    int row0 = b0->row0 < b1->row0 ? b0->row0 : b1->row0;
+    int row_end0 = b0->row0 + b0->nrow;
+    int row_end1 = b1->row0 + b1->nrow;
+    int row_end = row_end0 > row_end1 ? row_end0 : row_end1;
+    int ncol = b1->col0 + b1->ncol - b0->col0;
+    return (row_end - row0) * ncol - nnz_box_numel(b0) - nnz_box_numel(b1);
+}
+
+
+
+static void nnz_pattern_merge(external_function_nnz_pattern *pattern, int ii)
+{
+    external_function_nnz_box *b0 = pattern->block + ii;
+    external_function_nnz_box *b1 = pattern->block + ii + 1;
+    int row0 = b0->row0 < b1->row0 ? b0->row0 : b1->row0;
+    int row_end0 = b0->row0 + b0->nrow;
+    int row_end1 = b1->row0 + b1->nrow;
+    int row_end = row_end0 > row_end1 ? row_end0 : row_end1;
+    b0->ncol = b1->col0 + b1->ncol - b0->col0;
+    b0->row0 = row0;
+    b0->nrow = row_end - row0;
+    for (int jj = ii+1; jj < pattern->nblock-1; jj++)
+        pattern->block[jj] = pattern->block[jj+1];
+    pattern->nblock--;
+}
+
+
+
+void external_function_get_output_nnz_pattern(external_function_generic *fun, int idx_out, int m, int n,
+                                              external_function_nnz_pattern *pattern)
+{
+    // full matrix by default
+    pattern->nblock = 1;
+    pattern->block[0].row0 = 0;
+    pattern->block[0].nrow = m;
+    pattern->block[0].col0 = 0;
+    pattern->block[0].ncol = n;
+
+    const int *sparsity = external_function_get_output_sparsity_if_defined(fun, idx_out);
+    if (sparsity == NULL || sparsity[0] != m || sparsity[1] != n || sparsity[2] != 0)
+        return;
+
+    const int *idxcol = sparsity + 2;
+    const int *row = sparsity + n + 3;
+
+    // one block per run of adjacent columns with the same row range, empty columns are skipped;
+    // the run is temporarily stored in the last slot if all slots are in use
+    pattern->nblock = 0;
+    external_function_nnz_box *cur = NULL;
+    for (int jj = 0; jj < n; jj++)
+    {
+        if (idxcol[jj] == idxcol[jj+1])
+        {
+            cur = NULL;
+            continue;
+        }
+        int row_min = m;
+        int row_max = -1;
+        for (int idx = idxcol[jj]; idx < idxcol[jj+1]; idx++)
+        {
+            row_min = row[idx] < row_min ? row[idx] : row_min;
+            row_max = row[idx] > row_max ? row[idx] : row_max;
+        }
+        if (cur != NULL && cur->row0 == row_min && cur->nrow == row_max - row_min + 1)
+        {
+            cur->ncol++;
+            continue;
+        }
+        if (pattern->nblock == EXTERNAL_FUNCTION_NNZ_MAX_BLOCKS)
+        {
+            // merge the two adjacent blocks with the smallest fill, to free one slot
+            int ii_min = 0;
+            int fill_min = nnz_pattern_merge_fill(pattern, 0);
+            for (int ii = 1; ii < pattern->nblock-1; ii++)
+            {
+                int fill = nnz_pattern_merge_fill(pattern, ii);
+                if (fill < fill_min)
+                {
+                    fill_min = fill;
+                    ii_min = ii;
+                }
+            }
+            nnz_pattern_merge(pattern, ii_min);
+        }
+        cur = pattern->block + pattern->nblock;
+        cur->row0 = row_min;
+        cur->nrow = row_max - row_min + 1;
+        cur->col0 = jj;
+        cur->ncol = 1;
+        pattern->nblock++;
+    }
+}
+
+
+
+int external_function_nnz_pattern_numel(external_function_nnz_pattern *pattern)
+{
+    int numel = 0;
+    for (int ii = 0; ii < pattern->nblock; ii++)
+        numel += nnz_box_numel(pattern->block + ii);
+    return numel;
+}
+
+
+
+int external_function_nnz_pattern_row_end(external_function_nnz_pattern *pattern)
+{
+    int row_end = 0;
+    for (int ii = 0; ii < pattern->nblock; ii++)
+    {
+        int tmp = pattern->block[ii].row0 + pattern->block[ii].nrow;
+        row_end = tmp > row_end ? tmp : row_end;
+    }
+    return row_end;
+}
+
+
+
+void external_function_nnz_pattern_dgead(external_function_nnz_pattern *pattern, double alpha,
+                                         struct blasfeo_dmat *sA, struct blasfeo_dmat *sB)
+{
+    for (int ii = 0; ii < pattern->nblock; ii++)
+    {
+        external_function_nnz_box *box = pattern->block + ii;
+        blasfeo_dgead(box->nrow, box->ncol, alpha, sA, box->row0, box->col0,
+                      sB, box->row0, box->col0);
+    }
+}
+
 
 
 /************************************************
@@ -824,6 +987,280 @@ static int d_cvt_ext_fun_arg_to_casadi(ext_fun_arg_t type, void *in, double *out
 
 
 
+/************************************************
+ * casadi zero copy utils
+ ************************************************/
+
+// returns a pointer to column-major storage of the argument with leading dimension equal to
+// the number of rows in sparsity, or NULL if the argument is not stored like that
+static double *d_ext_fun_arg_contiguous_ptr(ext_fun_arg_t type, void *arg, const int *sparsity)
+{
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+
+    switch (type)
+    {
+        case COLMAJ:
+            return arg;
+
+        case COLMAJ_ARGS:
+        {
+            struct colmaj_args *args = arg;
+            if (args->lda == nrow || ncol == 1)
+                return args->A;
+            return NULL;
+        }
+
+        case BLASFEO_DVEC:
+        {
+            struct blasfeo_dvec *x = arg;
+            return x->pa;
+        }
+
+        case BLASFEO_DVEC_ARGS:
+        {
+            struct blasfeo_dvec_args *args = arg;
+            return args->x->pa + args->xi;
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+
+
+// address of element (i, j) of the argument, returns NULL for unknown types
+static double *d_ext_fun_arg_el_ptr(ext_fun_arg_t type, void *arg, int nrow, int i, int j)
+{
+    switch (type)
+    {
+        case COLMAJ:
+            return (double *) arg + i + j * nrow;
+
+        case COLMAJ_ARGS:
+        {
+            struct colmaj_args *args = arg;
+            return args->A + i + j * args->lda;
+        }
+
+        case BLASFEO_DMAT:
+            return &BLASFEO_DMATEL((struct blasfeo_dmat *) arg, i, j);
+
+        case BLASFEO_DMAT_ARGS:
+        {
+            struct blasfeo_dmat_args *args = arg;
+            return &BLASFEO_DMATEL(args->A, args->ai + i, args->aj + j);
+        }
+
+        case BLASFEO_DVEC:
+            return &BLASFEO_DVECEL((struct blasfeo_dvec *) arg, i);
+
+        case BLASFEO_DVEC_ARGS:
+        {
+            struct blasfeo_dvec_args *args = arg;
+            return &BLASFEO_DVECEL(args->x, args->xi + i);
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+
+
+// scatter the nonzeros of res into out and zero its structural zeros, returns 1 for unknown types
+static int d_casadi_scatter_to_ext_fun_arg(external_function_casadi_scatter *scatter, ext_fun_arg_t type,
+                                           double *res, int *sparsity, void *out)
+{
+    int ii, jj, idx;
+
+    int nrow = sparsity[0];
+    int ncol = sparsity[1];
+
+    if ((nrow <= 0) | (ncol <= 0))
+        return 0;
+
+    double *base = d_ext_fun_arg_el_ptr(type, out, nrow, 0, 0);
+    if (base == NULL)
+        return 1;
+
+    void *mat = NULL;
+    int ld = 0;
+    if (type == BLASFEO_DMAT)
+        mat = out;
+    else if (type == BLASFEO_DMAT_ARGS)
+        mat = ((struct blasfeo_dmat_args *) out)->A;
+    else if (type == COLMAJ)
+        ld = nrow;
+    else if (type == COLMAJ_ARGS)
+        ld = ((struct colmaj_args *) out)->lda;
+
+    int nnz = casadi_nnz(sparsity);
+    int numel = nrow * ncol;
+    int *scatter_idx = scatter->idx;
+
+    // new destination: build scatter map, structural nonzeros first, then structural zeros
+    if (base != scatter->base || mat != scatter->mat || ld != scatter->ld)
+    {
+        int *idxcol = sparsity + 2;
+        int *row = sparsity + ncol + 3;
+        int dense = sparsity[2];
+        int idx_zero = nnz;
+        idx = 0;
+        for (jj = 0; jj < ncol; jj++)
+        {
+            if (dense)
+            {
+                for (ii = 0; ii < nrow; ii++, idx++)
+                    scatter_idx[idx] = d_ext_fun_arg_el_ptr(type, out, nrow, ii, jj) - base;
+            }
+            else
+            {
+                // row indices are sorted within each column
+                for (ii = 0; ii < nrow; ii++)
+                {
+                    double *el = d_ext_fun_arg_el_ptr(type, out, nrow, ii, jj);
+                    if (idx != idxcol[jj + 1] && row[idx] == ii)
+                        scatter_idx[idx++] = el - base;
+                    else
+                        scatter_idx[idx_zero++] = el - base;
+                }
+            }
+        }
+        scatter->base = base;
+        scatter->mat = mat;
+        scatter->ld = ld;
+    }
+
+    // destinations may be shared or accumulated into in between evaluations
+    for (idx = nnz; idx < numel; idx++)
+        base[scatter_idx[idx]] = 0.0;
+    for (idx = 0; idx < nnz; idx++)
+        base[scatter_idx[idx]] = res[idx];
+
+    return 0;
+}
+
+
+
+// set args[i] to the input memory where possible, copy otherwise; returns index of failing input or -1
+static int casadi_zero_copy_set_args(int in_num, int idx_skip_0, int idx_skip_1,
+                                     const int *(*casadi_sparsity_in)(int),
+                                     int *args_dense, double **args, double **args_buf,
+                                     ext_fun_arg_t *type_in, void **in)
+{
+    for (int ii = 0; ii < in_num; ii++)
+    {
+        if (ii == idx_skip_0 || ii == idx_skip_1)
+            continue;
+
+        int *sparsity = (int *) casadi_sparsity_in(ii);
+        double *ptr = args_dense[ii] ? d_ext_fun_arg_contiguous_ptr(type_in[ii], in[ii], sparsity) : NULL;
+        if (ptr != NULL)
+        {
+            args[ii] = ptr;
+        }
+        else
+        {
+            args[ii] = args_buf[ii];
+            if (d_cvt_ext_fun_arg_to_casadi(type_in[ii], in[ii], args[ii], sparsity, args_dense[ii]))
+                return ii;
+        }
+    }
+    return -1;
+}
+
+
+
+// set res[i] to the output memory where possible, NULL for ignored outputs
+static void casadi_zero_copy_set_res(int out_num, const int *(*casadi_sparsity_out)(int),
+                                     int *res_dense, double **res, double **res_buf,
+                                     ext_fun_arg_t *type_out, void **out)
+{
+    for (int ii = 0; ii < out_num; ii++)
+    {
+        double *ptr = NULL;
+        if (res_dense[ii])
+            ptr = d_ext_fun_arg_contiguous_ptr(type_out[ii], out[ii], casadi_sparsity_out(ii));
+
+        if (type_out[ii] == IGNORE_ARGUMENT)
+            res[ii] = NULL;  // casadi skips outputs with NULL pointer
+        else if (ptr != NULL)
+            res[ii] = ptr;
+        else
+            res[ii] = res_buf[ii];
+    }
+}
+
+
+
+// scatter outputs computed into own memory; returns index of failing output or -1
+static int casadi_zero_copy_scatter_res(int out_num, const int *(*casadi_sparsity_out)(int),
+                                        double **res, double **res_buf,
+                                        external_function_casadi_scatter *res_scatter,
+                                        ext_fun_arg_t *type_out, void **out)
+{
+    for (int ii = 0; ii < out_num; ii++)
+    {
+        if (res[ii] == res_buf[ii])
+        {
+            if (d_casadi_scatter_to_ext_fun_arg(res_scatter + ii, type_out[ii], res[ii],
+                                                (int *) casadi_sparsity_out(ii), out[ii]))
+                return ii;
+        }
+    }
+    return -1;
+}
+
+
+
+// memory for args_buf, res_buf, res_scatter
+static acados_size_t casadi_zero_copy_calculate_size(int args_num, int res_num,
+                                                     const int *(*casadi_sparsity_out)(int))
+{
+    acados_size_t size = 0;
+    size += args_num * sizeof(double *);  // args_buf
+    size += res_num * sizeof(double *);  // res_buf
+    size += res_num * sizeof(external_function_casadi_scatter);  // res_scatter
+    for (int ii = 0; ii < res_num; ii++)
+    {
+        const int *sparsity = casadi_sparsity_out(ii);
+        size += sparsity[0] * sparsity[1] * sizeof(int);  // res_scatter[i].idx
+    }
+    return size;
+}
+
+
+
+// assign args_buf, res_buf, res_scatter, c_ptr has to be aligned to 8 bytes
+static void casadi_zero_copy_assign(int args_num, int res_num, const int *(*casadi_sparsity_out)(int),
+                                    double **args, double **res, double ***args_buf, double ***res_buf,
+                                    external_function_casadi_scatter **res_scatter, char **c_ptr)
+{
+    int ii;
+
+    assign_and_advance_double_ptrs(args_num, args_buf, c_ptr);
+    assign_and_advance_double_ptrs(res_num, res_buf, c_ptr);
+
+    *res_scatter = (external_function_casadi_scatter *) *c_ptr;
+    *c_ptr += res_num * sizeof(external_function_casadi_scatter);
+
+    for (ii = 0; ii < args_num; ii++)
+        (*args_buf)[ii] = args[ii];
+    for (ii = 0; ii < res_num; ii++)
+    {
+        (*res_buf)[ii] = res[ii];
+        (*res_scatter)[ii].base = NULL;
+        (*res_scatter)[ii].mat = NULL;
+        (*res_scatter)[ii].ld = 0;
+        const int *sparsity = casadi_sparsity_out(ii);
+        assign_and_advance_int(sparsity[0] * sparsity[1], &(*res_scatter)[ii].idx, c_ptr);
+    }
+}
+
+
+
 
 /************************************************
  * casadi external function
@@ -838,7 +1275,10 @@ acados_size_t external_function_casadi_struct_size()
 acados_size_t external_function_casadi_calculate_size(external_function_casadi *fun, external_function_opts *opts_)
 {
     // casadi wrapper as evaluate
-    fun->evaluate = &external_function_casadi_wrapper;
+    if (opts_->zero_copy)
+        fun->evaluate = &external_function_casadi_wrapper_zero_copy;
+    else
+        fun->evaluate = &external_function_casadi_wrapper;
     fun->get_external_workspace_requirement = external_function_casadi_get_external_workspace_requirement;
     fun->set_external_workspace = external_function_casadi_set_external_workspace;
 
@@ -887,6 +1327,11 @@ acados_size_t external_function_casadi_calculate_size(external_function_casadi *
     {
         size += fun->float_work_size * sizeof(double);
     }
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        size += casadi_zero_copy_calculate_size(fun->args_num, fun->res_num, fun->casadi_sparsity_out);
+    }
 
     size += 8;  // initial align
     size += 8;  // align to double
@@ -951,6 +1396,12 @@ void external_function_casadi_assign(external_function_casadi *fun, void *raw_me
     {
         assign_and_advance_double(fun->float_work_size, &fun->float_work, &c_ptr);
     }
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        casadi_zero_copy_assign(fun->args_num, fun->res_num, fun->casadi_sparsity_out, fun->args, fun->res,
+                                &fun->args_buf, &fun->res_buf, &fun->res_scatter, &c_ptr);
+    }
 
     assert((char *) raw_memory + external_function_casadi_calculate_size(fun, &fun->opts) >= c_ptr);
 
@@ -998,6 +1449,53 @@ void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void *
 }
 
 
+void external_function_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                ext_fun_arg_t *type_out, void **out)
+{
+    // cast into external casadi function
+    external_function_casadi *fun = self;
+
+    int idx_fail;
+
+    // in as args, without copy where possible
+    idx_fail = casadi_zero_copy_set_args(fun->in_num, -1, -1, fun->casadi_sparsity_in, fun->args_dense,
+                                         fun->args, fun->args_buf, type_in, in);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_casadi_wrapper_zero_copy: Unknown external function argument type %d for input %d\n\n", type_in[idx_fail], idx_fail);
+        return;
+    }
+
+    // out as res, without copy where possible
+    casadi_zero_copy_set_res(fun->out_num, fun->casadi_sparsity_out, fun->res_dense, fun->res,
+                             fun->res_buf, type_out, out);
+
+    // call casadi function
+    fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+
+    // scatter the results that could not be written in place
+    idx_fail = casadi_zero_copy_scatter_res(fun->out_num, fun->casadi_sparsity_out, fun->res, fun->res_buf,
+                                            fun->res_scatter, type_out, out);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_casadi_wrapper_zero_copy: Unknown external function argument type %d for output %d\n\n", type_out[idx_fail], idx_fail);
+        return;
+    }
+
+    return;
+}
+
+
+
+const int *external_function_casadi_get_output_sparsity(void *self, int idx_out)
+{
+    external_function_casadi *fun = self;
+    if (idx_out < 0 || idx_out >= fun->out_num)
+        return NULL;
+    return fun->casadi_sparsity_out(idx_out);
+}
+
+
 size_t external_function_casadi_get_external_workspace_requirement(void *self)
 {
     external_function_casadi *fun = self;
@@ -1065,7 +1563,10 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     int ii;
 
     // casadi wrapper as evaluate function
-    fun->evaluate = &external_function_param_casadi_wrapper;
+    if (opts_->zero_copy)
+        fun->evaluate = &external_function_param_casadi_wrapper_zero_copy;
+    else
+        fun->evaluate = &external_function_param_casadi_wrapper;
     fun->get_external_workspace_requirement = external_function_param_casadi_get_external_workspace_requirement;
     fun->set_external_workspace = external_function_param_casadi_set_external_workspace;
 
@@ -1124,6 +1625,11 @@ acados_size_t external_function_param_casadi_calculate_size(external_function_pa
     {
         size += fun->float_work_size * sizeof(double);
     }
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        size += casadi_zero_copy_calculate_size(fun->args_num, fun->res_num, fun->casadi_sparsity_out);
+    }
 
     size += 8;  // initial align
     size += 8;  // align to double
@@ -1188,6 +1694,12 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
     {
         assign_and_advance_double(fun->float_work_size, &fun->float_work, &c_ptr);
     }
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        casadi_zero_copy_assign(fun->args_num, fun->res_num, fun->casadi_sparsity_out, fun->args, fun->res,
+                                &fun->args_buf, &fun->res_buf, &fun->res_scatter, &c_ptr);
+    }
 
     assert((char *) raw_memory + external_function_param_casadi_calculate_size(fun, fun->np, &fun->opts) >=
            c_ptr);
@@ -1240,6 +1752,45 @@ void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in,
 
 
 
+void external_function_param_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                      ext_fun_arg_t *type_out, void **out)
+{
+    // cast into external casadi function
+    external_function_param_casadi *fun = self;
+
+    int idx_fail;
+
+    // in as args, without copy where possible;
+    // parameters are last argument and set via external_function_param_casadi_set_param
+    idx_fail = casadi_zero_copy_set_args(fun->in_num, fun->idx_in_p, -1, fun->casadi_sparsity_in,
+                                         fun->args_dense, fun->args, fun->args_buf, type_in, in);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_param_casadi_wrapper_zero_copy: Unknown external function argument type %d for input %d\n\n", type_in[idx_fail], idx_fail);
+        return;
+    }
+
+    // out as res, without copy where possible
+    casadi_zero_copy_set_res(fun->out_num, fun->casadi_sparsity_out, fun->res_dense, fun->res,
+                             fun->res_buf, type_out, out);
+
+    // call casadi function
+    fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+
+    // scatter the results that could not be written in place
+    idx_fail = casadi_zero_copy_scatter_res(fun->out_num, fun->casadi_sparsity_out, fun->res, fun->res_buf,
+                                            fun->res_scatter, type_out, out);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_param_casadi_wrapper_zero_copy: Unknown external function argument type %d for output %d\n\n", type_out[idx_fail], idx_fail);
+        return;
+    }
+
+    return;
+}
+
+
+
 void external_function_param_casadi_get_nparam(void *self, int *np)
 {
     external_function_param_casadi *fun = self;
@@ -1251,6 +1802,15 @@ void external_function_param_casadi_get_nparam(void *self, int *np)
 
 
 
+const int *external_function_param_casadi_get_output_sparsity(void *self, int idx_out)
+{
+    external_function_param_casadi *fun = self;
+    if (idx_out < 0 || idx_out >= fun->out_num)
+        return NULL;
+    return fun->casadi_sparsity_out(idx_out);
+}
+
+
 size_t external_function_param_casadi_get_external_workspace_requirement(void *self)
 {
     external_function_param_casadi *fun = self;
@@ -1420,7 +1980,10 @@ acados_size_t external_function_external_param_casadi_calculate_size(external_fu
     int ii;
 
     // casadi wrapper as evaluate function
-    fun->evaluate = &external_function_external_param_casadi_wrapper;
+    if (opts_->zero_copy)
+        fun->evaluate = &external_function_external_param_casadi_wrapper_zero_copy;
+    else
+        fun->evaluate = &external_function_external_param_casadi_wrapper;
     fun->get_external_workspace_requirement = external_function_external_param_casadi_get_external_workspace_requirement;
     fun->set_external_workspace = external_function_external_param_casadi_set_external_workspace;
 
@@ -1483,6 +2046,12 @@ acados_size_t external_function_external_param_casadi_calculate_size(external_fu
         size += fun->float_work_size * sizeof(double);
     }
 
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        size += casadi_zero_copy_calculate_size(fun->args_num, fun->res_num, fun->casadi_sparsity_out);
+    }
+
     size += 8;  // initial align
     size += 8;  // align to double
 
@@ -1553,6 +2122,13 @@ void external_function_external_param_casadi_assign(external_function_external_p
         assign_and_advance_double(fun->float_work_size, &fun->float_work, &c_ptr);
     }
 
+    // args_buf, res_buf, res_scatter
+    if (fun->opts.zero_copy)
+    {
+        casadi_zero_copy_assign(fun->args_num, fun->res_num, fun->casadi_sparsity_out, fun->args, fun->res,
+                                &fun->args_buf, &fun->res_buf, &fun->res_scatter, &c_ptr);
+    }
+
     fun->param_mem_is_set = false;
     fun->global_data_ptr_is_set = false;
 
@@ -1562,6 +2138,15 @@ void external_function_external_param_casadi_assign(external_function_external_p
 }
 
 
+const int *external_function_external_param_casadi_get_output_sparsity(void *self, int idx_out)
+{
+    external_function_external_param_casadi *fun = self;
+    if (idx_out < 0 || idx_out >= fun->out_num)
+        return NULL;
+    return fun->casadi_sparsity_out(idx_out);
+}
+
+
 size_t external_function_external_param_casadi_get_external_workspace_requirement(void *self)
 {
     external_function_external_param_casadi *fun = self;
@@ -1627,3 +2212,53 @@ void external_function_external_param_casadi_wrapper(void *self, ext_fun_arg_t *
 
     return;
 }
+
+
+
+void external_function_external_param_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                               ext_fun_arg_t *type_out, void **out)
+{
+    // cast into external casadi function
+    external_function_external_param_casadi *fun = self;
+
+    int idx_fail;
+
+    if (!fun->param_mem_is_set)
+    {
+        printf("external_function_external_param_casadi_wrapper_zero_copy: attempting to evaluate before parameter memory is set.\n");
+        return;
+    }
+    if (!fun->global_data_ptr_is_set && fun->opts.with_global_data)
+    {
+        printf("external_function_external_param_casadi_wrapper_zero_copy: attempting to evaluate before global data pointer is set.\n");
+        return;
+    }
+
+    // in as args, without copy where possible; parameters and global data are set via their pointers
+    idx_fail = casadi_zero_copy_set_args(fun->in_num, fun->idx_in_p, fun->idx_in_global_data,
+                                         fun->casadi_sparsity_in, fun->args_dense, fun->args, fun->args_buf,
+                                         type_in, in);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_external_param_casadi_wrapper_zero_copy: Unknown external function argument type %d for input %d\n\n", type_in[idx_fail], idx_fail);
+        return;
+    }
+
+    // out as res, without copy where possible
+    casadi_zero_copy_set_res(fun->out_num, fun->casadi_sparsity_out, fun->res_dense, fun->res,
+                             fun->res_buf, type_out, out);
+
+    // call casadi function
+    fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+
+    // scatter the results that could not be written in place
+    idx_fail = casadi_zero_copy_scatter_res(fun->out_num, fun->casadi_sparsity_out, fun->res, fun->res_buf,
+                                            fun->res_scatter, type_out, out);
+    if (idx_fail >= 0)
+    {
+        printf("\nexternal_function_external_param_casadi_wrapper_zero_copy: Unknown external function argument type %d for output %d\n\n", type_out[idx_fail], idx_fail);
+        return;
+    }
+
+    return;
+}
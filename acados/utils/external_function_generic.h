@@ -78,6 +78,9 @@ typedef struct
 {
     bool external_workspace;
     bool with_global_data;
+    // casadi functions only: pass contiguous dense arguments to casadi without copies and
+    // write sparse results straight into their destination, see external_function_casadi_scatter
+    bool zero_copy;
 } external_function_opts;
 
 
@@ -101,6 +104,40 @@ void external_function_set_fun_workspace_if_defined(external_function_generic *f
 void external_function_opts_set_to_default(external_function_opts *opts);
 
 
+// block of structural nonzeros of a matrix output,
+// rows [row0, row0+nrow) and columns [col0, col0+ncol)
+typedef struct
+{
+    int row0;
+    int nrow;
+    int col0;
+    int ncol;
+} external_function_nnz_box;
+
+#define EXTERNAL_FUNCTION_NNZ_MAX_BLOCKS 8
+
+// structural nonzeros of a matrix output, covered by column-disjoint blocks
+typedef struct
+{
+    int nblock;
+    external_function_nnz_box block[EXTERNAL_FUNCTION_NNZ_MAX_BLOCKS];
+} external_function_nnz_pattern;
+
+// returns NULL if the sparsity of the output is not known, i.e. fun is not a casadi function
+const int *external_function_get_output_sparsity_if_defined(external_function_generic *fun, int idx_out);
+
+// blocks covering the structural nonzeros of the m x n output idx_out; the full matrix if the sparsity is not known
+void external_function_get_output_nnz_pattern(external_function_generic *fun, int idx_out, int m, int n,
+                                              external_function_nnz_pattern *pattern);
+// number of entries covered by the blocks
+int external_function_nnz_pattern_numel(external_function_nnz_pattern *pattern);
+// one plus the largest row index covered by the blocks
+int external_function_nnz_pattern_row_end(external_function_nnz_pattern *pattern);
+// sB += alpha * sA, restricted to the blocks
+void external_function_nnz_pattern_dgead(external_function_nnz_pattern *pattern, double alpha,
+                                         struct blasfeo_dmat *sA, struct blasfeo_dmat *sB);
+
+
 
 
 /************************************************
@@ -148,6 +185,21 @@ void external_function_param_generic_set_external_workspace(void *self, void *wo
  * casadi external function
  ************************************************/
 
+/* Scatter map of one casadi output into its destination, used with opts.zero_copy.
+ * The map is built on the first evaluation into a destination and holds the offsets of the
+ * structural nonzeros followed by the ones of the structural zeros; every evaluation writes
+ * both, so destinations may be shared or accumulated into between evaluations.
+ * Dense outputs and inputs with contiguous storage are passed to casadi directly, so inputs
+ * and outputs of one evaluation must not overlap.
+ * On unknown argument types the zero_copy wrappers print an error and return. */
+typedef struct
+{
+    int *idx;      // offsets of the structural nonzeros, then of the structural zeros, w.r.t. base
+    double *base;  // address of the first element of the destination
+    void *mat;     // blasfeo_dmat of the destination, NULL otherwise
+    int ld;        // leading dimension of a column-major destination
+} external_function_casadi_scatter;
+
 typedef struct
 {
     // public members (have to be the same as in the prototype, and before the private ones)
@@ -178,6 +230,9 @@ typedef struct
     int out_num;        // number of output arrays
     int int_work_size;        // number of ints for worksapce
     int float_work_size;         // number of doubles for workspace
+    double **args_buf;  // own memory of args[i] (zero_copy only)
+    double **res_buf;   // own memory of res[i] (zero_copy only)
+    external_function_casadi_scatter *res_scatter;  // (zero_copy only)
     external_function_opts opts;
 } external_function_casadi;
 
@@ -191,6 +246,11 @@ void external_function_casadi_assign(external_function_casadi *fun, void *mem);
 void external_function_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                       ext_fun_arg_t *type_out, void **out);
 //
+void external_function_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                ext_fun_arg_t *type_out, void **out);
+//
+const int *external_function_casadi_get_output_sparsity(void *self, int idx_out);
+//
 size_t external_function_casadi_get_external_workspace_requirement(void *self);
 //
 void external_function_casadi_set_external_workspace(void *self, void *workspace);
@@ -233,6 +293,9 @@ typedef struct
     int out_num;        // number of output arrays
     int int_work_size;        // number of ints for worksapce
     int float_work_size;         // number of doubles for workspace
+    double **args_buf;  // own memory of args[i] (zero_copy only)
+    double **res_buf;   // own memory of res[i] (zero_copy only)
+    external_function_casadi_scatter *res_scatter;  // (zero_copy only)
     int np;             // number of parameters
     int idx_in_p;
     external_function_opts opts;
@@ -248,8 +311,13 @@ void external_function_param_casadi_assign(external_function_param_casadi *fun,
 void external_function_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                             ext_fun_arg_t *type_out, void **out);
 //
+void external_function_param_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                      ext_fun_arg_t *type_out, void **out);
+//
 void external_function_param_casadi_get_nparam(void *self, int *np);
 //
+const int *external_function_param_casadi_get_output_sparsity(void *self, int idx_out);
+//
 size_t external_function_param_casadi_get_external_workspace_requirement(void *self);
 //
 void external_function_param_casadi_set_external_workspace(void *self, void *workspace);
@@ -292,6 +360,9 @@ typedef struct
     int out_num;        // number of output arrays
     int int_work_size;        // number of ints for worksapce
     int float_work_size;         // number of doubles for workspace
+    double **args_buf;  // own memory of args[i] (zero_copy only)
+    double **res_buf;   // own memory of res[i] (zero_copy only)
+    external_function_casadi_scatter *res_scatter;  // (zero_copy only)
 
     bool param_mem_is_set;  // indicates if param memory is set;
     bool global_data_ptr_is_set;  // indicates if global data pointer is set;
@@ -311,6 +382,11 @@ void external_function_external_param_casadi_assign(external_function_external_p
 void external_function_external_param_casadi_wrapper(void *self, ext_fun_arg_t *type_in, void **in,
                                             ext_fun_arg_t *type_out, void **out);
 //
+void external_function_external_param_casadi_wrapper_zero_copy(void *self, ext_fun_arg_t *type_in, void **in,
+                                                               ext_fun_arg_t *type_out, void **out);
+//
+const int *external_function_external_param_casadi_get_output_sparsity(void *self, int idx_out);
+//
 size_t external_function_external_param_casadi_get_external_workspace_requirement(void *self);
 //
 void external_function_external_param_casadi_set_external_workspace(void *self, void *workspace);
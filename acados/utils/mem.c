@@ -33,6 +33,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // blasfeo
 #include "blasfeo_d_aux.h"
@@ -227,3 +228,43 @@ void assign_and_advance_blasfeo_dmat_mem(int m, int n, struct blasfeo_dmat *sA,
     *ptr += sA->memsize;
 #endif
 }
+
+
+
+void acados_arena_init(acados_arena *arena, void *memory, acados_size_t size)
+{
+    char *c_ptr = (char *) memory;
+    align_char_to(64, &c_ptr);
+
+    acados_size_t offset = (acados_size_t) (c_ptr - (char *) memory);
+
+    arena->base = c_ptr;
+    arena->size = size > offset ? size - offset : 0;
+    arena->used = 0;
+}
+
+
+
+acados_size_t acados_arena_block_size(acados_size_t size)
+{
+    make_int_multiple_of(64, &size);
+    return size;
+}
+
+
+
+void *acados_arena_alloc(acados_arena *arena, acados_size_t size)
+{
+    size = acados_arena_block_size(size);
+
+    if (arena->used + size > arena->size)
+        return NULL;
+
+    void *ptr = arena->base + arena->used;
+    arena->used += size;
+
+    // same semantics as acados_calloc
+    memset(ptr, 0, size);
+
+    return ptr;
+}
@@ -91,6 +91,23 @@ void assign_and_advance_blasfeo_dvec_mem(int n, struct blasfeo_dvec *sv, char **
 // allocate strmat and advance pointer
 void assign_and_advance_blasfeo_dmat_mem(int m, int n, struct blasfeo_dmat *sA, char **ptr);
 
+// bump allocator in a single caller-supplied region (e.g. huge page or mmap memory)
+typedef struct
+{
+    char *base;
+    acados_size_t size;
+    acados_size_t used;
+} acados_arena;
+
+// place arena in memory of given size; memory is owned by the caller
+void acados_arena_init(acados_arena *arena, void *memory, acados_size_t size);
+
+// bytes taken from an arena by a block of given size, including alignment
+acados_size_t acados_arena_block_size(acados_size_t size);
+
+// zeroed 64-byte aligned block from the arena, NULL if the arena is exhausted
+void *acados_arena_alloc(acados_arena *arena, acados_size_t size);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
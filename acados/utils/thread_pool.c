@@ -0,0 +1,518 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#if defined(ACADOS_WITH_THREAD_POOL) && defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // pthread_setaffinity_np
+#endif
+
+#include "acados/utils/thread_pool.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+
+#include <pthread.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+// number of polls before a waiting thread blocks on the condition variable
+#define ACADOS_THREAD_POOL_SPIN 4000
+
+#if defined(__GNUC__)
+#define POOL_LOAD(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define POOL_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#define POOL_DECREMENT(x) __atomic_sub_fetch(&(x), 1, __ATOMIC_ACQ_REL)
+#define POOL_FETCH_INCREMENT(x) __atomic_fetch_add(&(x), 1, __ATOMIC_RELAXED)
+#define POOL_SPIN 1
+#else
+#define POOL_SPIN 0
+#endif
+
+
+
+typedef struct
+{
+    acados_thread_pool *pool;
+    int id;
+    // index range [next, end) for work stealing, next is advanced by owner and thieves
+    int next;
+    int end;
+    char padding[64]; // keep ranges of different workers on different cache lines
+} acados_thread_pool_worker;
+
+
+
+struct acados_thread_pool_
+{
+    int num_threads;
+    pthread_t *threads;
+    acados_thread_pool_worker *workers;
+
+    pthread_mutex_t lock;
+    pthread_cond_t start_cond;
+    pthread_cond_t done_cond;
+
+    // current task, protected by generation
+    acados_parallel_fun fun;
+    void *args;
+    int n;
+    int steal;
+
+    unsigned long generation;
+    int pending;
+    int shutdown;
+};
+
+
+
+static void run_chunk(acados_thread_pool *pool, int id)
+{
+#if POOL_SPIN
+    if (pool->steal)
+    {
+        // own range first, then ranges of the other threads in round robin
+        int num_threads = pool->num_threads;
+        for (int k = 0; k < num_threads; k++)
+        {
+            acados_thread_pool_worker *victim = pool->workers + (id + k) % num_threads;
+            int i;
+            while ((i = POOL_FETCH_INCREMENT(victim->next)) < victim->end)
+                pool->fun(pool->args, i);
+        }
+        return;
+    }
+#endif
+    int lo = (int) (((long) id * pool->n) / pool->num_threads);
+    int hi = (int) (((long) (id + 1) * pool->n) / pool->num_threads);
+    for (int i = lo; i < hi; i++)
+        pool->fun(pool->args, i);
+}
+
+
+
+static int finish_chunk(acados_thread_pool *pool)
+{
+#if POOL_SPIN
+    return POOL_DECREMENT(pool->pending);
+#else
+    pthread_mutex_lock(&pool->lock);
+    int pending = --pool->pending;
+    pthread_mutex_unlock(&pool->lock);
+    return pending;
+#endif
+}
+
+
+
+static void *worker_main(void *arg)
+{
+    acados_thread_pool_worker *worker = arg;
+    acados_thread_pool *pool = worker->pool;
+    unsigned long generation = 0;
+
+    while (1)
+    {
+        // wait for new task
+#if POOL_SPIN
+        for (int k = 0; k < ACADOS_THREAD_POOL_SPIN; k++)
+        {
+            if (POOL_LOAD(pool->generation) != generation || POOL_LOAD(pool->shutdown))
+                break;
+        }
+#endif
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == generation && !pool->shutdown)
+            pthread_cond_wait(&pool->start_cond, &pool->lock);
+        generation = pool->generation;
+        int shutdown = pool->shutdown;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (shutdown)
+            break;
+
+        run_chunk(pool, worker->id);
+
+        if (finish_chunk(pool) == 0)
+        {
+            pthread_mutex_lock(&pool->lock);
+            pthread_cond_signal(&pool->done_cond);
+            pthread_mutex_unlock(&pool->lock);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+acados_thread_pool *acados_thread_pool_create(int num_threads, int pin)
+{
+    if (num_threads <= 1)
+        return NULL;
+
+    acados_thread_pool *pool = calloc(1, sizeof(acados_thread_pool));
+    assert(pool != NULL);
+
+    pool->num_threads = num_threads;
+    pool->threads = calloc(num_threads, sizeof(pthread_t));
+    pool->workers = calloc(num_threads, sizeof(acados_thread_pool_worker));
+    assert(pool->threads != NULL && pool->workers != NULL);
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start_cond, NULL);
+    pthread_cond_init(&pool->done_cond, NULL);
+
+#if defined(__linux__)
+    long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    // thread 0 is the calling thread
+    for (int t = 1; t < num_threads; t++)
+    {
+        pool->workers[t].pool = pool;
+        pool->workers[t].id = t;
+        if (pthread_create(pool->threads+t, NULL, worker_main, pool->workers+t))
+        {
+            // run with the threads started so far
+            pool->num_threads = t;
+            break;
+        }
+#if defined(__linux__)
+        if (pin && num_cpus > 0)
+        {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(t % num_cpus, &cpuset);
+            pthread_setaffinity_np(pool->threads[t], sizeof(cpu_set_t), &cpuset);
+        }
+#endif
+    }
+
+    return pool;
+}
+
+
+
+void acados_thread_pool_destroy(acados_thread_pool *pool)
+{
+    if (pool == NULL)
+        return;
+
+    pthread_mutex_lock(&pool->lock);
+#if POOL_SPIN
+    POOL_STORE(pool->shutdown, 1);
+#else
+    pool->shutdown = 1;
+#endif
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int t = 1; t < pool->num_threads; t++)
+        pthread_join(pool->threads[t], NULL);
+
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->start_cond);
+    pthread_mutex_destroy(&pool->lock);
+
+    free(pool->workers);
+    free(pool->threads);
+    free(pool);
+}
+
+
+
+int acados_thread_pool_num_threads(acados_thread_pool *pool)
+{
+    if (pool == NULL)
+        return 1;
+    return pool->num_threads;
+}
+
+
+
+static void run_task(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args, int steal)
+{
+    if (pool == NULL || n <= 1)
+    {
+        for (int i = 0; i < n; i++)
+            fun(args, i);
+        return;
+    }
+
+    // publish task
+    pthread_mutex_lock(&pool->lock);
+    pool->fun = fun;
+    pool->args = args;
+    pool->n = n;
+    pool->steal = steal;
+    for (int t = 0; t < pool->num_threads; t++)
+    {
+        pool->workers[t].next = (int) (((long) t * n) / pool->num_threads);
+        pool->workers[t].end = (int) (((long) (t + 1) * n) / pool->num_threads);
+    }
+    pool->pending = pool->num_threads - 1;
+#if POOL_SPIN
+    POOL_STORE(pool->generation, pool->generation + 1);
+#else
+    pool->generation++;
+#endif
+    pthread_cond_broadcast(&pool->start_cond);
+    pthread_mutex_unlock(&pool->lock);
+
+    run_chunk(pool, 0);
+
+    // wait for workers
+#if POOL_SPIN
+    for (int k = 0; k < ACADOS_THREAD_POOL_SPIN; k++)
+    {
+        if (POOL_LOAD(pool->pending) == 0)
+            return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (POOL_LOAD(pool->pending) > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+#else
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0)
+        pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+#endif
+}
+
+
+
+void acados_thread_pool_run(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args)
+{
+    run_task(pool, n, fun, args, 0);
+}
+
+
+
+void acados_thread_pool_run_stealing(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args)
+{
+    run_task(pool, n, fun, args, 1);
+}
+
+
+
+struct acados_async_task_
+{
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+
+    acados_parallel_fun fun;
+    void *args;
+
+    int pending; // task started, not finished
+    int shutdown;
+};
+
+
+
+static void *async_task_main(void *arg)
+{
+    acados_async_task *task = arg;
+
+    pthread_mutex_lock(&task->lock);
+    while (1)
+    {
+        while (!task->pending && !task->shutdown)
+            pthread_cond_wait(&task->cond, &task->lock);
+        if (task->pending)
+        {
+            pthread_mutex_unlock(&task->lock);
+            task->fun(task->args, 0);
+            pthread_mutex_lock(&task->lock);
+            task->pending = 0;
+            pthread_cond_broadcast(&task->cond);
+        }
+        else // shutdown
+        {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&task->lock);
+
+    return NULL;
+}
+
+
+
+acados_async_task *acados_async_task_create()
+{
+    acados_async_task *task = calloc(1, sizeof(acados_async_task));
+    assert(task != NULL);
+
+    pthread_mutex_init(&task->lock, NULL);
+    pthread_cond_init(&task->cond, NULL);
+
+    if (pthread_create(&task->thread, NULL, async_task_main, task))
+    {
+        pthread_cond_destroy(&task->cond);
+        pthread_mutex_destroy(&task->lock);
+        free(task);
+        return NULL;
+    }
+
+    return task;
+}
+
+
+
+void acados_async_task_destroy(acados_async_task *task)
+{
+    if (task == NULL)
+        return;
+
+    pthread_mutex_lock(&task->lock);
+    task->shutdown = 1;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+
+    pthread_join(task->thread, NULL);
+
+    pthread_cond_destroy(&task->cond);
+    pthread_mutex_destroy(&task->lock);
+    free(task);
+}
+
+
+
+void acados_async_task_start(acados_async_task *task, acados_parallel_fun fun, void *args)
+{
+    if (task == NULL)
+    {
+        fun(args, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&task->lock);
+    while (task->pending)
+        pthread_cond_wait(&task->cond, &task->lock);
+    task->fun = fun;
+    task->args = args;
+    task->pending = 1;
+    pthread_cond_broadcast(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+}
+
+
+
+void acados_async_task_wait(acados_async_task *task)
+{
+    if (task == NULL)
+        return;
+
+    pthread_mutex_lock(&task->lock);
+    while (task->pending)
+        pthread_cond_wait(&task->cond, &task->lock);
+    pthread_mutex_unlock(&task->lock);
+}
+
+
+
+#else  // ACADOS_WITH_THREAD_POOL
+
+
+
+acados_thread_pool *acados_thread_pool_create(int num_threads, int pin)
+{
+    return NULL;
+}
+
+
+
+void acados_thread_pool_destroy(acados_thread_pool *pool)
+{
+    return;
+}
+
+
+
+int acados_thread_pool_num_threads(acados_thread_pool *pool)
+{
+    return 1;
+}
+
+
+
+void acados_thread_pool_run(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args)
+{
+    for (int i = 0; i < n; i++)
+        fun(args, i);
+}
+
+
+
+void acados_thread_pool_run_stealing(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args)
+{
+    for (int i = 0; i < n; i++)
+        fun(args, i);
+}
+
+
+
+acados_async_task *acados_async_task_create()
+{
+    return NULL;
+}
+
+
+
+void acados_async_task_destroy(acados_async_task *task)
+{
+    return;
+}
+
+
+
+void acados_async_task_start(acados_async_task *task, acados_parallel_fun fun, void *args)
+{
+    fun(args, 0);
+}
+
+
+
+void acados_async_task_wait(acados_async_task *task)
+{
+    return;
+}
+
+
+
+#endif  // ACADOS_WITH_THREAD_POOL
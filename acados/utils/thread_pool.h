@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_UTILS_THREAD_POOL_H_
+#define ACADOS_UTILS_THREAD_POOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "acados/utils/types.h"
+
+/* Persistent worker pool for stage-parallel loops.
+ *
+ * The pool is created once (e.g. in ocp_nlp_solver_create) and reused for every parallel loop
+ * over the shooting nodes. Loop index i is always processed by the same thread, i.e.
+ * thread t works on the contiguous index range [t*n/num_threads, (t+1)*n/num_threads), such that
+ * stage memory stays local to one core across iterations. The calling thread works as thread 0.
+ *
+ * Only available if acados is compiled with ACADOS_WITH_THREAD_POOL, otherwise
+ * acados_thread_pool_create returns NULL and acados_thread_pool_run loops serially.
+ */
+
+typedef void (*acados_parallel_fun)(void *args, int index);
+
+typedef struct acados_thread_pool_ acados_thread_pool;
+
+// create pool with num_threads threads (including the calling thread), pin worker t to core t if pin != 0;
+// pools created with pin != 0 share these cores, e.g. the pools of several solvers in one process
+acados_thread_pool *acados_thread_pool_create(int num_threads, int pin);
+
+// stop and join all workers, free pool
+void acados_thread_pool_destroy(acados_thread_pool *pool);
+
+// number of threads in pool, 1 for NULL pool
+int acados_thread_pool_num_threads(acados_thread_pool *pool);
+
+// call fun(args, i) for i = 0, ..., n-1 using static assignment of indices to threads; blocks until done
+void acados_thread_pool_run(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args);
+// as acados_thread_pool_run, but threads that run out of indices steal from the ranges of the
+// others; for tasks of uneven cost
+void acados_thread_pool_run_stealing(acados_thread_pool *pool, int n, acados_parallel_fun fun, void *args);
+
+
+
+/* Background task with completion handle.
+ *
+ * A single persistent thread that runs one task at a time, e.g. the preparation phase of the
+ * next RTI step while the caller continues. Without ACADOS_WITH_THREAD_POOL,
+ * acados_async_task_create returns NULL and acados_async_task_start runs the task synchronously.
+ */
+
+typedef struct acados_async_task_ acados_async_task;
+
+//
+acados_async_task *acados_async_task_create();
+// waits for a running task, then stops and joins the thread
+void acados_async_task_destroy(acados_async_task *task);
+// start fun(args, 0) in the background; waits for a previously started task first
+void acados_async_task_start(acados_async_task *task, acados_parallel_fun fun, void *args);
+// block until the last started task has finished
+void acados_async_task_wait(acados_async_task *task);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_UTILS_THREAD_POOL_H_
@@ -29,6 +29,11 @@
  */
 
 
+// clock_gettime and CLOCK_MONOTONIC are POSIX, not part of strict C99
+#if !defined(_POSIX_C_SOURCE) && !(defined _WIN32 || defined _WIN64 || defined __APPLE__)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "acados/utils/timing.h"
 
 
@@ -46,6 +51,14 @@ real_t acados_toc(acados_timer* t)
     return ((t->toc.QuadPart - t->tic.QuadPart) / (real_t) t->freq.QuadPart);
 }
 
+real_t acados_time_now(void)
+{
+    LARGE_INTEGER now, freq;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return now.QuadPart / (real_t) freq.QuadPart;
+}
+
 #elif defined(__APPLE__)
 void acados_tic(acados_timer* t)
 {
@@ -67,6 +80,13 @@ real_t acados_toc(acados_timer* t)
 
     return (real_t) duration / 1e9;
 }
+
+real_t acados_time_now(void)
+{
+    mach_timebase_info_data_t tinfo;
+    mach_timebase_info(&tinfo);
+    return (real_t) mach_absolute_time() * tinfo.numer / tinfo.denom / 1e9;
+}
 #elif defined(_DS1104)
 
 void acados_tic(acados_timer* t)
@@ -77,6 +97,9 @@ void acados_tic(acados_timer* t)
 
 real_t acados_toc(acados_timer* t) { return ds1104_tic_read() - t->time; }
 
+/* tic_start resets the board timer, there is no free-running clock */
+real_t acados_time_now(void) { return 0.0; }
+
 #elif defined(__MABX2__)
 
 void acados_tic(acados_timer* t)
@@ -87,32 +110,31 @@ void acados_tic(acados_timer* t)
 
 real_t acados_toc(acados_timer* t) { return ds1401_tic_read() - t->time; }
 
+/* tic_start resets the board timer, there is no free-running clock */
+real_t acados_time_now(void) { return 0.0; }
+
 #else
 
 #if (__STDC_VERSION__ >= 199901L) && !(defined __MINGW32__ || defined __MINGW64__) // C99 Mode
 
+/* read current time in nanoseconds; on Linux this is a vDSO call without a syscall */
+static inline uint64_t acados_timer_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
 /* read current time */
-void acados_tic(acados_timer* t) { gettimeofday(&t->tic, 0); }
+void acados_tic(acados_timer* t) { t->tic = acados_timer_now_ns(); }
 /* return time passed since last call to tic on this timer */
 real_t acados_toc(acados_timer* t)
 {
-    struct timeval temp;
-
-    gettimeofday(&t->toc, 0);
-
-    if ((t->toc.tv_usec - t->tic.tv_usec) < 0)
-    {
-        temp.tv_sec = t->toc.tv_sec - t->tic.tv_sec - 1;
-        temp.tv_usec = 1000000 + t->toc.tv_usec - t->tic.tv_usec;
-    }
-    else
-    {
-        temp.tv_sec = t->toc.tv_sec - t->tic.tv_sec;
-        temp.tv_usec = t->toc.tv_usec - t->tic.tv_usec;
-    }
-
-    return (real_t) temp.tv_sec + (real_t) temp.tv_usec / 1e6;
+    t->toc = acados_timer_now_ns();
+    return (real_t) (t->toc - t->tic) / 1e9;
 }
+/* return current time in seconds */
+real_t acados_time_now(void) { return (real_t) acados_timer_now_ns() / 1e9; }
 
 #else  // ANSI C Mode
 
@@ -138,6 +160,13 @@ real_t acados_toc(acados_timer* t)
 
     return (real_t) temp.tv_sec + (real_t) temp.tv_nsec / 1e9;
 }
+/* return current time in seconds */
+real_t acados_time_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (real_t) now.tv_sec + (real_t) now.tv_nsec / 1e9;
+}
 
 #endif  // __STDC_VERSION__ >= 199901L
 
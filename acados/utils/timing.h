@@ -88,13 +88,13 @@ typedef struct acados_timer_
 
 #if (__STDC_VERSION__ >= 199901L) && !(defined __MINGW32__ || defined __MINGW64__)  // C99 Mode
 
-#include <sys/stat.h>
-#include <sys/time.h>
+#include <stdint.h>
 
+/** A structure for keeping internal timer data, in nanoseconds of CLOCK_MONOTONIC. */
 typedef struct acados_timer_
 {
-    struct timeval tic;
-    struct timeval toc;
+    uint64_t tic;
+    uint64_t toc;
 } acados_timer;
 
 #else  // ANSI C Mode
@@ -116,6 +116,10 @@ void acados_tic(acados_timer* t);
 /** A function which returns the elapsed time. */
 real_t acados_toc(acados_timer* t);
 
+/** A function which returns the current time in seconds of a monotonic clock with arbitrary origin.
+ * On dSPACE targets no free-running clock is available and 0 is returned. */
+real_t acados_time_now(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
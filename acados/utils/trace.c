@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "acados/utils/trace.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acados/utils/timing.h"
+
+#if defined(__GNUC__)
+#define TRACE_FETCH_INCREMENT(x) __atomic_fetch_add(&(x), 1, __ATOMIC_RELAXED)
+#define TRACE_THREAD_LOCAL __thread
+#else
+// no atomics and thread ids, recording from several threads at once is not supported
+#define TRACE_FETCH_INCREMENT(x) ((x)++)
+#define TRACE_THREAD_LOCAL
+#endif
+
+
+
+typedef struct
+{
+    const char *name;
+    double ts;     // microseconds since acados_trace_start
+    double value;  // counter value
+    int tid;
+    char ph;       // 'B', 'E' or 'C'
+} acados_trace_event;
+
+
+
+static struct
+{
+    acados_trace_event *events;
+    uint64_t capacity;  // power of two
+    uint64_t next;      // number of recorded events, index of the next event is next % capacity
+    int num_tids;
+    int enabled;
+    acados_timer start;
+} trace;
+
+static TRACE_THREAD_LOCAL int trace_tid = -1;
+
+
+
+static int trace_get_tid(void)
+{
+    if (trace_tid < 0)
+        trace_tid = TRACE_FETCH_INCREMENT(trace.num_tids);
+    return trace_tid;
+}
+
+
+
+static void trace_record(const char *name, char ph, double value)
+{
+    if (!trace.enabled)
+        return;
+
+    // copy of the start timer, such that threads do not write to shared memory
+    acados_timer timer = trace.start;
+    double ts = 1e6 * acados_toc(&timer);
+
+    uint64_t k = TRACE_FETCH_INCREMENT(trace.next);
+    acados_trace_event *ev = trace.events + (k & (trace.capacity - 1));
+    ev->name = name;
+    ev->ts = ts;
+    ev->value = value;
+    ev->tid = trace_get_tid();
+    ev->ph = ph;
+}
+
+
+
+void acados_trace_begin(const char *name) { trace_record(name, 'B', 0.0); }
+
+void acados_trace_end(const char *name) { trace_record(name, 'E', 0.0); }
+
+void acados_trace_counter(const char *name, double value) { trace_record(name, 'C', value); }
+
+
+
+int acados_trace_start(int capacity)
+{
+    uint64_t cap = 1;
+    while (cap < (uint64_t) capacity)
+        cap *= 2;
+
+    if (trace.events == NULL || trace.capacity != cap)
+    {
+        free(trace.events);
+        trace.events = malloc(cap * sizeof(acados_trace_event));
+        if (trace.events == NULL)
+        {
+            trace.capacity = 0;
+            trace.enabled = 0;
+            return 1;
+        }
+    }
+    trace.capacity = cap;
+    trace.next = 0;
+    acados_tic(&trace.start);
+    trace.enabled = 1;
+    return 0;
+}
+
+
+
+void acados_trace_stop(void) { trace.enabled = 0; }
+
+
+
+void acados_trace_free(void)
+{
+    trace.enabled = 0;
+    free(trace.events);
+    trace.events = NULL;
+    trace.capacity = 0;
+    trace.next = 0;
+}
+
+
+
+int acados_trace_dump(const char *filename)
+{
+    FILE *file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        printf("\nerror: acados_trace_dump: could not open file %s\n", filename);
+        return 1;
+    }
+
+    uint64_t n = trace.next;
+    uint64_t first = n > trace.capacity ? n - trace.capacity : 0;
+
+    // open begin events per thread, end events whose begin event was overwritten are dropped
+    int num_tids = trace.num_tids;
+    int *depth = calloc(num_tids > 0 ? num_tids : 1, sizeof(int));
+
+    fprintf(file, "{\"traceEvents\":[");
+    int num_written = 0;
+    for (uint64_t k = first; k < n; k++)
+    {
+        acados_trace_event *ev = trace.events + (k & (trace.capacity - 1));
+        if (ev->tid >= num_tids)
+            continue;
+        if (ev->ph == 'B')
+        {
+            depth[ev->tid]++;
+        }
+        else if (ev->ph == 'E')
+        {
+            if (depth[ev->tid] == 0)
+                continue;
+            depth[ev->tid]--;
+        }
+
+        fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                num_written > 0 ? "," : "", ev->name, ev->ph, ev->ts, ev->tid);
+        if (ev->ph == 'C')
+            fprintf(file, ",\"args\":{\"value\":%.17g}", ev->value);
+        fprintf(file, "}");
+        num_written++;
+    }
+    fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+
+    free(depth);
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef ACADOS_UTILS_TRACE_H_
+#define ACADOS_UTILS_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event tracer for the solver hot path.
+ *
+ * Records begin/end events (and counters) of SQP iterations, linearization, condensing,
+ * QP solves, line-search trials and integrator calls into a process-wide ring buffer, which can
+ * be dumped as a Chrome trace JSON file (chrome://tracing, https://ui.perfetto.dev).
+ * When the buffer is full, the oldest events are overwritten.
+ *
+ * The hooks in the solvers are only compiled in with ACADOS_WITH_TRACE, otherwise the
+ * ACADOS_TRACE_* macros expand to nothing. Event names must be string literals (only the pointer
+ * is stored). Recording is thread-safe with GCC/Clang; dump while no solver is running.
+ */
+
+// allocate a ring buffer for capacity events (rounded up to a power of two) and start recording
+int acados_trace_start(int capacity);
+
+// stop recording, the recorded events are kept
+void acados_trace_stop(void);
+
+// write the recorded events to filename in Chrome trace event format; returns 0 on success
+int acados_trace_dump(const char *filename);
+
+// stop recording and free the ring buffer
+void acados_trace_free(void);
+
+// record events on the calling thread
+void acados_trace_begin(const char *name);
+void acados_trace_end(const char *name);
+void acados_trace_counter(const char *name, double value);
+
+#if defined(ACADOS_WITH_TRACE)
+#define ACADOS_TRACE_BEGIN(name) acados_trace_begin(name)
+#define ACADOS_TRACE_END(name) acados_trace_end(name)
+#define ACADOS_TRACE_COUNTER(name, value) acados_trace_counter(name, value)
+#else
+#define ACADOS_TRACE_BEGIN(name) ((void) 0)
+#define ACADOS_TRACE_END(name) ((void) 0)
+#define ACADOS_TRACE_COUNTER(name, value) ((void) 0)
+#endif
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // ACADOS_UTILS_TRACE_H_
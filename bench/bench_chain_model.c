@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "bench/bench_chain_model.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench/bench_common.h"
+#include "examples/c/chain_model/chain_model.h"
+#include "examples/c/implicit_chain_model/chain_model_impl.h"
+
+#include "examples/c/chain_model/x0_nm2.c"
+#include "examples/c/chain_model/x0_nm3.c"
+#include "examples/c/chain_model/x0_nm4.c"
+#include "examples/c/chain_model/x0_nm5.c"
+
+#include "examples/c/chain_model/xN_nm2.c"
+#include "examples/c/chain_model/xN_nm3.c"
+#include "examples/c/chain_model/xN_nm4.c"
+#include "examples/c/chain_model/xN_nm5.c"
+
+
+#define SET_CHAIN_MODEL(model, nm)                                                          \
+    do                                                                                      \
+    {                                                                                       \
+        BENCH_SET_CASADI_FUN((model)->expl_vde_for, vde_chain_##nm);                        \
+        BENCH_SET_CASADI_FUN((model)->impl_ode_fun, casadi_impl_ode_fun_chain_##nm);        \
+        BENCH_SET_CASADI_FUN((model)->impl_ode_fun_jac_x_xdot,                              \
+                             casadi_impl_ode_fun_jac_x_xdot_chain_##nm);                    \
+        BENCH_SET_CASADI_FUN((model)->impl_ode_jac_x_xdot_u,                                \
+                             casadi_impl_ode_jac_x_xdot_u_chain_##nm);                      \
+        BENCH_SET_CASADI_FUN((model)->impl_ode_fun_jac_x_xdot_u,                            \
+                             casadi_impl_ode_fun_jac_x_xdot_u_chain_##nm);                  \
+    } while (0)
+
+
+
+void bench_chain_model_create(bench_chain_model *model, int num_free_masses)
+{
+    switch (num_free_masses)
+    {
+        case 1:
+            SET_CHAIN_MODEL(model, nm2);
+            break;
+        case 2:
+            SET_CHAIN_MODEL(model, nm3);
+            break;
+        case 3:
+            SET_CHAIN_MODEL(model, nm4);
+            break;
+        case 4:
+            SET_CHAIN_MODEL(model, nm5);
+            break;
+        default:
+            printf("\nerror: bench_chain_model_create: num_free_masses = %d not supported\n", num_free_masses);
+            exit(1);
+    }
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    external_function_casadi_create(&model->expl_vde_for, &ext_fun_opts);
+    external_function_casadi_create(&model->impl_ode_fun, &ext_fun_opts);
+    external_function_casadi_create(&model->impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+    external_function_casadi_create(&model->impl_ode_jac_x_xdot_u, &ext_fun_opts);
+    external_function_casadi_create(&model->impl_ode_fun_jac_x_xdot_u, &ext_fun_opts);
+}
+
+
+
+void bench_chain_model_free(bench_chain_model *model)
+{
+    external_function_casadi_free(&model->expl_vde_for);
+    external_function_casadi_free(&model->impl_ode_fun);
+    external_function_casadi_free(&model->impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&model->impl_ode_jac_x_xdot_u);
+    external_function_casadi_free(&model->impl_ode_fun_jac_x_xdot_u);
+}
+
+
+
+static void copy_state(int num_free_masses, double *nm2, double *nm3, double *nm4, double *nm5,
+                       double *x)
+{
+    double *ptr[4] = {nm2, nm3, nm4, nm5};
+    if (num_free_masses < 1 || num_free_masses > BENCH_CHAIN_MAX_FREE_MASSES)
+    {
+        printf("\nerror: bench_chain: num_free_masses = %d not supported\n", num_free_masses);
+        exit(1);
+    }
+    for (int i = 0; i < 6 * num_free_masses; i++)
+        x[i] = ptr[num_free_masses-1][i];
+}
+
+
+
+void bench_chain_x0(int num_free_masses, double *x0)
+{
+    copy_state(num_free_masses, x0_nm2, x0_nm3, x0_nm4, x0_nm5, x0);
+}
+
+
+
+void bench_chain_xN(int num_free_masses, double *xN)
+{
+    copy_state(num_free_masses, xN_nm2, xN_nm3, xN_nm4, xN_nm5, xN);
+}
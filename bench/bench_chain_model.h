@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef BENCH_BENCH_CHAIN_MODEL_H_
+#define BENCH_BENCH_CHAIN_MODEL_H_
+
+#include "acados_c/external_function_interface.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Chain of masses from examples/c/chain_model and examples/c/implicit_chain_model.
+ * num_free_masses in 1, ..., 4, nx = 6 * num_free_masses, nu = 3. */
+
+#define BENCH_CHAIN_MAX_FREE_MASSES 4
+
+typedef struct
+{
+    external_function_casadi expl_vde_for;
+    external_function_casadi impl_ode_fun;
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    external_function_casadi impl_ode_fun_jac_x_xdot_u;
+} bench_chain_model;
+
+// set casadi functions and create them
+void bench_chain_model_create(bench_chain_model *model, int num_free_masses);
+
+void bench_chain_model_free(bench_chain_model *model);
+
+// initial and final (resting) state, nx values
+void bench_chain_x0(int num_free_masses, double *x0);
+void bench_chain_xN(int num_free_masses, double *xN);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // BENCH_BENCH_CHAIN_MODEL_H_
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#include "bench/bench_common.h"
+
+#include <stdlib.h>
+
+
+
+void bench_parse_args(int argc, char **argv, const char *default_file, int default_nrep,
+                      const char **file, int *nrep)
+{
+    *file = argc > 1 ? argv[1] : default_file;
+    *nrep = argc > 2 ? atoi(argv[2]) : default_nrep;
+    if (*nrep < 1)
+        *nrep = 1;
+}
+
+
+
+static int compare_double(const void *a, const void *b)
+{
+    double da = *(const double *) a;
+    double db = *(const double *) b;
+    return (da > db) - (da < db);
+}
+
+
+
+void bench_stats_compute(double *samples, int n, bench_stats *stats)
+{
+    qsort(samples, n, sizeof(double), compare_double);
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++)
+        sum += samples[i];
+
+    stats->min = samples[0];
+    stats->max = samples[n-1];
+    stats->mean = sum / n;
+    stats->median = n % 2 ? samples[n/2] : 0.5 * (samples[n/2-1] + samples[n/2]);
+    // nearest rank
+    int k = (99 * n + 99) / 100 - 1;
+    stats->p99 = samples[k < n ? k : n-1];
+}
+
+
+
+int bench_json_open(bench_json *json, const char *filename, const char *suite)
+{
+    json->num_records = 0;
+    json->file = fopen(filename, "w");
+    if (json->file == NULL)
+    {
+        printf("\nerror: bench_json_open: could not open file %s\n", filename);
+        return 1;
+    }
+
+    int with_openmp = 0, with_thread_pool = 0;
+#if defined(ACADOS_WITH_OPENMP)
+    with_openmp = 1;
+#endif
+#if defined(ACADOS_WITH_THREAD_POOL)
+    with_thread_pool = 1;
+#endif
+
+    fprintf(json->file, "{\"suite\": \"%s\", \"build\": {\"openmp\": %d, \"thread_pool\": %d},\n",
+            suite, with_openmp, with_thread_pool);
+    fprintf(json->file, "\"results\": [");
+    return 0;
+}
+
+
+
+void bench_json_record(bench_json *json, const char *name, const char *params, int status,
+                       double *samples, int n)
+{
+    bench_stats stats;
+    bench_stats_compute(samples, n, &stats);
+
+    printf("%-32s %-40s status %2d   median %10.2f us   p99 %10.2f us\n",
+           name, params, status, 1e6*stats.median, 1e6*stats.p99);
+
+    if (json->file == NULL)
+        return;
+
+    fprintf(json->file, "%s\n{\"name\": \"%s\", \"params\": {%s}, \"status\": %d, \"nrep\": %d, ",
+            json->num_records > 0 ? "," : "", name, params, status, n);
+    fprintf(json->file, "\"min_us\": %.3f, \"median_us\": %.3f, \"p99_us\": %.3f, "
+            "\"max_us\": %.3f, \"mean_us\": %.3f}",
+            1e6*stats.min, 1e6*stats.median, 1e6*stats.p99, 1e6*stats.max, 1e6*stats.mean);
+    json->num_records++;
+}
+
+
+
+void bench_json_close(bench_json *json)
+{
+    if (json->file == NULL)
+        return;
+    fprintf(json->file, "\n]}\n");
+    fclose(json->file);
+    json->file = NULL;
+}
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+#ifndef BENCH_BENCH_COMMON_H_
+#define BENCH_BENCH_COMMON_H_
+
+#include <stdio.h>
+
+#include "acados/utils/timing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Helpers shared by the benchmark executables in bench/.
+ *
+ * Every benchmark case is run for a number of repetitions, the latency of each repetition is
+ * stored and summarized as min / median / p99 / max / mean. The results of all cases of one
+ * executable are written to one JSON file:
+ *
+ * {"suite": "ocp_nlp", "build": {...}, "results": [
+ *     {"name": "SQP", "params": {"N": 20, "nx": 12}, "status": 0, "nrep": 100,
+ *      "min_us": ..., "median_us": ..., "p99_us": ..., "max_us": ..., "mean_us": ...}, ...]}
+ */
+
+// set the function pointers of an external_function_casadi generated under the given name
+#define BENCH_SET_CASADI_FUN(ext_fun, name)                  \
+    do                                                       \
+    {                                                        \
+        (ext_fun).casadi_fun = &name;                        \
+        (ext_fun).casadi_work = &name##_work;                \
+        (ext_fun).casadi_sparsity_in = &name##_sparsity_in;  \
+        (ext_fun).casadi_sparsity_out = &name##_sparsity_out;\
+        (ext_fun).casadi_n_in = &name##_n_in;                \
+        (ext_fun).casadi_n_out = &name##_n_out;              \
+    } while (0)
+
+typedef struct
+{
+    double min;
+    double median;
+    double p99;
+    double max;
+    double mean;
+} bench_stats;
+
+typedef struct
+{
+    FILE *file;
+    int num_records;
+} bench_json;
+
+// command line: <executable> [output.json] [nrep]
+void bench_parse_args(int argc, char **argv, const char *default_file, int default_nrep,
+                      const char **file, int *nrep);
+
+// sorts samples in place
+void bench_stats_compute(double *samples, int n, bench_stats *stats);
+
+// returns 0 on success
+int bench_json_open(bench_json *json, const char *filename, const char *suite);
+
+// params: comma separated JSON members, e.g. "\"N\": 20, \"nx\": 12"; samples in seconds
+void bench_json_record(bench_json *json, const char *name, const char *params, int status,
+                       double *samples, int n);
+
+void bench_json_close(bench_json *json);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif  // BENCH_BENCH_COMMON_H_
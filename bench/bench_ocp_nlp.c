@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/* Benchmark of the OCP NLP solvers (SQP, SQP_RTI, DDP) on the chain of masses with ERK
+ * dynamics and linear least squares cost, for a range of horizons N, state dimensions
+ * nx = 6, 12, 18 and numbers of threads. Each solve starts from the same initial guess. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acados/utils/timing.h"
+#include "acados_c/external_function_interface.h"
+#include "acados_c/ocp_nlp_interface.h"
+
+#include "bench/bench_chain_model.h"
+#include "bench/bench_common.h"
+
+#define NREP 20
+#define NU 3
+#define UMAX 10.0
+
+
+
+static void bench_ocp_nlp_case(bench_json *json, ocp_nlp_solver_t solver_type, const char *name,
+                               int N, int num_free_masses, int num_threads, double *samples, int nrep)
+{
+    int nx_ = 6 * num_free_masses;
+    int nu_ = NU;
+    int ny_ = nx_ + nu_;
+    // DDP only supports constraints on the initial state
+    int with_u_bounds = solver_type != DDP;
+
+    bench_chain_model model;
+    bench_chain_model_create(&model, num_free_masses);
+
+    double *x0 = malloc(nx_ * sizeof(double));
+    double *xref = malloc(nx_ * sizeof(double));
+    bench_chain_x0(num_free_masses, x0);
+    bench_chain_xN(num_free_masses, xref);
+
+    /************************************************
+    * plan, config, dims
+    ************************************************/
+
+    ocp_nlp_plan_t *plan = ocp_nlp_plan_create(N);
+    plan->nlp_solver = solver_type;
+    for (int i = 0; i <= N; i++)
+    {
+        plan->nlp_cost[i] = LINEAR_LS;
+        plan->nlp_constraints[i] = BGH;
+    }
+    for (int i = 0; i < N; i++)
+    {
+        plan->nlp_dynamics[i] = CONTINUOUS_MODEL;
+        plan->sim_solver_plan[i].sim_solver = ERK;
+    }
+    plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    plan->regularization = NO_REGULARIZE;
+
+    ocp_nlp_config *config = ocp_nlp_config_create(*plan);
+    ocp_nlp_dims *dims = ocp_nlp_dims_create(config);
+
+    int *nx = malloc((N+1) * sizeof(int));
+    int *nu = malloc((N+1) * sizeof(int));
+    int *nz = malloc((N+1) * sizeof(int));
+    int *ns = malloc((N+1) * sizeof(int));
+    for (int i = 0; i <= N; i++)
+    {
+        nx[i] = nx_;
+        nu[i] = i < N ? nu_ : 0;
+        nz[i] = 0;
+        ns[i] = 0;
+    }
+    ocp_nlp_dims_set_opt_vars(config, dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nu", nu);
+    ocp_nlp_dims_set_opt_vars(config, dims, "nz", nz);
+    ocp_nlp_dims_set_opt_vars(config, dims, "ns", ns);
+
+    int zero = 0;
+    for (int i = 0; i <= N; i++)
+    {
+        int ny = i < N ? ny_ : nx_;
+        int nbx = i == 0 ? nx_ : 0;
+        int nbu = i < N && with_u_bounds ? nu_ : 0;
+        ocp_nlp_dims_set_cost(config, dims, i, "ny", &ny);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbx", &nbx);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nbu", &nbu);
+        ocp_nlp_dims_set_constraints(config, dims, i, "ng", &zero);
+        ocp_nlp_dims_set_constraints(config, dims, i, "nh", &zero);
+    }
+
+    /************************************************
+    * nlp_in
+    ************************************************/
+
+    ocp_nlp_in *nlp_in = ocp_nlp_in_create(config, dims);
+    ocp_nlp_out *nlp_out = ocp_nlp_out_create(config, dims);
+
+    for (int i = 0; i < N; i++)
+        nlp_in->Ts[i] = 0.2;
+
+    // cost: y = [x; u]
+    double *Cyt = calloc((nx_+nu_) * ny_, sizeof(double));
+    double *W = calloc(ny_ * ny_, sizeof(double));
+    double *yref = calloc(ny_, sizeof(double));
+    for (int j = 0; j < nu_; j++)
+        Cyt[j + (nx_+nu_) * (nx_+j)] = 1.0;
+    for (int j = 0; j < nx_; j++)
+        Cyt[nu_+j + (nx_+nu_) * j] = 1.0;
+    for (int j = 0; j < nx_; j++)
+        W[j + ny_ * j] = 1e-2;
+    for (int j = 0; j < nu_; j++)
+        W[nx_+j + ny_ * (nx_+j)] = 1.0;
+    for (int j = 0; j < nx_; j++)
+        yref[j] = xref[j];
+
+    double *CytN = calloc(nx_ * nx_, sizeof(double));
+    double *WN = calloc(nx_ * nx_, sizeof(double));
+    for (int j = 0; j < nx_; j++)
+    {
+        CytN[j + nx_ * j] = 1.0;
+        WN[j + nx_ * j] = 1e-2;
+    }
+
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "Cyt", Cyt);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, nlp_in, i, "yref", yref);
+    }
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "Cyt", CytN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, nlp_in, N, "yref", xref);
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        if (ocp_nlp_dynamics_model_set(config, dims, nlp_in, i, "expl_vde_for", &model.expl_vde_for))
+            exit(1);
+    }
+
+    // constraints
+    int *idxbx0 = malloc(nx_ * sizeof(int));
+    for (int j = 0; j < nx_; j++)
+        idxbx0[j] = j;
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "lbx", x0);
+    ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, 0, "ubx", x0);
+
+    int idxbu[NU];
+    double lbu[NU];
+    double ubu[NU];
+    for (int j = 0; j < NU; j++)
+    {
+        idxbu[j] = j;
+        lbu[j] = -UMAX;
+        ubu[j] = UMAX;
+    }
+    for (int i = 0; i < N && with_u_bounds; i++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, nlp_in, nlp_out, i, "ubu", ubu);
+    }
+
+    /************************************************
+    * solver
+    ************************************************/
+
+    void *nlp_opts = ocp_nlp_solver_opts_create(config, dims);
+
+    int max_iter = solver_type == SQP_RTI ? 1 : 20;
+    int rti_phase = 0;
+    ocp_nlp_solver_opts_set(config, nlp_opts, "max_iter", &max_iter);
+    ocp_nlp_solver_opts_set(config, nlp_opts, "num_threads", &num_threads);
+    if (solver_type == SQP_RTI)
+        ocp_nlp_solver_opts_set(config, nlp_opts, "rti_phase", &rti_phase);
+
+    ocp_nlp_solver *solver = ocp_nlp_solver_create(config, dims, nlp_opts, nlp_in);
+    int status = ocp_nlp_precompute(solver, nlp_in, nlp_out);
+
+    double u_init[NU] = {0.0};
+    acados_timer timer;
+    int solve_status = 0;
+    int sqp_iter = 0;
+
+    // first repetition is a warm up
+    for (int rep = -1; rep < nrep; rep++)
+    {
+        for (int i = 0; i <= N; i++)
+        {
+            ocp_nlp_out_set(config, dims, nlp_out, nlp_in, i, "x", x0);
+            if (i < N)
+                ocp_nlp_out_set(config, dims, nlp_out, nlp_in, i, "u", u_init);
+        }
+
+        acados_tic(&timer);
+        solve_status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+        if (rep >= 0)
+            samples[rep] = acados_toc(&timer);
+    }
+    ocp_nlp_get(solver, "sqp_iter", &sqp_iter);
+    // maximum number of iterations is not a failure for the purpose of timing
+    if (solve_status != ACADOS_SUCCESS && solve_status != ACADOS_MAXITER)
+        status = solve_status;
+
+    char params[160];
+    snprintf(params, sizeof(params),
+             "\"N\": %d, \"nx\": %d, \"nu\": %d, \"num_threads\": %d, \"sqp_iter\": %d",
+             N, nx_, nu_, num_threads, sqp_iter);
+    bench_json_record(json, name, params, status, samples, nrep);
+
+    /************************************************
+    * free memory
+    ************************************************/
+
+    ocp_nlp_solver_destroy(solver);
+    ocp_nlp_solver_opts_destroy(nlp_opts);
+    ocp_nlp_out_destroy(nlp_out);
+    ocp_nlp_in_destroy(nlp_in);
+    ocp_nlp_dims_destroy(dims);
+    ocp_nlp_config_destroy(config);
+    ocp_nlp_plan_destroy(plan);
+
+    bench_chain_model_free(&model);
+
+    free(nx);
+    free(nu);
+    free(nz);
+    free(ns);
+    free(x0);
+    free(xref);
+    free(Cyt);
+    free(W);
+    free(yref);
+    free(CytN);
+    free(WN);
+    free(idxbx0);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    const char *file;
+    int nrep;
+    bench_parse_args(argc, argv, "bench_ocp_nlp.json", NREP, &file, &nrep);
+
+    bench_json json;
+    if (bench_json_open(&json, file, "ocp_nlp"))
+        return 1;
+
+    double *samples = malloc(nrep * sizeof(double));
+
+    ocp_nlp_solver_t solvers[] = {SQP, SQP_RTI, DDP};
+    const char *names[] = {"SQP", "SQP_RTI", "DDP"};
+    int N_values[] = {10, 20, 40};
+#if defined(ACADOS_WITH_OPENMP) || defined(ACADOS_WITH_THREAD_POOL)
+    int num_threads_values[] = {1, 2, 4};
+#else
+    int num_threads_values[] = {1};
+#endif
+    int num_thread_values = sizeof(num_threads_values) / sizeof(num_threads_values[0]);
+
+    for (int k = 0; k < 3; k++)
+        for (int i = 0; i < 3; i++)
+            for (int nm = 1; nm <= 3; nm++)
+                for (int t = 0; t < num_thread_values; t++)
+                    bench_ocp_nlp_case(&json, solvers[k], names[k], N_values[i], nm,
+                                       num_threads_values[t], samples, nrep);
+
+    bench_json_close(&json);
+    free(samples);
+    return 0;
+}
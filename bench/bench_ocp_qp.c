@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/* Benchmark of the OCP QP solvers on the mass spring test problem for a range of horizons
+ * N and state dimensions nx. Each solve is cold started. With ACADOS_WITH_SINGLE_PRECISION,
+ * partial condensing HPIPM is also timed on the float path, PARTIAL_CONDENSING_HPIPM_SINGLE. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acados/utils/timing.h"
+#include "acados_c/ocp_qp_interface.h"
+
+#include "bench/bench_common.h"
+
+// mass spring helper functions, see examples/c/no_interface_examples/mass_spring_model
+ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
+ocp_qp_in *create_ocp_qp_in_mass_spring(ocp_qp_dims *dims);
+
+#define NREP 100
+
+
+
+static void bench_ocp_qp_case(bench_json *json, ocp_qp_solver_t solver_type, const char *name,
+                              int N, int nx, int cond_N, int single_precision, double *samples, int nrep)
+{
+    int nu = nx / 2 < 4 ? nx / 2 : 4;  // at most nx/2 for the mass spring system
+    int nb = nx + nu;
+    int ng = 0;
+    int ngN = nx / 2;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = solver_type;
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx, nu, nb, ng, ngN);
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(qp_dims->orig_dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_dims->orig_dims);
+
+    ocp_qp_xcond_solver_opts *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+
+    int iter_max = 100;
+    int warm_start = 0;
+    if (cond_N < N)
+        config->opts_set(config, opts, "cond_N", &cond_N);
+    config->opts_set(config, opts, "iter_max", &iter_max);
+    config->opts_set(config, opts, "warm_start", &warm_start);
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+    if (single_precision)
+        config->opts_set(config, opts, "single_precision", &single_precision);
+#endif
+
+    ocp_qp_solver *solver = ocp_qp_create(config, qp_dims, opts);
+
+    acados_timer timer;
+    int status = 0;
+
+    // warm up
+    status |= ocp_qp_solve(solver, qp_in, qp_out);
+
+    for (int rep = 0; rep < nrep; rep++)
+    {
+        acados_tic(&timer);
+        status |= ocp_qp_solve(solver, qp_in, qp_out);
+        samples[rep] = acados_toc(&timer);
+    }
+
+    char params[128];
+    snprintf(params, sizeof(params), "\"N\": %d, \"nx\": %d, \"nu\": %d, \"cond_N\": %d",
+             N, nx, nu, cond_N);
+    bench_json_record(json, name, params, status, samples, nrep);
+
+    ocp_qp_solver_destroy(solver);
+    ocp_qp_xcond_solver_opts_free(opts);
+    ocp_qp_out_free(qp_out);
+    ocp_qp_in_free(qp_in);
+    ocp_qp_xcond_solver_dims_free(qp_dims);
+    ocp_qp_xcond_solver_config_free(config);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    const char *file;
+    int nrep;
+    bench_parse_args(argc, argv, "bench_ocp_qp.json", NREP, &file, &nrep);
+
+    bench_json json;
+    if (bench_json_open(&json, file, "ocp_qp"))
+        return 1;
+
+    double *samples = malloc(nrep * sizeof(double));
+
+    ocp_qp_solver_t solvers[] =
+    {
+        PARTIAL_CONDENSING_HPIPM,
+        FULL_CONDENSING_HPIPM,
+#ifdef ACADOS_WITH_QPOASES
+        FULL_CONDENSING_QPOASES,
+#endif
+#ifdef ACADOS_WITH_DAQP
+        FULL_CONDENSING_DAQP,
+#endif
+#ifdef ACADOS_WITH_OSQP
+        PARTIAL_CONDENSING_OSQP,
+#endif
+    };
+    const char *names[] =
+    {
+        "PARTIAL_CONDENSING_HPIPM",
+        "FULL_CONDENSING_HPIPM",
+#ifdef ACADOS_WITH_QPOASES
+        "FULL_CONDENSING_QPOASES",
+#endif
+#ifdef ACADOS_WITH_DAQP
+        "FULL_CONDENSING_DAQP",
+#endif
+#ifdef ACADOS_WITH_OSQP
+        "PARTIAL_CONDENSING_OSQP",
+#endif
+    };
+    int num_solvers = sizeof(solvers) / sizeof(solvers[0]);
+
+    int N_values[] = {10, 20, 50};
+    int nx_values[] = {4, 8, 16};
+
+    for (int k = 0; k < num_solvers; k++)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                int N = N_values[i];
+                int nx = nx_values[j];
+                if (solvers[k] == PARTIAL_CONDENSING_HPIPM)
+                {
+                    // no condensing and a block size of 5 stages
+                    bench_ocp_qp_case(&json, solvers[k], names[k], N, nx, N, 0, samples, nrep);
+                    bench_ocp_qp_case(&json, solvers[k], names[k], N, nx, N / 5, 0, samples, nrep);
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+                    bench_ocp_qp_case(&json, solvers[k], "PARTIAL_CONDENSING_HPIPM_SINGLE",
+                                      N, nx, N / 5, 1, samples, nrep);
+#endif
+                }
+                else
+                {
+                    bench_ocp_qp_case(&json, solvers[k], names[k], N, nx, N, 0, samples, nrep);
+                }
+            }
+        }
+    }
+
+    bench_json_close(&json);
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/* Offline replay of QPs recorded with ocp_nlp_solver_qp_record_start, see
+ * acados/ocp_qp/ocp_qp_record.h. Every recorded qp_in is solved with every candidate of
+ * ocp_qp_autotune_default_candidates, or with the given qp solver and options, the latency of
+ * each solve is a sample. The solutions are compared against the recorded ones.
+ *
+ * command line: bench_qp_replay <recording> [output.json] [nrep] [qp_solver [field=value ...]]
+ * e.g. bench_qp_replay qp.rec out.json 10 PARTIAL_CONDENSING_HPIPM cond_N=5 iter_max=50 tol_stat=1e-8
+ * options are passed to ocp_qp_xcond_solver_opts_set, values with '.', 'e' or 'E' as double,
+ * all others as int. */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "blasfeo_d_aux.h"
+
+#include "acados/ocp_qp/ocp_qp_record.h"
+#include "acados/utils/timing.h"
+#include "acados_c/ocp_qp_interface.h"
+
+#include "bench/bench_common.h"
+
+#define NREP 10
+#define MAX_CANDIDATES 16
+#define MAX_PARAMS 1024
+
+
+
+// infinity norm of the difference of the primal solutions
+static double bench_qp_replay_ux_diff(ocp_qp_dims *dims, ocp_qp_out *a, ocp_qp_out *b)
+{
+    double diff = 0.0;
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        int nv = dims->nx[ii] + dims->nu[ii];
+        for (int jj = 0; jj < nv; jj++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->ux+ii, jj) - BLASFEO_DVECEL(b->ux+ii, jj)));
+    }
+    return diff;
+}
+
+
+
+// solves every qp_in nrep times with the given solver; config and opts are set up by the caller
+static void bench_qp_replay_solver(bench_json *json, const char *name, const char *solver_params,
+                                   ocp_qp_xcond_solver_config *config, ocp_qp_xcond_solver_dims *solver_dims,
+                                   void *opts, ocp_qp_dims *dims, int num_qp, ocp_qp_in **qp_in,
+                                   ocp_qp_out **qp_out_ref, int *status_ref, double *samples, int nrep)
+{
+    ocp_qp_solver *solver = ocp_qp_create(config, solver_dims, opts);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+    acados_timer timer;
+    int status = 0;
+    int status_mismatch = 0;
+    double max_ux_diff = 0.0;
+
+    for (int rep = 0; rep < nrep; rep++)
+    {
+        for (int k = 0; k < num_qp; k++)
+        {
+            acados_tic(&timer);
+            int qp_status = ocp_qp_solve(solver, qp_in[k], qp_out);
+            samples[rep * num_qp + k] = acados_toc(&timer);
+            status |= qp_status;
+
+            if (rep == 0 && qp_out_ref[k] != NULL)
+            {
+                if ((qp_status == ACADOS_SUCCESS) != (status_ref[k] == ACADOS_SUCCESS))
+                    status_mismatch++;
+                else if (qp_status == ACADOS_SUCCESS)
+                    max_ux_diff = fmax(max_ux_diff, bench_qp_replay_ux_diff(dims, qp_out, qp_out_ref[k]));
+            }
+        }
+    }
+
+    char params[MAX_PARAMS];
+    snprintf(params, sizeof(params),
+             "\"N\": %d, %s, \"num_qp\": %d, \"status_mismatch\": %d, \"max_ux_diff\": %e",
+             dims->N, solver_params, num_qp, status_mismatch, max_ux_diff);
+    bench_json_record(json, name, params, status, samples, nrep * num_qp);
+
+    ocp_qp_out_free(qp_out);
+    ocp_qp_solver_destroy(solver);
+}
+
+
+
+static void bench_qp_replay_candidate(bench_json *json, ocp_qp_autotune_candidate *cand,
+                                      ocp_qp_dims *dims, int num_qp, ocp_qp_in **qp_in,
+                                      ocp_qp_out **qp_out_ref, int *status_ref, double *samples, int nrep)
+{
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = cand->qp_solver;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *solver_dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(config, dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, solver_dims);
+    if (ocp_qp_solver_is_partial_condensing(cand->qp_solver))
+        ocp_qp_xcond_solver_opts_set(config, opts, "cond_N", &cand->cond_N);
+
+    char solver_params[64];
+    snprintf(solver_params, sizeof(solver_params), "\"cond_N\": %d", cand->cond_N);
+    bench_qp_replay_solver(json, ocp_qp_solver_name(cand->qp_solver), solver_params, config, solver_dims,
+                           opts, dims, num_qp, qp_in, qp_out_ref, status_ref, samples, nrep);
+
+    ocp_qp_xcond_solver_opts_free(opts);
+    ocp_qp_xcond_solver_dims_free(solver_dims);
+    ocp_qp_xcond_solver_config_free(config);
+}
+
+
+
+// replay with the qp solver named in argv[0] and the options field=value in argv[1:argc];
+// returns 1 for an unknown solver or a malformed option
+static int bench_qp_replay_user_solver(bench_json *json, int argc, char **argv, ocp_qp_dims *dims,
+                                       int num_qp, ocp_qp_in **qp_in, ocp_qp_out **qp_out_ref,
+                                       int *status_ref, double *samples, int nrep)
+{
+    ocp_qp_solver_plan_t plan;
+    for (plan.qp_solver = 0; plan.qp_solver < INVALID_QP_SOLVER; plan.qp_solver++)
+    {
+        if (!strcmp(ocp_qp_solver_name(plan.qp_solver), argv[0]))
+            break;
+    }
+    if (plan.qp_solver == INVALID_QP_SOLVER)
+    {
+        printf("\nerror: unknown or unavailable qp solver %s\n", argv[0]);
+        return 1;
+    }
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *solver_dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(config, dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, solver_dims);
+
+    char solver_params[MAX_PARAMS / 2] = "\"opts\": \"";
+    int status = 0;
+    for (int ii = 1; ii < argc; ii++)
+    {
+        char field[256];
+        const char *value = strchr(argv[ii], '=');
+        if (value == NULL || value == argv[ii] || value - argv[ii] >= (int) sizeof(field))
+        {
+            printf("\nerror: qp solver option %s is not of the form field=value\n", argv[ii]);
+            status = 1;
+            break;
+        }
+        memcpy(field, argv[ii], value - argv[ii]);
+        field[value - argv[ii]] = '\0';
+        value++;
+
+        if (strpbrk(value, ".eE") != NULL)
+        {
+            double double_value = atof(value);
+            ocp_qp_xcond_solver_opts_set(config, opts, field, &double_value);
+        }
+        else
+        {
+            int int_value = atoi(value);
+            ocp_qp_xcond_solver_opts_set(config, opts, field, &int_value);
+        }
+
+        size_t len = strlen(solver_params);
+        snprintf(solver_params + len, sizeof(solver_params) - len, "%s%s", ii > 1 ? " " : "", argv[ii]);
+    }
+
+    if (status == 0)
+    {
+        size_t len = strlen(solver_params);
+        snprintf(solver_params + len, sizeof(solver_params) - len, "\"");
+        bench_qp_replay_solver(json, argv[0], solver_params, config, solver_dims, opts, dims, num_qp,
+                               qp_in, qp_out_ref, status_ref, samples, nrep);
+    }
+
+    ocp_qp_xcond_solver_opts_free(opts);
+    ocp_qp_xcond_solver_dims_free(solver_dims);
+    ocp_qp_xcond_solver_config_free(config);
+
+    return status;
+}
+
+
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        printf("usage: %s <recording> [output.json] [nrep] [qp_solver [field=value ...]]\n", argv[0]);
+        return 1;
+    }
+
+    const char *file;
+    int nrep;
+    bench_parse_args(argc - 1, argv + 1, "bench_qp_replay.json", NREP, &file, &nrep);
+
+    ocp_qp_record_reader *reader = ocp_qp_record_reader_open(argv[1]);
+    if (reader == NULL)
+    {
+        printf("\nerror: cannot read QP recording %s\n", argv[1]);
+        return 1;
+    }
+
+    ocp_qp_dims *dims = ocp_qp_dims_create(ocp_qp_record_reader_N(reader));
+    ocp_qp_record_reader_dims_set(reader, dims);
+
+    // load all records, such that the timed solves do not include file access
+    int num_qp = ocp_qp_record_reader_num_records(reader, OCP_QP_RECORD_IN);
+    ocp_qp_in **qp_in = calloc(num_qp, sizeof(ocp_qp_in *));
+    ocp_qp_out **qp_out_ref = calloc(num_qp, sizeof(ocp_qp_out *));
+    int *status_ref = calloc(num_qp, sizeof(int));
+
+    int k = 0, kind, tag, status, flag;
+    ocp_qp_in *next_in = ocp_qp_in_create(dims);
+    ocp_qp_out *next_out = ocp_qp_out_create(dims);
+    while (k < num_qp && (flag = ocp_qp_record_reader_next(reader, next_in, next_out, &kind, &tag, &status)) == 0)
+    {
+        if (kind == OCP_QP_RECORD_IN)
+        {
+            qp_in[k] = next_in;
+            status_ref[k] = status;
+            next_in = ocp_qp_in_create(dims);
+            k++;
+        }
+        else if (k > 0 && qp_out_ref[k-1] == NULL)
+        {
+            qp_out_ref[k-1] = next_out;
+            next_out = ocp_qp_out_create(dims);
+        }
+    }
+    // a trailing qp_out record belongs to the last qp_in
+    if (k == num_qp && k > 0 && qp_out_ref[k-1] == NULL
+        && ocp_qp_record_reader_next(reader, NULL, next_out, &kind, &tag, &status) == 0
+        && kind == OCP_QP_RECORD_OUT)
+    {
+        qp_out_ref[k-1] = next_out;
+        next_out = NULL;
+    }
+    ocp_qp_in_free(next_in);
+    if (next_out != NULL)
+        ocp_qp_out_free(next_out);
+    ocp_qp_record_reader_close(reader);
+
+    if (k < num_qp)
+    {
+        printf("\nwarning: QP recording %s is corrupt, replaying the first %d of %d QPs\n",
+               argv[1], k, num_qp);
+        num_qp = k;
+    }
+    if (num_qp == 0)
+    {
+        printf("\nerror: QP recording %s contains no QPs\n", argv[1]);
+        return 1;
+    }
+
+    bench_json json;
+    if (bench_json_open(&json, file, "qp_replay"))
+        return 1;
+
+    int exit_status = 0;
+    double *samples = malloc(nrep * num_qp * sizeof(double));
+    if (argc > 4)
+    {
+        exit_status = bench_qp_replay_user_solver(&json, argc - 4, argv + 4, dims, num_qp, qp_in,
+                                                  qp_out_ref, status_ref, samples, nrep);
+    }
+    else
+    {
+        ocp_qp_autotune_candidate candidates[MAX_CANDIDATES];
+        int num_candidates = ocp_qp_autotune_default_candidates(dims->N, candidates, MAX_CANDIDATES);
+        if (num_candidates > MAX_CANDIDATES)
+            num_candidates = MAX_CANDIDATES;
+
+        for (int c = 0; c < num_candidates; c++)
+        {
+            bench_qp_replay_candidate(&json, &candidates[c], dims, num_qp, qp_in, qp_out_ref,
+                                      status_ref, samples, nrep);
+        }
+    }
+
+    bench_json_close(&json);
+
+    free(samples);
+    for (int ii = 0; ii < num_qp; ii++)
+    {
+        ocp_qp_in_free(qp_in[ii]);
+        if (qp_out_ref[ii] != NULL)
+            ocp_qp_out_free(qp_out_ref[ii]);
+    }
+    free(qp_in);
+    free(qp_out_ref);
+    free(status_ref);
+    ocp_qp_dims_free(dims);
+
+    return exit_status;
+}
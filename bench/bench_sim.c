@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/* Benchmark of the integrators (sim_solve) on the chain of masses (ERK, IRK, LIFTED_IRK,
+ * nx = 6, ..., 24) and on the wind turbine model with GNSF structure (nx = 3), and of the ERK
+ * batch mode (sim_solve_batch) against one sim_solve call per instance. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "acados/sim/sim_erk_integrator.h"
+#include "acados/utils/timing.h"
+#include "acados_c/external_function_interface.h"
+#include "acados_c/sim_interface.h"
+
+#include "bench/bench_chain_model.h"
+#include "bench/bench_common.h"
+
+// wind turbine model, x0 and u_sim
+#include "examples/c/wt_model_nx3/wt_model.h"
+#include "examples/c/wt_model_nx3/u_x0.c"
+
+#define NREP 200
+
+
+
+// run nrep integrations from the same initial value, return nonzero if any failed
+static int time_sim_solve(sim_solver *solver, sim_in *in, sim_out *out, double *samples, int nrep)
+{
+    int status = 0;
+    acados_timer timer;
+
+    // warm up
+    status |= sim_solve(solver, in, out);
+
+    for (int rep = 0; rep < nrep; rep++)
+    {
+        acados_tic(&timer);
+        status |= sim_solve(solver, in, out);
+        samples[rep] = acados_toc(&timer);
+    }
+    return status;
+}
+
+
+
+static void set_seeds(sim_in *in, int nx, int nu)
+{
+    for (int ii = 0; ii < nx * (nx + nu); ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+}
+
+
+
+static void bench_sim_chain(bench_json *json, sim_solver_t solver_type, const char *name,
+                            int num_free_masses, int num_steps, double *samples, int nrep)
+{
+    int nx = 6 * num_free_masses;
+    int nu = 3;
+    int nz = 0;
+
+    bench_chain_model model;
+    bench_chain_model_create(&model, num_free_masses);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = solver_type;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    sim_opts *opts = sim_opts_create(config, dims);
+    opts->ns = solver_type == ERK ? 4 : 2;
+    opts->num_steps = num_steps;
+    opts->sens_forw = true;
+    opts->sens_adj = false;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+    in->T = 0.2;
+
+    switch (solver_type)
+    {
+        case ERK:
+            config->model_set(in->model, "expl_vde_for", &model.expl_vde_for);
+            break;
+        case IRK:
+            config->model_set(in->model, "impl_ode_fun", &model.impl_ode_fun);
+            config->model_set(in->model, "impl_ode_fun_jac_x_xdot", &model.impl_ode_fun_jac_x_xdot);
+            config->model_set(in->model, "impl_ode_jac_x_xdot_u", &model.impl_ode_jac_x_xdot_u);
+            break;
+        case LIFTED_IRK:
+            config->model_set(in->model, "impl_ode_fun", &model.impl_ode_fun);
+            config->model_set(in->model, "impl_ode_fun_jac_x_xdot_u", &model.impl_ode_fun_jac_x_xdot_u);
+            break;
+        default:
+            printf("\nerror: bench_sim_chain: integrator not supported\n");
+            exit(1);
+    }
+
+    bench_chain_x0(num_free_masses, in->x);
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = 0.1;
+    set_seeds(in, nx, nu);
+
+    sim_solver *solver = sim_solver_create(config, dims, opts, in);
+    int status = sim_precompute(solver, in, out);
+    status |= time_sim_solve(solver, in, out, samples, nrep);
+
+    char params[128];
+    snprintf(params, sizeof(params), "\"nx\": %d, \"nu\": %d, \"num_steps\": %d, \"ns\": %d",
+             nx, nu, num_steps, opts->ns);
+    bench_json_record(json, name, params, status, samples, nrep);
+
+    sim_solver_destroy(solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+    bench_chain_model_free(&model);
+}
+
+
+
+// sim_solve_batch against one sim_solve call per instance, ERK with forward sensitivities
+static void bench_sim_erk_batch(bench_json *json, int num_free_masses, int num_instances,
+                                double *samples, int nrep)
+{
+    int nx = 6 * num_free_masses;
+    int nu = 3;
+    int nz = 0;
+
+    bench_chain_model model;
+    bench_chain_model_create(&model, num_free_masses);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    sim_opts *opts = sim_opts_create(config, dims);
+    opts->ns = 4;
+    opts->num_steps = 4;
+    opts->sens_forw = true;
+    opts->sens_adj = false;
+
+    sim_in **in = malloc(num_instances * sizeof(sim_in *));
+    sim_out **out = malloc(num_instances * sizeof(sim_out *));
+    for (int k = 0; k < num_instances; k++)
+    {
+        in[k] = sim_in_create(config, dims);
+        out[k] = sim_out_create(config, dims);
+        in[k]->T = 0.2;
+        config->model_set(in[k]->model, "expl_vde_for", &model.expl_vde_for);
+        bench_chain_x0(num_free_masses, in[k]->x);
+        in[k]->x[0] += 0.01 * k;
+        for (int ii = 0; ii < nu; ii++)
+            in[k]->u[ii] = 0.1;
+        set_seeds(in[k], nx, nu);
+    }
+
+    sim_solver *solver = sim_solver_create(config, dims, opts, in[0]);
+    int status = sim_precompute(solver, in[0], out[0]);
+    acados_timer timer;
+
+    char params[128];
+    snprintf(params, sizeof(params), "\"nx\": %d, \"nu\": %d, \"num_instances\": %d, \"lanes\": %d",
+             nx, nu, num_instances, SIM_ERK_BATCH_LANES);
+
+    // batch
+    int status_batch = status | sim_solve_batch(solver, in, out, num_instances);
+    for (int rep = 0; rep < nrep; rep++)
+    {
+        acados_tic(&timer);
+        status_batch |= sim_solve_batch(solver, in, out, num_instances);
+        samples[rep] = acados_toc(&timer);
+    }
+    bench_json_record(json, "ERK_batch", params, status_batch, samples, nrep);
+
+    // per instance
+    int status_single = status;
+    for (int k = 0; k < num_instances; k++)
+        status_single |= sim_solve(solver, in[k], out[k]);
+    for (int rep = 0; rep < nrep; rep++)
+    {
+        acados_tic(&timer);
+        for (int k = 0; k < num_instances; k++)
+            status_single |= sim_solve(solver, in[k], out[k]);
+        samples[rep] = acados_toc(&timer);
+    }
+    bench_json_record(json, "ERK_per_instance", params, status_single, samples, nrep);
+
+    sim_solver_destroy(solver);
+    for (int k = 0; k < num_instances; k++)
+    {
+        sim_in_destroy(in[k]);
+        sim_out_destroy(out[k]);
+    }
+    free(in);
+    free(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+    bench_chain_model_free(&model);
+}
+
+
+
+static void bench_sim_gnsf_wt(bench_json *json, int num_steps, double *samples, int nrep)
+{
+    int nx = 3;
+    int nu = 4;
+    int nz = 0;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    external_function_casadi phi_fun, phi_fun_jac_y, phi_jac_y_uhat, f_lo_fun_jac_x1k1uz, get_matrices_fun;
+    BENCH_SET_CASADI_FUN(phi_fun, casadi_phi_fun);
+    BENCH_SET_CASADI_FUN(phi_fun_jac_y, casadi_phi_fun_jac_y);
+    BENCH_SET_CASADI_FUN(phi_jac_y_uhat, casadi_phi_jac_y_uhat);
+    BENCH_SET_CASADI_FUN(f_lo_fun_jac_x1k1uz, casadi_f_lo_fun_jac_x1k1uz);
+    BENCH_SET_CASADI_FUN(get_matrices_fun, casadi_get_matrices_fun);
+    external_function_casadi_create(&phi_fun, &ext_fun_opts);
+    external_function_casadi_create(&phi_fun_jac_y, &ext_fun_opts);
+    external_function_casadi_create(&phi_jac_y_uhat, &ext_fun_opts);
+    external_function_casadi_create(&f_lo_fun_jac_x1k1uz, &ext_fun_opts);
+    external_function_casadi_create(&get_matrices_fun, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = GNSF;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    int nx1 = nx;
+    int nz1 = 0;
+    int nout = 1;
+    int ny = nx;
+    int nuhat = nu;
+    sim_dims_set(config, dims, "nx1", &nx1);
+    sim_dims_set(config, dims, "nz1", &nz1);
+    sim_dims_set(config, dims, "nout", &nout);
+    sim_dims_set(config, dims, "ny", &ny);
+    sim_dims_set(config, dims, "nuhat", &nuhat);
+
+    sim_opts *opts = sim_opts_create(config, dims);
+    opts->ns = 2;
+    opts->num_steps = num_steps;
+    opts->jac_reuse = true;
+    opts->newton_iter = 3;
+    opts->sens_forw = true;
+    opts->sens_adj = false;
+
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out = sim_out_create(config, dims);
+    in->T = 0.05;
+
+    config->model_set(in->model, "phi_fun", &phi_fun);
+    config->model_set(in->model, "phi_fun_jac_y", &phi_fun_jac_y);
+    config->model_set(in->model, "phi_jac_y_uhat", &phi_jac_y_uhat);
+    config->model_set(in->model, "f_lo_jac_x1_x1dot_u_z", &f_lo_fun_jac_x1k1uz);
+    config->model_set(in->model, "get_gnsf_matrices", &get_matrices_fun);
+
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+    set_seeds(in, nx, nu);
+
+    sim_solver *solver = sim_solver_create(config, dims, opts, in);
+    int status = sim_precompute(solver, in, out);
+    status |= time_sim_solve(solver, in, out, samples, nrep);
+
+    char params[128];
+    snprintf(params, sizeof(params), "\"nx\": %d, \"nu\": %d, \"num_steps\": %d, \"ns\": %d",
+             nx, nu, num_steps, opts->ns);
+    bench_json_record(json, "GNSF", params, status, samples, nrep);
+
+    sim_solver_destroy(solver);
+    sim_in_destroy(in);
+    sim_out_destroy(out);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&phi_fun);
+    external_function_casadi_free(&phi_fun_jac_y);
+    external_function_casadi_free(&phi_jac_y_uhat);
+    external_function_casadi_free(&f_lo_fun_jac_x1k1uz);
+    external_function_casadi_free(&get_matrices_fun);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    const char *file;
+    int nrep;
+    bench_parse_args(argc, argv, "bench_sim.json", NREP, &file, &nrep);
+
+    bench_json json;
+    if (bench_json_open(&json, file, "sim"))
+        return 1;
+
+    double *samples = malloc(nrep * sizeof(double));
+
+    sim_solver_t solvers[] = {ERK, IRK, LIFTED_IRK};
+    const char *names[] = {"ERK", "IRK", "LIFTED_IRK"};
+    int num_steps_values[] = {1, 4};
+
+    for (int k = 0; k < 3; k++)
+        for (int nm = 1; nm <= BENCH_CHAIN_MAX_FREE_MASSES; nm++)
+            for (int j = 0; j < 2; j++)
+                bench_sim_chain(&json, solvers[k], names[k], nm, num_steps_values[j], samples, nrep);
+
+    for (int j = 0; j < 2; j++)
+        bench_sim_gnsf_wt(&json, num_steps_values[j], samples, nrep);
+
+    // batch mode, the gain is bounded by the share of the RK combinations in the ERK step
+    for (int nm = 1; nm <= BENCH_CHAIN_MAX_FREE_MASSES; nm++)
+        bench_sim_erk_batch(&json, nm, 4 * SIM_ERK_BATCH_LANES, samples, nrep);
+
+    bench_json_close(&json);
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+/* Benchmark of the stage-parallel loop backends on a synthetic stage loop: serial, the acados
+ * thread pool (static and work stealing) and OpenMP, for a range of horizons N, stage sizes nx
+ * and numbers of threads. The stage body is a dense matrix-vector product on per-stage data, as
+ * a stand-in for the stage evaluations of ocp_nlp. The thread pool cases need acados compiled
+ * with ACADOS_WITH_THREAD_POOL, the OpenMP cases a compiler with OpenMP support. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "acados/utils/thread_pool.h"
+#include "acados/utils/timing.h"
+
+#include "bench/bench_common.h"
+
+#define NREP 1000
+
+
+
+typedef struct
+{
+    int nx;
+    double *A;  // nx x nx per stage
+    double *x;  // nx per stage
+    double *y;  // nx per stage
+} bench_stage_data;
+
+
+
+static void bench_stage_fun(void *args, int i)
+{
+    bench_stage_data *data = args;
+    int nx = data->nx;
+    double *A = data->A + i * nx * nx;
+    double *x = data->x + i * nx;
+    double *y = data->y + i * nx;
+
+    for (int r = 0; r < nx; r++)
+    {
+        double tmp = 0.0;
+        for (int c = 0; c < nx; c++)
+            tmp += A[r + c * nx] * x[c];
+        y[r] = tmp;
+    }
+}
+
+
+
+static void bench_stage_data_create(bench_stage_data *data, int n, int nx)
+{
+    data->nx = nx;
+    data->A = malloc(n * nx * nx * sizeof(double));
+    data->x = malloc(n * nx * sizeof(double));
+    data->y = malloc(n * nx * sizeof(double));
+    for (int k = 0; k < n * nx * nx; k++)
+        data->A[k] = 1.0 / (1 + k % 7);
+    for (int k = 0; k < n * nx; k++)
+        data->x[k] = 1.0;
+}
+
+
+
+static void bench_stage_data_free(bench_stage_data *data)
+{
+    free(data->A);
+    free(data->x);
+    free(data->y);
+}
+
+
+
+// backend: 0 serial, 1 thread pool, 2 thread pool with work stealing, 3 OpenMP
+static void bench_stage_loop(bench_json *json, const char *name, int backend, int N, int nx,
+                             int num_threads, double *samples, int nrep)
+{
+    int n = N + 1;
+    bench_stage_data data;
+    bench_stage_data_create(&data, n, nx);
+
+    acados_thread_pool *pool = NULL;
+    if (backend == 1 || backend == 2)
+        pool = acados_thread_pool_create(num_threads, 0);
+
+    acados_timer timer;
+    for (int rep = -1; rep < nrep; rep++)
+    {
+        acados_tic(&timer);
+        if (backend == 0)
+        {
+            for (int i = 0; i < n; i++)
+                bench_stage_fun(&data, i);
+        }
+        else if (backend == 1)
+        {
+            acados_thread_pool_run(pool, n, &bench_stage_fun, &data);
+        }
+        else if (backend == 2)
+        {
+            acados_thread_pool_run_stealing(pool, n, &bench_stage_fun, &data);
+        }
+        else
+        {
+#if defined(_OPENMP)
+            #pragma omp parallel for num_threads(num_threads)
+#endif
+            for (int i = 0; i < n; i++)
+                bench_stage_fun(&data, i);
+        }
+        // rep = -1 warms up the threads
+        if (rep >= 0)
+            samples[rep] = acados_toc(&timer);
+    }
+
+    char params[128];
+    snprintf(params, sizeof(params), "\"N\": %d, \"nx\": %d, \"num_threads\": %d",
+             N, nx, backend == 0 ? 1 : num_threads);
+    bench_json_record(json, name, params, 0, samples, nrep);
+
+    acados_thread_pool_destroy(pool);
+    bench_stage_data_free(&data);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    const char *file;
+    int nrep;
+    bench_parse_args(argc, argv, "bench_thread_pool.json", NREP, &file, &nrep);
+
+    bench_json json;
+    if (bench_json_open(&json, file, "thread_pool"))
+        return 1;
+
+    double *samples = malloc(nrep * sizeof(double));
+
+    int N_values[] = {20, 100};
+    int nx_values[] = {8, 32};
+    int num_threads_values[] = {2, 4};
+
+    for (int iN = 0; iN < 2; iN++)
+    {
+        for (int ix = 0; ix < 2; ix++)
+        {
+            int N = N_values[iN];
+            int nx = nx_values[ix];
+            bench_stage_loop(&json, "serial", 0, N, nx, 1, samples, nrep);
+            for (int it = 0; it < 2; it++)
+            {
+                int num_threads = num_threads_values[it];
+#if defined(ACADOS_WITH_THREAD_POOL)
+                bench_stage_loop(&json, "thread_pool", 1, N, nx, num_threads, samples, nrep);
+                bench_stage_loop(&json, "thread_pool_stealing", 2, N, nx, num_threads, samples, nrep);
+#endif
+#if defined(_OPENMP)
+                bench_stage_loop(&json, "openmp", 3, N, nx, num_threads, samples, nrep);
+#endif
+            }
+        }
+    }
+
+    bench_json_close(&json);
+    free(samples);
+    return 0;
+}
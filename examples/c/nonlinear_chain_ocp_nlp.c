@@ -1413,6 +1413,44 @@ int main()
 	printf("\ntotal time         = %f ms\n", time_tot*1e3);
 	printf("\n\n");
 
+    /************************************************
+    * benchmark: separate vs. fused stage evaluations
+    ************************************************/
+
+    // NOTE: with fuse_stage_evaluations, time_lin includes the computation of the NLP residuals,
+    // which are done in the same pass over the stages.
+    for (int fuse = 0; fuse < 2; fuse++)
+    {
+        ocp_nlp_solver_opts_set(config, nlp_opts, "fuse_stage_evaluations", &fuse);
+
+        double time_lin_sum = 0.0;
+        double time_tot_sum = 0.0;
+        int sqp_iter_sum = 0;
+
+        for (int rep = 0; rep < NREP; rep++)
+        {
+            for (int i=0; i<=NN; i++)
+            {
+                blasfeo_pack_dvec(nu[i], uref, 1, nlp_out->ux+i, 0);
+                blasfeo_pack_dvec(nx[i], xref, 1, nlp_out->ux+i, nu[i]);
+            }
+
+            status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+
+            ocp_nlp_get(solver, "sqp_iter", &sqp_iter);
+            ocp_nlp_get(solver, "time_lin", &time_lin);
+            ocp_nlp_get(solver, "time_tot", &time_tot);
+            time_lin_sum += time_lin;
+            time_tot_sum += time_tot;
+            sqp_iter_sum += sqp_iter;
+        }
+        sqp_iter_sum = sqp_iter_sum > 0 ? sqp_iter_sum : 1;
+
+        printf("fuse_stage_evaluations = %d: %d SQP iterations, per SQP iteration: lin %f us, total %f us\n",
+            fuse, sqp_iter_sum, time_lin_sum/sqp_iter_sum*1e6, time_tot_sum/sqp_iter_sum*1e6);
+    }
+    printf("\n\n");
+
     for (int k =0; k < 3; k++) {
         printf("u[%d] = \n", k);
         ocp_nlp_out_get(config, dims, nlp_out, k, "u", specific_u);
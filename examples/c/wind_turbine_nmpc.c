@@ -55,6 +55,8 @@
 
 #define MAX_SQP_ITERS 10
 #define NREP 1
+// linearize, fill QP and compute residuals in one pass over the stages
+#define FUSE_STAGE_EVALUATIONS 0
 
 
 
@@ -827,6 +829,9 @@ int main()
         ocp_nlp_solver_opts_set(config, nlp_opts, "tol_eq", &tol_eq);
         ocp_nlp_solver_opts_set(config, nlp_opts, "tol_ineq", &tol_ineq);
         ocp_nlp_solver_opts_set(config, nlp_opts, "tol_comp", &tol_comp);
+
+        int fuse_stage_evaluations = FUSE_STAGE_EVALUATIONS;
+        ocp_nlp_solver_opts_set(config, nlp_opts, "fuse_stage_evaluations", &fuse_stage_evaluations);
     }
     else if (plan->nlp_solver == SQP_RTI)
     {
@@ -920,6 +925,10 @@ int main()
     double *x_sim = malloc(nx_*(n_sim+1)*sizeof(double));
     double *u_sim = malloc(nu_*(n_sim+0)*sizeof(double));
 
+    // accumulated linearization time and iterations, to compare FUSE_STAGE_EVALUATIONS 0 / 1
+    double time_lin_sum = 0.0;
+    int sqp_iter_sum = 0;
+
     acados_timer timer;
     acados_tic(&timer);
 
@@ -1004,6 +1013,9 @@ int main()
                 ocp_nlp_get(solver, "time_qp_sol", &time_qp_sol);
                 ocp_nlp_get(solver, "time_lin", &time_lin);
 
+                time_lin_sum += time_lin;
+                sqp_iter_sum += sqp_iter;
+
                 printf("\nproblem #%d, status %d, iters %d, time (total %f, lin %f, qp_sol %f) ms\n",
                     idx, status, sqp_iter, time_tot*1e3, time_lin*1e3, time_qp_sol*1e3);
 
@@ -1039,6 +1051,8 @@ int main()
     double time = acados_toc(&timer)/NREP;
 
     printf("\n\ntotal time (including printing) = %f ms (time per SQP = %f)\n\n", time*1e3, time*1e3/n_sim);
+    printf("fuse_stage_evaluations = %d: linearization time per SQP iteration = %f us\n\n",
+        FUSE_STAGE_EVALUATIONS, time_lin_sum/(sqp_iter_sum > 0 ? sqp_iter_sum : 1)*1e6);
 
 #if 0
     d_print_mat(nx_, n_sim+1, x_sim, nx_);
@@ -60,8 +60,10 @@
 #include "acados/ocp_nlp/ocp_nlp_sqp_with_feasible_qp.h"
 #include "acados/ocp_nlp/ocp_nlp_sqp_rti.h"
 #include "acados/ocp_nlp/ocp_nlp_ddp.h"
+#include "acados/ocp_nlp/ocp_nlp_warm_start_cache.h"
 #include "acados/utils/mem.h"
 #include "acados/utils/strsep.h"
+#include "acados/utils/timing.h"
 
 // blasfeo
 #include "blasfeo/include/blasfeo_d_blas.h"
@@ -148,6 +150,9 @@ static void ocp_nlp_plan_initialize_default(ocp_nlp_plan_t *plan)
     // globalization: fixed step by default
     plan->globalization = FIXED_STEP;
 
+    // heap allocation by default
+    plan->arena = NULL;
+
     return;
 }
 
@@ -179,6 +184,30 @@ void ocp_nlp_plan_destroy(void* plan_)
 * config
 ************************************************/
 
+// zero initialized memory from the arena if given, from the heap otherwise
+static void *ocp_nlp_arena_or_heap_alloc(acados_arena *arena, acados_size_t bytes)
+{
+    void *ptr;
+    if (arena)
+    {
+        ptr = acados_arena_alloc(arena, bytes);
+        if (ptr == NULL)
+        {
+            printf("\nerror: ocp_nlp arena exhausted, requested %zu bytes, available %zu bytes\n",
+                (size_t) bytes, (size_t) (arena->size - arena->used));
+            exit(1);
+        }
+    }
+    else
+    {
+        ptr = acados_calloc(1, bytes);
+        assert(ptr != 0);
+    }
+    return ptr;
+}
+
+
+
 ocp_nlp_config *ocp_nlp_config_create(ocp_nlp_plan_t plan)
 {
     int N = plan.N;
@@ -186,9 +215,9 @@ ocp_nlp_config *ocp_nlp_config_create(ocp_nlp_plan_t plan)
     /* calculate_size & malloc & assign */
 
     acados_size_t bytes = ocp_nlp_config_calculate_size(N);
-    void *config_mem = acados_calloc(1, bytes);
-    assert(config_mem != 0);
+    void *config_mem = ocp_nlp_arena_or_heap_alloc(plan.arena, bytes);
     ocp_nlp_config *config = ocp_nlp_config_assign(N, config_mem);
+    config->arena = plan.arena;
 
     /* initialize config according plan */
 
@@ -371,6 +400,9 @@ ocp_nlp_config *ocp_nlp_config_create(ocp_nlp_plan_t plan)
 
 void ocp_nlp_config_destroy(void *config_)
 {
+    ocp_nlp_config *config = config_;
+    if (config->arena)
+        return;
     free(config_);
 }
 
@@ -379,17 +411,25 @@ void ocp_nlp_config_destroy(void *config_)
 * dims
 ************************************************/
 
+// zeroed memory from the arena of the config if set, else from the heap
+static void *ocp_nlp_config_alloc(ocp_nlp_config *config, acados_size_t bytes)
+{
+    return ocp_nlp_arena_or_heap_alloc(config->arena, bytes);
+}
+
+
+
 ocp_nlp_dims *ocp_nlp_dims_create(void *config_)
 {
     ocp_nlp_config *config = config_;
 
     acados_size_t bytes = ocp_nlp_dims_calculate_size(config);
 
-    void *ptr = acados_calloc(1, bytes);
-    assert(ptr != 0);
+    void *ptr = ocp_nlp_config_alloc(config, bytes);
 
     ocp_nlp_dims *dims = ocp_nlp_dims_assign(config, ptr);
-    dims->raw_memory = ptr;
+    // raw_memory is only freed if owned
+    dims->raw_memory = config->arena ? NULL : ptr;
 
     return dims;
 }
@@ -412,11 +452,10 @@ ocp_nlp_in *ocp_nlp_in_create(ocp_nlp_config *config, ocp_nlp_dims *dims)
 {
     acados_size_t bytes = ocp_nlp_in_calculate_size(config, dims);
 
-    void *ptr = acados_calloc(1, bytes);
-    assert(ptr != 0);
+    void *ptr = ocp_nlp_config_alloc(config, bytes);
 
     ocp_nlp_in *nlp_in = ocp_nlp_in_assign(config, dims, ptr);
-    nlp_in->raw_memory = ptr;
+    nlp_in->raw_memory = config->arena ? NULL : ptr;
 
     return nlp_in;
 }
@@ -434,6 +473,8 @@ void ocp_nlp_in_destroy(void *in_)
 void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         const char *field, void *value)
 {
+    ocp_nlp_in_wait_async(in);
+
     if (!strcmp(field, "Ts"))
     {
         double *Ts_value = value;
@@ -452,6 +493,7 @@ void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
         printf("\nerror: ocp_nlp_in_set: field %s not available\n", field);
         exit(1);
     }
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
     return;
 }
 
@@ -459,10 +501,13 @@ void ocp_nlp_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
 void ocp_nlp_in_set_params_sparse(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, int stage,
         int *idx, double *p, int n_update)
 {
+    ocp_nlp_in_wait_async(in);
+
     for (int ii = 0; ii < n_update; ii++)
     {
         in->parameter_values[stage][idx[ii]] = p[ii];
     }
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
 
     return;
 }
@@ -480,8 +525,12 @@ void ocp_nlp_in_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
     }
     else if (!strcmp(field, "parameter_pointer"))
     {
+        // the caller may write through the pointer, so the stage is conservatively marked as changed;
+        // writes after the next solver call require another ocp_nlp_in_stage_changed
+        ocp_nlp_in_wait_async(in);
         double **ptr = value;
         ptr[0] = in->parameter_values[stage];
+        ocp_nlp_in_stage_changed(dims, in, stage, false);
     }
     else if (!strcmp(field, "p"))
     {
@@ -503,19 +552,44 @@ void ocp_nlp_in_get(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
 int ocp_nlp_dynamics_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
         int stage, const char *field, void *value)
 {
+    ocp_nlp_in_wait_async(in);
+
     ocp_nlp_dynamics_config *dynamics_config = config->dynamics[stage];
 
     dynamics_config->model_set(dynamics_config, dims->dynamics[stage], in->dynamics[stage], field, value);
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
 
     return ACADOS_SUCCESS;
 }
 
 
 
+static bool ocp_nlp_cost_field_is_vector(const char *field)
+{
+    const char *vector_fields[] = {"y_ref", "yref", "z", "zl", "zu"};
+    int num_vector_fields = sizeof(vector_fields) / sizeof(vector_fields[0]);
+
+    for (int ii = 0; ii < num_vector_fields; ii++)
+    {
+        if (!strcmp(field, vector_fields[ii]))
+            return true;
+    }
+    return false;
+}
+
+
+
 int ocp_nlp_cost_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *value)
 {
+    ocp_nlp_in_wait_async(in);
+
     ocp_nlp_cost_config *cost_config = config->cost[stage];
+    // reference and linear slack penalties only enter the cost gradient, not the QP matrices
+    if (ocp_nlp_cost_field_is_vector(field))
+        ocp_nlp_in_cost_vectors_changed(dims, in, stage);
+    else
+        ocp_nlp_in_stage_changed(dims, in, stage, false);
     return cost_config->model_set(cost_config, dims->cost[stage], in->cost[stage], field, value);
 }
 
@@ -526,9 +600,28 @@ int ocp_nlp_cost_model_get(ocp_nlp_config *config, ocp_nlp_dims *dims,
     return cost_config->model_get(cost_config, dims->cost[stage], in->cost[stage], field, value);
 }
 
+static bool ocp_nlp_constraints_field_is_bound(const char *field)
+{
+    const char *bound_fields[] = {"lbx", "ubx", "lbu", "ubu", "lg", "ug", "lh", "uh", "lphi", "uphi",
+        "lsbu", "usbu", "lsbx", "usbx", "lsg", "usg", "lsh", "ush", "lsphi", "usphi"};
+    int num_bound_fields = sizeof(bound_fields) / sizeof(bound_fields[0]);
+
+    for (int ii = 0; ii < num_bound_fields; ii++)
+    {
+        if (!strcmp(field, bound_fields[ii]))
+            return true;
+    }
+    return false;
+}
+
+
+
 int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, ocp_nlp_out *out, int stage, const char *field, void *value)
 {
+    ocp_nlp_in_wait_async(in);
+    ocp_nlp_out_wait_async(out);
+
     ocp_nlp_constraints_config *constr_config = config->constraints[stage];
 
     // this updates both the bounds and the mask
@@ -536,6 +629,8 @@ int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
             in->constraints[stage], field, value);
     // multiply lam with new mask to ensure that multipliers associated with masked constraints are zero.
     blasfeo_dvecmul(2*dims->ni[stage], &in->dmask[stage], 0, &out->lam[stage], 0, &out->lam[stage], 0);
+    // bounds and mask only enter the constraint values, not the QP matrices
+    ocp_nlp_in_stage_changed(dims, in, stage, ocp_nlp_constraints_field_is_bound(field));
 
     return status;
 }
@@ -544,6 +639,8 @@ int ocp_nlp_constraints_model_set(ocp_nlp_config *config, ocp_nlp_dims *dims,
 int ocp_nlp_dynamics_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in,
         int stage, const char *field, void *ext_fun_)
 {
+    ocp_nlp_in_wait_async(in);
+
     ocp_nlp_dynamics_config *dynamics_config = config->dynamics[stage];
     external_function_external_param_generic * ext_fun = (external_function_external_param_generic *) ext_fun_;
 
@@ -553,6 +650,7 @@ int ocp_nlp_dynamics_model_set_external_param_fun(ocp_nlp_config *config, ocp_nl
         ext_fun->set_global_data_pointer(ext_fun, in->global_data);
 
     dynamics_config->model_set(dynamics_config, dims->dynamics[stage], in->dynamics[stage], field, ext_fun);
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
 
     return ACADOS_SUCCESS;
 }
@@ -562,6 +660,8 @@ int ocp_nlp_dynamics_model_set_external_param_fun(ocp_nlp_config *config, ocp_nl
 int ocp_nlp_cost_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *ext_fun_)
 {
+    ocp_nlp_in_wait_async(in);
+
     ocp_nlp_cost_config *cost_config = config->cost[stage];
     external_function_external_param_generic * ext_fun = (external_function_external_param_generic *) ext_fun_;
 
@@ -570,6 +670,7 @@ int ocp_nlp_cost_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_di
     if (dims->n_global_data > 0)
         ext_fun->set_global_data_pointer(ext_fun, in->global_data);
 
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
     return cost_config->model_set(cost_config, dims->cost[stage], in->cost[stage], field, ext_fun);
 
 }
@@ -579,6 +680,8 @@ int ocp_nlp_cost_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_di
 int ocp_nlp_constraints_model_set_external_param_fun(ocp_nlp_config *config, ocp_nlp_dims *dims,
         ocp_nlp_in *in, int stage, const char *field, void *ext_fun_)
 {
+    ocp_nlp_in_wait_async(in);
+
     ocp_nlp_constraints_config *constr_config = config->constraints[stage];
     external_function_external_param_generic * ext_fun = (external_function_external_param_generic *) ext_fun_;
 
@@ -587,6 +690,7 @@ int ocp_nlp_constraints_model_set_external_param_fun(ocp_nlp_config *config, ocp
     if (dims->n_global_data > 0)
         ext_fun->set_global_data_pointer(ext_fun, in->global_data);
 
+    ocp_nlp_in_stage_changed(dims, in, stage, false);
     return constr_config->model_set(constr_config, dims->constraints[stage],
             in->constraints[stage], field, ext_fun);
 }
@@ -614,11 +718,10 @@ ocp_nlp_out *ocp_nlp_out_create(ocp_nlp_config *config, ocp_nlp_dims *dims)
 {
     acados_size_t bytes = ocp_nlp_out_calculate_size(config, dims);
 
-    void *ptr = acados_calloc(1, bytes);
-    assert(ptr != 0);
+    void *ptr = ocp_nlp_config_alloc(config, bytes);
 
     ocp_nlp_out *nlp_out = ocp_nlp_out_assign(config, dims, ptr);
-    nlp_out->raw_memory = ptr;
+    nlp_out->raw_memory = config->arena ? NULL : ptr;
 
     return nlp_out;
 }
@@ -636,6 +739,8 @@ void ocp_nlp_out_destroy(void *out_)
 void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out, ocp_nlp_in *in,
         int stage, const char *field, void *value)
 {
+    ocp_nlp_out_wait_async(out);
+
     double *double_values = value;
     if (!strcmp(field, "x"))
     {
@@ -679,6 +784,8 @@ void ocp_nlp_out_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *ou
 
 void ocp_nlp_out_set_values_to_zero(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_out *out)
 {
+    ocp_nlp_out_wait_async(out);
+
     int N = dims->N;
     for (int i = 0; i<=N; i++)
     {
@@ -1198,14 +1305,27 @@ void ocp_nlp_cost_dims_get_from_attr(ocp_nlp_config *config, ocp_nlp_dims *dims,
 * opts
 ************************************************/
 
+// the options do not know their config, a header in front of them holds the owned raw memory
+#define OCP_NLP_OPTS_HEADER_SIZE 64
+
+static acados_size_t ocp_nlp_solver_opts_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims)
+{
+    return OCP_NLP_OPTS_HEADER_SIZE + config->opts_calculate_size(config, dims);
+}
+
+
+
 void *ocp_nlp_solver_opts_create(ocp_nlp_config *config, ocp_nlp_dims *dims)
 {
-    acados_size_t bytes = config->opts_calculate_size(config, dims);
+    acados_size_t bytes = ocp_nlp_solver_opts_calculate_size(config, dims);
 
-    void *ptr = acados_calloc(1, bytes);
-    assert(ptr != 0);
+    char *ptr = ocp_nlp_config_alloc(config, bytes);
+
+    // raw_memory is only freed if owned
+    *((void **) ptr) = config->arena ? NULL : ptr;
 
-    void *opts = config->opts_assign(config, dims, ptr);
+    void *opts = config->opts_assign(config, dims, ptr + OCP_NLP_OPTS_HEADER_SIZE);
+    assert((char *) opts == ptr + OCP_NLP_OPTS_HEADER_SIZE);
 
     config->opts_initialize_default(config, dims, opts);
 
@@ -1234,7 +1354,8 @@ void ocp_nlp_solver_opts_set_at_stage(ocp_nlp_config *config, void *opts_, int s
 
 void ocp_nlp_solver_opts_destroy(void *opts)
 {
-    free(opts);
+    void *raw_memory = *((void **) ((char *) opts - OCP_NLP_OPTS_HEADER_SIZE));
+    free(raw_memory);
 }
 
 
@@ -1287,19 +1408,88 @@ ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims
 
     acados_size_t bytes = ocp_nlp_calculate_size(config, dims, opts_, nlp_in);
 
-    void *ptr = acados_calloc(1, bytes);
-    assert(ptr != 0);
+    void *ptr = ocp_nlp_config_alloc(config, bytes);
 
     ocp_nlp_solver *solver = ocp_nlp_assign(config, dims, opts_, nlp_in, ptr);
 
+    // persistent worker pool for stage-parallel loops
+    ocp_nlp_opts *nlp_opts;
+    ocp_nlp_memory *nlp_mem;
+    config->opts_get(config, dims, opts_, "nlp_opts", &nlp_opts);
+    config->get(config, dims, solver->mem, "nlp_mem", &nlp_mem);
+    nlp_mem->thread_pool = acados_thread_pool_create(nlp_opts->num_threads, nlp_opts->pin_threads);
+    config->qp_solver->memory_set(config->qp_solver, nlp_mem->qp_solver_mem, "thread_pool", nlp_mem->thread_pool);
+    config->regularize->memory_set(config->regularize, dims->regularize, nlp_mem->regularize, "thread_pool", nlp_mem->thread_pool);
+
+    if (nlp_opts->print_level > 1)
+        ocp_nlp_memory_report_print(config, dims, opts_, nlp_in, nlp_mem, nlp_opts->print_level > 3);
+
     return solver;
 }
 
 
+
+void ocp_nlp_solver_memory_report(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_memory_report *report)
+{
+    ocp_nlp_memory *nlp_mem;
+    solver->config->get(solver->config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+    ocp_nlp_memory_report_compute(solver->config, solver->dims, solver->opts, nlp_in, nlp_mem, report);
+}
+
+
 void ocp_nlp_solver_destroy(ocp_nlp_solver *solver)
 {
+    // the asynchronous preparation uses the thread pool
+    ocp_nlp_solver_wait_async(solver);
+
+    ocp_nlp_memory *nlp_mem;
+    solver->config->get(solver->config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+    acados_thread_pool_destroy(nlp_mem->thread_pool);
+    ocp_qp_recorder_close(nlp_mem->qp_recorder);
+
+    // terminate uses the qp solver memory, which is in autotune_qp_mem after an autotune
     solver->config->terminate(solver->config, solver->mem, solver->work);
-    free(solver);
+    free(nlp_mem->autotune_qp_mem);
+    if (solver->config->arena == NULL)
+        free(solver);
+}
+
+
+
+void ocp_nlp_solver_wait_async(ocp_nlp_solver *solver)
+{
+    if (solver->config->wait_async != NULL)
+        solver->config->wait_async(solver->config, solver->mem);
+}
+
+
+
+acados_size_t ocp_nlp_arena_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    void *opts_, ocp_nlp_in *nlp_in)
+{
+    // the external function workspaces are only known once the functions are set
+    if (nlp_in == NULL)
+    {
+        printf("\nerror: ocp_nlp_arena_calculate_size: nlp_in with the external functions set is required\n");
+        exit(1);
+    }
+
+    // as in ocp_nlp_solver_create
+    config->opts_update(config, dims, opts_);
+
+    acados_size_t bytes = 0;
+
+    bytes += acados_arena_block_size(ocp_nlp_config_calculate_size(config->N));
+    bytes += acados_arena_block_size(ocp_nlp_dims_calculate_size(config));
+    bytes += acados_arena_block_size(ocp_nlp_solver_opts_calculate_size(config, dims));
+    bytes += acados_arena_block_size(ocp_nlp_in_calculate_size(config, dims));
+    bytes += acados_arena_block_size(ocp_nlp_out_calculate_size(config, dims));
+    bytes += acados_arena_block_size(ocp_nlp_calculate_size(config, dims, opts_, nlp_in));
+
+    // alignment of the arena start
+    bytes += 64;
+
+    return bytes;
 }
 
 
@@ -1310,6 +1500,36 @@ void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in,
 }
 
 
+int ocp_nlp_solver_qp_record_start(ocp_nlp_solver *solver, const char *filename, int compress)
+{
+    ocp_nlp_memory *nlp_mem;
+    solver->config->get(solver->config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+
+    ocp_qp_recorder_close(nlp_mem->qp_recorder);
+    nlp_mem->qp_record_failed = 0;
+    nlp_mem->qp_recorder = ocp_qp_recorder_open(filename, nlp_mem->qp_in->dim, compress);
+    if (nlp_mem->qp_recorder == NULL)
+    {
+        printf("\nocp_nlp_solver_qp_record_start: cannot open %s for writing.\n", filename);
+        return 1;
+    }
+    return 0;
+}
+
+
+int ocp_nlp_solver_qp_record_stop(ocp_nlp_solver *solver)
+{
+    ocp_nlp_memory *nlp_mem;
+    solver->config->get(solver->config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+
+    if (ocp_qp_recorder_close(nlp_mem->qp_recorder))
+        nlp_mem->qp_record_failed = 1;
+    nlp_mem->qp_recorder = NULL;
+
+    return nlp_mem->qp_record_failed;
+}
+
+
 int ocp_nlp_solve(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
     return solver->config->evaluate(solver->config, solver->dims, nlp_in, nlp_out,
@@ -1324,10 +1544,500 @@ int ocp_nlp_setup_qp_matrices_and_factorize(ocp_nlp_solver *solver, ocp_nlp_in *
 }
 
 
+/************************************************
+* qp autotune
+************************************************/
+
+// qp solver memory followed by the workspace, for the current qp solver options
+static acados_size_t ocp_nlp_autotune_qp_block_size(ocp_qp_xcond_solver_config *qp_solver,
+    ocp_qp_xcond_solver_dims *qp_dims, void *qp_opts, acados_size_t *work_offset)
+{
+    acados_size_t mem_size = qp_solver->memory_calculate_size(qp_solver, qp_dims, qp_opts);
+    *work_offset = (mem_size + 63) / 64 * 64;
+    return *work_offset + qp_solver->workspace_calculate_size(qp_solver, qp_dims, qp_opts) + 64;
+}
+
+
+
+// re-populates the condensed qp dims from the qp solver options after a change of cond_N
+static void ocp_nlp_autotune_qp_set_cond_N(ocp_qp_xcond_solver_config *qp_solver,
+    ocp_qp_xcond_solver_dims *qp_dims, void *qp_opts, int N2, int *block_size)
+{
+    qp_solver->opts_set(qp_solver, qp_opts, "cond_N", &N2);
+    if (block_size != NULL)
+        qp_solver->opts_set(qp_solver, qp_opts, "cond_block_size", block_size);
+    qp_solver->opts_update(qp_solver, qp_dims, qp_opts);
+    qp_solver->memory_calculate_size(qp_solver, qp_dims, qp_opts);
+}
+
+
+
+// terminate the qp solver in a block of ocp_nlp_autotune_qp_block_size and free it
+static void ocp_nlp_autotune_qp_block_free(ocp_qp_xcond_solver_config *qp_solver, void *block,
+    acados_size_t work_offset)
+{
+    if (block == NULL)
+        return;
+    qp_solver->terminate(qp_solver, block, (char *) block + work_offset);
+    free(block);
+}
+
+
+
+// fastest of n_rep qp solves [s], ACADOS_INFTY if a solve fails
+static double ocp_nlp_autotune_qp_time(ocp_qp_xcond_solver_config *qp_solver, ocp_qp_xcond_solver_dims *qp_dims,
+    ocp_qp_in *qp_in, ocp_qp_out *qp_out, void *qp_opts, void *qp_mem, void *qp_work, int n_rep)
+{
+    acados_timer timer;
+    double time = ACADOS_INFTY;
+
+    for (int rep = 0; rep < n_rep; rep++)
+    {
+        acados_tic(&timer);
+        int status = qp_solver->evaluate(qp_solver, qp_dims, qp_in, qp_out, qp_opts, qp_mem, qp_work);
+        double tmp_time = acados_toc(&timer);
+        if (status != ACADOS_SUCCESS)
+            return ACADOS_INFTY;
+        if (tmp_time < time)
+            time = tmp_time;
+    }
+    return time;
+}
+
+
+
+// Times the qp solver on the qp at the initial guess for cond_N = N, N/2, ..., 1 and
+// keeps the fastest horizon. The qp solver memory of the winner is allocated next to the
+// solver and replaces the one in the solver block. The qp solver itself is not switched:
+// the full condensing solvers are only timed and reported, using one of them requires
+// creating the solver from another plan.
+static void ocp_nlp_autotune_qp(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
+{
+    ocp_nlp_config *config = solver->config;
+    ocp_nlp_dims *dims = solver->dims;
+    ocp_qp_xcond_solver_config *qp_solver = config->qp_solver;
+    ocp_qp_xcond_solver_dims *qp_dims = dims->qp_solver;
+
+    ocp_nlp_opts *nlp_opts;
+    ocp_nlp_memory *nlp_mem;
+    ocp_nlp_workspace *nlp_work;
+    config->opts_get(config, dims, solver->opts, "nlp_opts", &nlp_opts);
+    config->get(config, dims, solver->mem, "nlp_mem", &nlp_mem);
+    config->work_get(config, dims, solver->work, "nlp_work", &nlp_work);
+    void *qp_opts = nlp_opts->qp_solver_opts;
+
+    int N = dims->N;
+    int n_rep = nlp_opts->autotune_qp;
+    int print_level = nlp_opts->print_level;
+
+    // representative qp: linearization at the initial guess
+    config->eval_kkt_residual(config, dims, nlp_in, nlp_out, solver->opts, solver->mem, solver->work);
+    config->regularize->regularize(config->regularize, dims->regularize,
+                                   nlp_opts->regularize, nlp_mem->regularize);
+    ocp_qp_in *qp_in = nlp_mem->qp_in;
+    ocp_qp_out *qp_out = nlp_mem->qp_out;
+
+    int N2_init;
+    qp_solver->xcond->dims_get(qp_solver->xcond, qp_dims->xcond_dims, "cond_N", &N2_init);
+    bool tune_cond_N = N2_init > 0;
+    if (tune_cond_N && config->arena != NULL)
+    {
+        if (print_level > 0)
+            printf("\nocp_nlp_autotune_qp: solver placed in an arena, cond_N is not tuned.\n");
+        tune_cond_N = false;
+    }
+
+    // current configuration, in the solver block
+    double time_best = ocp_nlp_autotune_qp_time(qp_solver, qp_dims, qp_in, qp_out, qp_opts,
+                                                nlp_mem->qp_solver_mem, nlp_work->qp_work, n_rep);
+    int N2_best = N2_init;
+    void *block_best = NULL;
+    acados_size_t work_best_offset = 0;
+
+    if (print_level > 0)
+    {
+        printf("\nocp_nlp_autotune_qp: %d qp solves per configuration\n", n_rep);
+        printf("  %6s %12s\n", "cond_N", "time [ms]");
+        printf("  %6d %12.4f  (initial)\n", N2_init, time_best < ACADOS_INFTY ? 1e3*time_best : -1.0);
+    }
+
+    if (tune_cond_N)
+    {
+        int *block_size_init = malloc((N2_init+1)*sizeof(int));
+        qp_solver->xcond->dims_get(qp_solver->xcond, qp_dims->xcond_dims, "block_size", block_size_init);
+
+        for (int N2 = N; N2 > 0; N2 /= 2)
+        {
+            if (N2 == N2_init)
+                continue;
+
+            ocp_nlp_autotune_qp_set_cond_N(qp_solver, qp_dims, qp_opts, N2, NULL);
+            acados_size_t work_offset;
+            acados_size_t bytes = ocp_nlp_autotune_qp_block_size(qp_solver, qp_dims, qp_opts, &work_offset);
+            void *block = calloc(1, bytes);
+            void *qp_mem = qp_solver->memory_assign(qp_solver, qp_dims, qp_opts, block);
+            qp_solver->memory_set(qp_solver, qp_mem, "thread_pool", nlp_mem->thread_pool);
+
+            double time = ocp_nlp_autotune_qp_time(qp_solver, qp_dims, qp_in, qp_out, qp_opts,
+                                                   qp_mem, (char *) block + work_offset, n_rep);
+            if (print_level > 0)
+                printf("  %6d %12.4f\n", N2, time < ACADOS_INFTY ? 1e3*time : -1.0);
+
+            if (time < time_best)
+            {
+                ocp_nlp_autotune_qp_block_free(qp_solver, block_best, work_best_offset);
+                block_best = block;
+                work_best_offset = work_offset;
+                N2_best = N2;
+                time_best = time;
+            }
+            else
+            {
+                ocp_nlp_autotune_qp_block_free(qp_solver, block, work_offset);
+            }
+        }
+
+        // lock in
+        if (block_best == NULL)
+        {
+            ocp_nlp_autotune_qp_set_cond_N(qp_solver, qp_dims, qp_opts, N2_init, block_size_init);
+        }
+        else
+        {
+            ocp_nlp_autotune_qp_set_cond_N(qp_solver, qp_dims, qp_opts, N2_best, NULL);
+            // release the replaced qp solver memory, the one in the solver block or of a previous autotune
+            qp_solver->terminate(qp_solver, nlp_mem->qp_solver_mem, nlp_work->qp_work);
+            free(nlp_mem->autotune_qp_mem);
+            nlp_mem->autotune_qp_mem = block_best;
+            nlp_mem->qp_solver_mem = block_best;
+            nlp_work->qp_work = (ocp_qp_xcond_solver_workspace *) ((char *) block_best + work_best_offset);
+        }
+        free(block_size_init);
+    }
+
+    // compare with the other qp solvers on standalone instances
+    int n_candidates = ocp_qp_autotune_default_candidates(N, NULL, 0);
+    ocp_qp_autotune_candidate *candidates = malloc(n_candidates*sizeof(ocp_qp_autotune_candidate));
+    ocp_qp_autotune_default_candidates(N, candidates, n_candidates);
+    if (tune_cond_N)
+    {
+        // the partial condensing horizons have been timed with the current qp solver above
+        int n_full = 0;
+        for (int k = 0; k < n_candidates; k++)
+        {
+            if (!ocp_qp_solver_is_partial_condensing(candidates[k].qp_solver))
+                candidates[n_full++] = candidates[k];
+        }
+        n_candidates = n_full;
+    }
+    int best = ocp_qp_autotune(qp_in, candidates, n_candidates, n_rep, print_level);
+
+    if (print_level > 0)
+        printf("\nocp_nlp_autotune_qp: using cond_N = %d (%.4f ms)\n", N2_best,
+               time_best < ACADOS_INFTY ? 1e3*time_best : -1.0);
+    if (print_level > 0 && best >= 0 && candidates[best].time < time_best)
+    {
+        printf("ocp_nlp_autotune_qp: %s", ocp_qp_solver_name(candidates[best].qp_solver));
+        if (ocp_qp_solver_is_partial_condensing(candidates[best].qp_solver))
+            printf(" with cond_N = %d", candidates[best].cond_N);
+        printf(" is faster (%.4f ms), create the solver with this qp_solver to use it\n",
+               1e3*candidates[best].time);
+    }
+    free(candidates);
+}
+
+
+
 int ocp_nlp_precompute(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
 {
-    return solver->config->precompute(solver->config, solver->dims, nlp_in, nlp_out,
-                                      solver->opts, solver->mem, solver->work);
+    ocp_nlp_config *config = solver->config;
+
+    int status = config->precompute(config, solver->dims, nlp_in, nlp_out,
+                                    solver->opts, solver->mem, solver->work);
+
+    ocp_nlp_opts *nlp_opts;
+    ocp_nlp_memory *nlp_mem;
+    config->opts_get(config, solver->dims, solver->opts, "nlp_opts", &nlp_opts);
+    config->get(config, solver->dims, solver->mem, "nlp_mem", &nlp_mem);
+
+    // precompute assigns the workspace again, keep the qp workspace of a previous autotune
+    if (nlp_mem->autotune_qp_mem != NULL)
+    {
+        ocp_nlp_workspace *nlp_work;
+        config->work_get(config, solver->dims, solver->work, "nlp_work", &nlp_work);
+        acados_size_t work_offset;
+        ocp_nlp_autotune_qp_block_size(config->qp_solver, solver->dims->qp_solver,
+                                       nlp_opts->qp_solver_opts, &work_offset);
+        nlp_work->qp_work = (ocp_qp_xcond_solver_workspace *) ((char *) nlp_mem->autotune_qp_mem + work_offset);
+    }
+
+    if (status == ACADOS_SUCCESS && nlp_opts->autotune_qp > 0)
+        ocp_nlp_autotune_qp(solver, nlp_in, nlp_out);
+
+    return status;
+}
+
+
+
+/************************************************
+* batch solver
+************************************************/
+
+ocp_nlp_batch_solver *ocp_nlp_batch_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    int batch_size, int num_threads)
+{
+    assert(batch_size > 0);
+
+    // per instance sizes, multiple of a cache line so that instances do not share lines
+    acados_size_t in_size = ocp_nlp_in_calculate_size(config, dims);
+    acados_size_t out_size = ocp_nlp_out_calculate_size(config, dims);
+    make_int_multiple_of(64, &in_size);
+    make_int_multiple_of(64, &out_size);
+
+    acados_size_t header_size = sizeof(ocp_nlp_batch_solver);
+    header_size += 4 * batch_size * sizeof(void *);
+    header_size += batch_size * sizeof(int);
+    make_int_multiple_of(64, &header_size);
+
+    acados_size_t bytes = header_size + 64;
+    bytes += batch_size * (in_size + out_size);
+    char *raw_memory = acados_calloc(1, bytes);
+    assert(raw_memory != 0);
+
+    char *c_ptr = raw_memory;
+    ocp_nlp_batch_solver *batch = (ocp_nlp_batch_solver *) c_ptr;
+    c_ptr += sizeof(ocp_nlp_batch_solver);
+
+    batch->config = config;
+    batch->dims = dims;
+    batch->batch_size = batch_size;
+    batch->num_threads = num_threads;
+    batch->raw_memory = raw_memory;
+    batch->solver_memory = NULL;
+
+    batch->opts = (void **) c_ptr;
+    c_ptr += batch_size * sizeof(void *);
+    batch->nlp_in = (ocp_nlp_in **) c_ptr;
+    c_ptr += batch_size * sizeof(void *);
+    batch->nlp_out = (ocp_nlp_out **) c_ptr;
+    c_ptr += batch_size * sizeof(void *);
+    batch->solver = (ocp_nlp_solver **) c_ptr;
+    c_ptr += batch_size * sizeof(void *);
+    batch->status = (int *) c_ptr;
+    c_ptr += batch_size * sizeof(int);
+
+    c_ptr = raw_memory + header_size;
+    align_char_to(64, &c_ptr);
+
+    // inputs of all instances
+    for (int b = 0; b < batch_size; b++)
+    {
+        batch->nlp_in[b] = ocp_nlp_in_assign(config, dims, c_ptr);
+        batch->nlp_in[b]->raw_memory = NULL;
+        c_ptr += in_size;
+    }
+
+    // outputs of all instances
+    for (int b = 0; b < batch_size; b++)
+    {
+        batch->nlp_out[b] = ocp_nlp_out_assign(config, dims, c_ptr);
+        batch->nlp_out[b]->raw_memory = NULL;
+        c_ptr += out_size;
+    }
+
+    assert(raw_memory + bytes >= c_ptr);
+
+    // the solvers write to their options during a solve, every instance owns a copy;
+    // solver memories are assigned once the models are set, see ocp_nlp_batch_solver_memory_create
+    for (int b = 0; b < batch_size; b++)
+    {
+        batch->opts[b] = ocp_nlp_solver_opts_create(config, dims);
+        batch->solver[b] = NULL;
+        batch->status[b] = ACADOS_READY;
+    }
+    // created with the solver memories, such that the pin_threads option is set
+    batch->thread_pool = NULL;
+
+    return batch;
+}
+
+
+
+// the solver memory depends on the external function workspaces of nlp_in,
+// the instances are sized with the maximum over the batch after the models are set
+static void ocp_nlp_batch_solver_memory_create(ocp_nlp_batch_solver *batch)
+{
+    ocp_nlp_config *config = batch->config;
+    ocp_nlp_dims *dims = batch->dims;
+
+    acados_size_t solver_size = 0;
+    for (int b = 0; b < batch->batch_size; b++)
+    {
+        config->opts_update(config, dims, batch->opts[b]);
+        acados_size_t size = ocp_nlp_calculate_size(config, dims, batch->opts[b], batch->nlp_in[b]);
+        if (size > solver_size)
+            solver_size = size;
+    }
+    make_int_multiple_of(64, &solver_size);
+
+    batch->solver_memory = acados_calloc(1, batch->batch_size * solver_size + 64);
+    assert(batch->solver_memory != 0);
+
+    char *c_ptr = batch->solver_memory;
+    align_char_to(64, &c_ptr);
+    for (int b = 0; b < batch->batch_size; b++)
+    {
+        // instances run single threaded, nlp_mem->thread_pool stays NULL
+        batch->solver[b] = ocp_nlp_assign(config, dims, batch->opts[b], batch->nlp_in[b], c_ptr);
+        c_ptr += solver_size;
+    }
+
+    // pin_threads of the instance options applies to the batch pool
+    ocp_nlp_opts *nlp_opts;
+    config->opts_get(config, dims, batch->opts[0], "nlp_opts", &nlp_opts);
+    batch->thread_pool = acados_thread_pool_create(batch->num_threads, nlp_opts->pin_threads);
+}
+
+
+
+void ocp_nlp_batch_solver_destroy(ocp_nlp_batch_solver *batch)
+{
+    acados_thread_pool_destroy(batch->thread_pool);
+
+    if (batch->solver_memory != NULL)
+    {
+        for (int b = 0; b < batch->batch_size; b++)
+        {
+            ocp_nlp_solver *solver = batch->solver[b];
+            solver->config->terminate(solver->config, solver->mem, solver->work);
+        }
+    }
+
+    for (int b = 0; b < batch->batch_size; b++)
+        ocp_nlp_solver_opts_destroy(batch->opts[b]);
+
+    free(batch->solver_memory);
+    free(batch->raw_memory);
+}
+
+
+
+void ocp_nlp_batch_solver_opts_set(ocp_nlp_batch_solver *batch, const char *field, void *value)
+{
+    for (int b = 0; b < batch->batch_size; b++)
+        batch->config->opts_set(batch->config, batch->opts[b], field, value);
+}
+
+
+
+void ocp_nlp_batch_solver_opts_set_at_stage(ocp_nlp_batch_solver *batch, int stage, const char *field, void *value)
+{
+    for (int b = 0; b < batch->batch_size; b++)
+        batch->config->opts_set_at_stage(batch->config, batch->opts[b], stage, field, value);
+}
+
+
+
+int ocp_nlp_batch_precompute(ocp_nlp_batch_solver *batch)
+{
+    if (batch->solver_memory == NULL)
+        ocp_nlp_batch_solver_memory_create(batch);
+
+    for (int b = 0; b < batch->batch_size; b++)
+    {
+        // no autotune_qp, the solver memories are laid out with one size for all instances
+        ocp_nlp_solver *solver = batch->solver[b];
+        int status = solver->config->precompute(solver->config, solver->dims, batch->nlp_in[b],
+                        batch->nlp_out[b], solver->opts, solver->mem, solver->work);
+        if (status)
+            return status;
+    }
+    return 0;
+}
+
+
+
+static void ocp_nlp_batch_solve_instance(void *batch_, int b)
+{
+    ocp_nlp_batch_solver *batch = batch_;
+    batch->status[b] = ocp_nlp_solve(batch->solver[b], batch->nlp_in[b], batch->nlp_out[b]);
+}
+
+
+
+int ocp_nlp_batch_solve(ocp_nlp_batch_solver *batch, int n)
+{
+    assert(n <= batch->batch_size);
+
+    if (batch->solver_memory == NULL)
+    {
+        printf("\nerror: ocp_nlp_batch_solve: call ocp_nlp_batch_precompute after setting the models\n");
+        exit(1);
+    }
+
+#if defined(ACADOS_WITH_THREAD_POOL)
+    // instances with many iterations are stolen by idle threads
+    acados_thread_pool_run_stealing(batch->thread_pool, n, ocp_nlp_batch_solve_instance, batch);
+#elif defined(ACADOS_WITH_OPENMP)
+    #pragma omp parallel for schedule(dynamic) num_threads(batch->num_threads)
+    for (int b = 0; b < n; b++)
+        ocp_nlp_batch_solve_instance(batch, b);
+#else
+    for (int b = 0; b < n; b++)
+        ocp_nlp_batch_solve_instance(batch, b);
+#endif
+
+    int num_failed = 0;
+    for (int b = 0; b < n; b++)
+    {
+        if (batch->status[b] != ACADOS_SUCCESS)
+            num_failed++;
+    }
+    return num_failed;
+}
+
+
+
+/************************************************
+* warm start cache
+************************************************/
+
+ocp_nlp_warm_start_cache *ocp_nlp_warm_start_cache_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    ocp_nlp_warm_start_cache_opts *opts)
+{
+    acados_size_t bytes = ocp_nlp_warm_start_cache_calculate_size(config, dims, opts);
+
+    void *ptr = acados_calloc(1, bytes);
+    assert(ptr != 0);
+
+    ocp_nlp_warm_start_cache *cache = ocp_nlp_warm_start_cache_assign(config, dims, opts, ptr);
+
+    return cache;
+}
+
+
+
+void ocp_nlp_warm_start_cache_destroy(ocp_nlp_warm_start_cache *cache)
+{
+    free(cache);
+}
+
+
+
+int ocp_nlp_solve_with_warm_start_cache(ocp_nlp_solver *solver, ocp_nlp_warm_start_cache *cache,
+    ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out)
+{
+    double *key = cache->key_tmp;
+
+    ocp_nlp_warm_start_cache_compute_key(cache, solver->config, solver->dims, nlp_in, key);
+    ocp_nlp_warm_start_cache_lookup(cache, solver->dims, key, nlp_out);
+
+    int status = ocp_nlp_solve(solver, nlp_in, nlp_out);
+
+    if (status == ACADOS_SUCCESS)
+        ocp_nlp_warm_start_cache_insert(cache, solver->dims, key, nlp_out);
+
+    return status;
 }
 
 
@@ -1722,6 +2432,9 @@ void ocp_nlp_get_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
 
 void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, const char *field, void *value)
 {
+    ocp_nlp_in_wait_async(in);
+    ocp_nlp_out_wait_async(out);
+
     ocp_nlp_dims *dims = solver->dims;
 
     double *double_values = value;
@@ -1814,6 +2527,7 @@ void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
             }
             tmp_offset += dims->np[stage];
         }
+        ocp_nlp_in_stage_changed(dims, in, -1, false);
     }
     else
     {
@@ -1825,6 +2539,8 @@ void ocp_nlp_set_all(ocp_nlp_solver *solver, ocp_nlp_in *in, ocp_nlp_out *out, c
 
 void ocp_nlp_set(ocp_nlp_solver *solver, int stage, const char *field, void *value)
 {
+    ocp_nlp_solver_wait_async(solver);
+
     ocp_nlp_memory *mem;
     ocp_nlp_config *config = solver->config;
     config->get(config, solver->dims, solver->mem, "nlp_mem", &mem);
@@ -1864,4 +2580,6 @@ void ocp_nlp_set(ocp_nlp_solver *solver, int stage, const char *field, void *val
         printf("\nerror: ocp_nlp_set: field %s not available\n", field);
         exit(1);
     }
+    // the integrator guess is only used when the stage is evaluated
+    ocp_nlp_memo_invalidate_stage(mem, stage);
 }
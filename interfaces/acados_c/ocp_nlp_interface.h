@@ -39,6 +39,7 @@ extern "C" {
 // acados
 #include "acados/ocp_nlp/ocp_nlp_common.h"
 #include "acados/ocp_nlp/ocp_nlp_constraints_bgh.h"
+#include "acados/ocp_nlp/ocp_nlp_warm_start_cache.h"
 #include "acados/sim/sim_erk_integrator.h"
 #include "acados/sim/sim_irk_integrator.h"
 #include "acados/sim/sim_lifted_irk_integrator.h"
@@ -137,6 +138,10 @@ typedef struct ocp_nlp_plan_t
     /// Horizon length.
     int N;
 
+    /// Optional arena, defaults to NULL (heap allocation). If set, config, dims, opts, in, out
+    /// and solver created from this plan are placed in the arena, see ocp_nlp_arena_calculate_size.
+    acados_arena *arena;
+
 } ocp_nlp_plan_t;
 
 
@@ -381,6 +386,40 @@ ACADOS_SYMBOL_EXPORT ocp_nlp_solver *ocp_nlp_solver_create(ocp_nlp_config *confi
 /// \param solver The solver struct.
 ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_destroy(ocp_nlp_solver *solver);
 
+/// Waits for the background work started by the previous solver call, i.e. the preparation
+/// phase with the SQP-RTI option rti_async_preparation. The setters of nlp_in and nlp_out, and
+/// ocp_nlp_set, wait for the preparation themselves; the getters do not, since the preparation
+/// only reads nlp_in and nlp_out. Direct writes to nlp_in or nlp_out require this function
+/// (or ocp_nlp_in_wait_async / ocp_nlp_out_wait_async) first.
+///
+/// \param solver The solver struct.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_wait_async(ocp_nlp_solver *solver);
+
+/// Breakdown of the solver memory and workspace by module, also printed at creation if
+/// print_level > 1 (with stage-wise sizes if print_level > 3).
+/// The alignment padding of the workspace is only known after ocp_nlp_precompute.
+///
+/// \param solver The solver struct.
+/// \param nlp_in The inputs struct.
+/// \param report Output.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_memory_report(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in,
+    ocp_nlp_memory_report *report);
+
+/// Footprint of config, dims, opts, in, out and solver in an arena.
+/// The size only depends on plan, dims, opts and the workspaces of the external functions set
+/// in nlp_in, which are part of the solver memory with ext_fun_opts.external_workspace = true
+/// (as in the generated solvers). nlp_in is typically that of a heap allocated solver of the same problem.
+/// With an arena, the destroy functions do not free memory; ocp_nlp_solver_destroy still has
+/// to be called to release solver resources.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param opts_ The options struct.
+/// \param nlp_in The inputs struct with the external functions set.
+/// \return Size in bytes.
+ACADOS_SYMBOL_EXPORT acados_size_t ocp_nlp_arena_calculate_size(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    void *opts_, ocp_nlp_in *nlp_in);
+
 /// Solves the optimal control problem. Call ocp_nlp_precompute before
 /// calling this function.
 ///
@@ -402,8 +441,31 @@ ACADOS_SYMBOL_EXPORT int ocp_nlp_setup_qp_matrices_and_factorize(ocp_nlp_solver
 ACADOS_SYMBOL_EXPORT void ocp_nlp_solver_reset_qp_memory(ocp_nlp_solver *solver, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
 
 
+/// Starts recording every QP solved by the solver, together with its solution, to a binary file
+/// that can be replayed with bench_qp_replay, see ocp_qp_record.h for the format.
+///
+/// \param solver The solver struct.
+/// \param filename The recording file, overwritten if it exists.
+/// \param compress Delta compression of consecutive records if nonzero.
+/// \return 0 on success, 1 if the file cannot be opened.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_solver_qp_record_start(ocp_nlp_solver *solver, const char *filename, int compress);
+
+
+/// Stops recording QPs and closes the recording file.
+/// A write error during the solves stops the recording early, the recording then ends with the
+/// last complete record.
+///
+/// \param solver The solver struct.
+/// \return 0 if all QPs were recorded, 1 if a write error stopped the recording.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_solver_qp_record_stop(ocp_nlp_solver *solver);
+
+
 /// Performs precomputations for the solver. Needs to be called before
 /// ocp_nlp_solve (TBC).
+/// With the option autotune_qp > 0, the partial condensing horizon cond_N is chosen by
+/// timing qp solves at the initial guess. Only cond_N is tuned: the qp solver of the plan
+/// is kept, the full condensing solvers are timed and reported only. To select the qp solver,
+/// run ocp_qp_autotune on a representative qp and create the solver from the fastest plan.
 ///
 /// \param solver The solver struct.
 /// \param nlp_in The inputs struct.
@@ -461,6 +523,87 @@ ACADOS_SYMBOL_EXPORT void ocp_nlp_set(ocp_nlp_solver *solver, int stage, const c
 
 
 
+/* batch solver */
+
+/// Batch of independent problem instances sharing one config and dims.
+/// Every instance owns its options, the solvers modify them during a solve (e.g. warm_start
+/// of the qp solver) and the instances are solved concurrently.
+/// The inputs, outputs and solver memories are stored in one contiguous block each, instance
+/// after instance (array of structs), and solves are scheduled on a work-stealing thread pool.
+typedef struct ocp_nlp_batch_solver
+{
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    void **opts;              // opts[b], b = 0, ..., batch_size-1
+    int batch_size;
+    int num_threads;
+    ocp_nlp_in **nlp_in;
+    ocp_nlp_out **nlp_out;
+    ocp_nlp_solver **solver;
+    int *status;              // return value of the last solve of each instance
+    acados_thread_pool *thread_pool;
+    void *raw_memory;
+    void *solver_memory;
+} ocp_nlp_batch_solver;
+
+/// Creates a batch of solvers with their inputs, outputs and default options.
+/// The instances are solved single threaded each, the batch is distributed over num_threads.
+/// The solver memories and the thread pool (pinned if the option pin_threads is set) are
+/// allocated by ocp_nlp_batch_precompute, after the models and options are set.
+/// External functions with internal memory must not be shared between instances.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param batch_size Number of problem instances.
+/// \param num_threads Number of threads used for the batch.
+/// \return The batch solver.
+ACADOS_SYMBOL_EXPORT ocp_nlp_batch_solver *ocp_nlp_batch_solver_create(ocp_nlp_config *config, ocp_nlp_dims *dims,
+    int batch_size, int num_threads);
+
+/// Sets an option of all instances, see ocp_nlp_solver_opts_set.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_batch_solver_opts_set(ocp_nlp_batch_solver *batch, const char *field, void *value);
+
+/// Sets an option at a stage of all instances, see ocp_nlp_solver_opts_set_at_stage.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_batch_solver_opts_set_at_stage(ocp_nlp_batch_solver *batch, int stage,
+    const char *field, void *value);
+
+/// Destructor of the batch solver.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_batch_solver_destroy(ocp_nlp_batch_solver *batch);
+
+/// Allocates the solver memories, sized with the maximum over all instances, and
+/// calls ocp_nlp_precompute for all instances; returns the first nonzero status or 0.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_batch_precompute(ocp_nlp_batch_solver *batch);
+
+/// Solves instances 0, ..., n-1; the status of each is stored in batch->status.
+/// Returns the number of instances with status other than ACADOS_SUCCESS.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_batch_solve(ocp_nlp_batch_solver *batch, int n);
+
+
+
+/* warm start cache */
+
+/// Creates a cache of converged iterates, keyed by x0 and (optionally) the stage parameters.
+/// The number of stored iterates follows from opts->budget; set the defaults with
+/// ocp_nlp_warm_start_cache_opts_initialize_default.
+///
+/// \param config The configuration struct.
+/// \param dims The dimension struct.
+/// \param opts The cache options.
+ACADOS_SYMBOL_EXPORT ocp_nlp_warm_start_cache *ocp_nlp_warm_start_cache_create(ocp_nlp_config *config,
+    ocp_nlp_dims *dims, ocp_nlp_warm_start_cache_opts *opts);
+
+/// Destructor of the warm start cache.
+ACADOS_SYMBOL_EXPORT void ocp_nlp_warm_start_cache_destroy(ocp_nlp_warm_start_cache *cache);
+
+/// Initializes nlp_out from the cached iterate nearest to the key of nlp_in (if any),
+/// solves, and stores the iterate in the cache if the solve succeeded.
+/// The lam part of the iterate warm starts the QP solver if its warm start option is set.
+/// Returns the solver status.
+ACADOS_SYMBOL_EXPORT int ocp_nlp_solve_with_warm_start_cache(ocp_nlp_solver *solver,
+    ocp_nlp_warm_start_cache *cache, ocp_nlp_in *nlp_in, ocp_nlp_out *nlp_out);
+
+
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
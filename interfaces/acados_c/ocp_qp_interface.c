@@ -33,11 +33,13 @@
 
 // external
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 // acados_c
 
 #include "acados/utils/mem.h"
+#include "acados/utils/timing.h"
 
 #include "acados/dense_qp/dense_qp_hpipm.h"
 #include "acados/ocp_qp/ocp_qp_xcond_solver.h"
@@ -432,6 +434,172 @@ void ocp_qp_solver_destroy(ocp_qp_solver *solver)
 }
 
 
+
+/************************************************
+* autotune
+************************************************/
+
+bool ocp_qp_solver_is_partial_condensing(ocp_qp_solver_t qp_solver)
+{
+    return qp_solver < FULL_CONDENSING_HPIPM;
+}
+
+
+
+const char *ocp_qp_solver_name(ocp_qp_solver_t qp_solver)
+{
+    switch (qp_solver)
+    {
+        case PARTIAL_CONDENSING_HPIPM:
+            return "PARTIAL_CONDENSING_HPIPM";
+#ifdef ACADOS_WITH_HPMPC
+        case PARTIAL_CONDENSING_HPMPC:
+            return "PARTIAL_CONDENSING_HPMPC";
+#endif
+#ifdef ACADOS_WITH_OOQP
+        case PARTIAL_CONDENSING_OOQP:
+            return "PARTIAL_CONDENSING_OOQP";
+#endif
+#ifdef ACADOS_WITH_OSQP
+        case PARTIAL_CONDENSING_OSQP:
+            return "PARTIAL_CONDENSING_OSQP";
+#endif
+#ifdef ACADOS_WITH_QPDUNES
+        case PARTIAL_CONDENSING_QPDUNES:
+            return "PARTIAL_CONDENSING_QPDUNES";
+#endif
+        case FULL_CONDENSING_HPIPM:
+            return "FULL_CONDENSING_HPIPM";
+#ifdef ACADOS_WITH_QPOASES
+        case FULL_CONDENSING_QPOASES:
+            return "FULL_CONDENSING_QPOASES";
+#endif
+#ifdef ACADOS_WITH_DAQP
+        case FULL_CONDENSING_DAQP:
+            return "FULL_CONDENSING_DAQP";
+#endif
+#ifdef ACADOS_WITH_QORE
+        case FULL_CONDENSING_QORE:
+            return "FULL_CONDENSING_QORE";
+#endif
+#ifdef ACADOS_WITH_OOQP
+        case FULL_CONDENSING_OOQP:
+            return "FULL_CONDENSING_OOQP";
+#endif
+        default:
+            return "INVALID_QP_SOLVER";
+    }
+}
+
+
+
+int ocp_qp_autotune_default_candidates(int N, ocp_qp_autotune_candidate *candidates, int max_candidates)
+{
+    ocp_qp_solver_t full_condensing[] = {
+        FULL_CONDENSING_HPIPM,
+#ifdef ACADOS_WITH_QPOASES
+        FULL_CONDENSING_QPOASES,
+#endif
+#ifdef ACADOS_WITH_DAQP
+        FULL_CONDENSING_DAQP,
+#endif
+    };
+    int n_full = sizeof(full_condensing) / sizeof(full_condensing[0]);
+
+    int n = 0;
+    // partial condensing, halving the horizon down to a single block
+    for (int N2 = N; ; N2 /= 2)
+    {
+        if (candidates != NULL && n < max_candidates)
+        {
+            candidates[n].qp_solver = PARTIAL_CONDENSING_HPIPM;
+            candidates[n].cond_N = N2 > 0 ? N2 : 1;
+        }
+        n++;
+        if (N2 <= 1)
+            break;
+    }
+    // full condensing
+    for (int i = 0; i < n_full; i++)
+    {
+        if (candidates != NULL && n < max_candidates)
+        {
+            candidates[n].qp_solver = full_condensing[i];
+            candidates[n].cond_N = 0;
+        }
+        n++;
+    }
+
+    return candidates != NULL && n > max_candidates ? max_candidates : n;
+}
+
+
+
+int ocp_qp_autotune(ocp_qp_in *qp_in, ocp_qp_autotune_candidate *candidates, int n_candidates,
+                    int n_rep, int print_level)
+{
+    acados_timer timer;
+    int best = -1;
+
+    ocp_qp_out *qp_out = ocp_qp_out_create(qp_in->dim);
+
+    for (int k = 0; k < n_candidates; k++)
+    {
+        ocp_qp_autotune_candidate *cand = &candidates[k];
+        ocp_qp_solver_plan_t plan;
+        plan.qp_solver = cand->qp_solver;
+
+        ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+        ocp_qp_xcond_solver_dims *dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(config, qp_in->dim);
+        void *opts = ocp_qp_xcond_solver_opts_create(config, dims);
+        if (ocp_qp_solver_is_partial_condensing(cand->qp_solver))
+            ocp_qp_xcond_solver_opts_set(config, opts, "cond_N", &cand->cond_N);
+
+        ocp_qp_solver *solver = ocp_qp_create(config, dims, opts);
+
+        cand->time = ACADOS_INFTY;
+        cand->status = ACADOS_SUCCESS;
+        for (int rep = 0; rep < n_rep; rep++)
+        {
+            acados_tic(&timer);
+            int status = ocp_qp_solve(solver, qp_in, qp_out);
+            double time = acados_toc(&timer);
+
+            cand->status = status;
+            if (status != ACADOS_SUCCESS)
+                break;
+            if (time < cand->time)
+                cand->time = time;
+        }
+
+        if (cand->status == ACADOS_SUCCESS && (best < 0 || cand->time < candidates[best].time))
+            best = k;
+
+        solver->config->terminate(solver->config, solver->mem, solver->work);
+        ocp_qp_solver_destroy(solver);
+        ocp_qp_xcond_solver_opts_free(opts);
+        ocp_qp_xcond_solver_dims_free(dims);
+        ocp_qp_xcond_solver_config_free(config);
+    }
+
+    ocp_qp_out_free(qp_out);
+
+    if (print_level > 0)
+    {
+        printf("\nocp_qp_autotune: %d candidates, %d solves each\n", n_candidates, n_rep);
+        printf("  %-28s %6s %6s %12s\n", "qp_solver", "cond_N", "status", "time [ms]");
+        for (int k = 0; k < n_candidates; k++)
+        {
+            printf("%s %-28s %6d %6d %12.4f\n", k == best ? "*" : " ",
+                   ocp_qp_solver_name(candidates[k].qp_solver), candidates[k].cond_N,
+                   candidates[k].status, candidates[k].status == ACADOS_SUCCESS ? 1e3*candidates[k].time : -1.0);
+        }
+    }
+
+    return best;
+}
+
+
 // qp residual
 static ocp_qp_res *ocp_qp_res_create(ocp_qp_dims *dims)
 {
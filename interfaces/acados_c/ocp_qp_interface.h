@@ -247,6 +247,44 @@ void ocp_qp_x_cond_solver_free(ocp_qp_xcond_solver_config *config,
 int ocp_qp_solve(ocp_qp_solver *solver, ocp_qp_in *qp_in, ocp_qp_out *qp_out);
 
 
+/// Candidate configuration for ocp_qp_autotune.
+typedef struct
+{
+    ocp_qp_solver_t qp_solver;
+    int cond_N;  // horizon after partial condensing, ignored by full condensing solvers
+    int status;  // status of the last timed solve
+    double time;  // fastest timed solve [s]
+} ocp_qp_autotune_candidate;
+
+/// Returns true if the qp solver works on a partially condensed qp.
+bool ocp_qp_solver_is_partial_condensing(ocp_qp_solver_t qp_solver);
+
+/// Returns a printable name of the qp solver.
+const char *ocp_qp_solver_name(ocp_qp_solver_t qp_solver);
+
+/// Fills candidates with the default search space for a qp with horizon N:
+/// PARTIAL_CONDENSING_HPIPM with cond_N = N, N/2, N/4, ..., 1, followed by the
+/// full condensing solvers acados was compiled with.
+///
+/// \param N The horizon of the qp.
+/// \param candidates Output array, NULL to only count.
+/// \param max_candidates Capacity of candidates.
+/// \return The number of candidates.
+int ocp_qp_autotune_default_candidates(int N, ocp_qp_autotune_candidate *candidates, int max_candidates);
+
+/// Times n_rep solves of qp_in for every candidate. Each candidate gets its own solver
+/// instance with default options, which is destroyed afterwards.
+///
+/// \param qp_in A representative qp.
+/// \param candidates Candidate configurations, status and time are written.
+/// \param n_candidates The number of candidates.
+/// \param n_rep The number of timed solves per candidate.
+/// \param print_level Prints a summary if > 0.
+/// \return The index of the fastest successful candidate, -1 if no candidate succeeded.
+int ocp_qp_autotune(ocp_qp_in *qp_in, ocp_qp_autotune_candidate *candidates, int n_candidates,
+                    int n_rep, int print_level);
+
+
 /// Calculates the infinity norm of the residuals.
 ///
 /// \param dims The dimension struct.
@@ -317,6 +317,8 @@ acados_size_t sim_calculate_size(sim_config *config, void *dims, void *opts_, si
     bytes += config->memory_calculate_size(config, dims, opts_);
     bytes += config->workspace_calculate_size(config, dims, opts_);
     bytes += config->get_external_fun_workspace_requirement(config, dims, opts_, in->model);
+    if (config->batch_workspace_calculate_size)
+        bytes += config->batch_workspace_calculate_size(config, dims, opts_);
 
     return bytes;
 }
@@ -343,6 +345,13 @@ sim_solver *sim_assign(sim_config *config, void *dims, void *opts_, sim_in *in,
     config->set_external_fun_workspaces(config, dims, opts_, in->model, c_ptr);
     c_ptr += config->get_external_fun_workspace_requirement(config, dims, opts_, in->model);
 
+    solver->batch_work = NULL;
+    if (config->batch_workspace_calculate_size)
+    {
+        solver->batch_work = (void *) c_ptr;
+        c_ptr += config->batch_workspace_calculate_size(config, dims, opts_);
+    }
+
     assert((char *) raw_memory + sim_calculate_size(config, dims, opts_, in) == c_ptr);
 
     return solver;
@@ -379,6 +388,28 @@ int sim_solve(sim_solver *solver, sim_in *in, sim_out *out)
     return status;
 }
 
+int sim_solve_batch(sim_solver *solver, sim_in **in, sim_out **out, int num_instances)
+{
+    sim_opts *opts = solver->opts;
+
+    // batch mode covers simulation and forward sensitivities with fixed steps in double
+    if (solver->config->evaluate_batch && solver->batch_work && !opts->sens_adj && !opts->sens_hess
+        && !opts->adaptive_steps && !opts->single_precision)
+    {
+        return solver->config->evaluate_batch(solver->config, in, out, num_instances, solver->opts,
+                                              solver->mem, solver->batch_work);
+    }
+
+    int status = ACADOS_SUCCESS;
+    for (int i = 0; i < num_instances; i++)
+    {
+        int status_i = sim_solve(solver, in[i], out[i]);
+        if (status == ACADOS_SUCCESS)
+            status = status_i;
+    }
+    return status;
+}
+
 int sim_precompute(sim_solver *solver, sim_in *in, sim_out *out)
 {
     return solver->config->precompute(solver->config, in, out, solver->opts, solver->mem,
@@ -65,6 +65,7 @@ typedef struct
     void *opts;
     void *mem;
     void *work;
+    void *batch_work;  // NULL if the integrator has no batch mode
 } sim_solver;
 
 
@@ -125,6 +126,11 @@ ACADOS_SYMBOL_EXPORT sim_solver *sim_solver_create(sim_config *config, void *dim
 ACADOS_SYMBOL_EXPORT void sim_solver_destroy(void *solver);
 //
 ACADOS_SYMBOL_EXPORT int sim_solve(sim_solver *solver, sim_in *in, sim_out *out);
+// solve independent instances with the dims and opts of the solver;
+// ERK runs them lane interleaved (forward pass and S_forw only), the model functions are still
+// evaluated once per instance; all other integrators, and adjoint or hessian propagation,
+// fall back to one sim_solve call per instance, as do adaptive steps and single precision
+ACADOS_SYMBOL_EXPORT int sim_solve_batch(sim_solver *solver, sim_in **in, sim_out **out, int num_instances);
 //
 ACADOS_SYMBOL_EXPORT int sim_precompute(sim_solver *solver, sim_in *in, sim_out *out);
 //
@@ -55,6 +55,7 @@ classdef AcadosOcpOptions < handle
         sim_method_newton_iter
         sim_method_newton_tol
         sim_method_jac_reuse
+        sim_method_simplified_newton
         sim_method_detect_gnsf
         time_steps
         shooting_nodes
@@ -129,6 +130,7 @@ classdef AcadosOcpOptions < handle
         ext_fun_expand_cost
         ext_fun_expand_constr
         ext_fun_expand_precompute
+        ext_fun_zero_copy
 
         model_external_shared_lib_dir
         model_external_shared_lib_name
@@ -167,6 +169,7 @@ classdef AcadosOcpOptions < handle
             obj.sim_method_newton_iter = 3;
             obj.sim_method_newton_tol = 0.0;
             obj.sim_method_jac_reuse = 0;
+            obj.sim_method_simplified_newton = false;
             obj.time_steps = [];
             obj.Tsim = [];
             obj.qp_solver = 'PARTIAL_CONDENSING_HPIPM';
@@ -248,6 +251,7 @@ classdef AcadosOcpOptions < handle
             obj.ext_fun_expand_cost = false;
             obj.ext_fun_expand_constr = false;
             obj.ext_fun_expand_precompute = false;
+            obj.ext_fun_zero_copy = false;
 
             obj.model_external_shared_lib_dir = [];
             obj.model_external_shared_lib_name = [];
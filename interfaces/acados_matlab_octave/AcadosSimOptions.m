@@ -39,6 +39,7 @@ classdef AcadosSimOptions < handle
         newton_iter
         newton_tol
         jac_reuse
+        simplified_newton
         sens_forw
         sens_adj
         sens_algebraic
@@ -65,6 +66,7 @@ classdef AcadosSimOptions < handle
             obj.sens_hess = false;
             obj.output_z = true;
             obj.jac_reuse = 0;
+            obj.simplified_newton = false;
             % check whether flags are provided by environment variable
             env_var = getenv("ACADOS_EXT_FUN_COMPILE_FLAGS");
             if isempty(env_var)
@@ -87,7 +89,8 @@ classdef AcadosSimOptions < handle
             for fi = 1:numel(publicProperties)
                 property_name = publicProperties{fi};
                 if strcmp(property_name, 'num_stages') || strcmp(property_name, 'num_steps') || strcmp(property_name, 'newton_iter') || ...
-                     strcmp(property_name, 'jac_reuse') || strcmp(property_name, 'newton_tol')
+                     strcmp(property_name, 'jac_reuse') || strcmp(property_name, 'newton_tol') || ...
+                     strcmp(property_name, 'simplified_newton')
                     out_name = strcat('sim_method_', property_name);
                     s.(out_name) = self.(property_name);
                 else
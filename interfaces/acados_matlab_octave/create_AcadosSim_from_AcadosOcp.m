@@ -52,6 +52,7 @@ function sim = create_AcadosSim_from_AcadosOcp(ocp)
     sim.solver_options.newton_iter = ocp.solver_options.sim_method_newton_iter(1);
     sim.solver_options.newton_tol = ocp.solver_options.sim_method_newton_tol(1);
     sim.solver_options.jac_reuse = ocp.solver_options.sim_method_jac_reuse(1);
+    sim.solver_options.simplified_newton = ocp.solver_options.sim_method_simplified_newton;
     sim.solver_options.ext_fun_compile_flags = ocp.solver_options.ext_fun_compile_flags;
     sim.parameter_values = ocp.parameter_values;
 end
\ No newline at end of file
@@ -64,6 +64,7 @@ class AcadosOcpOptions:
         self.__sim_method_newton_iter = 3
         self.__sim_method_newton_tol = 0.0
         self.__sim_method_jac_reuse = 0
+        self.__sim_method_simplified_newton = False
         self.__shooting_nodes = None
         self.__time_steps = None
         self.__cost_scaling = None
@@ -137,6 +138,7 @@ class AcadosOcpOptions:
         self.__ext_fun_expand_cost = False
         self.__ext_fun_expand_precompute = False
         self.__ext_fun_expand_dyn = False
+        self.__ext_fun_zero_copy = False
         self.__model_external_shared_lib_dir = None
         self.__model_external_shared_lib_name = None
         self.__custom_update_filename = ''
@@ -196,6 +198,16 @@ class AcadosOcpOptions:
         """
         return self.__ext_fun_expand_precompute
 
+    @property
+    def ext_fun_zero_copy(self):
+        """
+        Flag indicating whether the CasADi functions of cost, constraints and dynamics are evaluated without copies:
+        dense inputs and outputs with contiguous storage are passed to CasADi directly,
+        sparse outputs are scattered into their destination.
+        Default: False
+        """
+        return self.__ext_fun_zero_copy
+
     @property
     def custom_update_filename(self):
         """
@@ -442,6 +454,17 @@ class AcadosOcpOptions:
         """
         return self.__sim_method_jac_reuse
 
+    @property
+    def sim_method_simplified_newton(self):
+        """
+        Boolean determining if the IRK integrator uses simplified Newton iterations:
+        the stage Jacobian is evaluated at the first stage only, and the Butcher matrix is
+        diagonalized to decouple the Newton system into blocks of size nx+nz per real eigenvalue
+        and 2*(nx+nz) per complex pair. Ignored by the other integrators.
+        Default: False
+        """
+        return self.__sim_method_simplified_newton
+
     @property
     def qp_solver_tol_stat(self):
         """
@@ -1345,6 +1368,12 @@ class AcadosOcpOptions:
             raise TypeError('Invalid ext_fun_expand_precompute value, expected bool.\n')
         self.__ext_fun_expand_precompute = ext_fun_expand_precompute
 
+    @ext_fun_zero_copy.setter
+    def ext_fun_zero_copy(self, ext_fun_zero_copy):
+        if not isinstance(ext_fun_zero_copy, bool):
+            raise TypeError('Invalid ext_fun_zero_copy value, expected bool.\n')
+        self.__ext_fun_zero_copy = ext_fun_zero_copy
+
     @custom_update_filename.setter
     def custom_update_filename(self, custom_update_filename):
         if isinstance(custom_update_filename, str):
@@ -1641,6 +1670,13 @@ class AcadosOcpOptions:
     def sim_method_jac_reuse(self, sim_method_jac_reuse):
         self.__sim_method_jac_reuse = sim_method_jac_reuse
 
+    @sim_method_simplified_newton.setter
+    def sim_method_simplified_newton(self, sim_method_simplified_newton):
+        if sim_method_simplified_newton in (True, False):
+            self.__sim_method_simplified_newton = sim_method_simplified_newton
+        else:
+            raise ValueError('Invalid sim_method_simplified_newton value. sim_method_simplified_newton must be a Boolean.')
+
     @nlp_solver_type.setter
     def nlp_solver_type(self, nlp_solver_type):
         nlp_solver_types = ('SQP', 'SQP_RTI', 'DDP', 'SQP_WITH_FEASIBLE_QP')
@@ -1495,6 +1495,7 @@ class AcadosOcpSolver:
             - 5: Solver created (ACADOS_READY)
             - 6: Problem unbounded (ACADOS_UNBOUNDED)
             - 7: Solver timeout (ACADOS_TIMEOUT)
+            - 8: Deadline reached, last accepted iterate returned (ACADOS_DEADLINE)
 
         See `return_values` in https://github.com/acados/acados/blob/main/acados/utils/types.h
         """
@@ -2204,7 +2205,7 @@ class AcadosOcpSolver:
                 'globalization_funnel_initial_penalty_parameter', 'globalization_funnel_init_increase_factor',
                 'levenberg_marquardt',
                 'adaptive_levenberg_marquardt_lam', 'adaptive_levenberg_marquardt_mu_min', 'adaptive_levenberg_marquardt_mu0',
-                'tau_min'
+                'tau_min', 'deadline', 'deadline_safety_factor'
 
         :param value: of type int, float, string, bool
 
@@ -2216,6 +2217,9 @@ class AcadosOcpSolver:
             - qp_mu0: for HPIPM QP solvers: initial value for complementarity slackness
             - warm_start_first_qp: indicates if first QP in SQP is warm_started
             - rti_phase: 0: PREPARATION_AND_FEEDBACK, 1: PREPARATION, 2: FEEDBACK; only support for nlp_solver = 'SQP_RTI'
+            - deadline: absolute time in seconds by which the solver returns with the last accepted iterate and status 8 (ACADOS_DEADLINE),
+              on the monotonic clock of the acados timers (CLOCK_MONOTONIC on Linux, as read by `time.monotonic()`); 0: no deadline
+            - deadline_safety_factor: factor >= 1 applied to the predicted phase times when checking against the deadline
         """
         int_fields = ['print_level',
                       'rti_phase',
@@ -2252,7 +2256,9 @@ class AcadosOcpSolver:
                          'qp_tol_ineq',
                          'qp_tol_comp',
                          'qp_tau_min',
-                         'qp_mu0']
+                         'qp_mu0',
+                         'deadline',
+                         'deadline_safety_factor']
         string_fields = []
         bool_fields = ['with_adaptive_levenberg_marquardt', 'warm_start_first_qp_from_nlp', 'warm_start_first_qp']
 
@@ -65,6 +65,7 @@ class AcadosSimOptions:
         self.__sens_hess = False
         self.__output_z = True
         self.__sim_method_jac_reuse = 0
+        self.__sim_method_simplified_newton = False
         env = os.environ
         self.__ext_fun_compile_flags = '-O2' if 'ACADOS_EXT_FUN_COMPILE_FLAGS' not in env else env['ACADOS_EXT_FUN_COMPILE_FLAGS']
         self.__ext_fun_expand_dyn = False
@@ -130,6 +131,11 @@ class AcadosSimOptions:
         """Integer determining if jacobians are reused (0 or 1). Default: 0"""
         return self.__sim_method_jac_reuse
 
+    @property
+    def sim_method_simplified_newton(self):
+        """Boolean determining if the IRK integrator uses simplified Newton iterations, ignored by the other integrators. Default: False"""
+        return self.__sim_method_simplified_newton
+
     @property
     def T(self):
         """Time horizon"""
@@ -291,6 +297,13 @@ class AcadosSimOptions:
         else:
             raise ValueError('Invalid sim_method_jac_reuse value. sim_method_jac_reuse must be 0 or 1.')
 
+    @sim_method_simplified_newton.setter
+    def sim_method_simplified_newton(self, sim_method_simplified_newton):
+        if sim_method_simplified_newton in (True, False):
+            self.__sim_method_simplified_newton = sim_method_simplified_newton
+        else:
+            raise ValueError('Invalid sim_method_simplified_newton value. sim_method_simplified_newton must be a Boolean.')
+
     @num_threads_in_batch_solve.setter
     def num_threads_in_batch_solve(self, num_threads_in_batch_solve):
         print("Warning: num_threads_in_batch_solve is deprecated, set the flag with_batch_functionality instead and pass the number of threads directly to the BatchSolver.")
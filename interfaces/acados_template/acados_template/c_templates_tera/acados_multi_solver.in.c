@@ -2500,6 +2500,12 @@ ocp_nlp_solver_opts_set(nlp_config, nlp_opts, "allow_direction_mode_switch_to_no
     for (int i = {{ start_idx[jj] }}; i < {{ end_idx[jj] }}; i++)
         ocp_nlp_solver_opts_set_at_stage(nlp_config, nlp_opts, i, "dynamics_jac_reuse", &sim_method_jac_reuse[i]);
 
+{%- if mocp_opts.integrator_type[jj] == "IRK" and solver_options.sim_method_simplified_newton %}
+    tmp_bool = true;
+    for (int i = {{ start_idx[jj] }}; i < {{ end_idx[jj] }}; i++)
+        ocp_nlp_solver_opts_set_at_stage(nlp_config, nlp_opts, i, "dynamics_simplified_newton", &tmp_bool);
+{%- endif %}
+
 {%- if mocp_opts.cost_discretization[jj] == "INTEGRATOR" %}
     tmp_bool = true;
     for (int i = {{ start_idx[jj] }}; i < {{ end_idx[jj] }}; i++)
@@ -2775,6 +2781,8 @@ int {{ name }}_acados_set_p_global_and_precompute_dependencies({{ name }}_solver
     fun->res[0] = in->global_data;
 
     fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+    // global data enters all stages
+    ocp_nlp_in_stage_changed(capsule->nlp_dims, in, -1, false);
 
 {%- else %}
     // printf("No global_data, {{ name }}_acados_set_p_global_and_precompute_dependencies does nothing.\n");
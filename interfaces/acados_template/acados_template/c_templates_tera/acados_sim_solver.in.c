@@ -301,6 +301,10 @@ int {{ model.name }}_acados_sim_create({{ model.name }}_sim_solver_capsule * cap
     tmp_bool = {{ solver_options.sim_method_jac_reuse[0] }};
     sim_opts_set({{ model.name }}_sim_config, {{ model.name }}_sim_opts, "jac_reuse", &tmp_bool);
 {% endif %}
+{%- if solver_options.integrator_type == "IRK" and solver_options.sim_method_simplified_newton %}
+    bool simplified_newton = true;
+    sim_opts_set({{ model.name }}_sim_config, {{ model.name }}_sim_opts, "simplified_newton", &simplified_newton);
+{%- endif %}
 
     // sim in / out
     sim_in *{{ model.name }}_sim_in = sim_in_create({{ model.name }}_sim_config, {{ model.name }}_sim_dims);
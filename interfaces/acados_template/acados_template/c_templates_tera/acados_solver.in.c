@@ -465,6 +465,9 @@ void {{ model.name }}_acados_create_setup_functions({{ model.name }}_solver_caps
     ext_fun_opts.with_global_data = true;
 {%- endif %}
     ext_fun_opts.external_workspace = true;
+{%- if solver_options.ext_fun_zero_copy %}
+    ext_fun_opts.zero_copy = true;
+{%- endif %}
 
 {%- if solver_options.N_horizon > 0 %}
 {%- if constraints.constr_type_0 == "BGH" and dims.nh_0 > 0 %}
@@ -2368,6 +2371,12 @@ static void {{ model.name }}_acados_create_set_opts({{ model.name }}_solver_caps
     free(sim_method_jac_reuse);
   {%- endif %}
 
+{%- if solver_options.integrator_type == "IRK" and solver_options.sim_method_simplified_newton %}
+    bool simplified_newton = true;
+    for (int i = 0; i < N; i++)
+        ocp_nlp_solver_opts_set_at_stage(nlp_config, nlp_opts, i, "dynamics_simplified_newton", &simplified_newton);
+{%- endif %}
+
 {%- if solver_options.cost_discretization == "INTEGRATOR" %}
     bool cost_in_integrator = true;
     for (int i = 0; i < N; i++)
@@ -2825,9 +2834,13 @@ int {{ name }}_acados_set_p_global_and_precompute_dependencies({{ name }}_solver
     }
 
     ocp_nlp_in *in = {{ model.name }}_acados_get_nlp_in(capsule);
+    // global_data is written directly, wait for an asynchronous preparation reading it
+    ocp_nlp_in_wait_async(in);
     fun->res[0] = in->global_data;
 
     fun->casadi_fun((const double **) fun->args, fun->res, fun->int_work, fun->float_work, NULL);
+    // global data enters all stages
+    ocp_nlp_in_stage_changed(capsule->nlp_dims, in, -1, false);
 
 {%- else %}
     // printf("No global_data, {{ name }}_acados_set_p_global_and_precompute_dependencies does nothing.\n");
@@ -0,0 +1,974 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+// external
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+
+#include "catch/include/catch.hpp"
+
+// blasfeo
+#include "blasfeo_d_aux.h"
+
+// acados
+#include "acados_c/ocp_nlp_interface.h"
+#include "acados/ocp_nlp/ocp_nlp_common.h"
+#include "acados/ocp_nlp/ocp_nlp_sqp_rti.h"
+#include "acados/utils/external_function_generic.h"
+#include "acados/utils/timing.h"
+
+
+
+/************************************************
+ * discrete pendulum, x = [theta; omega], u = torque
+ * x+ = [theta + dt * omega; omega + dt * (-sin(theta) + u)]
+ ************************************************/
+
+#define PEND_N 20
+#define PEND_NX 2
+#define PEND_NU 1
+#define PEND_DT 0.1
+
+// hand-written external function, which evaluates through an external workspace
+typedef struct
+{
+    // public members for core (have to be the same as in the prototype)
+    void (*evaluate)(void *, ext_fun_arg_t *, void **, ext_fun_arg_t *, void **);
+    size_t (*get_external_workspace_requirement)(void *);
+    void (*set_external_workspace)(void *, void *);
+    // private members
+    int num_out;  // 1: fun, 2: fun_jac, 3: fun_jac_hess
+    double *work;
+    int num_eval;
+    int num_eval_without_work;
+} pendulum_disc_dyn;
+
+static double *pendulum_vec_ptr(ext_fun_arg_t type, void *arg)
+{
+    if (type == BLASFEO_DVEC)
+        return ((struct blasfeo_dvec *) arg)->pa;
+    struct blasfeo_dvec_args *args = (struct blasfeo_dvec_args *) arg;
+    return args->x->pa + args->xi;
+}
+
+static void pendulum_disc_dyn_evaluate(void *self, ext_fun_arg_t *type_in, void **in,
+                                       ext_fun_arg_t *type_out, void **out)
+{
+    pendulum_disc_dyn *fun = (pendulum_disc_dyn *) self;
+    fun->num_eval++;
+
+    double tmp[3];
+    double *work = fun->work;
+    if (work == NULL)
+    {
+        fun->num_eval_without_work++;
+        work = tmp;
+    }
+
+    double *x = pendulum_vec_ptr(type_in[0], in[0]);
+    double *u = pendulum_vec_ptr(type_in[1], in[1]);
+
+    work[0] = sin(x[0]);
+    work[1] = cos(x[0]);
+
+    double *x_next = pendulum_vec_ptr(type_out[0], out[0]);
+    x_next[0] = x[0] + PEND_DT * x[1];
+    x_next[1] = x[1] + PEND_DT * (-work[0] + u[0]);
+
+    if (fun->num_out > 1)
+    {
+        // jac': (nu+nx) x nx, rows [u; theta; omega]
+        struct blasfeo_dmat_args *jac = (struct blasfeo_dmat_args *) out[1];
+        struct blasfeo_dmat *A = jac->A;
+        int ai = jac->ai;
+        int aj = jac->aj;
+        BLASFEO_DMATEL(A, ai+0, aj+0) = 0.0;
+        BLASFEO_DMATEL(A, ai+0, aj+1) = PEND_DT;
+        BLASFEO_DMATEL(A, ai+1, aj+0) = 1.0;
+        BLASFEO_DMATEL(A, ai+1, aj+1) = -PEND_DT * work[1];
+        BLASFEO_DMATEL(A, ai+2, aj+0) = PEND_DT;
+        BLASFEO_DMATEL(A, ai+2, aj+1) = 1.0;
+    }
+    if (fun->num_out > 2)
+    {
+        // hess of pi' * x+ w.r.t. [u; theta; omega]
+        double *pi = pendulum_vec_ptr(type_in[2], in[2]);
+        struct blasfeo_dmat_args *hess = (struct blasfeo_dmat_args *) out[2];
+        blasfeo_dgese(PEND_NU+PEND_NX, PEND_NU+PEND_NX, 0.0, hess->A, hess->ai, hess->aj);
+        BLASFEO_DMATEL(hess->A, hess->ai+1, hess->aj+1) = PEND_DT * pi[1] * work[0];
+    }
+}
+
+static size_t pendulum_disc_dyn_get_external_workspace_requirement(void *self)
+{
+    return 3 * sizeof(double);
+}
+
+static void pendulum_disc_dyn_set_external_workspace(void *self, void *workspace)
+{
+    pendulum_disc_dyn *fun = (pendulum_disc_dyn *) self;
+    fun->work = (double *) workspace;
+}
+
+static void pendulum_disc_dyn_init(pendulum_disc_dyn *fun, int num_out)
+{
+    fun->evaluate = &pendulum_disc_dyn_evaluate;
+    fun->get_external_workspace_requirement = &pendulum_disc_dyn_get_external_workspace_requirement;
+    fun->set_external_workspace = &pendulum_disc_dyn_set_external_workspace;
+    fun->num_out = num_out;
+    fun->work = NULL;
+    fun->num_eval = 0;
+    fun->num_eval_without_work = 0;
+}
+
+
+
+typedef struct
+{
+    ocp_nlp_plan_t *plan;
+    ocp_nlp_config *config;
+    ocp_nlp_dims *dims;
+    ocp_nlp_in *in;
+    ocp_nlp_out *out;
+    void *opts;
+    ocp_nlp_solver *solver;
+    pendulum_disc_dyn dyn_fun[PEND_N];
+    pendulum_disc_dyn dyn_fun_jac[PEND_N];
+    pendulum_disc_dyn dyn_fun_jac_hess[PEND_N];
+} pendulum_ocp;
+
+// sets cost, dynamics and constraints of one problem instance, with its own external functions
+static void pendulum_in_set(ocp_nlp_config *config, ocp_nlp_dims *dims, ocp_nlp_in *in, ocp_nlp_out *out,
+                            pendulum_disc_dyn *dyn_fun, pendulum_disc_dyn *dyn_fun_jac,
+                            pendulum_disc_dyn *dyn_fun_jac_hess, double theta0)
+{
+    int N = PEND_N;
+
+    // cost: y = [theta; omega; u]
+    double Vx[3*PEND_NX] = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0};
+    double Vu[3*PEND_NU] = {0.0, 0.0, 1.0};
+    double W[9] = {1.0, 0.0, 0.0, 0.0, 0.1, 0.0, 0.0, 0.0, 0.01};
+    double yref[3] = {0.0, 0.0, 0.0};
+    double VxN[4] = {1.0, 0.0, 0.0, 1.0};
+    double WN[4] = {10.0, 0.0, 0.0, 10.0};
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_cost_model_set(config, dims, in, i, "Vx", Vx);
+        ocp_nlp_cost_model_set(config, dims, in, i, "Vu", Vu);
+        ocp_nlp_cost_model_set(config, dims, in, i, "W", W);
+        ocp_nlp_cost_model_set(config, dims, in, i, "yref", yref);
+    }
+    ocp_nlp_cost_model_set(config, dims, in, N, "Vx", VxN);
+    ocp_nlp_cost_model_set(config, dims, in, N, "W", WN);
+    ocp_nlp_cost_model_set(config, dims, in, N, "yref", yref);
+
+    // dynamics
+    for (int i = 0; i < N; i++)
+    {
+        pendulum_disc_dyn_init(&dyn_fun[i], 1);
+        pendulum_disc_dyn_init(&dyn_fun_jac[i], 2);
+        pendulum_disc_dyn_init(&dyn_fun_jac_hess[i], 3);
+        ocp_nlp_dynamics_model_set(config, dims, in, i, "disc_dyn_fun", &dyn_fun[i]);
+        ocp_nlp_dynamics_model_set(config, dims, in, i, "disc_dyn_fun_jac", &dyn_fun_jac[i]);
+        ocp_nlp_dynamics_model_set(config, dims, in, i, "disc_dyn_fun_jac_hess", &dyn_fun_jac_hess[i]);
+    }
+
+    // constraints
+    int idxbx0[PEND_NX] = {0, 1};
+    double x0[PEND_NX] = {theta0, 0.0};
+    ocp_nlp_constraints_model_set(config, dims, in, out, 0, "idxbx", idxbx0);
+    ocp_nlp_constraints_model_set(config, dims, in, out, 0, "lbx", x0);
+    ocp_nlp_constraints_model_set(config, dims, in, out, 0, "ubx", x0);
+    int idxbu[PEND_NU] = {0};
+    double lbu[PEND_NU] = {-1.0};
+    double ubu[PEND_NU] = {1.0};
+    for (int i = 0; i < N; i++)
+    {
+        ocp_nlp_constraints_model_set(config, dims, in, out, i, "idxbu", idxbu);
+        ocp_nlp_constraints_model_set(config, dims, in, out, i, "lbu", lbu);
+        ocp_nlp_constraints_model_set(config, dims, in, out, i, "ubu", ubu);
+    }
+}
+
+// sets up plan, config, dims, in, out and opts; the solver is created by pendulum_ocp_create_solver
+static void pendulum_ocp_setup_in_arena(pendulum_ocp *ocp, ocp_nlp_solver_t nlp_solver, double theta0,
+                                        acados_arena *arena)
+{
+    int N = PEND_N;
+
+    ocp->plan = ocp_nlp_plan_create(N);
+    ocp->plan->nlp_solver = nlp_solver;
+    ocp->plan->arena = arena;
+    ocp->plan->ocp_qp_solver_plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+    for (int i = 0; i <= N; i++)
+    {
+        ocp->plan->nlp_cost[i] = LINEAR_LS;
+        ocp->plan->nlp_constraints[i] = BGH;
+    }
+    for (int i = 0; i < N; i++)
+        ocp->plan->nlp_dynamics[i] = DISCRETE_MODEL;
+
+    ocp->config = ocp_nlp_config_create(*ocp->plan);
+
+    // dims
+    int nx[PEND_N+1], nu[PEND_N+1];
+    for (int i = 0; i <= N; i++)
+    {
+        nx[i] = PEND_NX;
+        nu[i] = i < N ? PEND_NU : 0;
+    }
+    ocp->dims = ocp_nlp_dims_create(ocp->config);
+    ocp_nlp_dims_set_opt_vars(ocp->config, ocp->dims, "nx", nx);
+    ocp_nlp_dims_set_opt_vars(ocp->config, ocp->dims, "nu", nu);
+    for (int i = 0; i <= N; i++)
+    {
+        int ny = i < N ? PEND_NX+PEND_NU : PEND_NX;
+        int nbx = i == 0 ? PEND_NX : 0;
+        int nbu = nu[i];
+        int zero = 0;
+        ocp_nlp_dims_set_cost(ocp->config, ocp->dims, i, "ny", &ny);
+        ocp_nlp_dims_set_constraints(ocp->config, ocp->dims, i, "nbx", &nbx);
+        ocp_nlp_dims_set_constraints(ocp->config, ocp->dims, i, "nbu", &nbu);
+        ocp_nlp_dims_set_constraints(ocp->config, ocp->dims, i, "ng", &zero);
+        ocp_nlp_dims_set_constraints(ocp->config, ocp->dims, i, "nh", &zero);
+    }
+
+    ocp->in = ocp_nlp_in_create(ocp->config, ocp->dims);
+    ocp->out = ocp_nlp_out_create(ocp->config, ocp->dims);
+
+    pendulum_in_set(ocp->config, ocp->dims, ocp->in, ocp->out, ocp->dyn_fun, ocp->dyn_fun_jac,
+                    ocp->dyn_fun_jac_hess, theta0);
+
+    // opts
+    ocp->opts = ocp_nlp_solver_opts_create(ocp->config, ocp->dims);
+    int max_iter = 50;
+    double tol = 1e-10;
+    ocp_nlp_solver_opts_set(ocp->config, ocp->opts, "max_iter", &max_iter);
+    ocp_nlp_solver_opts_set(ocp->config, ocp->opts, "tol_stat", &tol);
+    ocp_nlp_solver_opts_set(ocp->config, ocp->opts, "tol_eq", &tol);
+    ocp_nlp_solver_opts_set(ocp->config, ocp->opts, "tol_ineq", &tol);
+    ocp_nlp_solver_opts_set(ocp->config, ocp->opts, "tol_comp", &tol);
+
+    ocp->solver = NULL;
+}
+
+static void pendulum_ocp_setup(pendulum_ocp *ocp, ocp_nlp_solver_t nlp_solver, double theta0)
+{
+    pendulum_ocp_setup_in_arena(ocp, nlp_solver, theta0, NULL);
+}
+
+static void pendulum_ocp_create_solver(pendulum_ocp *ocp)
+{
+    ocp->config->opts_update(ocp->config, ocp->dims, ocp->opts);
+    ocp->solver = ocp_nlp_solver_create(ocp->config, ocp->dims, ocp->opts, ocp->in);
+    ocp_nlp_precompute(ocp->solver, ocp->in, ocp->out);
+}
+
+static void pendulum_ocp_set_x0(pendulum_ocp *ocp, double *x0)
+{
+    ocp_nlp_constraints_model_set(ocp->config, ocp->dims, ocp->in, ocp->out, 0, "lbx", x0);
+    ocp_nlp_constraints_model_set(ocp->config, ocp->dims, ocp->in, ocp->out, 0, "ubx", x0);
+}
+
+static void pendulum_ocp_free(pendulum_ocp *ocp)
+{
+    if (ocp->solver != NULL)
+        ocp_nlp_solver_destroy(ocp->solver);
+    ocp_nlp_solver_opts_destroy(ocp->opts);
+    ocp_nlp_out_destroy(ocp->out);
+    ocp_nlp_in_destroy(ocp->in);
+    ocp_nlp_dims_destroy(ocp->dims);
+    ocp_nlp_config_destroy(ocp->config);
+    ocp_nlp_plan_destroy(ocp->plan);
+}
+
+static int pendulum_ocp_num_eval_without_work(pendulum_ocp *ocp)
+{
+    int num = 0;
+    for (int i = 0; i < PEND_N; i++)
+    {
+        num += ocp->dyn_fun[i].num_eval_without_work;
+        num += ocp->dyn_fun_jac[i].num_eval_without_work;
+        num += ocp->dyn_fun_jac_hess[i].num_eval_without_work;
+    }
+    return num;
+}
+
+// largest absolute difference between the primal and dual iterates of two solutions
+static double pendulum_out_max_diff(ocp_nlp_dims *dims, ocp_nlp_out *out_a, ocp_nlp_out *out_b)
+{
+    double diff = 0.0;
+    for (int i = 0; i <= dims->N; i++)
+    {
+        for (int j = 0; j < dims->nv[i]; j++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(out_a->ux+i, j) - BLASFEO_DVECEL(out_b->ux+i, j)));
+        for (int j = 0; j < 2*dims->ni[i]; j++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(out_a->lam+i, j) - BLASFEO_DVECEL(out_b->lam+i, j)));
+        if (i < dims->N)
+        {
+            for (int j = 0; j < dims->nx[i+1]; j++)
+                diff = fmax(diff, fabs(BLASFEO_DVECEL(out_a->pi+i, j) - BLASFEO_DVECEL(out_b->pi+i, j)));
+        }
+    }
+    return diff;
+}
+
+
+
+TEST_CASE("pendulum: fused and separate stage evaluations", "[ocp_nlp][fused]")
+{
+    for (int compute_adj = 0; compute_adj < 2; compute_adj++)
+    {
+        SECTION("compute_adj = " + std::to_string(compute_adj))
+        {
+            pendulum_ocp ocp[2];
+            for (int fuse = 0; fuse < 2; fuse++)
+            {
+                pendulum_ocp_setup(&ocp[fuse], SQP, 0.8);
+                ocp_nlp_solver_opts_set(ocp[fuse].config, ocp[fuse].opts, "fuse_stage_evaluations", &fuse);
+                // fixed number of iterations, without adjoints the stationarity residual is not meaningful
+                int max_iter = 6;
+                ocp_nlp_solver_opts_set(ocp[fuse].config, ocp[fuse].opts, "max_iter", &max_iter);
+                for (int i = 0; i < PEND_N; i++)
+                    ocp_nlp_solver_opts_set_at_stage(ocp[fuse].config, ocp[fuse].opts, i,
+                                                     "dynamics_compute_adj", &compute_adj);
+                pendulum_ocp_create_solver(&ocp[fuse]);
+            }
+
+            int status[2], sqp_iter[2];
+            ocp_nlp_res *res[2];
+            for (int fuse = 0; fuse < 2; fuse++)
+            {
+                status[fuse] = ocp_nlp_solve(ocp[fuse].solver, ocp[fuse].in, ocp[fuse].out);
+                ocp_nlp_get(ocp[fuse].solver, "sqp_iter", &sqp_iter[fuse]);
+                ocp_nlp_get(ocp[fuse].solver, "nlp_res", &res[fuse]);
+            }
+
+            REQUIRE(status[0] == status[1]);
+            REQUIRE(sqp_iter[0] == sqp_iter[1]);
+            REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-12);
+            REQUIRE(fabs(res[0]->inf_norm_res_stat - res[1]->inf_norm_res_stat) <= 1e-12);
+            REQUIRE(fabs(res[0]->inf_norm_res_eq - res[1]->inf_norm_res_eq) <= 1e-12);
+            REQUIRE(fabs(res[0]->inf_norm_res_ineq - res[1]->inf_norm_res_ineq) <= 1e-12);
+            REQUIRE(fabs(res[0]->inf_norm_res_comp - res[1]->inf_norm_res_comp) <= 1e-12);
+
+            for (int fuse = 0; fuse < 2; fuse++)
+                pendulum_ocp_free(&ocp[fuse]);
+        }
+    }
+}
+
+
+
+TEST_CASE("pendulum: asynchronous RTI preparation", "[ocp_nlp][rti]")
+{
+    // ocp[0]: synchronous preparation before each feedback, ocp[1]: asynchronous preparation
+    pendulum_ocp ocp[2];
+    for (int async = 0; async < 2; async++)
+    {
+        pendulum_ocp_setup(&ocp[async], SQP_RTI, 0.8);
+        ocp_nlp_solver_opts_set(ocp[async].config, ocp[async].opts, "rti_async_preparation", &async);
+        pendulum_ocp_create_solver(&ocp[async]);
+    }
+
+    int preparation = PREPARATION;
+    int feedback = FEEDBACK;
+    double x[PEND_NX] = {0.8, 0.0};
+    double u0[2][PEND_NU];
+
+    for (int k = 0; k < 10; k++)
+    {
+        for (int async = 0; async < 2; async++)
+        {
+            pendulum_ocp *p = &ocp[async];
+            if (!async || k == 0)
+            {
+                ocp_nlp_solver_opts_set(p->config, p->opts, "rti_phase", &preparation);
+                ocp_nlp_solve(p->solver, p->in, p->out);
+            }
+            else if (k % 2)
+            {
+                // the preparation started by the previous feedback reads nlp_in
+                ocp_nlp_solver_wait_async(p->solver);
+            }
+            // for even k, the setters wait for the preparation
+            pendulum_ocp_set_x0(p, x);
+
+            ocp_nlp_solver_opts_set(p->config, p->opts, "rti_phase", &feedback);
+            ocp_nlp_solve(p->solver, p->in, p->out);
+            ocp_nlp_out_get(p->config, p->dims, p->out, 0, "u", u0[async]);
+        }
+
+        // the preparation running in the background only reads nlp_out
+        REQUIRE(u0[0][0] == u0[1][0]);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) == 0.0);
+
+        if (k > 0)
+        {
+            // timings of the asynchronous preparation are kept
+            double time_preparation, time_lin;
+            ocp_nlp_get(ocp[1].solver, "time_preparation", &time_preparation);
+            ocp_nlp_get(ocp[1].solver, "time_lin", &time_lin);
+            REQUIRE(time_preparation > 0.0);
+            REQUIRE(time_lin > 0.0);
+        }
+
+        // simulate the pendulum
+        double theta = x[0];
+        x[0] = theta + PEND_DT * x[1];
+        x[1] = x[1] + PEND_DT * (-sin(theta) + u0[0][0]);
+    }
+
+    for (int async = 0; async < 2; async++)
+        pendulum_ocp_free(&ocp[async]);
+}
+
+
+
+TEST_CASE("pendulum: batch solver", "[ocp_nlp][batch]")
+{
+    const int batch_size = 4;
+    const int num_threads = 2;
+    double theta0[batch_size] = {0.2, 0.5, 0.8, -0.6};
+
+    // standalone solver of each instance
+    pendulum_ocp ocp[batch_size];
+    for (int b = 0; b < batch_size; b++)
+    {
+        pendulum_ocp_setup(&ocp[b], SQP, theta0[b]);
+        pendulum_ocp_create_solver(&ocp[b]);
+        REQUIRE(ocp_nlp_solve(ocp[b].solver, ocp[b].in, ocp[b].out) == ACADOS_SUCCESS);
+    }
+
+    // batch with config and dims of the first instance, options and models set after creation
+    pendulum_ocp *ref = &ocp[0];
+    ocp_nlp_batch_solver *batch = ocp_nlp_batch_solver_create(ref->config, ref->dims, batch_size, num_threads);
+    int max_iter = 50;
+    double tol = 1e-10;
+    ocp_nlp_batch_solver_opts_set(batch, "max_iter", &max_iter);
+    ocp_nlp_batch_solver_opts_set(batch, "tol_stat", &tol);
+    ocp_nlp_batch_solver_opts_set(batch, "tol_eq", &tol);
+    ocp_nlp_batch_solver_opts_set(batch, "tol_ineq", &tol);
+    ocp_nlp_batch_solver_opts_set(batch, "tol_comp", &tol);
+
+    pendulum_ocp *lane = (pendulum_ocp *) calloc(batch_size, sizeof(pendulum_ocp));
+    for (int b = 0; b < batch_size; b++)
+        pendulum_in_set(ref->config, ref->dims, batch->nlp_in[b], batch->nlp_out[b], lane[b].dyn_fun,
+                        lane[b].dyn_fun_jac, lane[b].dyn_fun_jac_hess, theta0[b]);
+
+    REQUIRE(ocp_nlp_batch_precompute(batch) == 0);
+    REQUIRE(ocp_nlp_batch_solve(batch, batch_size) == 0);
+
+    for (int b = 0; b < batch_size; b++)
+    {
+        REQUIRE(batch->status[b] == ACADOS_SUCCESS);
+        REQUIRE(pendulum_out_max_diff(ref->dims, ocp[b].out, batch->nlp_out[b]) == 0.0);
+        // the external function workspaces are part of the solver memory of each lane
+        REQUIRE(pendulum_ocp_num_eval_without_work(&lane[b]) == 0);
+        REQUIRE(lane[b].dyn_fun_jac[0].num_eval > 0);
+    }
+
+    ocp_nlp_batch_solver_destroy(batch);
+    free(lane);
+    for (int b = 0; b < batch_size; b++)
+        pendulum_ocp_free(&ocp[b]);
+}
+
+
+
+TEST_CASE("pendulum: solver in an arena", "[ocp_nlp][arena]")
+{
+    // heap allocated reference
+    pendulum_ocp ref;
+    pendulum_ocp_setup(&ref, SQP, 0.8);
+
+    // sized with the external functions of the reference, which evaluate in the solver workspace
+    acados_size_t bytes = ocp_nlp_arena_calculate_size(ref.config, ref.dims, ref.opts, ref.in);
+
+    pendulum_ocp_create_solver(&ref);
+    REQUIRE(ocp_nlp_solve(ref.solver, ref.in, ref.out) == ACADOS_SUCCESS);
+
+    void *memory = malloc(bytes);
+    acados_arena arena;
+    acados_arena_init(&arena, memory, bytes);
+
+    pendulum_ocp ocp;
+    pendulum_ocp_setup_in_arena(&ocp, SQP, 0.8, &arena);
+    pendulum_ocp_create_solver(&ocp);
+
+    REQUIRE(arena.used <= arena.size);
+    REQUIRE((char *) ocp.solver >= arena.base);
+    REQUIRE((char *) ocp.solver < arena.base + arena.used);
+
+    REQUIRE(ocp_nlp_solve(ocp.solver, ocp.in, ocp.out) == ACADOS_SUCCESS);
+    REQUIRE(pendulum_out_max_diff(ocp.dims, ocp.out, ref.out) == 0.0);
+
+    // destroy does not free arena memory, including the options
+    pendulum_ocp_free(&ocp);
+    free(memory);
+
+    pendulum_ocp_free(&ref);
+}
+
+
+
+TEST_CASE("pendulum: deadline", "[ocp_nlp][deadline]")
+{
+    pendulum_ocp ocp;
+    pendulum_ocp_setup(&ocp, SQP, 0.8);
+    pendulum_ocp_create_solver(&ocp);
+
+    int sqp_iter;
+    ocp_nlp_res *res;
+
+    SECTION("passed deadline returns the initial guess with its residuals")
+    {
+        double deadline = acados_time_now();
+        ocp_nlp_solver_opts_set(ocp.config, ocp.opts, "deadline", &deadline);
+
+        REQUIRE(ocp_nlp_solve(ocp.solver, ocp.in, ocp.out) == ACADOS_DEADLINE);
+        ocp_nlp_get(ocp.solver, "sqp_iter", &sqp_iter);
+        ocp_nlp_get(ocp.solver, "nlp_res", &res);
+        REQUIRE(sqp_iter == 0);
+        for (int i = 0; i <= PEND_N; i++)
+            for (int j = 0; j < ocp.dims->nv[i]; j++)
+                REQUIRE(BLASFEO_DVECEL(ocp.out->ux+i, j) == 0.0);
+        // x0 = 0.8 is violated by the initial guess
+        REQUIRE(res->inf_norm_res_ineq >= 0.8);
+    }
+
+    SECTION("the termination check comes before the deadline")
+    {
+        REQUIRE(ocp_nlp_solve(ocp.solver, ocp.in, ocp.out) == ACADOS_SUCCESS);
+
+        // warm started at the solution, converged before the deadline is checked
+        double deadline = acados_time_now();
+        ocp_nlp_solver_opts_set(ocp.config, ocp.opts, "deadline", &deadline);
+        REQUIRE(ocp_nlp_solve(ocp.solver, ocp.in, ocp.out) == ACADOS_SUCCESS);
+        ocp_nlp_get(ocp.solver, "sqp_iter", &sqp_iter);
+        REQUIRE(sqp_iter == 0);
+    }
+
+    SECTION("deadline far ahead does not change the solution")
+    {
+        pendulum_ocp ref;
+        pendulum_ocp_setup(&ref, SQP, 0.8);
+        pendulum_ocp_create_solver(&ref);
+        REQUIRE(ocp_nlp_solve(ref.solver, ref.in, ref.out) == ACADOS_SUCCESS);
+
+        double deadline = acados_time_now() + 100.0;
+        ocp_nlp_solver_opts_set(ocp.config, ocp.opts, "deadline", &deadline);
+        REQUIRE(ocp_nlp_solve(ocp.solver, ocp.in, ocp.out) == ACADOS_SUCCESS);
+        REQUIRE(pendulum_out_max_diff(ocp.dims, ocp.out, ref.out) == 0.0);
+
+        pendulum_ocp_free(&ref);
+    }
+
+    pendulum_ocp_free(&ocp);
+}
+
+
+
+// uniform in [-1, 1], deterministic
+static double pendulum_rand(unsigned *state)
+{
+    *state = 1664525u * *state + 1013904223u;
+    return 2.0 * (*state >> 8) / (double) (1u << 24) - 1.0;
+}
+
+// entries are tagged with an id in their first control
+static void pendulum_cache_insert(ocp_nlp_warm_start_cache *cache, pendulum_ocp *ocp, double *key, double id)
+{
+    BLASFEO_DVECEL(ocp->out->ux+0, 0) = id;
+    ocp_nlp_warm_start_cache_insert(cache, ocp->dims, key, ocp->out);
+}
+
+// id of the returned entry, -1 on a miss
+static int pendulum_cache_lookup(ocp_nlp_warm_start_cache *cache, pendulum_ocp *ocp, double *key)
+{
+    if (!ocp_nlp_warm_start_cache_lookup(cache, ocp->dims, key, ocp->out))
+        return -1;
+    return (int) BLASFEO_DVECEL(ocp->out->ux+0, 0);
+}
+
+static double pendulum_key_dist2(double *a, double *b)
+{
+    double dist2 = 0.0;
+    for (int j = 0; j < PEND_NX; j++)
+        dist2 += (a[j] - b[j]) * (a[j] - b[j]);
+    return dist2;
+}
+
+
+
+TEST_CASE("pendulum: warm-start cache", "[ocp_nlp][warm_start_cache]")
+{
+    pendulum_ocp ocp;
+    pendulum_ocp_setup(&ocp, SQP, 0.8);
+
+    ocp_nlp_warm_start_cache_opts opts;
+    ocp_nlp_warm_start_cache_opts_initialize_default(&opts);
+
+    int key_dim, capacity, num_entries, num_rebuilds;
+
+    SECTION("nearest lookup matches brute force while entries are inserted")
+    {
+        const int num_keys = 150;
+        double keys[num_keys][PEND_NX];
+        unsigned state = 1;
+
+        opts.budget = 1 << 22;
+        ocp_nlp_warm_start_cache *cache = ocp_nlp_warm_start_cache_create(ocp.config, ocp.dims, &opts);
+        ocp_nlp_warm_start_cache_get(cache, "key_dim", &key_dim);
+        ocp_nlp_warm_start_cache_get(cache, "capacity", &capacity);
+        REQUIRE(key_dim == PEND_NX);
+        REQUIRE(capacity >= num_keys);
+
+        for (int k = 0; k < num_keys; k++)
+        {
+            for (int j = 0; j < PEND_NX; j++)
+                keys[k][j] = pendulum_rand(&state);
+            pendulum_cache_insert(cache, &ocp, keys[k], k);
+
+            double query[PEND_NX];
+            for (int j = 0; j < PEND_NX; j++)
+                query[j] = pendulum_rand(&state);
+            double dist2_min = pendulum_key_dist2(query, keys[0]);
+            for (int m = 1; m <= k; m++)
+                dist2_min = fmin(dist2_min, pendulum_key_dist2(query, keys[m]));
+
+            int id = pendulum_cache_lookup(cache, &ocp, query);
+            REQUIRE(id >= 0);
+            REQUIRE(id <= k);
+            REQUIRE(pendulum_key_dist2(query, keys[id]) == dist2_min);
+        }
+
+        // the tree is rebuilt after batches of insertions, not after each one
+        ocp_nlp_warm_start_cache_get(cache, "num_entries", &num_entries);
+        ocp_nlp_warm_start_cache_get(cache, "num_rebuilds", &num_rebuilds);
+        REQUIRE(num_entries == num_keys);
+        REQUIRE(num_rebuilds > 0);
+        REQUIRE(num_rebuilds < num_keys / 4);
+
+        ocp_nlp_warm_start_cache_destroy(cache);
+    }
+
+    SECTION("LRU and FIFO eviction")
+    {
+        // budget for exactly three entries
+        opts.budget = 1 << 22;
+        ocp_nlp_warm_start_cache *cache = ocp_nlp_warm_start_cache_create(ocp.config, ocp.dims, &opts);
+        ocp_nlp_warm_start_cache_get(cache, "capacity", &capacity);
+        ocp_nlp_warm_start_cache_destroy(cache);
+        REQUIRE(capacity > 3);
+        acados_size_t budget = 3 * (opts.budget / capacity);
+
+        double keys[4][PEND_NX] = {{0.0, 0.0}, {10.0, 0.0}, {20.0, 0.0}, {30.0, 0.0}};
+        opts.lookup_tol = 1.0;
+        opts.budget = budget;
+
+        for (int fifo = 0; fifo < 2; fifo++)
+        {
+            opts.eviction = fifo ? WARM_START_CACHE_EVICT_FIFO : WARM_START_CACHE_EVICT_LRU;
+            cache = ocp_nlp_warm_start_cache_create(ocp.config, ocp.dims, &opts);
+            ocp_nlp_warm_start_cache_get(cache, "capacity", &capacity);
+            REQUIRE(capacity == 3);
+
+            for (int k = 0; k < 3; k++)
+                pendulum_cache_insert(cache, &ocp, keys[k], k);
+            // entry 0 is the oldest insertion, but the most recently used one
+            REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[0]) == 0);
+            pendulum_cache_insert(cache, &ocp, keys[3], 3);
+
+            ocp_nlp_warm_start_cache_get(cache, "num_entries", &num_entries);
+            REQUIRE(num_entries == 3);
+            REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[0]) == (fifo ? -1 : 0));
+            REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[1]) == (fifo ? 1 : -1));
+            REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[2]) == 2);
+            REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[3]) == 3);
+
+            ocp_nlp_warm_start_cache_destroy(cache);
+        }
+    }
+
+    SECTION("insertions within insert_tol replace the nearby entry")
+    {
+        double keys[3][PEND_NX] = {{0.0, 0.0}, {0.1, 0.0}, {1.0, 0.0}};
+        double query[PEND_NX] = {0.45, 0.0};
+        opts.insert_tol = 0.5;
+        opts.lookup_tol = 0.4;
+        ocp_nlp_warm_start_cache *cache = ocp_nlp_warm_start_cache_create(ocp.config, ocp.dims, &opts);
+
+        pendulum_cache_insert(cache, &ocp, keys[0], 0);
+        pendulum_cache_insert(cache, &ocp, keys[1], 1);
+        ocp_nlp_warm_start_cache_get(cache, "num_entries", &num_entries);
+        REQUIRE(num_entries == 1);
+        REQUIRE(pendulum_cache_lookup(cache, &ocp, keys[0]) == 1);
+
+        pendulum_cache_insert(cache, &ocp, keys[2], 2);
+        ocp_nlp_warm_start_cache_get(cache, "num_entries", &num_entries);
+        REQUIRE(num_entries == 2);
+        // the replaced entry moved to its new key, the query is out of lookup_tol of the old one
+        REQUIRE(pendulum_cache_lookup(cache, &ocp, query) == 1);
+
+        ocp_nlp_warm_start_cache_destroy(cache);
+    }
+
+    pendulum_ocp_free(&ocp);
+}
+
+
+
+TEST_CASE("pendulum: QP matrix reuse", "[ocp_nlp][memo]")
+{
+    // ocp[0] reuses the condensed QP matrices when re-solved from the same iterate, which requires
+    // with_memoization; ocp[1] is the reference without memoization. One SQP iteration per call,
+    // such that the QP matrices of the last QP solve are the ones of the initial iterate.
+    pendulum_ocp ocp[2];
+    for (int k = 0; k < 2; k++)
+    {
+        pendulum_ocp_setup(&ocp[k], SQP, 0.8);
+        int with_memoization = k == 0;
+        int max_iter = 1;
+        ocp_nlp_solver_opts_set(ocp[k].config, ocp[k].opts, "with_memoization", &with_memoization);
+        ocp_nlp_solver_opts_set(ocp[k].config, ocp[k].opts, "max_iter", &max_iter);
+        pendulum_ocp_create_solver(&ocp[k]);
+    }
+    ocp_nlp_out *init = ocp_nlp_out_create(ocp[0].config, ocp[0].dims);
+    ocp_nlp_out *sol = ocp_nlp_out_create(ocp[0].config, ocp[0].dims);
+    copy_ocp_nlp_out(ocp[0].dims, ocp[0].out, init);
+
+    int reused = -1;
+    ocp_nlp_solve(ocp[0].solver, ocp[0].in, ocp[0].out);
+    ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+    REQUIRE(reused == 0);
+    copy_ocp_nlp_out(ocp[0].dims, ocp[0].out, sol);
+
+    // without memoization, every QP approximation marks its stage as changed
+    ocp_nlp_solve(ocp[1].solver, ocp[1].in, ocp[1].out);
+    copy_ocp_nlp_out(ocp[1].dims, init, ocp[1].out);
+    ocp_nlp_solve(ocp[1].solver, ocp[1].in, ocp[1].out);
+    ocp_nlp_get(ocp[1].solver, "qp_lhs_reused", &reused);
+    REQUIRE(reused == 0);
+
+    SECTION("unchanged data")
+    {
+        copy_ocp_nlp_out(ocp[0].dims, init, ocp[0].out);
+        ocp_nlp_solve(ocp[0].solver, ocp[0].in, ocp[0].out);
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 1);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, sol) == 0.0);
+    }
+
+    SECTION("bound change")
+    {
+        // bounds only enter the QP vectors
+        double x0[PEND_NX] = {0.5, 0.2};
+        for (int k = 0; k < 2; k++)
+        {
+            pendulum_ocp_set_x0(&ocp[k], x0);
+            copy_ocp_nlp_out(ocp[k].dims, init, ocp[k].out);
+            ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        }
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 1);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-12);
+    }
+
+    SECTION("reference change")
+    {
+        // the reference only enters the cost gradient of the linear least squares cost
+        double yref[3] = {0.3, -0.1, 0.2};
+        for (int k = 0; k < 2; k++)
+        {
+            ocp_nlp_cost_model_set(ocp[k].config, ocp[k].dims, ocp[k].in, 3, "yref", yref);
+            copy_ocp_nlp_out(ocp[k].dims, init, ocp[k].out);
+            ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        }
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 1);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-12);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, sol) > 0.0);
+    }
+
+    SECTION("cost change")
+    {
+        double W[9] = {2.0, 0.0, 0.0, 0.0, 0.1, 0.0, 0.0, 0.0, 0.01};
+        for (int k = 0; k < 2; k++)
+        {
+            ocp_nlp_cost_model_set(ocp[k].config, ocp[k].dims, ocp[k].in, 3, "W", W);
+            copy_ocp_nlp_out(ocp[k].dims, init, ocp[k].out);
+            ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        }
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 0);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-12);
+    }
+
+    SECTION("parameter pointer")
+    {
+        // the caller may write through the pointer, the stage is marked as changed
+        double *p = NULL;
+        ocp_nlp_in_get(ocp[0].config, ocp[0].dims, ocp[0].in, 3, "parameter_pointer", &p);
+        copy_ocp_nlp_out(ocp[0].dims, init, ocp[0].out);
+        ocp_nlp_solve(ocp[0].solver, ocp[0].in, ocp[0].out);
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 0);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, sol) <= 1e-12);
+
+        // the next re-solve reuses the matrices again
+        copy_ocp_nlp_out(ocp[0].dims, init, ocp[0].out);
+        ocp_nlp_solve(ocp[0].solver, ocp[0].in, ocp[0].out);
+        ocp_nlp_get(ocp[0].solver, "qp_lhs_reused", &reused);
+        REQUIRE(reused == 1);
+    }
+
+    ocp_nlp_out_destroy(sol);
+    ocp_nlp_out_destroy(init);
+    for (int k = 0; k < 2; k++)
+        pendulum_ocp_free(&ocp[k]);
+}
+
+
+
+TEST_CASE("pendulum: memoized stage evaluations", "[ocp_nlp][memo]")
+{
+    // ocp[0] uses with_memoization, ocp[1] evaluates every stage afresh. A memo hit has to give
+    // bit-identical iterates and residuals. One SQP iteration per call, such that the last QP
+    // approximation is the one at the initial iterate.
+    pendulum_ocp ocp[2];
+    for (int k = 0; k < 2; k++)
+    {
+        pendulum_ocp_setup(&ocp[k], SQP, 0.8);
+        int with_memoization = k == 0;
+        int max_iter = 1;
+        ocp_nlp_solver_opts_set(ocp[k].config, ocp[k].opts, "with_memoization", &with_memoization);
+        ocp_nlp_solver_opts_set(ocp[k].config, ocp[k].opts, "max_iter", &max_iter);
+        pendulum_ocp_create_solver(&ocp[k]);
+    }
+    ocp_nlp_out *init = ocp_nlp_out_create(ocp[0].config, ocp[0].dims);
+    copy_ocp_nlp_out(ocp[0].dims, ocp[0].out, init);
+
+    int evals[OCP_NLP_MEMO_NUM], hits[OCP_NLP_MEMO_NUM];
+    int status[2];
+    ocp_nlp_res *res[2];
+
+    // fresh evaluations on both solvers
+    for (int k = 0; k < 2; k++)
+        status[k] = ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+    ocp_nlp_get(ocp[0].solver, "memo_evals", evals);
+    ocp_nlp_get(ocp[0].solver, "memo_hits", hits);
+    REQUIRE(evals[OCP_NLP_MEMO_QP] == PEND_N+1);
+    REQUIRE(hits[OCP_NLP_MEMO_QP] == 0);
+    REQUIRE(status[0] == status[1]);
+    REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) == 0.0);
+
+    // ocp[0] re-solves from the memoized iterate
+    for (int k = 0; k < 2; k++)
+    {
+        copy_ocp_nlp_out(ocp[k].dims, init, ocp[k].out);
+        status[k] = ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        ocp_nlp_get(ocp[k].solver, "nlp_res", &res[k]);
+    }
+    ocp_nlp_get(ocp[0].solver, "memo_evals", evals);
+    ocp_nlp_get(ocp[0].solver, "memo_hits", hits);
+    REQUIRE(hits[OCP_NLP_MEMO_QP] == PEND_N+1);
+    REQUIRE(evals[OCP_NLP_MEMO_QP] == 0);
+    REQUIRE(status[0] == status[1]);
+    REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) == 0.0);
+    REQUIRE(res[0]->inf_norm_res_stat == res[1]->inf_norm_res_stat);
+    REQUIRE(res[0]->inf_norm_res_eq == res[1]->inf_norm_res_eq);
+    REQUIRE(res[0]->inf_norm_res_ineq == res[1]->inf_norm_res_ineq);
+    REQUIRE(res[0]->inf_norm_res_comp == res[1]->inf_norm_res_comp);
+
+    // further solves continue from new iterates
+    for (int iter = 0; iter < 3; iter++)
+    {
+        for (int k = 0; k < 2; k++)
+            status[k] = ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        REQUIRE(status[0] == status[1]);
+        REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) == 0.0);
+    }
+
+    ocp_nlp_out_destroy(init);
+    for (int k = 0; k < 2; k++)
+        pendulum_ocp_free(&ocp[k]);
+}
+
+
+
+TEST_CASE("pendulum: QP autotune", "[ocp_nlp][autotune]")
+{
+    // ocp[0] tunes cond_N at precompute, ocp[1] keeps the default cond_N = N
+    pendulum_ocp ocp[2];
+    for (int k = 0; k < 2; k++)
+    {
+        pendulum_ocp_setup(&ocp[k], SQP, 0.8);
+        int autotune_qp = k == 0 ? 3 : 0;
+        ocp_nlp_solver_opts_set(ocp[k].config, ocp[k].opts, "autotune_qp", &autotune_qp);
+        pendulum_ocp_create_solver(&ocp[k]);
+    }
+
+    // the picked horizon is one of the candidates N, N/2, ..., 1, the qp solver is not switched
+    ocp_qp_xcond_solver_config *qp_solver = ocp[0].config->qp_solver;
+    int cond_N = -1;
+    qp_solver->xcond->dims_get(qp_solver->xcond, ocp[0].dims->qp_solver->xcond_dims, "cond_N", &cond_N);
+    bool is_candidate = false;
+    for (int N2 = PEND_N; N2 > 0; N2 /= 2)
+        is_candidate = is_candidate || cond_N == N2;
+    REQUIRE(is_candidate);
+
+    int status[2], sqp_iter[2];
+    for (int k = 0; k < 2; k++)
+    {
+        status[k] = ocp_nlp_solve(ocp[k].solver, ocp[k].in, ocp[k].out);
+        ocp_nlp_get(ocp[k].solver, "sqp_iter", &sqp_iter[k]);
+    }
+    REQUIRE(status[0] == ACADOS_SUCCESS);
+    REQUIRE(status[1] == ACADOS_SUCCESS);
+    REQUIRE(sqp_iter[0] == sqp_iter[1]);
+    REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-8);
+
+    // a second precompute tunes again, starting from the horizon picked before
+    REQUIRE(ocp_nlp_precompute(ocp[0].solver, ocp[0].in, ocp[0].out) == ACADOS_SUCCESS);
+    qp_solver->xcond->dims_get(qp_solver->xcond, ocp[0].dims->qp_solver->xcond_dims, "cond_N", &cond_N);
+    is_candidate = false;
+    for (int N2 = PEND_N; N2 > 0; N2 /= 2)
+        is_candidate = is_candidate || cond_N == N2;
+    REQUIRE(is_candidate);
+    REQUIRE(ocp_nlp_solve(ocp[0].solver, ocp[0].in, ocp[0].out) == ACADOS_SUCCESS);
+    REQUIRE(pendulum_out_max_diff(ocp[0].dims, ocp[0].out, ocp[1].out) <= 1e-8);
+
+    for (int k = 0; k < 2; k++)
+        pendulum_ocp_free(&ocp[k]);
+}
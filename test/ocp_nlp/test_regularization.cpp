@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <math.h>
+#include <stdlib.h>
+#include <string>
+
+#include "catch/include/catch.hpp"
+
+// blasfeo
+#include "blasfeo_d_aux.h"
+
+// acados
+#include "acados/ocp_nlp/ocp_nlp_reg_common.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_mirror.h"
+#include "acados/ocp_nlp/ocp_nlp_reg_project.h"
+
+
+
+/************************************************
+ * Hessian blocks with known spectrum, A = H * diag(lam) * H with a Householder reflection H
+ ************************************************/
+
+#define REG_N 4
+#define REG_NX 3
+#define REG_NU 2
+#define REG_NUX (REG_NX + REG_NU)
+
+// eps = 1e-4: well above, indefinite, below, just above, singular
+static const double reg_lam[REG_N+1][REG_NUX] = {
+    {1.0, 2.0, 3.0, 4.0, 5.0},
+    {-2.0, -0.5, 0.3, 1.0, 4.0},
+    {1e-6, 0.1, 1.0, 2.0, 3.0},
+    {2e-4, 0.5, 1.0, 2.0, 3.0},
+    {0.0, 0.0, 1.0, 1.0, 1.0},
+};
+
+
+
+// column-major A of dimension REG_NUX with eigenvalues lam
+static void reg_block(const double *lam, double *A)
+{
+    double v[REG_NUX] = {1.0, 2.0, -1.0, 3.0, 0.5};
+    double vtv = 0.0;
+    for (int i = 0; i < REG_NUX; i++)
+        vtv += v[i] * v[i];
+
+    double H[REG_NUX*REG_NUX];
+    for (int j = 0; j < REG_NUX; j++)
+        for (int i = 0; i < REG_NUX; i++)
+            H[i+j*REG_NUX] = (i == j ? 1.0 : 0.0) - 2.0 * v[i] * v[j] / vtv;
+
+    // lower triangle, mirrored such that A is symmetric bit for bit
+    for (int j = 0; j < REG_NUX; j++)
+    {
+        for (int i = j; i < REG_NUX; i++)
+        {
+            A[i+j*REG_NUX] = 0.0;
+            for (int k = 0; k < REG_NUX; k++)
+                A[i+j*REG_NUX] += H[i+k*REG_NUX] * lam[k] * H[j+k*REG_NUX];
+            A[j+i*REG_NUX] = A[i+j*REG_NUX];
+        }
+    }
+}
+
+
+
+static double reg_lam_min(const double *lam)
+{
+    double lam_min = lam[0];
+    for (int k = 1; k < REG_NUX; k++)
+        lam_min = fmin(lam_min, lam[k]);
+    return lam_min;
+}
+
+
+
+TEST_CASE("regularization: shifted Cholesky screen", "[ocp_nlp][regularization]")
+{
+    double A[REG_NUX*REG_NUX];
+    struct blasfeo_dmat sA, sL;
+    void *mem = malloc(2 * blasfeo_memsize_dmat(REG_NUX, REG_NUX) + 64);
+    char *c_ptr = (char *) (((size_t) mem + 63) / 64 * 64);
+    blasfeo_create_dmat(REG_NUX, REG_NUX, &sA, c_ptr);
+    c_ptr += blasfeo_memsize_dmat(REG_NUX, REG_NUX);
+    blasfeo_create_dmat(REG_NUX, REG_NUX, &sL, c_ptr);
+
+    double shifts[3] = {1e-4, 0.05, 0.2};
+    for (int ii = 0; ii <= REG_N; ii++)
+    {
+        reg_block(reg_lam[ii], A);
+        blasfeo_pack_dmat(REG_NUX, REG_NUX, A, REG_NUX, &sA, 0, 0);
+
+        // agrees with the spectrum, for shifts away from the eigenvalues
+        for (double shift : shifts)
+        {
+            bool above = reg_lam_min(reg_lam[ii]) > shift;
+            REQUIRE(acados_reg_eig_above(REG_NUX, &sA, 0, 0, shift, &sL) == above);
+        }
+
+        // the matrix itself is not modified
+        for (int j = 0; j < REG_NUX; j++)
+            for (int i = j; i < REG_NUX; i++)
+                REQUIRE(BLASFEO_DMATEL(&sA, i, j) == A[i+j*REG_NUX]);
+
+        // Gershgorin bound on the spectral radius
+        double lam_abs_max = 0.0;
+        for (int k = 0; k < REG_NUX; k++)
+            lam_abs_max = fmax(lam_abs_max, fabs(reg_lam[ii][k]));
+        REQUIRE(acados_reg_eig_abs_bound(REG_NUX, &sA, 0, 0) >= lam_abs_max - 1e-12);
+    }
+
+    free(mem);
+}
+
+
+
+TEST_CASE("regularization: screened and eigen regularization", "[ocp_nlp][regularization]")
+{
+    std::string modules[2] = {"PROJECT", "MIRROR"};
+
+    for (std::string module : modules)
+    {
+        for (int adaptive = 0; adaptive < 2; adaptive++)
+        {
+            SECTION(module + (adaptive ? " adaptive_eps" : ""))
+            {
+                void *config_mem = malloc(ocp_nlp_reg_config_calculate_size());
+                ocp_nlp_reg_config *config = (ocp_nlp_reg_config *) ocp_nlp_reg_config_assign(config_mem);
+                if (module == "PROJECT")
+                    ocp_nlp_reg_project_config_initialize_default(config);
+                else
+                    ocp_nlp_reg_mirror_config_initialize_default(config);
+
+                void *dims_mem = malloc(config->dims_calculate_size(REG_N));
+                ocp_nlp_reg_dims *dims = config->dims_assign(REG_N, dims_mem);
+                int nx = REG_NX, nu = REG_NU, zero = 0;
+                for (int ii = 0; ii <= REG_N; ii++)
+                {
+                    config->dims_set(config, dims, ii, (char *) "nx", &nx);
+                    config->dims_set(config, dims, ii, (char *) "nu", &nu);
+                    config->dims_set(config, dims, ii, (char *) "nbu", &zero);
+                    config->dims_set(config, dims, ii, (char *) "nbx", &zero);
+                    config->dims_set(config, dims, ii, (char *) "ng", &zero);
+                }
+
+                void *opts_mem = malloc(config->opts_calculate_size());
+                void *opts = config->opts_assign(opts_mem);
+                config->opts_initialize_default(config, dims, opts);
+                bool adaptive_eps = adaptive;
+                config->opts_set(config, opts, "adaptive_eps", &adaptive_eps);
+                double epsilon = 1e-4;
+                double min_epsilon = 1e-8;
+                double max_cond_block = 1e7;
+                config->opts_set(config, opts, "epsilon", &epsilon);
+                config->opts_set(config, opts, "min_epsilon", &min_epsilon);
+                config->opts_set(config, opts, "max_cond_block", &max_cond_block);
+
+                void *mem_mem = malloc(config->memory_calculate_size(config, dims, opts));
+                void *mem = config->memory_assign(config, dims, opts, mem_mem);
+
+                // RSQrq, with the gradient row below the Hessian block
+                struct blasfeo_dmat RSQrq[REG_N+1];
+                acados_size_t RSQrq_size = blasfeo_memsize_dmat(REG_NUX+1, REG_NUX);
+                void *RSQrq_mem = malloc((REG_N+1) * RSQrq_size + 64);
+                char *c_ptr = (char *) (((size_t) RSQrq_mem + 63) / 64 * 64);
+                double A[REG_N+1][REG_NUX*REG_NUX];
+                for (int ii = 0; ii <= REG_N; ii++)
+                {
+                    blasfeo_create_dmat(REG_NUX+1, REG_NUX, RSQrq+ii, c_ptr);
+                    c_ptr += RSQrq_size;
+                    reg_block(reg_lam[ii], A[ii]);
+                    blasfeo_pack_dmat(REG_NUX, REG_NUX, A[ii], REG_NUX, RSQrq+ii, 0, 0);
+                    for (int j = 0; j < REG_NUX; j++)
+                        BLASFEO_DMATEL(RSQrq+ii, REG_NUX, j) = 0.1 * (j+1);
+                }
+                config->memory_set_RSQrq_ptr(dims, RSQrq, mem);
+
+                config->regularize(config, dims, opts, mem);
+
+                for (int ii = 0; ii <= REG_N; ii++)
+                {
+                    // reference: eigen decomposition of every block
+                    double A_ref[REG_NUX*REG_NUX], V[REG_NUX*REG_NUX], d[REG_NUX], e[REG_NUX];
+                    for (int k = 0; k < REG_NUX*REG_NUX; k++)
+                        A_ref[k] = A[ii][k];
+                    if (module == "PROJECT" && adaptive)
+                        acados_project_adaptive_eps(REG_NUX, A_ref, V, d, e, max_cond_block, min_epsilon);
+                    else if (module == "PROJECT")
+                        acados_project(REG_NUX, A_ref, V, d, e, epsilon);
+                    else if (adaptive)
+                        acados_mirror_adaptive_eps(REG_NUX, A_ref, V, d, e, max_cond_block, min_epsilon);
+                    else
+                        acados_mirror(REG_NUX, A_ref, V, d, e, epsilon);
+
+                    double diff = 0.0;
+                    for (int j = 0; j < REG_NUX; j++)
+                        for (int i = 0; i < REG_NUX; i++)
+                            diff = fmax(diff, fabs(BLASFEO_DMATEL(RSQrq+ii, i, j) - A_ref[i+j*REG_NUX]));
+                    REQUIRE(diff <= 1e-10);
+
+                    // blocks that pass the screen skip the eigen decomposition and stay untouched
+                    if (reg_lam_min(reg_lam[ii]) > epsilon)
+                    {
+                        for (int j = 0; j < REG_NUX; j++)
+                            for (int i = 0; i < REG_NUX; i++)
+                                REQUIRE(BLASFEO_DMATEL(RSQrq+ii, i, j) == A[ii][i+j*REG_NUX]);
+                    }
+
+                    // the gradient row is not touched
+                    for (int j = 0; j < REG_NUX; j++)
+                        REQUIRE(BLASFEO_DMATEL(RSQrq+ii, REG_NUX, j) == 0.1 * (j+1));
+                }
+
+                free(RSQrq_mem);
+                free(mem_mem);
+                free(opts_mem);
+                free(dims_mem);
+                free(config_mem);
+            }
+        }
+    }
+}
@@ -29,6 +29,7 @@
  */
 
 
+#include <math.h>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -37,6 +38,9 @@
 //#include "test/test_utils/eigen.h"
 
 #include "acados_c/ocp_qp_interface.h"
+#include "acados/ocp_qp/ocp_qp_partial_condensing.h"
+#include "acados/ocp_qp/ocp_qp_record.h"
+#include "acados/utils/thread_pool.h"
 
 extern "C" {
 ocp_qp_xcond_solver_dims *create_ocp_qp_dims_mass_spring(ocp_qp_xcond_solver_config *config, int N, int nx_, int nu_, int nb_, int ng_, int ngN);
@@ -266,3 +270,554 @@ TEST_CASE("mass spring example", "[QP solvers]")
     }  // END_FOR_SOLVERS
 
 }  // END_TEST_CASE
+
+
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+TEST_CASE("mass spring example single precision", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+    int N2 = 5;
+
+    // float accuracy, the float IPM stops at OCP_QP_HPIPM_SINGLE_TOL_MIN
+    double tol_res = 1e-4;
+    double tol_sol = 1e-3;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+    ocp_qp_out *qp_out_single = ocp_qp_out_create(dims);
+
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    void *opts_single = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    config->opts_set(config, opts, "cond_N", &N2);
+    config->opts_set(config, opts_single, "cond_N", &N2);
+    int single_precision = 1;
+    config->opts_set(config, opts_single, "single_precision", &single_precision);
+
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+    ocp_qp_solver *qp_solver_single = ocp_qp_create(config, qp_dims, opts_single);
+
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+    REQUIRE(ocp_qp_solve(qp_solver_single, qp_in, qp_out_single) == 0);
+
+    // residuals of the float solution in the double QP
+    double res[4];
+    ocp_qp_inf_norm_residuals(dims, qp_in, qp_out_single, res);
+    for (int ii = 0; ii < 4; ii++)
+        REQUIRE(res[ii] <= tol_res);
+
+    // primal solution against the double path
+    double max_diff = 0.0;
+    double max_abs = 0.0;
+    for (int ii = 0; ii <= N; ii++)
+    {
+        for (int jj = 0; jj < dims->nu[ii] + dims->nx[ii]; jj++)
+        {
+            double val = BLASFEO_DVECEL(qp_out->ux+ii, jj);
+            double diff = fabs(BLASFEO_DVECEL(qp_out_single->ux+ii, jj) - val);
+            max_diff = diff > max_diff ? diff : max_diff;
+            max_abs = fabs(val) > max_abs ? fabs(val) : max_abs;
+        }
+    }
+    REQUIRE(max_diff <= tol_sol * (1.0 + max_abs));
+
+    free(qp_solver_single);
+    free(qp_solver);
+    free(qp_out_single);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(opts_single);
+    free(opts);
+    free(config);
+}  // END_TEST_CASE
+#endif
+
+
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+TEST_CASE("mass spring example mixed precision", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+    int N2 = 5;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+
+    // tolerances below the accuracy of the float IPM, OCP_QP_HPIPM_SINGLE_TOL_MIN
+    double tol = 1e-8;
+    int refine_max = 10;
+
+    // 0: single precision, 1: mixed precision
+    double res_max[2];
+    int refine_iter = 0;
+    for (int k = 0; k < 2; k++)
+    {
+        ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+        void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+        config->opts_set(config, opts, "cond_N", &N2);
+        config->opts_set(config, opts, "tol_stat", &tol);
+        config->opts_set(config, opts, "tol_eq", &tol);
+        config->opts_set(config, opts, "tol_ineq", &tol);
+        config->opts_set(config, opts, "tol_comp", &tol);
+        int one = 1;
+        config->opts_set(config, opts, k == 0 ? "single_precision" : "mixed_precision", &one);
+        if (k == 1)
+            config->opts_set(config, opts, "mixed_precision_refine_max", &refine_max);
+
+        ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+        int status = ocp_qp_solve(qp_solver, qp_in, qp_out);
+
+        double res[4];
+        ocp_qp_inf_norm_residuals(dims, qp_in, qp_out, res);
+
+        res_max[k] = 0.0;
+        for (int ii = 0; ii < 4; ii++)
+            res_max[k] = res[ii] > res_max[k] ? res[ii] : res_max[k];
+
+        if (k == 1)
+        {
+            // the double tolerances are met by refinement
+            REQUIRE(status == ACADOS_SUCCESS);
+            config->memory_get(config, qp_solver->mem, "mixed_precision_refine_iter", &refine_iter);
+            for (int ii = 0; ii < 4; ii++)
+                REQUIRE(res[ii] <= tol);
+        }
+
+        free(qp_solver);
+        free(opts);
+        free(qp_out);
+    }
+
+    // the float solution does not meet the double tolerances, refinement steps are taken
+    REQUIRE(res_max[0] > tol);
+    REQUIRE(refine_iter > 0);
+    REQUIRE(res_max[1] <= res_max[0]);
+
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}  // END_TEST_CASE
+#endif
+
+
+
+#ifdef ACADOS_WITH_OSQP
+TEST_CASE("mass spring example OSQP sparsity pattern", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_OSQP;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    config->opts_set(config, opts, "cond_N", &N);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    // cross term between the first two inputs at stage 1, zero in the mass spring QP
+    double cross = 0.01;
+    REQUIRE(BLASFEO_DMATEL(qp_in->RSQrq+1, 1, 0) == 0.0);
+
+    int pattern_setups;
+    double res[4];
+    for (int k = 0; k < 6; k++)
+    {
+        // the entry toggles between zero and nonzero
+        double val = k % 2 ? cross : 0.0;
+        BLASFEO_DMATEL(qp_in->RSQrq+1, 1, 0) = val;
+        BLASFEO_DMATEL(qp_in->RSQrq+1, 0, 1) = val;
+
+        REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+        ocp_qp_inf_norm_residuals(dims, qp_in, qp_out, res);
+        for (int ii = 0; ii < 4; ii++)
+            REQUIRE(res[ii] <= 1e-8);
+
+        // the pattern grows once and keeps the entry as explicit zero afterwards
+        config->memory_get(config, qp_solver->mem, "pattern_setups", &pattern_setups);
+        REQUIRE(pattern_setups == (k == 0 ? 0 : 1));
+    }
+
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}  // END_TEST_CASE
+#endif
+
+
+
+
+// largest absolute difference of the qp data stored in a recording
+static double qp_in_max_diff(ocp_qp_dims *dims, ocp_qp_in *a, ocp_qp_in *b)
+{
+    double diff = 0.0;
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        int nv = dims->nx[ii] + dims->nu[ii];
+        int nc = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+        for (int jj = 0; jj < nv + 1; jj++)
+            for (int kk = 0; kk < nv; kk++)
+                diff = fmax(diff, fabs(BLASFEO_DMATEL(a->RSQrq+ii, jj, kk) - BLASFEO_DMATEL(b->RSQrq+ii, jj, kk)));
+        for (int jj = 0; jj < nv + 2 * dims->ns[ii]; jj++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->rqz+ii, jj) - BLASFEO_DVECEL(b->rqz+ii, jj)));
+        for (int jj = 0; jj < nv; jj++)
+            for (int kk = 0; kk < dims->ng[ii]; kk++)
+                diff = fmax(diff, fabs(BLASFEO_DMATEL(a->DCt+ii, jj, kk) - BLASFEO_DMATEL(b->DCt+ii, jj, kk)));
+        for (int jj = 0; jj < nc; jj++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->d+ii, jj) - BLASFEO_DVECEL(b->d+ii, jj)));
+        for (int jj = 0; jj < dims->nb[ii]; jj++)
+            diff = fmax(diff, fabs((double) (a->idxb[ii][jj] - b->idxb[ii][jj])));
+        if (ii < dims->N)
+        {
+            for (int jj = 0; jj < nv + 1; jj++)
+                for (int kk = 0; kk < dims->nx[ii+1]; kk++)
+                    diff = fmax(diff, fabs(BLASFEO_DMATEL(a->BAbt+ii, jj, kk) - BLASFEO_DMATEL(b->BAbt+ii, jj, kk)));
+            for (int jj = 0; jj < dims->nx[ii+1]; jj++)
+                diff = fmax(diff, fabs(BLASFEO_DVECEL(a->b+ii, jj) - BLASFEO_DVECEL(b->b+ii, jj)));
+        }
+    }
+    return diff;
+}
+
+
+
+// largest absolute difference of the primal and dual solutions
+static double qp_out_max_diff(ocp_qp_dims *dims, ocp_qp_out *a, ocp_qp_out *b)
+{
+    double diff = 0.0;
+    for (int ii = 0; ii <= dims->N; ii++)
+    {
+        int nv = dims->nx[ii] + dims->nu[ii] + 2 * dims->ns[ii];
+        int nc = 2 * (dims->nb[ii] + dims->ng[ii] + dims->ns[ii]);
+        for (int jj = 0; jj < nv; jj++)
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->ux+ii, jj) - BLASFEO_DVECEL(b->ux+ii, jj)));
+        for (int jj = 0; jj < nc; jj++)
+        {
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->lam+ii, jj) - BLASFEO_DVECEL(b->lam+ii, jj)));
+            diff = fmax(diff, fabs(BLASFEO_DVECEL(a->t+ii, jj) - BLASFEO_DVECEL(b->t+ii, jj)));
+        }
+        if (ii < dims->N)
+        {
+            for (int jj = 0; jj < dims->nx[ii+1]; jj++)
+                diff = fmax(diff, fabs(BLASFEO_DVECEL(a->pi+ii, jj) - BLASFEO_DVECEL(b->pi+ii, jj)));
+        }
+    }
+    return diff;
+}
+
+
+
+// the k-th recorded QP differs from the mass spring QP in a cost and a bound entry
+static void qp_in_record_perturb(ocp_qp_in *qp_in, int k)
+{
+    BLASFEO_DMATEL(qp_in->RSQrq+1, 0, 0) += 0.1 * k;
+    BLASFEO_DVECEL(qp_in->d+2, 0) -= 1.0 * k;
+}
+
+
+
+TEST_CASE("mass spring example QP recording round trip", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+    const int num_records = 3;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+
+    // recorded QPs and solutions
+    ocp_qp_in *qp_in[num_records];
+    ocp_qp_out *qp_out[num_records];
+    int status[num_records];
+    for (int k = 0; k < num_records; k++)
+    {
+        qp_in[k] = create_ocp_qp_in_mass_spring(dims);
+        qp_in_record_perturb(qp_in[k], k);
+        qp_out[k] = ocp_qp_out_create(dims);
+        status[k] = ocp_qp_solve(qp_solver, qp_in[k], qp_out[k]);
+    }
+
+    ocp_qp_in *read_in = ocp_qp_in_create(dims);
+    ocp_qp_out *read_out = ocp_qp_out_create(dims);
+    const char *filename[2] = {"test_qp_record_raw.bin", "test_qp_record_compressed.bin"};
+    long file_size[2];
+
+    for (int compress = 0; compress < 2; compress++)
+    {
+        ocp_qp_recorder *rec = ocp_qp_recorder_open(filename[compress], dims, compress);
+        REQUIRE(rec != NULL);
+        for (int k = 0; k < num_records; k++)
+        {
+            REQUIRE(ocp_qp_recorder_write_in(rec, qp_in[k], k, status[k]) == 0);
+            REQUIRE(ocp_qp_recorder_write_out(rec, qp_out[k], k, status[k]) == 0);
+        }
+        REQUIRE(ocp_qp_recorder_close(rec) == 0);
+
+        FILE *file = fopen(filename[compress], "rb");
+        REQUIRE(file != NULL);
+        fseek(file, 0, SEEK_END);
+        file_size[compress] = ftell(file);
+        fclose(file);
+
+        ocp_qp_record_reader *reader = ocp_qp_record_reader_open(filename[compress]);
+        REQUIRE(reader != NULL);
+        REQUIRE(ocp_qp_record_reader_N(reader) == N);
+        REQUIRE(ocp_qp_record_reader_num_records(reader, OCP_QP_RECORD_IN) == num_records);
+        REQUIRE(ocp_qp_record_reader_num_records(reader, OCP_QP_RECORD_OUT) == num_records);
+
+        ocp_qp_dims *read_dims = ocp_qp_dims_create(N);
+        ocp_qp_record_reader_dims_set(reader, read_dims);
+        for (int ii = 0; ii <= N; ii++)
+        {
+            REQUIRE(read_dims->nx[ii] == dims->nx[ii]);
+            REQUIRE(read_dims->nu[ii] == dims->nu[ii]);
+            REQUIRE(read_dims->nb[ii] == dims->nb[ii]);
+            REQUIRE(read_dims->ng[ii] == dims->ng[ii]);
+            REQUIRE(read_dims->ns[ii] == dims->ns[ii]);
+        }
+        ocp_qp_dims_free(read_dims);
+
+        // twice, the second pass after a rewind
+        for (int pass = 0; pass < 2; pass++)
+        {
+            int kind, tag, rec_status;
+            for (int k = 0; k < num_records; k++)
+            {
+                REQUIRE(ocp_qp_record_reader_next(reader, read_in, read_out, &kind, &tag, &rec_status) == 0);
+                REQUIRE(kind == OCP_QP_RECORD_IN);
+                REQUIRE(tag == k);
+                REQUIRE(rec_status == status[k]);
+                REQUIRE(qp_in_max_diff(dims, read_in, qp_in[k]) == 0.0);
+
+                REQUIRE(ocp_qp_record_reader_next(reader, read_in, read_out, &kind, &tag, &rec_status) == 0);
+                REQUIRE(kind == OCP_QP_RECORD_OUT);
+                REQUIRE(tag == k);
+                REQUIRE(qp_out_max_diff(dims, read_out, qp_out[k]) == 0.0);
+            }
+            REQUIRE(ocp_qp_record_reader_next(reader, read_in, read_out, &kind, &tag, &rec_status) == 1);
+            ocp_qp_record_reader_rewind(reader);
+        }
+
+        ocp_qp_record_reader_close(reader);
+        remove(filename[compress]);
+    }
+
+    // consecutive records share most of their data
+    REQUIRE(file_size[1] < file_size[0]);
+
+    for (int k = 0; k < num_records; k++)
+    {
+        free(qp_in[k]);
+        free(qp_out[k]);
+    }
+    free(read_in);
+    free(read_out);
+    free(qp_solver);
+    free(opts);
+    free(qp_dims);
+    free(config);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example QP autotune", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    ocp_qp_xcond_solver_config *config = ocp_qp_xcond_solver_config_create(plan);
+    ocp_qp_xcond_solver_dims *qp_dims = create_ocp_qp_dims_mass_spring(config, N, nx_, nu_, nb_, ng_, ngN);
+    ocp_qp_dims *dims = qp_dims->orig_dims;
+
+    ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+    ocp_qp_out *qp_out = ocp_qp_out_create(dims);
+    void *opts = ocp_qp_xcond_solver_opts_create(config, qp_dims);
+    ocp_qp_solver *qp_solver = ocp_qp_create(config, qp_dims, opts);
+    REQUIRE(ocp_qp_solve(qp_solver, qp_in, qp_out) == 0);
+
+    // cond_N = 15, 7, 3, 1 with PARTIAL_CONDENSING_HPIPM, then at least FULL_CONDENSING_HPIPM
+    int n_candidates = ocp_qp_autotune_default_candidates(N, NULL, 0);
+    REQUIRE(n_candidates >= 5);
+    std::vector<ocp_qp_autotune_candidate> candidates(n_candidates);
+    REQUIRE(ocp_qp_autotune_default_candidates(N, candidates.data(), n_candidates) == n_candidates);
+    REQUIRE(ocp_qp_autotune_default_candidates(N, candidates.data(), 2) == 2);
+    int cond_N_expected[4] = {15, 7, 3, 1};
+    for (int k = 0; k < 4; k++)
+    {
+        REQUIRE(candidates[k].qp_solver == PARTIAL_CONDENSING_HPIPM);
+        REQUIRE(candidates[k].cond_N == cond_N_expected[k]);
+    }
+    REQUIRE(candidates[4].qp_solver == FULL_CONDENSING_HPIPM);
+
+    int best = ocp_qp_autotune(qp_in, candidates.data(), n_candidates, 3, 0);
+    REQUIRE(best >= 0);
+    REQUIRE(candidates[best].status == ACADOS_SUCCESS);
+    for (int k = 0; k < n_candidates; k++)
+    {
+        if (candidates[k].status == ACADOS_SUCCESS)
+            REQUIRE(candidates[best].time <= candidates[k].time);
+    }
+
+    // the picked plan solves the qp
+    ocp_qp_solver_plan_t best_plan;
+    best_plan.qp_solver = candidates[best].qp_solver;
+    ocp_qp_xcond_solver_config *best_config = ocp_qp_xcond_solver_config_create(best_plan);
+    ocp_qp_xcond_solver_dims *best_dims = ocp_qp_xcond_solver_dims_create_from_ocp_qp_dims(best_config, dims);
+    void *best_opts = ocp_qp_xcond_solver_opts_create(best_config, best_dims);
+    if (ocp_qp_solver_is_partial_condensing(best_plan.qp_solver))
+        best_config->opts_set(best_config, best_opts, "cond_N", &candidates[best].cond_N);
+    ocp_qp_solver *best_solver = ocp_qp_create(best_config, best_dims, best_opts);
+    ocp_qp_out *best_out = ocp_qp_out_create(dims);
+    REQUIRE(ocp_qp_solve(best_solver, qp_in, best_out) == 0);
+    REQUIRE(qp_out_max_diff(dims, qp_out, best_out) <= 1e-6);
+
+    free(best_solver);
+    free(best_out);
+    free(best_opts);
+    free(best_dims);
+    free(best_config);
+    free(qp_solver);
+    free(opts);
+    free(qp_out);
+    free(qp_in);
+    free(qp_dims);
+    free(config);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("mass spring example parallel partial condensing", "[QP solvers]")
+{
+    int nx_ = 8;
+    int nu_ = 3;
+    int N = 15;
+    int nb_ = 11;
+    int ng_ = 0;
+    int ngN = 0;
+
+    // without ACADOS_WITH_THREAD_POOL the pool is NULL and both solvers condense serially
+    acados_thread_pool *pool = acados_thread_pool_create(3, 0);
+
+    // equal blocks and blocks of different size
+    int N2_values[] = {5, 4};
+
+    ocp_qp_solver_plan_t plan;
+    plan.qp_solver = PARTIAL_CONDENSING_HPIPM;
+
+    for (int N2 : N2_values)
+    {
+        SECTION("N2 = " + std::to_string(N2))
+        {
+            // solver k = 1 condenses and expands the blocks on the thread pool
+            ocp_qp_xcond_solver_config *config[2];
+            ocp_qp_xcond_solver_dims *qp_dims[2];
+            void *opts[2];
+            ocp_qp_solver *qp_solver[2];
+            ocp_qp_out *qp_out[2];
+            for (int k = 0; k < 2; k++)
+            {
+                config[k] = ocp_qp_xcond_solver_config_create(plan);
+                qp_dims[k] = create_ocp_qp_dims_mass_spring(config[k], N, nx_, nu_, nb_, ng_, ngN);
+                opts[k] = ocp_qp_xcond_solver_opts_create(config[k], qp_dims[k]);
+                set_N2("SPARSE_HPIPM", config[k], opts[k], N2, N);
+                qp_solver[k] = ocp_qp_create(config[k], qp_dims[k], opts[k]);
+                qp_out[k] = ocp_qp_out_create(qp_dims[k]->orig_dims);
+            }
+            qp_solver[1]->config->memory_set(qp_solver[1]->config, qp_solver[1]->mem, "thread_pool", pool);
+
+            ocp_qp_dims *dims = qp_dims[0]->orig_dims;
+            ocp_qp_dims *pcond_dims = ((ocp_qp_partial_condensing_dims *) qp_dims[0]->xcond_dims)->pcond_dims;
+            ocp_qp_in *qp_in = create_ocp_qp_in_mass_spring(dims);
+
+            // condensing and expansion
+            for (int k = 0; k < 2; k++)
+                REQUIRE(ocp_qp_solve(qp_solver[k], qp_in, qp_out[k]) == 0);
+            ocp_qp_xcond_solver_memory *mem[2];
+            for (int k = 0; k < 2; k++)
+                mem[k] = (ocp_qp_xcond_solver_memory *) qp_solver[k]->mem;
+            REQUIRE(qp_in_max_diff(pcond_dims, (ocp_qp_in *) mem[0]->xcond_qp_in,
+                                   (ocp_qp_in *) mem[1]->xcond_qp_in) == 0.0);
+            REQUIRE(qp_out_max_diff(dims, qp_out[0], qp_out[1]) == 0.0);
+
+            // separate lhs and rhs condensing, with new matrices and bounds
+            qp_in_record_perturb(qp_in, 1);
+            for (int k = 0; k < 2; k++)
+            {
+                ocp_qp_solver *s = qp_solver[k];
+                s->config->condense_lhs(s->config, s->dims, qp_in, qp_out[k], s->opts, s->mem, s->work);
+                REQUIRE(s->config->condense_rhs_and_solve(s->config, s->dims, qp_in, qp_out[k],
+                                                          s->opts, s->mem, s->work) == 0);
+            }
+            REQUIRE(qp_in_max_diff(pcond_dims, (ocp_qp_in *) mem[0]->xcond_qp_in,
+                                   (ocp_qp_in *) mem[1]->xcond_qp_in) == 0.0);
+            REQUIRE(qp_out_max_diff(dims, qp_out[0], qp_out[1]) == 0.0);
+
+            free(qp_in);
+            for (int k = 0; k < 2; k++)
+            {
+                free(qp_solver[k]);
+                free(qp_out[k]);
+                free(opts[k]);
+                free(qp_dims[k]);
+                free(config[k]);
+            }
+        }
+    }
+
+    acados_thread_pool_destroy(pool);
+}  // END_TEST_CASE
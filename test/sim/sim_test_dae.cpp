@@ -709,3 +709,138 @@ TEST_CASE("crane_dae_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("crane_dae_irk_simplified_newton", "[integrators]")
+{
+    // the simplified Newton Jacobian includes df_dz of the algebraic equations
+    int nx = 9;
+    int nu = 2;
+    int nz = 2;
+    int NF = nx + nu;  // columns of forward seed
+
+    // both Newton variants converge to the same stage values
+    double tol = 1e-8;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &crane_dae_impl_ode_fun;
+    impl_ode_fun.casadi_work = &crane_dae_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &crane_dae_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &crane_dae_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &crane_dae_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &crane_dae_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &crane_dae_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &crane_dae_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &crane_dae_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &crane_dae_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &crane_dae_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &crane_dae_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &crane_dae_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &crane_dae_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &crane_dae_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &crane_dae_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &crane_dae_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &crane_dae_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+    sim_dims_set(config, dims, "nz", &nz);
+
+    sim_in *in = sim_in_create(config, dims);
+
+    in->T = 0.01;
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = 0.0;
+    in->x[0] = 0.8;  // xL
+    in->u[0] = 40.108149413030752;
+    in->u[1] = -50.446662212534974;
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_adj[ii] = 1.0;
+    for (int ii = nx; ii < nx + nu; ii++)
+        in->S_adj[ii] = 0.0;
+
+    // odd and even number of stages: with and without real eigenvalue of A^{-1}
+    for (int ns = 3; ns < 5; ns++)
+    {
+        sim_opts *opts[2];
+        sim_solver *solver[2];
+        sim_out *out[2];
+
+        // 0: exact Newton, 1: simplified Newton
+        for (int k = 0; k < 2; k++)
+        {
+            bool simplified_newton = (k == 1);
+            int newton_iter = 20;
+            double newton_tol = 1e-12;
+
+            opts[k] = (sim_opts *) sim_opts_create(config, dims);
+            opts[k]->sens_forw = true;
+            opts[k]->sens_adj = true;
+            opts[k]->sens_algebraic = true;
+            opts[k]->output_z = true;
+            opts[k]->num_steps = 2;
+            opts[k]->ns = ns;
+            sim_opts_set(config, opts[k], "newton_iter", &newton_iter);
+            sim_opts_set(config, opts[k], "newton_tol", &newton_tol);
+            sim_opts_set(config, opts[k], "simplified_newton", &simplified_newton);
+
+            out[k] = sim_out_create(config, dims);
+            solver[k] = sim_solver_create(config, dims, opts[k], in);
+            sim_precompute(solver[k], in, out[k]);
+            REQUIRE(sim_solve(solver[k], in, out[k]) == 0);
+        }
+
+        for (int ii = 0; ii < nx; ii++)
+            REQUIRE(fabs(out[1]->xn[ii] - out[0]->xn[ii]) <= tol * (1.0 + fabs(out[0]->xn[ii])));
+        for (int ii = 0; ii < nx * NF; ii++)
+            REQUIRE(fabs(out[1]->S_forw[ii] - out[0]->S_forw[ii]) <= tol * (1.0 + fabs(out[0]->S_forw[ii])));
+        for (int ii = 0; ii < NF; ii++)
+            REQUIRE(fabs(out[1]->S_adj[ii] - out[0]->S_adj[ii]) <= tol * (1.0 + fabs(out[0]->S_adj[ii])));
+        for (int ii = 0; ii < nz; ii++)
+            REQUIRE(fabs(out[1]->zn[ii] - out[0]->zn[ii]) <= tol * (1.0 + fabs(out[0]->zn[ii])));
+        for (int ii = 0; ii < nz * NF; ii++)
+            REQUIRE(fabs(out[1]->S_algebraic[ii] - out[0]->S_algebraic[ii])
+                    <= tol * (1.0 + fabs(out[0]->S_algebraic[ii])));
+
+        for (int k = 0; k < 2; k++)
+        {
+            sim_out_destroy(out[k]);
+            sim_solver_destroy(solver[k]);
+            sim_opts_destroy(opts[k]);
+        }
+    }
+
+    sim_in_destroy(in);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}  // END_TEST_CASE
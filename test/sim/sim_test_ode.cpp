@@ -604,3 +604,707 @@ TEST_CASE("wt_nx3_example", "[integrators]")
     external_function_casadi_free(&get_matrices_fun);
 
 }  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_erk_batch", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    // not a multiple of the number of lanes
+    const int num_instances = 6;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // expl_vde_for
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_casadi_create(&expl_vde_for, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+    opts->sens_forw = true;
+    opts->sens_adj = false;
+    opts->num_steps = 3;
+    opts->ns = 4;
+
+    sim_in *in[num_instances];
+    sim_out *out[num_instances];
+    sim_out *out_ref[num_instances];
+    for (int k = 0; k < num_instances; k++)
+    {
+        in[k] = sim_in_create(config, dims);
+        out[k] = sim_out_create(config, dims);
+        out_ref[k] = sim_out_create(config, dims);
+
+        // different horizon and controls per instance
+        in[k]->T = 0.05 * (1.0 + 0.1 * k);
+        sim_in_set(config, dims, in[k], "expl_vde_for", &expl_vde_for);
+        for (int ii = 0; ii < nx; ii++)
+            in[k]->x[ii] = x0[ii];
+        for (int ii = 0; ii < nu; ii++)
+            in[k]->u[ii] = u_sim[k*nu+ii];
+        for (int ii = 0; ii < nx * NF; ii++)
+            in[k]->S_forw[ii] = 0.0;
+        for (int ii = 0; ii < nx; ii++)
+            in[k]->S_forw[ii * (nx + 1)] = 1.0;
+    }
+
+    sim_solver *solver = sim_solver_create(config, dims, opts, in[0]);
+    sim_precompute(solver, in[0], out[0]);
+
+    for (int k = 0; k < num_instances; k++)
+        REQUIRE(sim_solve(solver, in[k], out_ref[k]) == 0);
+
+    REQUIRE(sim_solve_batch(solver, in, out, num_instances) == 0);
+
+    for (int k = 0; k < num_instances; k++)
+    {
+        for (int ii = 0; ii < nx; ii++)
+            REQUIRE(fabs(out[k]->xn[ii] - out_ref[k]->xn[ii]) <= 1e-12);
+        for (int ii = 0; ii < nx * NF; ii++)
+            REQUIRE(fabs(out[k]->S_forw[ii] - out_ref[k]->S_forw[ii]) <= 1e-12);
+    }
+
+    for (int k = 0; k < num_instances; k++)
+    {
+        sim_in_destroy(in[k]);
+        sim_out_destroy(out[k]);
+        sim_out_destroy(out_ref[k]);
+    }
+    sim_solver_destroy(solver);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&expl_vde_for);
+}  // END_TEST_CASE
+
+
+
+#if defined(ACADOS_WITH_SINGLE_PRECISION)
+TEST_CASE("wt_nx3_erk_single_precision", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    // float accumulation over num_steps*ns stages, relative to the double result
+    double tol = 1e-4;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // expl_vde_for
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_casadi_create(&expl_vde_for, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    bool single_precision = true;
+    sim_opts *opts[2];
+    sim_solver *solver[2];
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out[2];
+
+    in->T = 0.05;
+    sim_in_set(config, dims, in, "expl_vde_for", &expl_vde_for);
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+
+    // 0: double, 1: single precision
+    for (int k = 0; k < 2; k++)
+    {
+        opts[k] = (sim_opts *) sim_opts_create(config, dims);
+        opts[k]->sens_forw = true;
+        opts[k]->sens_adj = false;
+        opts[k]->num_steps = 3;
+        opts[k]->ns = 4;
+        if (k == 1)
+            sim_opts_set(config, opts[k], "single_precision", &single_precision);
+
+        out[k] = sim_out_create(config, dims);
+        solver[k] = sim_solver_create(config, dims, opts[k], in);
+        sim_precompute(solver[k], in, out[k]);
+        REQUIRE(sim_solve(solver[k], in, out[k]) == 0);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        REQUIRE(fabs(out[1]->xn[ii] - out[0]->xn[ii]) <= tol * (1.0 + fabs(out[0]->xn[ii])));
+    for (int ii = 0; ii < nx * NF; ii++)
+        REQUIRE(fabs(out[1]->S_forw[ii] - out[0]->S_forw[ii]) <= tol * (1.0 + fabs(out[0]->S_forw[ii])));
+
+    for (int k = 0; k < 2; k++)
+    {
+        sim_out_destroy(out[k]);
+        sim_solver_destroy(solver[k]);
+        sim_opts_destroy(opts[k]);
+    }
+    sim_in_destroy(in);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&expl_vde_for);
+}  // END_TEST_CASE
+#endif
+
+
+
+TEST_CASE("wt_nx3_erk_adaptive_steps", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    // relative to a fine uniform grid
+    double tol = 1e-6;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // expl_ode_fun
+    external_function_casadi expl_ode_fun;
+    expl_ode_fun.casadi_fun = &casadi_expl_ode_fun;
+    expl_ode_fun.casadi_work = &casadi_expl_ode_fun_work;
+    expl_ode_fun.casadi_sparsity_in = &casadi_expl_ode_fun_sparsity_in;
+    expl_ode_fun.casadi_sparsity_out = &casadi_expl_ode_fun_sparsity_out;
+    expl_ode_fun.casadi_n_in = &casadi_expl_ode_fun_n_in;
+    expl_ode_fun.casadi_n_out = &casadi_expl_ode_fun_n_out;
+    external_function_casadi_create(&expl_ode_fun, &ext_fun_opts);
+
+    // expl_vde_for
+    external_function_casadi expl_vde_for;
+    expl_vde_for.casadi_fun = &casadi_expl_vde_for;
+    expl_vde_for.casadi_work = &casadi_expl_vde_for_work;
+    expl_vde_for.casadi_sparsity_in = &casadi_expl_vde_for_sparsity_in;
+    expl_vde_for.casadi_sparsity_out = &casadi_expl_vde_for_sparsity_out;
+    expl_vde_for.casadi_n_in = &casadi_expl_vde_for_n_in;
+    expl_vde_for.casadi_n_out = &casadi_expl_vde_for_n_out;
+    external_function_casadi_create(&expl_vde_for, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = ERK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    bool adaptive_steps = true;
+    double adaptive_tol = 1e-8;
+    sim_opts *opts[2];
+    sim_solver *solver[2];
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out[2];
+
+    in->T = 0.05;
+    sim_in_set(config, dims, in, "expl_ode_fun", &expl_ode_fun);
+    sim_in_set(config, dims, in, "expl_vde_for", &expl_vde_for);
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+
+    // 0: uniform reference, 1: adaptive with num_steps as upper bound
+    for (int k = 0; k < 2; k++)
+    {
+        opts[k] = (sim_opts *) sim_opts_create(config, dims);
+        opts[k]->sens_forw = true;
+        opts[k]->sens_adj = false;
+        opts[k]->num_steps = 50;
+        opts[k]->ns = 4;
+        if (k == 1)
+        {
+            sim_opts_set(config, opts[k], "adaptive_steps", &adaptive_steps);
+            sim_opts_set(config, opts[k], "adaptive_tol", &adaptive_tol);
+        }
+
+        out[k] = sim_out_create(config, dims);
+        solver[k] = sim_solver_create(config, dims, opts[k], in);
+        sim_precompute(solver[k], in, out[k]);
+        REQUIRE(sim_solve(solver[k], in, out[k]) == 0);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        REQUIRE(fabs(out[1]->xn[ii] - out[0]->xn[ii]) <= tol * (1.0 + fabs(out[0]->xn[ii])));
+    for (int ii = 0; ii < nx * NF; ii++)
+        REQUIRE(fabs(out[1]->S_forw[ii] - out[0]->S_forw[ii]) <= tol * (1.0 + fabs(out[0]->S_forw[ii])));
+
+    // the selected sequence is coarser than the upper bound
+    int num_steps_used, adaptive_status;
+    config->memory_get(config, dims, solver[1]->mem, "num_steps_used", &num_steps_used);
+    config->memory_get(config, dims, solver[1]->mem, "adaptive_status", &adaptive_status);
+    REQUIRE(num_steps_used > 0);
+    REQUIRE(num_steps_used < opts[1]->num_steps);
+    REQUIRE(adaptive_status == ACADOS_SUCCESS);
+
+    // a frozen sequence is reused and reproduces the result
+    bool adaptive_freeze = true;
+    double xn_ref[nx];
+    for (int ii = 0; ii < nx; ii++)
+        xn_ref[ii] = out[1]->xn[ii];
+    sim_opts_set(config, opts[1], "adaptive_freeze", &adaptive_freeze);
+    REQUIRE(sim_solve(solver[1], in, out[1]) == 0);
+    for (int ii = 0; ii < nx; ii++)
+        REQUIRE(out[1]->xn[ii] == xn_ref[ii]);
+
+    // a tolerance that cannot be met within num_steps is reported, the uniform grid is used
+    double adaptive_tol_tight = 1e-14;
+    int num_steps_max = 2;
+    sim_opts *opts_tight = (sim_opts *) sim_opts_create(config, dims);
+    opts_tight->sens_forw = true;
+    opts_tight->sens_adj = false;
+    opts_tight->num_steps = num_steps_max;
+    opts_tight->ns = 4;
+    sim_opts_set(config, opts_tight, "adaptive_steps", &adaptive_steps);
+    sim_opts_set(config, opts_tight, "adaptive_tol", &adaptive_tol_tight);
+    sim_out *out_tight = sim_out_create(config, dims);
+    sim_solver *solver_tight = sim_solver_create(config, dims, opts_tight, in);
+    sim_precompute(solver_tight, in, out_tight);
+    REQUIRE(sim_solve(solver_tight, in, out_tight) == ACADOS_MAXITER);
+    config->memory_get(config, dims, solver_tight->mem, "num_steps_used", &num_steps_used);
+    config->memory_get(config, dims, solver_tight->mem, "adaptive_status", &adaptive_status);
+    REQUIRE(num_steps_used == num_steps_max);
+    REQUIRE(adaptive_status == ACADOS_MAXITER);
+
+    // freezing the fallback grid keeps the status
+    sim_opts_set(config, opts_tight, "adaptive_freeze", &adaptive_freeze);
+    REQUIRE(sim_solve(solver_tight, in, out_tight) == ACADOS_MAXITER);
+
+    sim_out_destroy(out_tight);
+    sim_solver_destroy(solver_tight);
+    sim_opts_destroy(opts_tight);
+
+    for (int k = 0; k < 2; k++)
+    {
+        sim_out_destroy(out[k]);
+        sim_solver_destroy(solver[k]);
+        sim_opts_destroy(opts[k]);
+    }
+    sim_in_destroy(in);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&expl_ode_fun);
+    external_function_casadi_free(&expl_vde_for);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_irk_simplified_newton", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    // both Newton variants converge to the same stage values
+    double tol = 1e-8;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    sim_in *in = sim_in_create(config, dims);
+
+    in->T = 0.05;
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+
+    // odd and even number of stages: with and without real eigenvalue of A^{-1}
+    for (int ns = 3; ns < 5; ns++)
+    {
+        sim_opts *opts[2];
+        sim_solver *solver[2];
+        sim_out *out[2];
+
+        // 0: exact Newton, 1: simplified Newton
+        for (int k = 0; k < 2; k++)
+        {
+            bool simplified_newton = (k == 1);
+            int newton_iter = 20;
+            double newton_tol = 1e-12;
+
+            opts[k] = (sim_opts *) sim_opts_create(config, dims);
+            opts[k]->sens_forw = true;
+            opts[k]->sens_adj = false;
+            opts[k]->num_steps = 2;
+            opts[k]->ns = ns;
+            sim_opts_set(config, opts[k], "newton_iter", &newton_iter);
+            sim_opts_set(config, opts[k], "newton_tol", &newton_tol);
+            sim_opts_set(config, opts[k], "simplified_newton", &simplified_newton);
+
+            out[k] = sim_out_create(config, dims);
+            solver[k] = sim_solver_create(config, dims, opts[k], in);
+            sim_precompute(solver[k], in, out[k]);
+            REQUIRE(sim_solve(solver[k], in, out[k]) == 0);
+        }
+
+        for (int ii = 0; ii < nx; ii++)
+            REQUIRE(fabs(out[1]->xn[ii] - out[0]->xn[ii]) <= tol * (1.0 + fabs(out[0]->xn[ii])));
+        for (int ii = 0; ii < nx * NF; ii++)
+            REQUIRE(fabs(out[1]->S_forw[ii] - out[0]->S_forw[ii]) <= tol * (1.0 + fabs(out[0]->S_forw[ii])));
+
+        for (int k = 0; k < 2; k++)
+        {
+            sim_out_destroy(out[k]);
+            sim_solver_destroy(solver[k]);
+            sim_opts_destroy(opts[k]);
+        }
+    }
+
+    sim_in_destroy(in);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_irk_adaptive_steps", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    // relative to a fine uniform grid
+    double tol = 1e-6;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    bool adaptive_steps = true;
+    double adaptive_tol = 1e-8;
+    int newton_iter = 20;
+    double newton_tol = 1e-12;
+    sim_opts *opts[2];
+    sim_solver *solver[2];
+    sim_in *in = sim_in_create(config, dims);
+    sim_out *out[2];
+
+    in->T = 0.05;
+    sim_in_set(config, dims, in, "impl_ode_fun", &impl_ode_fun);
+    sim_in_set(config, dims, in, "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+    sim_in_set(config, dims, in, "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+    for (int ii = 0; ii < nx; ii++)
+        in->x[ii] = x0[ii];
+    for (int ii = 0; ii < nu; ii++)
+        in->u[ii] = u_sim[ii];
+    for (int ii = 0; ii < nx * NF; ii++)
+        in->S_forw[ii] = 0.0;
+    for (int ii = 0; ii < nx; ii++)
+        in->S_forw[ii * (nx + 1)] = 1.0;
+
+    // 0: uniform reference, 1: adaptive with num_steps as upper bound
+    for (int k = 0; k < 2; k++)
+    {
+        opts[k] = (sim_opts *) sim_opts_create(config, dims);
+        opts[k]->sens_forw = true;
+        opts[k]->sens_adj = false;
+        opts[k]->num_steps = 50;
+        opts[k]->ns = 2;
+        sim_opts_set(config, opts[k], "newton_iter", &newton_iter);
+        sim_opts_set(config, opts[k], "newton_tol", &newton_tol);
+        if (k == 1)
+        {
+            sim_opts_set(config, opts[k], "adaptive_steps", &adaptive_steps);
+            sim_opts_set(config, opts[k], "adaptive_tol", &adaptive_tol);
+        }
+
+        out[k] = sim_out_create(config, dims);
+        solver[k] = sim_solver_create(config, dims, opts[k], in);
+        sim_precompute(solver[k], in, out[k]);
+        REQUIRE(sim_solve(solver[k], in, out[k]) == 0);
+    }
+
+    for (int ii = 0; ii < nx; ii++)
+        REQUIRE(fabs(out[1]->xn[ii] - out[0]->xn[ii]) <= tol * (1.0 + fabs(out[0]->xn[ii])));
+    for (int ii = 0; ii < nx * NF; ii++)
+        REQUIRE(fabs(out[1]->S_forw[ii] - out[0]->S_forw[ii]) <= tol * (1.0 + fabs(out[0]->S_forw[ii])));
+
+    // the selected sequence is coarser than the upper bound
+    int num_steps_used, adaptive_status;
+    config->memory_get(config, dims, solver[1]->mem, "num_steps_used", &num_steps_used);
+    config->memory_get(config, dims, solver[1]->mem, "adaptive_status", &adaptive_status);
+    REQUIRE(num_steps_used > 0);
+    REQUIRE(num_steps_used < opts[1]->num_steps);
+    REQUIRE(adaptive_status == ACADOS_SUCCESS);
+
+    // a frozen sequence is reused and reproduces the result up to the Newton tolerance,
+    // the stage values are warm started from the previous call
+    bool adaptive_freeze = true;
+    double xn_ref[nx];
+    for (int ii = 0; ii < nx; ii++)
+        xn_ref[ii] = out[1]->xn[ii];
+    sim_opts_set(config, opts[1], "adaptive_freeze", &adaptive_freeze);
+    REQUIRE(sim_solve(solver[1], in, out[1]) == 0);
+    int num_steps_frozen;
+    config->memory_get(config, dims, solver[1]->mem, "num_steps_used", &num_steps_frozen);
+    REQUIRE(num_steps_frozen == num_steps_used);
+    for (int ii = 0; ii < nx; ii++)
+        REQUIRE(fabs(out[1]->xn[ii] - xn_ref[ii]) <= 1e-10 * (1.0 + fabs(xn_ref[ii])));
+
+    for (int k = 0; k < 2; k++)
+    {
+        sim_out_destroy(out[k]);
+        sim_solver_destroy(solver[k]);
+        sim_opts_destroy(opts[k]);
+    }
+    sim_in_destroy(in);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}  // END_TEST_CASE
+
+
+
+TEST_CASE("wt_nx3_irk_batch", "[integrators]")
+{
+    const int nx = 3;
+    const int nu = 4;
+    int NF = nx + nu;  // columns of forward seed
+
+    const int num_instances = 3;
+
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+    ext_fun_opts.external_workspace = true;
+
+    // impl_ode_fun
+    external_function_casadi impl_ode_fun;
+    impl_ode_fun.casadi_fun = &casadi_impl_ode_fun;
+    impl_ode_fun.casadi_work = &casadi_impl_ode_fun_work;
+    impl_ode_fun.casadi_sparsity_in = &casadi_impl_ode_fun_sparsity_in;
+    impl_ode_fun.casadi_sparsity_out = &casadi_impl_ode_fun_sparsity_out;
+    impl_ode_fun.casadi_n_in = &casadi_impl_ode_fun_n_in;
+    impl_ode_fun.casadi_n_out = &casadi_impl_ode_fun_n_out;
+    external_function_casadi_create(&impl_ode_fun, &ext_fun_opts);
+
+    // impl_ode_fun_jac_x_xdot
+    external_function_casadi impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_fun = &casadi_impl_ode_fun_jac_x_xdot;
+    impl_ode_fun_jac_x_xdot.casadi_work = &casadi_impl_ode_fun_jac_x_xdot_work;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_in = &casadi_impl_ode_fun_jac_x_xdot_sparsity_in;
+    impl_ode_fun_jac_x_xdot.casadi_sparsity_out = &casadi_impl_ode_fun_jac_x_xdot_sparsity_out;
+    impl_ode_fun_jac_x_xdot.casadi_n_in = &casadi_impl_ode_fun_jac_x_xdot_n_in;
+    impl_ode_fun_jac_x_xdot.casadi_n_out = &casadi_impl_ode_fun_jac_x_xdot_n_out;
+    external_function_casadi_create(&impl_ode_fun_jac_x_xdot, &ext_fun_opts);
+
+    // impl_ode_jac_x_xdot_u
+    external_function_casadi impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_fun = &casadi_impl_ode_jac_x_xdot_u;
+    impl_ode_jac_x_xdot_u.casadi_work = &casadi_impl_ode_jac_x_xdot_u_work;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_in = &casadi_impl_ode_jac_x_xdot_u_sparsity_in;
+    impl_ode_jac_x_xdot_u.casadi_sparsity_out = &casadi_impl_ode_jac_x_xdot_u_sparsity_out;
+    impl_ode_jac_x_xdot_u.casadi_n_in = &casadi_impl_ode_jac_x_xdot_u_n_in;
+    impl_ode_jac_x_xdot_u.casadi_n_out = &casadi_impl_ode_jac_x_xdot_u_n_out;
+    external_function_casadi_create(&impl_ode_jac_x_xdot_u, &ext_fun_opts);
+
+    // IRK has no batch mode, sim_solve_batch solves the instances one by one
+    sim_solver_plan_t plan;
+    plan.sim_solver = IRK;
+    sim_config *config = sim_config_create(plan);
+    REQUIRE(config->evaluate_batch == NULL);
+
+    void *dims = sim_dims_create(config);
+    sim_dims_set(config, dims, "nx", &nx);
+    sim_dims_set(config, dims, "nu", &nu);
+
+    void *opts_ = sim_opts_create(config, dims);
+    sim_opts *opts = (sim_opts *) opts_;
+    opts->sens_forw = true;
+    opts->sens_adj = true;
+    opts->jac_reuse = false;
+    opts->newton_iter = 3;
+    opts->num_steps = 3;
+    opts->ns = 2;
+
+    sim_in *in[num_instances];
+    sim_out *out[num_instances];
+    sim_out *out_ref[num_instances];
+    for (int k = 0; k < num_instances; k++)
+    {
+        in[k] = sim_in_create(config, dims);
+        out[k] = sim_out_create(config, dims);
+        out_ref[k] = sim_out_create(config, dims);
+
+        in[k]->T = 0.05 * (1.0 + 0.1 * k);
+        sim_in_set(config, dims, in[k], "impl_ode_fun", &impl_ode_fun);
+        sim_in_set(config, dims, in[k], "impl_ode_fun_jac_x_xdot", &impl_ode_fun_jac_x_xdot);
+        sim_in_set(config, dims, in[k], "impl_ode_jac_x_xdot_u", &impl_ode_jac_x_xdot_u);
+        for (int ii = 0; ii < nx; ii++)
+            in[k]->x[ii] = x0[ii];
+        for (int ii = 0; ii < nu; ii++)
+            in[k]->u[ii] = u_sim[k*nu+ii];
+        for (int ii = 0; ii < nx * NF; ii++)
+            in[k]->S_forw[ii] = 0.0;
+        for (int ii = 0; ii < nx; ii++)
+            in[k]->S_forw[ii * (nx + 1)] = 1.0;
+        for (int ii = 0; ii < nx; ii++)
+            in[k]->S_adj[ii] = 1.0;
+    }
+
+    sim_solver *solver = sim_solver_create(config, dims, opts, in[0]);
+
+    for (int k = 0; k < num_instances; k++)
+        REQUIRE(sim_solve(solver, in[k], out_ref[k]) == 0);
+
+    REQUIRE(sim_solve_batch(solver, in, out, num_instances) == 0);
+
+    for (int k = 0; k < num_instances; k++)
+    {
+        for (int ii = 0; ii < nx; ii++)
+            REQUIRE(out[k]->xn[ii] == out_ref[k]->xn[ii]);
+        for (int ii = 0; ii < nx * NF; ii++)
+            REQUIRE(out[k]->S_forw[ii] == out_ref[k]->S_forw[ii]);
+        for (int ii = 0; ii < NF; ii++)
+            REQUIRE(out[k]->S_adj[ii] == out_ref[k]->S_adj[ii]);
+    }
+
+    for (int k = 0; k < num_instances; k++)
+    {
+        sim_in_destroy(in[k]);
+        sim_out_destroy(out[k]);
+        sim_out_destroy(out_ref[k]);
+    }
+    sim_solver_destroy(solver);
+    sim_opts_destroy(opts);
+    sim_dims_destroy(dims);
+    sim_config_destroy(config);
+
+    external_function_casadi_free(&impl_ode_fun);
+    external_function_casadi_free(&impl_ode_fun_jac_x_xdot);
+    external_function_casadi_free(&impl_ode_jac_x_xdot_u);
+}  // END_TEST_CASE
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+
+// external
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+// acados
+#include "acados/utils/external_function_generic.h"
+#include "acados_c/external_function_interface.h"
+
+#include "blasfeo_d_aux.h"
+#include "blasfeo_d_aux_ext_dep.h"
+
+
+
+/************************************************
+ * hand-written function in casadi format
+ ************************************************/
+
+// f(x) = 5 x 5 sparse matrix with nonzeros
+//   (0,0) = x0, (1,0) = x1, (0,1) = x1, (1,1) = x0, (3,2) = 1, (4,4) = x0 * x1
+static const int test_fun_sparsity_x[3] = {2, 1, 1};
+static const int test_fun_sparsity_out[14] = {5, 5, 0, 2, 4, 5, 5, 6, 0, 1, 0, 1, 3, 4};
+
+static int test_fun(const double **arg, double **res, int *iw, double *w, void *mem)
+{
+    const double *x = arg[0];
+    if (res[0] != NULL)
+    {
+        res[0][0] = x[0];
+        res[0][1] = x[1];
+        res[0][2] = x[1];
+        res[0][3] = x[0];
+        res[0][4] = 1.0;
+        res[0][5] = x[0] * x[1];
+    }
+    return 0;
+}
+
+static int test_fun_work(int *sz_arg, int *sz_res, int *sz_iw, int *sz_w)
+{
+    *sz_arg = 1;
+    *sz_res = 1;
+    *sz_iw = 0;
+    *sz_w = 0;
+    return 0;
+}
+
+static const int *test_fun_sparsity_in_fun(int i)
+{
+    return i == 0 ? test_fun_sparsity_x : NULL;
+}
+
+static const int *test_fun_sparsity_out_fun(int i)
+{
+    return i == 0 ? test_fun_sparsity_out : NULL;
+}
+
+static int test_fun_n_in(void) { return 1; }
+
+static int test_fun_n_out(void) { return 1; }
+
+static void test_fun_set(external_function_casadi *fun)
+{
+    fun->casadi_fun = &test_fun;
+    fun->casadi_work = &test_fun_work;
+    fun->casadi_sparsity_in = &test_fun_sparsity_in_fun;
+    fun->casadi_sparsity_out = &test_fun_sparsity_out_fun;
+    fun->casadi_n_in = &test_fun_n_in;
+    fun->casadi_n_out = &test_fun_n_out;
+}
+
+// diagonal n x n matrix in casadi format
+static std::vector<int> diagonal_sparsity(int n)
+{
+    std::vector<int> sparsity(2 + n+1 + n);
+    sparsity[0] = n;
+    sparsity[1] = n;
+    for (int jj = 0; jj <= n; jj++)
+        sparsity[2+jj] = jj;
+    for (int jj = 0; jj < n; jj++)
+        sparsity[n+3+jj] = jj;
+    return sparsity;
+}
+
+static std::vector<int> diagonal_10;
+
+static const int *diagonal_sparsity_out_fun(int i)
+{
+    return i == 0 ? diagonal_10.data() : NULL;
+}
+
+// checks that the blocks are column-disjoint and cover all structural nonzeros
+static void check_nnz_pattern_covers(external_function_nnz_pattern *pattern, const int *sparsity)
+{
+    int n = sparsity[1];
+    const int *idxcol = sparsity + 2;
+    const int *row = sparsity + n + 3;
+    for (int jj = 0; jj < n; jj++)
+    {
+        int nblock_col = 0;
+        for (int ii = 0; ii < pattern->nblock; ii++)
+        {
+            external_function_nnz_box *box = pattern->block + ii;
+            if (jj >= box->col0 && jj < box->col0 + box->ncol)
+            {
+                nblock_col++;
+                for (int idx = idxcol[jj]; idx < idxcol[jj+1]; idx++)
+                {
+                    REQUIRE(row[idx] >= box->row0);
+                    REQUIRE(row[idx] < box->row0 + box->nrow);
+                }
+            }
+        }
+        if (idxcol[jj+1] > idxcol[jj])
+            REQUIRE(nblock_col == 1);
+        else
+            REQUIRE(nblock_col <= 1);
+    }
+}
+
+
+
+TEST_CASE("external function output nnz pattern", "[external_function]")
+{
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    SECTION("casadi sparsity split into blocks")
+    {
+        external_function_casadi fun;
+        test_fun_set(&fun);
+        external_function_casadi_create(&fun, &ext_fun_opts);
+
+        REQUIRE(external_function_get_output_sparsity_if_defined((external_function_generic *) &fun, 0)
+                == test_fun_sparsity_out);
+        REQUIRE(external_function_get_output_sparsity_if_defined((external_function_generic *) &fun, 1)
+                == NULL);
+
+        external_function_nnz_pattern pattern;
+        external_function_get_output_nnz_pattern((external_function_generic *) &fun, 0, 5, 5, &pattern);
+
+        REQUIRE(pattern.nblock == 3);
+        REQUIRE(external_function_nnz_pattern_numel(&pattern) == 6);
+        REQUIRE(external_function_nnz_pattern_row_end(&pattern) == 5);
+        check_nnz_pattern_covers(&pattern, test_fun_sparsity_out);
+
+        // dimension mismatch: full matrix
+        external_function_get_output_nnz_pattern((external_function_generic *) &fun, 0, 4, 5, &pattern);
+        REQUIRE(pattern.nblock == 1);
+        REQUIRE(external_function_nnz_pattern_numel(&pattern) == 20);
+
+        external_function_casadi_free(&fun);
+    }
+
+    SECTION("blocks are merged beyond EXTERNAL_FUNCTION_NNZ_MAX_BLOCKS")
+    {
+        diagonal_10 = diagonal_sparsity(10);
+
+        external_function_casadi fun;
+        test_fun_set(&fun);
+        fun.casadi_sparsity_out = &diagonal_sparsity_out_fun;
+        external_function_casadi_create(&fun, &ext_fun_opts);
+
+        external_function_nnz_pattern pattern;
+        external_function_get_output_nnz_pattern((external_function_generic *) &fun, 0, 10, 10, &pattern);
+
+        REQUIRE(pattern.nblock == EXTERNAL_FUNCTION_NNZ_MAX_BLOCKS);
+        // two merged 2 x 2 blocks and six 1 x 1 blocks
+        REQUIRE(external_function_nnz_pattern_numel(&pattern) == 14);
+        check_nnz_pattern_covers(&pattern, diagonal_10.data());
+
+        external_function_casadi_free(&fun);
+    }
+
+    SECTION("unknown sparsity gives the full matrix")
+    {
+        external_function_nnz_pattern pattern;
+        external_function_get_output_nnz_pattern(NULL, 0, 5, 3, &pattern);
+        REQUIRE(pattern.nblock == 1);
+        REQUIRE(external_function_nnz_pattern_numel(&pattern) == 15);
+        REQUIRE(external_function_nnz_pattern_row_end(&pattern) == 5);
+    }
+
+    SECTION("restricted dgead matches dense dgead")
+    {
+        external_function_casadi fun;
+        test_fun_set(&fun);
+        external_function_casadi_create(&fun, &ext_fun_opts);
+
+        double x[2] = {2.0, 3.0};
+        struct blasfeo_dvec x_in;
+        blasfeo_allocate_dvec(2, &x_in);
+        blasfeo_pack_dvec(2, x, 1, &x_in, 0);
+
+        struct blasfeo_dmat out_mat, sB_dense, sB_pattern;
+        blasfeo_allocate_dmat(5, 5, &out_mat);
+        blasfeo_allocate_dmat(5, 5, &sB_dense);
+        blasfeo_allocate_dmat(5, 5, &sB_pattern);
+        blasfeo_dgese(5, 5, 1.0, &sB_dense, 0, 0);
+        blasfeo_dgese(5, 5, 1.0, &sB_pattern, 0, 0);
+
+        ext_fun_arg_t type_in[1] = {BLASFEO_DVEC};
+        void *in[1] = {&x_in};
+        ext_fun_arg_t type_out[1] = {BLASFEO_DMAT};
+        void *out[1] = {&out_mat};
+        fun.evaluate(&fun, type_in, in, type_out, out);
+
+        external_function_nnz_pattern pattern;
+        external_function_get_output_nnz_pattern((external_function_generic *) &fun, 0, 5, 5, &pattern);
+
+        blasfeo_dgead(5, 5, 0.5, &out_mat, 0, 0, &sB_dense, 0, 0);
+        external_function_nnz_pattern_dgead(&pattern, 0.5, &out_mat, &sB_pattern);
+
+        for (int jj = 0; jj < 5; jj++)
+            for (int ii = 0; ii < 5; ii++)
+                REQUIRE(BLASFEO_DMATEL(&sB_pattern, ii, jj) == BLASFEO_DMATEL(&sB_dense, ii, jj));
+
+        blasfeo_free_dvec(&x_in);
+        blasfeo_free_dmat(&out_mat);
+        blasfeo_free_dmat(&sB_dense);
+        blasfeo_free_dmat(&sB_pattern);
+        external_function_casadi_free(&fun);
+    }
+}
+
+
+
+TEST_CASE("external function zero-copy scatter", "[external_function]")
+{
+    external_function_opts ext_fun_opts;
+    external_function_opts_set_to_default(&ext_fun_opts);
+
+    // fun_dense converts via the dense casadi output, fun_scatter scatters into the destination
+    external_function_casadi fun_dense, fun_scatter;
+    test_fun_set(&fun_dense);
+    test_fun_set(&fun_scatter);
+    external_function_casadi_create(&fun_dense, &ext_fun_opts);
+    ext_fun_opts.zero_copy = true;
+    external_function_casadi_create(&fun_scatter, &ext_fun_opts);
+    REQUIRE(fun_scatter.evaluate == &external_function_casadi_wrapper_zero_copy);
+
+    struct blasfeo_dvec x_in;
+    blasfeo_allocate_dvec(2, &x_in);
+    ext_fun_arg_t type_in[1] = {BLASFEO_DVEC};
+    void *in[1] = {&x_in};
+
+    // 5 x 5 output in a shared 7 x 8 matrix, at offset (1, 2)
+    struct blasfeo_dmat A_dense, A_scatter;
+    blasfeo_allocate_dmat(7, 8, &A_dense);
+    blasfeo_allocate_dmat(7, 8, &A_scatter);
+    struct blasfeo_dmat_args out_dense = {&A_dense, 1, 2};
+    struct blasfeo_dmat_args out_scatter = {&A_scatter, 1, 2};
+
+    ext_fun_arg_t type_out[1] = {BLASFEO_DMAT_ARGS};
+    void *out_d[1] = {&out_dense};
+    void *out_s[1] = {&out_scatter};
+
+    double x[3][2] = {{2.0, 3.0}, {-1.0, 0.5}, {4.0, -2.0}};
+    for (int k = 0; k < 3; k++)
+    {
+        // the destination is overwritten in between, e.g. accumulated into by the caller
+        blasfeo_dgese(7, 8, 7.0 + k, &A_dense, 0, 0);
+        blasfeo_dgese(7, 8, 7.0 + k, &A_scatter, 0, 0);
+
+        blasfeo_pack_dvec(2, x[k], 1, &x_in, 0);
+        fun_dense.evaluate(&fun_dense, type_in, in, type_out, out_d);
+        fun_scatter.evaluate(&fun_scatter, type_in, in, type_out, out_s);
+
+        for (int jj = 0; jj < 8; jj++)
+            for (int ii = 0; ii < 7; ii++)
+                REQUIRE(BLASFEO_DMATEL(&A_scatter, ii, jj) == BLASFEO_DMATEL(&A_dense, ii, jj));
+        REQUIRE(BLASFEO_DMATEL(&A_scatter, 1+4, 2+4) == x[k][0] * x[k][1]);
+        REQUIRE(BLASFEO_DMATEL(&A_scatter, 1+2, 2+2) == 0.0);
+    }
+
+    // column-major destination with leading dimension 6
+    double B_dense[6*5], B_scatter[6*5];
+    for (int ii = 0; ii < 6*5; ii++)
+    {
+        B_dense[ii] = -1.0;
+        B_scatter[ii] = -1.0;
+    }
+    struct colmaj_args colmaj_dense = {B_dense, 6};
+    struct colmaj_args colmaj_scatter = {B_scatter, 6};
+    type_out[0] = COLMAJ_ARGS;
+    out_d[0] = &colmaj_dense;
+    out_s[0] = &colmaj_scatter;
+    fun_dense.evaluate(&fun_dense, type_in, in, type_out, out_d);
+    fun_scatter.evaluate(&fun_scatter, type_in, in, type_out, out_s);
+    for (int ii = 0; ii < 6*5; ii++)
+        REQUIRE(B_scatter[ii] == B_dense[ii]);
+
+    blasfeo_free_dvec(&x_in);
+    blasfeo_free_dmat(&A_dense);
+    blasfeo_free_dmat(&A_scatter);
+    external_function_casadi_free(&fun_dense);
+    external_function_casadi_free(&fun_scatter);
+}
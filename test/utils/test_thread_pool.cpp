@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) The acados authors.
+ *
+ * This file is part of acados.
+ *
+ * The 2-Clause BSD License
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.;
+ */
+
+
+// external
+#include <thread>
+#include <vector>
+
+#include "catch/include/catch.hpp"
+
+// acados
+#include "acados/utils/thread_pool.h"
+
+
+
+/************************************************
+ * loop bodies
+ ************************************************/
+
+typedef struct
+{
+    std::vector<int> count;               // calls per index
+    std::vector<std::thread::id> thread;  // thread of the last call per index
+} pool_test_args;
+
+static void pool_test_fun(void *args_, int i)
+{
+    pool_test_args *args = (pool_test_args *) args_;
+    args->count[i]++;
+    args->thread[i] = std::this_thread::get_id();
+}
+
+// uneven cost, the last indices are the most expensive
+static void pool_test_fun_uneven(void *args_, int i)
+{
+    pool_test_args *args = (pool_test_args *) args_;
+    volatile double x = 0.0;
+    for (int k = 0; k < 1000 * i; k++)
+        x += 1e-3;
+    args->count[i]++;
+    args->thread[i] = std::this_thread::get_id();
+}
+
+
+
+TEST_CASE("thread pool: every index once", "[utils][thread_pool]")
+{
+    int num_threads = 4;
+    acados_thread_pool *pool = acados_thread_pool_create(num_threads, 0);
+#if defined(ACADOS_WITH_THREAD_POOL)
+    REQUIRE(acados_thread_pool_num_threads(pool) == num_threads);
+#else
+    REQUIRE(pool == NULL);
+    REQUIRE(acados_thread_pool_num_threads(pool) == 1);
+#endif
+
+    // n = 0, n < num_threads, n not a multiple of num_threads
+    int n_values[] = {0, 1, 2, 7, 64};
+    int num_runs = 50;
+
+    for (int n : n_values)
+    {
+        for (int steal = 0; steal < 2; steal++)
+        {
+            pool_test_args args;
+            args.count.assign(n, 0);
+            args.thread.assign(n, std::thread::id());
+            std::vector<std::thread::id> first_thread;
+
+            for (int run = 0; run < num_runs; run++)
+            {
+                if (steal)
+                    acados_thread_pool_run_stealing(pool, n, &pool_test_fun_uneven, &args);
+                else
+                    acados_thread_pool_run(pool, n, &pool_test_fun, &args);
+
+                // static assignment: index i stays on the same thread across runs
+                if (run == 0)
+                    first_thread = args.thread;
+                else if (!steal)
+                    REQUIRE(args.thread == first_thread);
+            }
+
+            for (int i = 0; i < n; i++)
+                REQUIRE(args.count[i] == num_runs);
+        }
+    }
+
+    acados_thread_pool_destroy(pool);
+}
+
+
+
+TEST_CASE("thread pool: single thread and NULL pool run serially", "[utils][thread_pool]")
+{
+    acados_thread_pool *pool = acados_thread_pool_create(1, 0);
+    REQUIRE(pool == NULL);
+
+    int n = 5;
+    pool_test_args args;
+    args.count.assign(n, 0);
+    args.thread.assign(n, std::thread::id());
+    acados_thread_pool_run(pool, n, &pool_test_fun, &args);
+    acados_thread_pool_run_stealing(pool, n, &pool_test_fun, &args);
+    for (int i = 0; i < n; i++)
+    {
+        REQUIRE(args.count[i] == 2);
+        REQUIRE(args.thread[i] == std::this_thread::get_id());
+    }
+
+    acados_thread_pool_destroy(pool);
+}
+
+
+
+/************************************************
+ * asynchronous task
+ ************************************************/
+
+static void async_test_fun(void *args_, int index)
+{
+    int *count = (int *) args_;
+    (*count)++;
+}
+
+
+
+TEST_CASE("async task: start, wait and repeated runs", "[utils][thread_pool]")
+{
+    acados_async_task *task = acados_async_task_create();
+#if !defined(ACADOS_WITH_THREAD_POOL)
+    REQUIRE(task == NULL);
+#endif
+
+    // wait without a started task returns immediately, also for NULL
+    acados_async_task_wait(task);
+    acados_async_task_wait(NULL);
+
+    int count = 0;
+    int num_runs = 100;
+    for (int run = 0; run < num_runs; run++)
+    {
+        acados_async_task_start(task, &async_test_fun, &count);
+        acados_async_task_wait(task);
+        REQUIRE(count == run + 1);
+        // idempotent
+        acados_async_task_wait(task);
+    }
+
+    // start waits for the previous task
+    count = 0;
+    for (int run = 0; run < num_runs; run++)
+        acados_async_task_start(task, &async_test_fun, &count);
+    acados_async_task_wait(task);
+    REQUIRE(count == num_runs);
+
+    // destroy waits for a running task
+    acados_async_task_start(task, &async_test_fun, &count);
+    acados_async_task_destroy(task);
+    REQUIRE(count == num_runs + 1);
+}